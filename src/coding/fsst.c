@@ -0,0 +1,424 @@
+/**
+ * Copyright 2018 Marcus Pinnecke
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <limits.h>
+#include <assert.h>
+
+#include "coding/coding_fsst.h"
+
+/** codes of symbols and escaped bytes while learning: symbols are 0 to 254, and the escaped byte b is 256 + b */
+#define NG5_FSST_NUM_CODES              (2 * (UCHAR_MAX + 1))
+
+struct fsst_candidate {
+        unsigned char bytes[NG5_FSST_MAX_SYMBOL_LENGTH];
+        u8 length;
+        u64 gain;
+};
+
+static void sample_strings(const char ***sample, size_t **lengths, size_t *num_sampled,
+        const string_vector_t *strings);
+static void learn_generation(struct coding_fsst *dic, u32 *counts, u32 *pair_counts,
+        struct fsst_candidate *candidates, const char **sample, const size_t *lengths, size_t num_sampled);
+static bool index_symbols(struct coding_fsst *dic);
+
+NG5_EXPORT(bool) coding_fsst_create(struct coding_fsst *dic)
+{
+        error_if_null(dic);
+
+        dic->num_symbols = 0;
+        ng5_zero_memory(dic->lengths, sizeof(dic->lengths));
+        ng5_zero_memory(dic->symbols, sizeof(dic->symbols));
+        ng5_zero_memory(dic->first, sizeof(dic->first));
+        error_init(&dic->err);
+
+        return true;
+}
+
+NG5_EXPORT(bool) coding_fsst_cpy(struct coding_fsst *dst, const struct coding_fsst *src)
+{
+        error_if_null(dst);
+        error_if_null(src);
+
+        *dst = *src;
+        return true;
+}
+
+NG5_EXPORT(bool) coding_fsst_drop(struct coding_fsst *dic)
+{
+        error_if_null(dic);
+
+        dic->num_symbols = 0;
+        return true;
+}
+
+NG5_EXPORT(bool) coding_fsst_build(struct coding_fsst *dic, const string_vector_t *strings)
+{
+        error_if_null(dic);
+        error_if_null(strings);
+
+        const char **sample;
+        size_t *lengths, num_sampled, sample_size = 0;
+
+        coding_fsst_create(dic);
+        sample_strings(&sample, &lengths, &num_sampled, strings);
+        for (size_t i = 0; i < num_sampled; i++) {
+                sample_size += lengths[i];
+        }
+
+        u32 *counts = malloc(NG5_FSST_NUM_CODES * sizeof(u32));
+        u32 *pair_counts = malloc(NG5_FSST_NUM_CODES * NG5_FSST_NUM_CODES * sizeof(u32));
+        struct fsst_candidate *candidates = malloc((NG5_FSST_NUM_CODES + sample_size) * sizeof(struct fsst_candidate));
+        bool status = counts && pair_counts && candidates;
+
+        if (status) {
+                for (int generation = 0; generation < NG5_FSST_GENERATIONS; generation++) {
+                        learn_generation(dic, counts, pair_counts, candidates, sample, lengths, num_sampled);
+                }
+        } else {
+                error(&dic->err, NG5_ERR_MALLOCERR);
+        }
+
+        free(candidates);
+        free(pair_counts);
+        free(counts);
+        free(sample);
+        free(lengths);
+        return status;
+}
+
+NG5_EXPORT(bool) coding_fsst_get_error(struct err *err, const struct coding_fsst *dic)
+{
+        error_if_null(err)
+        error_if_null(dic)
+        error_cpy(err, &dic->err);
+        return true;
+}
+
+/** returns the code of the longest symbol that is a prefix of the 'remain' bytes at 'string', or -1 if none is */
+static inline int find_symbol(const struct coding_fsst *dic, const unsigned char *string, size_t remain)
+{
+        for (u16 code = dic->first[string[0]]; code < dic->first[string[0] + 1]; code++) {
+                if (dic->lengths[code] <= remain && memcmp(dic->symbols[code], string, dic->lengths[code]) == 0) {
+                        return code;
+                }
+        }
+        return -1;
+}
+
+NG5_EXPORT(size_t) coding_fsst_compress(void *dst, const struct coding_fsst *dic, const char *string, size_t strlen)
+{
+        const unsigned char *in = (const unsigned char *) string, *end = in + strlen;
+        u8 *out = dst;
+
+        while (in < end) {
+                int code = find_symbol(dic, in, end - in);
+                if (likely(code >= 0)) {
+                        *out++ = (u8) code;
+                        in += dic->lengths[code];
+                } else {
+                        *out++ = NG5_FSST_ESCAPE;
+                        *out++ = *in++;
+                }
+        }
+        return out - (u8 *) dst;
+}
+
+NG5_EXPORT(bool) coding_fsst_encode(struct memfile *file, struct coding_fsst *dic, const char *string)
+{
+        error_if_null(file)
+        error_if_null(dic)
+        error_if_null(string)
+
+        size_t length = strlen(string);
+        u32 nbytes_encoded = 0;
+
+        offset_t nbytes_encoded_off = memfile_tell(file);
+        memfile_skip(file, sizeof(u32));
+        if (length > 0) {
+                nbytes_encoded = coding_fsst_compress(memfile_current_pos(file, 2 * length), dic, string, length);
+        }
+        memfile_skip(file, nbytes_encoded);
+
+        offset_t continue_off = memfile_tell(file);
+        memfile_seek(file, nbytes_encoded_off);
+        memfile_write(file, &nbytes_encoded, sizeof(u32));
+        memfile_seek(file, continue_off);
+
+        return true;
+}
+
+bool coding_fsst_read_string(struct pack_fsst_str_info *info, struct memfile *src)
+{
+        info->nbytes_encoded = *NG5_MEMFILE_READ_TYPE(src, u32);
+        info->encoded_bytes = NG5_MEMFILE_READ(src, info->nbytes_encoded);
+        return true;
+}
+
+NG5_EXPORT(bool) coding_fsst_decode(char *dst, size_t strlen, struct coding_fsst *dic, const void *src,
+        size_t nbytes)
+{
+        error_if_null(dst)
+        error_if_null(dic)
+
+        const u8 *in = src, *end = in + nbytes;
+        size_t num_decoded = 0;
+
+        while (num_decoded < strlen) {
+                if (unlikely(in == end)) {
+                        error(&dic->err, NG5_ERR_CORRUPTED)
+                        return false;
+                }
+                u8 code = *in++;
+                if (likely(code < dic->num_symbols)) {
+                        /** symbols are copied as a whole unless they would be written beyond the string */
+                        size_t remain = strlen - num_decoded;
+                        if (likely(remain >= NG5_FSST_MAX_SYMBOL_LENGTH)) {
+                                memcpy(dst + num_decoded, dic->symbols[code], NG5_FSST_MAX_SYMBOL_LENGTH);
+                        } else {
+                                memcpy(dst + num_decoded, dic->symbols[code], ng5_min(remain, dic->lengths[code]));
+                        }
+                        num_decoded += dic->lengths[code];
+                } else if (code == NG5_FSST_ESCAPE && in < end) {
+                        dst[num_decoded++] = *in++;
+                } else {
+                        error(&dic->err, NG5_ERR_CORRUPTED)
+                        return false;
+                }
+        }
+        return true;
+}
+
+NG5_EXPORT(bool) coding_fsst_equals(const void *lhs, size_t lhs_nbytes, const void *rhs, size_t rhs_nbytes)
+{
+        return lhs_nbytes == rhs_nbytes && memcmp(lhs, rhs, lhs_nbytes) == 0;
+}
+
+NG5_EXPORT(bool) coding_fsst_serialize(struct memfile *file, const struct coding_fsst *dic, char marker_symbol)
+{
+        error_if_null(file)
+        error_if_null(dic)
+
+        memfile_write(file, &dic->num_symbols, sizeof(u8));
+        for (u8 code = 0; code < dic->num_symbols; code++) {
+                memfile_write(file, &marker_symbol, sizeof(char));
+                memfile_write(file, &dic->lengths[code], sizeof(u8));
+                memfile_write(file, dic->symbols[code], dic->lengths[code]);
+        }
+        return true;
+}
+
+NG5_EXPORT(bool) coding_fsst_deserialize(struct coding_fsst *dic, struct memfile *file, char marker_symbol)
+{
+        error_if_null(dic)
+        error_if_null(file)
+
+        struct pack_fsst_symbol_info info;
+
+        coding_fsst_create(dic);
+        u8 num_symbols = *NG5_MEMFILE_READ_TYPE(file, u8);
+        for (u8 code = 0; code < num_symbols; code++) {
+                if (!coding_fsst_read_symbol(&info, file, marker_symbol) || info.length == 0
+                        || info.length > NG5_FSST_MAX_SYMBOL_LENGTH) {
+                        error(&dic->err, NG5_ERR_CORRUPTED)
+                        return false;
+                }
+                dic->lengths[code] = info.length;
+                memcpy(dic->symbols[code], info.bytes, info.length);
+        }
+        dic->num_symbols = num_symbols;
+
+        if (!index_symbols(dic)) {
+                error(&dic->err, NG5_ERR_CORRUPTED)
+                return false;
+        }
+        return true;
+}
+
+NG5_EXPORT(bool) coding_fsst_read_symbol(struct pack_fsst_symbol_info *info, struct memfile *file, char marker_symbol)
+{
+        char marker = *NG5_MEMFILE_PEEK(file, char);
+        if (marker == marker_symbol) {
+                memfile_skip(file, sizeof(char));
+                info->length = *NG5_MEMFILE_READ_TYPE(file, u8);
+                info->bytes = NG5_MEMFILE_READ(file, info->length);
+                return true;
+        } else {
+                return false;
+        }
+}
+
+/**
+ * Samples up to NG5_FSST_SAMPLE_SIZE bytes of strings, taking every k-th string of 'strings' such that the sample
+ * spans the entire dictionary. The last sampled string is cut at the sample size.
+ */
+static void sample_strings(const char ***sample, size_t **lengths, size_t *num_sampled,
+        const string_vector_t *strings)
+{
+        size_t num_strings = strings->num_elems, total_size = 0;
+        const char **all = (const char **) vec_data(strings);
+
+        for (size_t i = 0; i < num_strings; i++) {
+                total_size += strlen(all[i]);
+        }
+        size_t stride = ng5_max(1, (total_size + NG5_FSST_SAMPLE_SIZE - 1) / NG5_FSST_SAMPLE_SIZE);
+
+        *sample = malloc(ng5_max(1, num_strings) * sizeof(const char *));
+        *lengths = malloc(ng5_max(1, num_strings) * sizeof(size_t));
+        *num_sampled = 0;
+
+        size_t sample_size = 0;
+        for (size_t i = 0; i < num_strings && sample_size < NG5_FSST_SAMPLE_SIZE; i += stride) {
+                size_t length = ng5_min(strlen(all[i]), NG5_FSST_SAMPLE_SIZE - sample_size);
+                (*sample)[*num_sampled] = all[i];
+                (*lengths)[*num_sampled] = length;
+                (*num_sampled)++;
+                sample_size += length;
+        }
+}
+
+static void add_candidate(struct fsst_candidate *candidates, size_t *num_candidates, const unsigned char *lhs,
+        u8 lhs_length, const unsigned char *rhs, u8 rhs_length, u64 count)
+{
+        struct fsst_candidate *candidate = candidates + (*num_candidates)++;
+        ng5_zero_memory(candidate->bytes, sizeof(candidate->bytes));
+        memcpy(candidate->bytes, lhs, lhs_length);
+        memcpy(candidate->bytes + lhs_length, rhs, rhs_length);
+        candidate->length = lhs_length + rhs_length;
+        candidate->gain = count * candidate->length;
+}
+
+static int compare_candidates_by_bytes(const void *lhs, const void *rhs)
+{
+        const struct fsst_candidate *a = lhs, *b = rhs;
+        return a->length != b->length ? a->length - b->length : memcmp(a->bytes, b->bytes, sizeof(a->bytes));
+}
+
+static int compare_candidates_by_gain(const void *lhs, const void *rhs)
+{
+        const struct fsst_candidate *a = lhs, *b = rhs;
+        if (a->gain != b->gain) {
+                return a->gain > b->gain ? -1 : 1;
+        }
+        return compare_candidates_by_bytes(rhs, lhs);
+}
+
+static int compare_candidates_by_first_byte(const void *lhs, const void *rhs)
+{
+        const struct fsst_candidate *a = lhs, *b = rhs;
+        if (a->bytes[0] != b->bytes[0]) {
+                return a->bytes[0] - b->bytes[0];
+        }
+        return compare_candidates_by_bytes(rhs, lhs);
+}
+
+/**
+ * Refines the symbol table once: the sample is encoded with the current symbol table while counting the codes and
+ * pairs of consecutive codes that are emitted. Each code, and each concatenation of two consecutive codes that fits
+ * into a symbol, is a candidate whose gain is the number of bytes it covers in the sample. The candidates with the
+ * highest gain make up the new symbol table.
+ */
+static void learn_generation(struct coding_fsst *dic, u32 *counts, u32 *pair_counts,
+        struct fsst_candidate *candidates, const char **sample, const size_t *lengths, size_t num_sampled)
+{
+        unsigned char escaped[UCHAR_MAX + 1][1];
+        u8 code_lengths[NG5_FSST_NUM_CODES];
+        const unsigned char *code_bytes[NG5_FSST_NUM_CODES];
+        size_t num_candidates = 0;
+
+        ng5_zero_memory(counts, NG5_FSST_NUM_CODES * sizeof(u32));
+        ng5_zero_memory(pair_counts, NG5_FSST_NUM_CODES * NG5_FSST_NUM_CODES * sizeof(u32));
+        ng5_zero_memory(code_lengths, sizeof(code_lengths));
+        for (int code = 0; code < dic->num_symbols; code++) {
+                code_lengths[code] = dic->lengths[code];
+                code_bytes[code] = dic->symbols[code];
+        }
+        for (int byte = 0; byte <= UCHAR_MAX; byte++) {
+                escaped[byte][0] = (unsigned char) byte;
+                code_lengths[UCHAR_MAX + 1 + byte] = 1;
+                code_bytes[UCHAR_MAX + 1 + byte] = escaped[byte];
+        }
+
+        for (size_t i = 0; i < num_sampled; i++) {
+                const unsigned char *in = (const unsigned char *) sample[i], *end = in + lengths[i];
+                int prev = -1;
+                while (in < end) {
+                        int code = find_symbol(dic, in, end - in);
+                        code = code >= 0 ? code : UCHAR_MAX + 1 + *in;
+                        counts[code]++;
+                        if (prev >= 0) {
+                                pair_counts[prev * NG5_FSST_NUM_CODES + code]++;
+                        }
+                        in += code_lengths[code];
+                        prev = code;
+                }
+        }
+
+        for (int code = 0; code < NG5_FSST_NUM_CODES; code++) {
+                if (counts[code] == 0) {
+                        continue;
+                }
+                add_candidate(candidates, &num_candidates, code_bytes[code], code_lengths[code], NULL, 0,
+                        counts[code]);
+                for (int next = 0; next < NG5_FSST_NUM_CODES; next++) {
+                        u32 count = pair_counts[code * NG5_FSST_NUM_CODES + next];
+                        if (count > 0 && code_lengths[code] + code_lengths[next] <= NG5_FSST_MAX_SYMBOL_LENGTH) {
+                                add_candidate(candidates, &num_candidates, code_bytes[code], code_lengths[code],
+                                        code_bytes[next], code_lengths[next], count);
+                        }
+                }
+        }
+
+        /** the same bytes might be a candidate several times (e.g., 'ab' + 'c' and 'a' + 'bc') */
+        qsort(candidates, num_candidates, sizeof(struct fsst_candidate), compare_candidates_by_bytes);
+        size_t num_unique = 0;
+        for (size_t i = 0; i < num_candidates; i++) {
+                if (num_unique > 0 && compare_candidates_by_bytes(candidates + num_unique - 1, candidates + i) == 0) {
+                        candidates[num_unique - 1].gain = ng5_max(candidates[num_unique - 1].gain, candidates[i].gain);
+                } else {
+                        candidates[num_unique++] = candidates[i];
+                }
+        }
+
+        qsort(candidates, num_unique, sizeof(struct fsst_candidate), compare_candidates_by_gain);
+        size_t num_symbols = ng5_min(num_unique, NG5_FSST_MAX_SYMBOLS);
+        qsort(candidates, num_symbols, sizeof(struct fsst_candidate), compare_candidates_by_first_byte);
+
+        dic->num_symbols = num_symbols;
+        for (size_t code = 0; code < num_symbols; code++) {
+                dic->lengths[code] = candidates[code].length;
+                memcpy(dic->symbols[code], candidates[code].bytes, NG5_FSST_MAX_SYMBOL_LENGTH);
+        }
+        index_symbols(dic);
+}
+
+/** computes 'first' of the symbols, and returns false if they are not sorted by their first byte */
+static bool index_symbols(struct coding_fsst *dic)
+{
+        u16 byte = 0;
+        for (u16 code = 0; code < dic->num_symbols; code++) {
+                if (code > 0 && dic->symbols[code][0] < dic->symbols[code - 1][0]) {
+                        return false;
+                }
+                while (byte <= dic->symbols[code][0]) {
+                        dic->first[byte++] = code;
+                }
+        }
+        while (byte <= UCHAR_MAX + 1) {
+                dic->first[byte++] = dic->num_symbols;
+        }
+        return true;
+}
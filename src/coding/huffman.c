@@ -18,24 +18,25 @@
 #include <limits.h>
 #include <assert.h>
 #include <inttypes.h>
+#include <unistd.h>
 
 #include "coding/coding_huffman.h"
-#include "std/bitmap.h"
+#include "core/async/parallel.h"
 
-struct huff_node {
-        struct huff_node *prev, *next, *left, *right;
-        u64 freq;
-        unsigned char letter;
-};
+#define NG5_HUFFMAN_NUM_LETTERS         (UCHAR_MAX + 1)
+#define NG5_HUFFMAN_TABLE_SIZE          (1u << NG5_HUFFMAN_TABLE_BITS)
+#define NG5_HUFFMAN_TABLE_MASK          (NG5_HUFFMAN_TABLE_SIZE - 1)
 
-static void huff_tree_create(struct vector ofType(struct pack_huffman_entry) *table,
-        const struct vector ofType(u32) *frequencies);
+static void compute_code_lengths(u8 lengths[NG5_HUFFMAN_NUM_LETTERS], const u64 freqs[NG5_HUFFMAN_NUM_LETTERS]);
+static void assign_canonical_codes(struct coding_huffman *dic, const u8 lengths[NG5_HUFFMAN_NUM_LETTERS]);
+static bool build_decode_table(struct coding_huffman *dic);
 
 bool coding_huffman_create(struct coding_huffman *dic)
 {
         error_if_null(dic);
 
-        vec_create(&dic->table, NULL, sizeof(struct pack_huffman_entry), UCHAR_MAX / 4);
+        ng5_zero_memory(dic->codes, sizeof(dic->codes));
+        dic->table = NULL;
         error_init(&dic->err);
 
         return true;
@@ -45,11 +46,42 @@ NG5_EXPORT(bool) coding_huffman_cpy(struct coding_huffman *dst, struct coding_hu
 {
         error_if_null(dst);
         error_if_null(src);
-        if (!vec_cpy(&dst->table, &src->table)) {
-                error(&src->err, NG5_ERR_HARDCOPYFAILED);
-                return false;
-        } else {
-                return error_cpy(&dst->err, &src->err);
+
+        memcpy(dst->codes, src->codes, sizeof(src->codes));
+        dst->table = NULL;
+        if (src->table) {
+                dst->table = malloc(NG5_HUFFMAN_TABLE_SIZE * sizeof(struct pack_huffman_decode_entry));
+                if (!dst->table) {
+                        error(&src->err, NG5_ERR_HARDCOPYFAILED);
+                        return false;
+                }
+                memcpy(dst->table, src->table, NG5_HUFFMAN_TABLE_SIZE * sizeof(struct pack_huffman_decode_entry));
+        }
+        return error_cpy(&dst->err, &src->err);
+}
+
+/** letter frequencies of a range of strings, see 'count_letters' */
+struct letter_histograms {
+        const char *const *strings;
+        size_t num_strings;
+        size_t chunk_len;
+        u64 (*freqs)[NG5_HUFFMAN_NUM_LETTERS];
+};
+
+static void count_letters(const void *start, size_t width, size_t len, void *args, thread_id_t tid)
+{
+        ng5_unused(width);
+        ng5_unused(tid);
+        ng5_cast(struct letter_histograms *, histograms, args);
+        for (const size_t *chunk = start; len--; chunk++) {
+                u64 *freqs = histograms->freqs[*chunk];
+                size_t begin = *chunk * histograms->chunk_len;
+                size_t end = ng5_min(begin + histograms->chunk_len, histograms->num_strings);
+                for (size_t i = begin; i < end; i++) {
+                        for (const unsigned char *c = (const unsigned char *) histograms->strings[i]; *c; c++) {
+                                freqs[*c]++;
+                        }
+                }
         }
 }
 
@@ -58,26 +90,48 @@ NG5_EXPORT(bool) coding_huffman_build(struct coding_huffman *encoder, const stri
         error_if_null(encoder);
         error_if_null(strings);
 
-        struct vector ofType(u32) frequencies;
-        vec_create(&frequencies, NULL, sizeof(u32), UCHAR_MAX);
-        vec_enlarge_size_to_capacity(&frequencies);
-
-        u32 *freq_data = vec_all(&frequencies, u32);
-        ng5_zero_memory(freq_data, UCHAR_MAX * sizeof(u32));
+        u8 lengths[NG5_HUFFMAN_NUM_LETTERS];
+
+        /** each thread counts the letters of a range of strings into a histogram of its own, which are summed up */
+        size_t num_strings = strings->num_elems;
+        size_t num_threads = ng5_max(1, sysconf(_SC_NPROCESSORS_ONLN));
+        size_t num_chunks = num_strings >= NG5_HUFFMAN_PARALLEL_MIN ? num_threads : 1;
+        u64 (*freqs)[NG5_HUFFMAN_NUM_LETTERS] = calloc(num_chunks, sizeof(*freqs));
+        size_t *chunks = malloc(num_chunks * sizeof(size_t));
+        if (unlikely(!freqs || !chunks)) {
+                free(freqs);
+                free(chunks);
+                error(&encoder->err, NG5_ERR_MALLOCERR);
+                return false;
+        }
 
-        for (size_t i = 0; i < strings->num_elems; i++) {
-                const char *string = *vec_get(strings, i, const char *);
-                size_t string_length = strlen(string);
-                for (size_t k = 0; k < string_length; k++) {
-                        size_t c = (unsigned char) string[k];
-                        freq_data[c]++;
+        struct letter_histograms histograms = {
+                .strings = vec_all(strings, const char *),
+                .num_strings = num_strings,
+                .chunk_len = (num_strings + num_chunks - 1) / num_chunks,
+                .freqs = freqs
+        };
+        for (size_t i = 0; i < num_chunks; i++) {
+                chunks[i] = i;
+        }
+        if (num_chunks > 1) {
+                parallel_for(chunks, sizeof(size_t), num_chunks, count_letters, &histograms, THREADING_HINT_MULTI,
+                        num_chunks - 1);
+        } else {
+                count_letters(chunks, sizeof(size_t), num_chunks, &histograms, 0);
+        }
+        for (size_t i = 1; i < num_chunks; i++) {
+                for (unsigned letter = 0; letter < NG5_HUFFMAN_NUM_LETTERS; letter++) {
+                        freqs[0][letter] += freqs[i][letter];
                 }
         }
 
-        huff_tree_create(&encoder->table, &frequencies);
-        vec_drop(&frequencies);
+        compute_code_lengths(lengths, freqs[0]);
+        free(freqs);
+        free(chunks);
 
-        return true;
+        assign_canonical_codes(encoder, lengths);
+        return build_decode_table(encoder);
 }
 
 NG5_EXPORT(bool) coding_huffman_get_error(struct err *err, const struct coding_huffman *dic)
@@ -92,13 +146,7 @@ bool coding_huffman_drop(struct coding_huffman *dic)
 {
         error_if_null(dic);
 
-        for (size_t i = 0; i < dic->table.num_elems; i++) {
-                struct pack_huffman_entry *entry = vec_get(&dic->table, i, struct pack_huffman_entry);
-                free(entry->blocks);
-        }
-
-        vec_drop(&dic->table);
-
+        free(dic->table);
         free(dic);
 
         return true;
@@ -109,88 +157,36 @@ bool coding_huffman_serialize(struct memfile *file, const struct coding_huffman
         error_if_null(file)
         error_if_null(dic)
 
-        for (size_t i = 0; i < dic->table.num_elems; i++) {
-                struct pack_huffman_entry *entry = vec_get(&dic->table, i, struct pack_huffman_entry);
-                memfile_write(file, &marker_symbol, sizeof(char));
-                memfile_write(file, &entry->letter, sizeof(unsigned char));
-
-                /** block one is the block that holds the significant part of the prefix code */
-                offset_t offset_meta, offset_continue;
-                memfile_get_offset(&offset_meta, file);
-                /** this will be the number of bytes used to encode the significant part of the prefix code */
-                memfile_skip(file, sizeof(u8));
-
-                memfile_begin_bit_mode(file);
-                bool first_bit_found = false;
-                for (int i = 31; entry->blocks && i >= 0; i--) {
-                        u32 mask = 1 << i;
-                        u32 k = entry->blocks[0] & mask;
-                        bool bit_state = k != 0;
-                        first_bit_found |= bit_state;
-
-                        if (first_bit_found) {
-                                memfile_write_bit(file, bit_state);
-                        }
+        for (unsigned letter = 0; letter < NG5_HUFFMAN_NUM_LETTERS; letter++) {
+                if (dic->codes[letter].length > 0) {
+                        unsigned char letter_uchar = (unsigned char) letter;
+                        memfile_write(file, &marker_symbol, sizeof(char));
+                        memfile_write(file, &letter_uchar, sizeof(unsigned char));
+                        memfile_write(file, &dic->codes[letter].length, sizeof(u8));
                 }
-                size_t num_bytes_written;
-                memfile_end_bit_mode(&num_bytes_written, file);
-                memfile_get_offset(&offset_continue, file);
-                memfile_seek(file, offset_meta);
-                u8 num_bytes_written_uint8 = (u8) num_bytes_written;
-                memfile_write(file, &num_bytes_written_uint8, sizeof(u8));
-
-                memfile_seek(file, offset_continue);
         }
 
         return true;
 }
 
-static struct pack_huffman_entry *find_dic_entry(struct coding_huffman *dic, unsigned char c)
-{
-        for (size_t i = 0; i < dic->table.num_elems; i++) {
-                struct pack_huffman_entry *entry = vec_get(&dic->table, i, struct pack_huffman_entry);
-                if (entry->letter == c) {
-                        return entry;
-                }
-        }
-        error(&dic->err, NG5_ERR_HUFFERR)
-        return NULL;
-}
-
-static size_t encodeString(struct memfile *file, struct coding_huffman *dic, const char *string)
+bool coding_huffman_deserialize(struct coding_huffman *dic, struct memfile *file, char marker_symbol)
 {
-        memfile_begin_bit_mode(file);
+        error_if_null(dic)
+        error_if_null(file)
 
-        for (const char *c = string; *c != '\0'; c++) {
-                struct pack_huffman_entry *entry = find_dic_entry(dic, (unsigned char) *c);
-                if (!entry) {
-                        return 0;
-                }
+        struct pack_huffman_info info;
+        u8 lengths[NG5_HUFFMAN_NUM_LETTERS] = {0};
 
-                if (!entry->blocks) {
-                        memfile_write_bit(file, false);
-                } else {
-                        for (size_t j = 0; j < entry->nblocks; j++) {
-                                u32 block = entry->blocks[j];
-
-                                bool first_bit_found = false;
-                                for (int i = 31; i >= 0; i--) {
-                                        u32 mask = 1 << i;
-                                        u32 k = block & mask;
-                                        bool bit_state = k != 0;
-                                        first_bit_found |= bit_state;
-
-                                        if (first_bit_found) {
-                                                memfile_write_bit(file, bit_state);
-                                        }
-                                }
-                        }
+        while (memfile_remain_size(file) > 0 && coding_huffman_read_entry(&info, file, marker_symbol)) {
+                if (info.code_length == 0 || info.code_length > NG5_HUFFMAN_MAX_CODE_LENGTH) {
+                        error(&dic->err, NG5_ERR_CORRUPTED);
+                        return false;
                 }
+                lengths[info.letter] = info.code_length;
         }
 
-        size_t num_written_bytes;
-        memfile_end_bit_mode(&num_written_bytes, file);
-        return num_written_bytes;
+        assign_canonical_codes(dic, lengths);
+        return build_decode_table(dic);
 }
 
 NG5_EXPORT(bool) coding_huffman_encode(struct memfile *file, struct coding_huffman *dic, const char *string)
@@ -199,15 +195,25 @@ NG5_EXPORT(bool) coding_huffman_encode(struct memfile *file, struct coding_huffm
         error_if_null(dic)
         error_if_null(string)
 
-        u32 num_bytes_encoded = 0;
+        struct memfile_bit_writer writer;
+        size_t num_bytes;
 
         offset_t num_bytes_encoded_off = memfile_tell(file);
         memfile_skip(file, sizeof(u32));
-
-        if ((num_bytes_encoded = (u32) encodeString(file, dic, string)) == 0) {
-                return false;
+        memfile_bit_writer_begin(&writer, file);
+
+        /** codes are written most significant bit first, see 'coding_huffman_decode' for the reverse */
+        for (const unsigned char *c = (const unsigned char *) string; *c != '\0'; c++) {
+                const struct pack_huffman_code *code = dic->codes + *c;
+                if (unlikely(code->length == 0)) {
+                        error(&dic->err, NG5_ERR_HUFFERR)
+                        return false;
+                }
+                memfile_write_bits(&writer, code->code, code->length);
         }
+        memfile_bit_writer_end(&num_bytes, &writer);
 
+        u32 num_bytes_encoded = num_bytes;
         offset_t continue_off = memfile_tell(file);
         memfile_seek(file, num_bytes_encoded_off);
         memfile_write(file, &num_bytes_encoded, sizeof(u32));
@@ -216,6 +222,49 @@ NG5_EXPORT(bool) coding_huffman_encode(struct memfile *file, struct coding_huffm
         return true;
 }
 
+/** returns the NG5_HUFFMAN_TABLE_BITS bits at bit position 'pos' of 'src', padded with zeros after 'nbytes' bytes */
+static inline u32 peek_bits(const u8 *src, size_t nbytes, size_t pos)
+{
+        size_t byte = pos / 8;
+        u32 window;
+        if (likely(byte + sizeof(u32) <= nbytes)) {
+                memcpy(&window, src + byte, sizeof(u32));
+                window = __builtin_bswap32(window);
+        } else {
+                window = 0;
+                for (size_t i = 0; i < sizeof(u32); i++) {
+                        window = (window << 8) | (byte + i < nbytes ? src[byte + i] : 0);
+                }
+        }
+        return (window >> (32 - NG5_HUFFMAN_TABLE_BITS - pos % 8)) & NG5_HUFFMAN_TABLE_MASK;
+}
+
+NG5_EXPORT(bool) coding_huffman_decode(char *dst, size_t strlen, struct coding_huffman *dic, const void *src,
+        size_t nbytes)
+{
+        error_if_null(dst)
+        error_if_null(dic)
+
+        size_t pos = 0, num_decoded = 0;
+        while (num_decoded < strlen) {
+                if (unlikely(!dic->table || pos >= nbytes * 8)) {
+                        error(&dic->err, NG5_ERR_CORRUPTED)
+                        return false;
+                }
+                const struct pack_huffman_decode_entry *entry = dic->table + peek_bits(src, nbytes, pos);
+                if (unlikely(entry->num_letters == 0)) {
+                        error(&dic->err, NG5_ERR_CORRUPTED)
+                        return false;
+                }
+                /** letters after the last letter of the string are decoded from padding bits, and dropped */
+                size_t num_letters = ng5_min(entry->num_letters, strlen - num_decoded);
+                memcpy(dst + num_decoded, entry->letters, num_letters);
+                num_decoded += num_letters;
+                pos += entry->num_bits;
+        }
+        return true;
+}
+
 bool coding_huffman_read_string(struct pack_huffman_str_info *info, struct memfile *src)
 {
         info->nbytes_encoded = *NG5_MEMFILE_READ_TYPE(src, u32);
@@ -229,264 +278,181 @@ bool coding_huffman_read_entry(struct pack_huffman_info *info, struct memfile *f
         if (marker == marker_symbol) {
                 memfile_skip(file, sizeof(char));
                 info->letter = *NG5_MEMFILE_READ_TYPE(file, unsigned char);
-                info->nbytes_prefix = *NG5_MEMFILE_READ_TYPE(file, u8);
-                info->prefix_code = NG5_MEMFILE_PEEK(file, char);
-
-                memfile_skip(file, info->nbytes_prefix);
-
+                info->code_length = *NG5_MEMFILE_READ_TYPE(file, u8);
                 return true;
         } else {
                 return false;
         }
 }
 
-static const u32 *get_num_used_blocks(u16 *numUsedBlocks, struct pack_huffman_entry *entry, u16 num_blocks,
-        const u32 *blocks)
+static int compare_by_freq(const void *lhs, const void *rhs, void *args)
 {
-        for (entry->nblocks = 0; entry->nblocks < num_blocks; entry->nblocks++) {
-                const u32 *block = blocks + entry->nblocks;
-                if (*block != 0) {
-                        *numUsedBlocks = (num_blocks - entry->nblocks);
-                        return block;
-                }
-        }
-        return NULL;
+        ng5_cast(const u64 *, freqs, args);
+        u8 a = *(const u8 *) lhs, b = *(const u8 *) rhs;
+        return freqs[a] != freqs[b] ? (freqs[a] < freqs[b] ? -1 : 1) : (a < b ? -1 : a > b);
 }
 
-static void import_into_entry(struct pack_huffman_entry *entry, const struct huff_node *node, const struct bitmap *map)
+static int compare_by_length(const void *lhs, const void *rhs, void *args)
 {
-        entry->letter = node->letter;
-        u32 *blocks, num_blocks;
-        const u32 *used_blocks;
-        bitmap_blocks(&blocks, &num_blocks, map);
-        used_blocks = get_num_used_blocks(&entry->nblocks, entry, num_blocks, blocks);
-        entry->blocks = malloc(entry->nblocks * sizeof(u32));
-        if (num_blocks > 0) {
-                memcpy(entry->blocks, used_blocks, entry->nblocks * sizeof(u32));
-        } else {
-                entry->blocks = NULL;
-        }
-        free(blocks);
-}
-
-static struct huff_node *seek_to_begin(struct huff_node *handle)
-{
-        for (; handle->prev != NULL; handle = handle->prev) { }
-        return handle;
-}
-
-static struct huff_node *seek_to_end(struct huff_node *handle)
-{
-        for (; handle->next != NULL; handle = handle->next) { }
-        return handle;
+        ng5_cast(const u8 *, lengths, args);
+        u8 a = *(const u8 *) lhs, b = *(const u8 *) rhs;
+        return lengths[a] != lengths[b] ? (lengths[a] < lengths[b] ? -1 : 1) : (a < b ? -1 : a > b);
 }
 
-ng5_func_unused
-static void __diag_print_insight(struct huff_node *n)
+/** sorts the 'num' letters in 'letters' by 'compare' (insertion sort; there are at most 256 letters) */
+static void sort_letters(u8 *letters, size_t num, int (*compare)(const void *, const void *, void *), void *args)
 {
-        printf("(");
-        if (!n->left && !n->right) {
-                printf("%c", n->letter);
-        } else {
-                if (n->left) {
-                        __diag_print_insight(n->left);
-                }
-                printf(",");
-                if (n->right) {
-                        __diag_print_insight(n->right);
+        for (size_t i = 1; i < num; i++) {
+                u8 letter = letters[i];
+                size_t j = i;
+                for (; j > 0 && compare(letters + j - 1, &letter, args) > 0; j--) {
+                        letters[j] = letters[j - 1];
                 }
+                letters[j] = letter;
         }
-        printf(")");
-        printf(": %"PRIu64"", n->freq);
 }
 
-ng5_func_unused
-static void __diag_dump_remaining_candidates(struct huff_node *n)
+/**
+ * Computes the lengths of the Huffman codes of the letters with non-zero frequency by the two-queue method on the
+ * letters sorted by frequency, and limits them to NG5_HUFFMAN_MAX_CODE_LENGTH by lengthening the longest codes
+ * that are still shorter than the limit until the Kraft inequality holds again.
+ */
+static void compute_code_lengths(u8 lengths[NG5_HUFFMAN_NUM_LETTERS], const u64 freqs[NG5_HUFFMAN_NUM_LETTERS])
 {
-        struct huff_node *it = seek_to_begin(n);
-        while (it->next != NULL) {
-                __diag_print_insight(it);
-                printf(" | ");
-                it = it->next;
-        }
-}
+        u8 letters[NG5_HUFFMAN_NUM_LETTERS];
+        size_t num_letters = 0;
 
-static struct huff_node *find_smallest(struct huff_node *begin, u64 lowerBound, struct huff_node *skip)
-{
-        u64 smallest = UINT64_MAX;
-        struct huff_node *result = NULL;
-        for (struct huff_node *it = begin; it != NULL; it = it->next) {
-                if (it != skip && it->freq >= lowerBound && it->freq <= smallest) {
-                        smallest = it->freq;
-                        result = it;
+        ng5_zero_memory(lengths, NG5_HUFFMAN_NUM_LETTERS * sizeof(u8));
+        for (unsigned letter = 0; letter < NG5_HUFFMAN_NUM_LETTERS; letter++) {
+                if (freqs[letter] > 0) {
+                        letters[num_letters++] = (u8) letter;
                 }
         }
-        return result;
-}
-
-static void assign_code(struct huff_node *node, const struct bitmap *path,
-        struct vector ofType(struct pack_huffman_entry) *table)
-{
-        if (!node->left && !node->right) {
-                struct pack_huffman_entry *entry = vec_new_and_get(table, struct pack_huffman_entry);
-                import_into_entry(entry, node, path);
-        } else {
-                if (node->left) {
-                        struct bitmap left;
-                        bitmap_cpy(&left, path);
-                        bitmap_lshift(&left);
-                        bitmap_set(&left, 0, false);
-                        assign_code(node->left, &left, table);
-                        bitmap_drop(&left);
-                }
-                if (node->right) {
-                        struct bitmap right;
-                        bitmap_cpy(&right, path);
-                        bitmap_lshift(&right);
-                        bitmap_set(&right, 0, true);
-                        assign_code(node->right, &right, table);
-                        bitmap_drop(&right);
+        if (num_letters == 0) {
+                return;
+        } else if (num_letters == 1) {
+                lengths[letters[0]] = 1;
+                return;
+        }
+        sort_letters(letters, num_letters, compare_by_freq, (void *) freqs);
+
+        /** nodes [0, num_letters) are the leaves in order of frequency, further nodes are the inner nodes in order of
+         * creation; inner nodes are created with non-decreasing frequency, and after their children */
+        u64 weights[2 * NG5_HUFFMAN_NUM_LETTERS];
+        u16 parents[2 * NG5_HUFFMAN_NUM_LETTERS];
+        u16 depths[2 * NG5_HUFFMAN_NUM_LETTERS];
+        size_t next_leaf = 0, next_inner = num_letters, num_nodes = num_letters;
+        for (size_t i = 0; i < num_letters; i++) {
+                weights[i] = freqs[letters[i]];
+        }
+        while (num_nodes < 2 * num_letters - 1) {
+                size_t children[2];
+                for (int k = 0; k < 2; k++) {
+                        if (next_leaf < num_letters && (next_inner == num_nodes
+                                || weights[next_leaf] <= weights[next_inner])) {
+                                children[k] = next_leaf++;
+                        } else {
+                                children[k] = next_inner++;
+                        }
                 }
+                weights[num_nodes] = weights[children[0]] + weights[children[1]];
+                parents[children[0]] = parents[children[1]] = (u16) num_nodes;
+                num_nodes++;
+        }
+        depths[num_nodes - 1] = 0;
+        for (size_t i = num_nodes - 1; i-- > 0;) {
+                depths[i] = depths[parents[i]] + 1;
         }
-}
 
-static struct huff_node *trim_and_begin(struct vector ofType(HuffNode) *candidates)
-{
-        struct huff_node *begin = NULL;
-        for (struct huff_node *it = vec_get(candidates, 0, struct huff_node);; it++) {
-                if (it->freq == 0) {
-                        if (it->prev) {
-                                it->prev->next = it->next;
-                        }
-                        if (it->next) {
-                                it->next->prev = it->prev;
-                        }
-                } else {
-                        if (!begin) {
-                                begin = it;
+        /** the Kraft sum in units of the shortest possible code */
+        const u32 kraft_max = 1u << NG5_HUFFMAN_MAX_CODE_LENGTH;
+        u32 kraft = 0;
+        for (size_t i = 0; i < num_letters; i++) {
+                u16 length = ng5_min(depths[i], NG5_HUFFMAN_MAX_CODE_LENGTH);
+                lengths[letters[i]] = (u8) length;
+                kraft += kraft_max >> length;
+        }
+        while (kraft > kraft_max) {
+                /** the least frequent letter with the longest code that is shorter than the limit */
+                size_t candidate = num_letters;
+                for (size_t i = 0; i < num_letters; i++) {
+                        u8 length = lengths[letters[i]];
+                        if (length < NG5_HUFFMAN_MAX_CODE_LENGTH
+                                && (candidate == num_letters || length > lengths[letters[candidate]])) {
+                                candidate = i;
                         }
                 }
-                if (!it->next) {
-                        break;
+                kraft -= kraft_max >> ++lengths[letters[candidate]];
+        }
+        /** the most frequent letters take the slack that lengthening might have left */
+        for (size_t i = num_letters; i-- > 0;) {
+                while (lengths[letters[i]] > 1 && kraft + (kraft_max >> lengths[letters[i]]) <= kraft_max) {
+                        kraft += kraft_max >> lengths[letters[i]];
+                        lengths[letters[i]]--;
                 }
         }
-        return begin;
 }
 
-static void huff_tree_create(struct vector ofType(struct pack_huffman_entry) *table,
-        const struct vector ofType(u32) *frequencies)
+static void assign_canonical_codes(struct coding_huffman *dic, const u8 lengths[NG5_HUFFMAN_NUM_LETTERS])
 {
-        assert(UCHAR_MAX == frequencies->num_elems);
-
-        struct vector ofType(HuffNode) candidates;
-        vec_create(&candidates, NULL, sizeof(struct huff_node), UCHAR_MAX * UCHAR_MAX);
-        size_t appender_idx = UCHAR_MAX;
+        u8 letters[NG5_HUFFMAN_NUM_LETTERS];
+        size_t num_letters = 0;
 
-        for (unsigned char i = 0; i < UCHAR_MAX; i++) {
-                struct huff_node *node = vec_new_and_get(&candidates, struct huff_node);
-                node->letter = i;
-                node->freq = *vec_get(frequencies, i, u32);
+        ng5_zero_memory(dic->codes, sizeof(dic->codes));
+        for (unsigned letter = 0; letter < NG5_HUFFMAN_NUM_LETTERS; letter++) {
+                if (lengths[letter] > 0) {
+                        letters[num_letters++] = (u8) letter;
+                }
         }
-
-        for (unsigned char i = 0; i < UCHAR_MAX; i++) {
-                struct huff_node *node = vec_get(&candidates, i, struct huff_node);
-                struct huff_node *prev = i > 0 ? vec_get(&candidates, i - 1, struct huff_node) : NULL;
-                struct huff_node *next = i + 1 < UCHAR_MAX ? vec_get(&candidates, i + 1, struct huff_node) : NULL;
-                node->next = next;
-                node->prev = prev;
-                node->left = node->right = NULL;
+        sort_letters(letters, num_letters, compare_by_length, (void *) lengths);
+
+        u32 code = 0;
+        u8 prev_length = num_letters > 0 ? lengths[letters[0]] : 0;
+        for (size_t i = 0; i < num_letters; i++) {
+                code <<= lengths[letters[i]] - prev_length;
+                dic->codes[letters[i]].code = (u16) code++;
+                dic->codes[letters[i]].length = prev_length = lengths[letters[i]];
         }
+}
 
-        struct huff_node *smallest, *small;
-        struct huff_node *handle = trim_and_begin(&candidates);
-        struct huff_node *new_node = NULL;
-
-        while (handle->next != NULL) {
-                smallest = find_smallest(handle, 0, NULL);
-                small = find_smallest(handle, smallest->freq, smallest);
-
-                appender_idx++;
-                new_node = vec_new_and_get(&candidates, struct huff_node);
-                new_node->freq = small->freq + smallest->freq;
-                new_node->letter = '\0';
-                new_node->left = small;
-                new_node->right = smallest;
-
-                if ((small->prev == NULL && smallest->next == NULL) && small->next == smallest) {
-                        break;
-                }
-
-                if ((smallest->prev == NULL && small->next == NULL) && smallest->next == small) {
-                        break;
-                }
-                if (smallest->prev) {
-                        smallest->prev->next = smallest->next;
-                }
-                if (smallest->next) {
-                        smallest->next->prev = smallest->prev;
-                }
-                if (small->prev) {
-                        small->prev->next = small->next;
-                }
-                if (small->next) {
-                        small->next->prev = small->prev;
-                }
-
-                if (small->prev) {
-                        handle = seek_to_begin(small->prev);
-                } else if (smallest->prev) {
-                        handle = seek_to_begin(smallest->prev);
-                } else if (small->next) {
-                        handle = seek_to_begin(small->next);
-                } else if (smallest->next) {
-                        handle = seek_to_begin(smallest->next);
-                } else {
-                        print_error_and_die(NG5_ERR_INTERNALERR);
+static bool build_decode_table(struct coding_huffman *dic)
+{
+        struct pack_huffman_decode_entry *table = dic->table;
+        if (!table && !(table = malloc(NG5_HUFFMAN_TABLE_SIZE * sizeof(struct pack_huffman_decode_entry)))) {
+                error(&dic->err, NG5_ERR_MALLOCERR);
+                return false;
+        }
+        dic->table = table;
+        ng5_zero_memory(table, NG5_HUFFMAN_TABLE_SIZE * sizeof(struct pack_huffman_decode_entry));
+
+        /** the letter that the bits of each entry start with */
+        for (unsigned letter = 0; letter < NG5_HUFFMAN_NUM_LETTERS; letter++) {
+                const struct pack_huffman_code *code = dic->codes + letter;
+                if (code->length > 0) {
+                        unsigned shift = NG5_HUFFMAN_TABLE_BITS - code->length;
+                        for (u32 suffix = 0; suffix < (1u << shift); suffix++) {
+                                struct pack_huffman_decode_entry *entry = table + ((code->code << shift) | suffix);
+                                entry->num_letters = 1;
+                                entry->num_bits = code->length;
+                                entry->letters[0] = (unsigned char) letter;
+                        }
                 }
-
-                assert (!handle->prev);
-                struct huff_node *end = seek_to_end(handle);
-                assert(!end->next);
-                end->next = new_node;
-                new_node->prev = end;
-                new_node->next = NULL;
-
-#ifdef DIAG_HUFFMAN_ENABLE_DEBUG
-                printf("in-memory huff-tree: ");
-                __diag_print_insight(new_node);
-                printf("\n");
-                printf("remaining candidates: ");
-                __diag_dump_remaining_candidates(handle);
-                printf("\n");
-#endif
         }
 
-        seek_to_begin(handle);
-        if (handle->next) {
-                struct huff_node *finalNode = vec_new_and_get(&candidates, struct huff_node);
-                finalNode->freq = small->freq + smallest->freq;
-                finalNode->letter = '\0';
-                if (handle->freq > handle->next->freq) {
-                        finalNode->left = handle;
-                        finalNode->right = handle->next;
-                } else {
-                        finalNode->left = handle->next;
-                        finalNode->right = handle;
+        /** extends each entry by the further letters whose codes are contained entirely in the looked up bits */
+        for (u32 bits = 0; bits < NG5_HUFFMAN_TABLE_SIZE; bits++) {
+                struct pack_huffman_decode_entry *entry = table + bits;
+                while (entry->num_letters > 0 && entry->num_letters < NG5_HUFFMAN_TABLE_MAX_LETTERS) {
+                        const struct pack_huffman_decode_entry *next =
+                                table + ((bits << entry->num_bits) & NG5_HUFFMAN_TABLE_MASK);
+                        /** the first letter of 'next' is the letter whose code starts with the remaining bits */
+                        u8 length = next->num_letters > 0 ? dic->codes[next->letters[0]].length : 0;
+                        if (length == 0 || entry->num_bits + length > NG5_HUFFMAN_TABLE_BITS) {
+                                break;
+                        }
+                        entry->letters[entry->num_letters++] = next->letters[0];
+                        entry->num_bits += length;
                 }
-                new_node = finalNode;
         }
-
-#ifdef DIAG_HUFFMAN_ENABLE_DEBUG
-        printf("final in-memory huff-tree: ");
-        __diag_print_insight(new_node);
-        printf("\n");
-#endif
-
-        struct bitmap root_path;
-        bitmap_create(&root_path, UCHAR_MAX);
-        bitmap_set(&root_path, 0, true);
-        assign_code(new_node, &root_path, table);
-        bitmap_drop(&root_path);
-
-        vec_drop(&candidates);
-}
\ No newline at end of file
+        return true;
+}
@@ -52,17 +52,6 @@ NG5_EXPORT (bool) alloc_this_or_std(struct allocator *dst, const struct allocato
         }
 }
 
-NG5_EXPORT (void *)alloc_malloc(struct allocator *alloc, size_t size)
-{
-        assert(alloc);
-        return alloc->malloc(alloc, size);
-}
-
-NG5_EXPORT (void *)alloc_realloc(struct allocator *alloc, void *ptr, size_t size)
-{
-        return alloc->realloc(alloc, ptr, size);
-}
-
 NG5_EXPORT (bool) alloc_free(struct allocator *alloc, void *ptr)
 {
         error_if_null(alloc);
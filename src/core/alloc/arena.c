@@ -0,0 +1,282 @@
+/**
+ * Copyright 2018 Marcus Pinnecke
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <assert.h>
+
+#include "core/alloc/arena.h"
+
+/**
+ * Each block is preceded by a header that stores its (aligned) size. The lowest bit of the header is set for
+ * blocks that occupy a chunk of their own.
+ */
+#define ARENA_HEADER_SIZE               sizeof(size_t)
+#define ARENA_DEDICATED                 ((size_t) 1)
+#define ARENA_ALIGN(size)               (((size) + NG5_ARENA_ALIGNMENT - 1) & ~((size_t) NG5_ARENA_ALIGNMENT - 1))
+
+struct arena_chunk {
+        struct arena_chunk *prev, *next;
+        size_t capacity;
+        size_t used;
+};
+
+struct arena {
+        struct arena_chunk *chunks;     /* all chunks, the first one is the one from which small blocks are taken */
+        size_t chunk_size;
+        size_t num_bytes;
+};
+
+static void *invoke_malloc(struct allocator *self, size_t size);
+
+static void *invoke_realloc(struct allocator *self, void *ptr, size_t size);
+
+static void invoke_free(struct allocator *self, void *ptr);
+
+static void invoke_clone(struct allocator *dst, const struct allocator *self);
+
+NG5_EXPORT(bool) arena_alloc_create(struct allocator *alloc, size_t chunk_size)
+{
+        error_if_null(alloc)
+        struct arena *arena = malloc(sizeof(struct arena));
+        if (unlikely(!arena)) {
+                error(&alloc->err, NG5_ERR_MALLOCERR);
+                return false;
+        }
+        arena->chunks = NULL;
+        arena->chunk_size = chunk_size ? chunk_size : NG5_ARENA_CHUNK_SIZE;
+        arena->num_bytes = 0;
+
+        alloc->extra = arena;
+        alloc->malloc = invoke_malloc;
+        alloc->realloc = invoke_realloc;
+        alloc->free = invoke_free;
+        alloc->clone = invoke_clone;
+        error_init(&alloc->err);
+        return true;
+}
+
+NG5_EXPORT(bool) arena_alloc_drop(struct allocator *alloc)
+{
+        error_if_null(alloc)
+        if (unlikely(!arena_alloc_is(alloc))) {
+                error(&alloc->err, NG5_ERR_ILLEGALARG);
+                return false;
+        }
+        struct arena *arena = alloc->extra;
+        for (struct arena_chunk *chunk = arena->chunks, *next; chunk; chunk = next) {
+                next = chunk->next;
+                free(chunk);
+        }
+        free(arena);
+        alloc->extra = NULL;
+        return true;
+}
+
+NG5_EXPORT(bool) arena_alloc_reset(struct allocator *alloc)
+{
+        error_if_null(alloc)
+        if (unlikely(!arena_alloc_is(alloc))) {
+                error(&alloc->err, NG5_ERR_ILLEGALARG);
+                return false;
+        }
+        struct arena *arena = alloc->extra;
+        /** the first chunk is kept unless it is the chunk of a single large block, i.e., no small block was taken */
+        struct arena_chunk *first = arena->chunks;
+        if (first && first->capacity != arena->chunk_size) {
+                first = NULL;
+        }
+        for (struct arena_chunk *chunk = first ? first->next : arena->chunks, *next; chunk; chunk = next) {
+                next = chunk->next;
+                arena->num_bytes -= sizeof(struct arena_chunk) + chunk->capacity;
+                free(chunk);
+        }
+        if (first) {
+                first->next = NULL;
+                first->used = 0;
+        }
+        arena->chunks = first;
+        return true;
+}
+
+NG5_EXPORT(bool) arena_alloc_size(size_t *num_bytes, const struct allocator *alloc)
+{
+        error_if_null(num_bytes)
+        error_if_null(alloc)
+        if (unlikely(!arena_alloc_is(alloc))) {
+                return false;
+        }
+        *num_bytes = ((const struct arena *) alloc->extra)->num_bytes;
+        return true;
+}
+
+NG5_EXPORT(bool) arena_alloc_is(const struct allocator *alloc)
+{
+        return alloc && alloc->malloc == invoke_malloc;
+}
+
+static inline size_t *block_header(void *ptr)
+{
+        return (size_t *) ((char *) ptr - ARENA_HEADER_SIZE);
+}
+
+static inline char *chunk_data(struct arena_chunk *chunk)
+{
+        return (char *) (chunk + 1);
+}
+
+static inline bool is_last_block(struct arena *arena, void *ptr, size_t size)
+{
+        struct arena_chunk *chunk = arena->chunks;
+        return chunk && (char *) ptr + size == chunk_data(chunk) + chunk->used;
+}
+
+static struct arena_chunk *chunk_new(struct arena *arena, size_t capacity)
+{
+        struct arena_chunk *chunk = malloc(sizeof(struct arena_chunk) + capacity);
+        if (unlikely(!chunk)) {
+                print_error_and_die(NG5_ERR_MALLOCERR)
+        }
+        chunk->capacity = capacity;
+        chunk->used = 0;
+        arena->num_bytes += sizeof(struct arena_chunk) + capacity;
+        return chunk;
+}
+
+static void chunk_link(struct arena_chunk *chunk, struct arena_chunk *prev, struct arena_chunk *next,
+        struct arena *arena)
+{
+        chunk->prev = prev;
+        chunk->next = next;
+        if (prev) {
+                prev->next = chunk;
+        } else {
+                arena->chunks = chunk;
+        }
+        if (next) {
+                next->prev = chunk;
+        }
+}
+
+static void *dedicated_block_new(struct arena *arena, size_t size)
+{
+        struct arena_chunk *chunk = chunk_new(arena, ARENA_HEADER_SIZE + size);
+        /** keep the chunk of small blocks at the front */
+        if (arena->chunks) {
+                chunk_link(chunk, arena->chunks, arena->chunks->next, arena);
+        } else {
+                chunk_link(chunk, NULL, NULL, arena);
+        }
+        chunk->used = chunk->capacity;
+        *(size_t *) chunk_data(chunk) = size | ARENA_DEDICATED;
+        return chunk_data(chunk) + ARENA_HEADER_SIZE;
+}
+
+static inline struct arena_chunk *dedicated_block_chunk(void *ptr)
+{
+        return (struct arena_chunk *) ((char *) block_header(ptr) - sizeof(struct arena_chunk));
+}
+
+static void *invoke_malloc(struct allocator *self, size_t size)
+{
+        struct arena *arena = self->extra;
+        size = ARENA_ALIGN(ng5_max(size, 1));
+
+        if (unlikely(size > arena->chunk_size / 4)) {
+                return dedicated_block_new(arena, size);
+        }
+
+        struct arena_chunk *chunk = arena->chunks;
+        if (unlikely(!chunk || chunk->used + ARENA_HEADER_SIZE + size > chunk->capacity)) {
+                chunk = chunk_new(arena, arena->chunk_size);
+                chunk_link(chunk, NULL, arena->chunks, arena);
+        }
+        char *block = chunk_data(chunk) + chunk->used;
+        chunk->used += ARENA_HEADER_SIZE + size;
+        *(size_t *) block = size;
+        return block + ARENA_HEADER_SIZE;
+}
+
+static void *invoke_realloc(struct allocator *self, void *ptr, size_t size)
+{
+        if (unlikely(!ptr)) {
+                return invoke_malloc(self, size);
+        }
+
+        struct arena *arena = self->extra;
+        size_t *header = block_header(ptr);
+        size_t old_size = *header & ~ARENA_DEDICATED;
+        size = ARENA_ALIGN(ng5_max(size, 1));
+
+        if (*header & ARENA_DEDICATED) {
+                struct arena_chunk *chunk = dedicated_block_chunk(ptr), *resized;
+                struct arena_chunk *prev = chunk->prev, *next = chunk->next;
+                if (unlikely(!(resized = realloc(chunk, sizeof(struct arena_chunk) + ARENA_HEADER_SIZE + size)))) {
+                        /** the block stays valid (and owned by the caller) as for realloc(3) */
+                        error(&self->err, NG5_ERR_MALLOCERR);
+                        return NULL;
+                }
+                arena->num_bytes = arena->num_bytes - resized->capacity + ARENA_HEADER_SIZE + size;
+                resized->capacity = resized->used = ARENA_HEADER_SIZE + size;
+                chunk_link(resized, prev, next, arena);
+                *(size_t *) chunk_data(resized) = size | ARENA_DEDICATED;
+                return chunk_data(resized) + ARENA_HEADER_SIZE;
+        }
+
+        if (is_last_block(arena, ptr, old_size)) {
+                /** the most recent block is shrunk or grown in place if the chunk has room for it */
+                struct arena_chunk *chunk = arena->chunks;
+                if (size <= old_size || (size <= arena->chunk_size / 4
+                        && chunk->used - old_size + size <= chunk->capacity)) {
+                        chunk->used = chunk->used - old_size + size;
+                        *header = size;
+                        return ptr;
+                }
+        } else if (size <= old_size) {
+                return ptr;
+        }
+
+        void *result = invoke_malloc(self, size);
+        memcpy(result, ptr, old_size);
+        invoke_free(self, ptr);
+        return result;
+}
+
+static void invoke_free(struct allocator *self, void *ptr)
+{
+        struct arena *arena = self->extra;
+        size_t *header = block_header(ptr);
+
+        if (*header & ARENA_DEDICATED) {
+                struct arena_chunk *chunk = dedicated_block_chunk(ptr);
+                if (chunk->prev) {
+                        chunk->prev->next = chunk->next;
+                } else {
+                        arena->chunks = chunk->next;
+                }
+                if (chunk->next) {
+                        chunk->next->prev = chunk->prev;
+                }
+                arena->num_bytes -= sizeof(struct arena_chunk) + chunk->capacity;
+                free(chunk);
+        } else if (is_last_block(arena, ptr, *header)) {
+                arena->chunks->used -= ARENA_HEADER_SIZE + *header;
+        }
+}
+
+static void invoke_clone(struct allocator *dst, const struct allocator *self)
+{
+        *dst = *self;
+}
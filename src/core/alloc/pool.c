@@ -0,0 +1,490 @@
+/**
+ * Copyright 2018 Marcus Pinnecke
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+
+#include "core/alloc/pool.h"
+#include "core/async/spin.h"
+
+/**
+ * Size classes are 16, 32, ..., 128 bytes, and four classes per power of two above, up to
+ * <code>NG5_POOL_MAX_BLOCK_SIZE</code> (see <code>size_class_of</code>).
+ */
+#define POOL_NUM_CLASSES                36
+#define POOL_LARGE                      POOL_NUM_CLASSES
+#define POOL_PAGE_SIZE                  4096
+#define POOL_HEADER_SIZE                ((sizeof(struct pool_slab) + 63) & ~((size_t) 63))
+
+/** number of empty slabs that keep their memory, the pages of further empty slabs are given back to the system */
+#define POOL_NUM_CACHED_SLABS           64
+
+enum pool_slab_list {
+        SLAB_CURRENT, SLAB_PARTIAL, SLAB_FULL, SLAB_EMPTY
+};
+
+struct pool_block {
+        struct pool_block *next;
+};
+
+struct pool_heap;
+
+/**
+ * Header at the beginning of each slab, i.e., the slab of a block is found by rounding the block's address down to
+ * a multiple of <code>NG5_POOL_SLAB_SIZE</code>. Blocks with a mapping of their own have such a header as well.
+ */
+struct pool_slab {
+        struct pool_heap *heap;                 /* owning heap, does not change while blocks of the slab are in use */
+        struct pool_slab *prev, *next;          /* in a list of the owning heap, or in the list of empty slabs */
+        struct pool_block *free;                /* blocks freed by the owning heap */
+        char *bump;                             /* first block that was never handed out */
+        size_t map_size;                        /* number of mapped bytes, for blocks with a mapping of their own */
+        u32 size_class;
+        u32 block_size;
+        u32 num_used;
+        u32 list;
+        _Atomic(struct pool_block *) remote;    /* blocks freed by other threads, see slab_collect */
+};
+
+struct pool_class {
+        struct pool_slab *current;              /* slab from which blocks are handed out */
+        struct pool_slab *partial;              /* slabs with free blocks */
+        struct pool_slab *full;                 /* slabs without free blocks, except for remote frees */
+};
+
+/** per-thread state; heaps are never released but handed over to another thread when their thread exits */
+struct pool_heap {
+        struct pool_class classes[POOL_NUM_CLASSES];
+        atomic_size_t num_remote;               /* number of remote frees into slabs of this heap since last sweep */
+        struct pool_heap *next;                 /* in the list of abandoned heaps */
+};
+
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+static pthread_key_t pool_key;
+static struct spinlock pool_lock;
+static struct pool_slab *pool_empty_slabs;
+static size_t pool_num_empty_slabs;
+static char *pool_chunk_begin, *pool_chunk_end;
+static struct pool_heap *pool_abandoned_heaps;
+static atomic_size_t pool_num_bytes;
+
+static _Thread_local struct pool_heap *local_heap;
+
+static void *invoke_malloc(struct allocator *self, size_t size);
+
+static void *invoke_realloc(struct allocator *self, void *ptr, size_t size);
+
+static void invoke_free(struct allocator *self, void *ptr);
+
+static void invoke_clone(struct allocator *dst, const struct allocator *self);
+
+NG5_EXPORT(bool) pool_alloc_create(struct allocator *alloc)
+{
+        error_if_null(alloc)
+        alloc->extra = NULL;
+        alloc->malloc = invoke_malloc;
+        alloc->realloc = invoke_realloc;
+        alloc->free = invoke_free;
+        alloc->clone = invoke_clone;
+        error_init(&alloc->err);
+        return true;
+}
+
+NG5_EXPORT(bool) pool_alloc_size(size_t *num_bytes)
+{
+        error_if_null(num_bytes)
+        *num_bytes = atomic_load(&pool_num_bytes);
+        return true;
+}
+
+NG5_EXPORT(bool) pool_alloc_is(const struct allocator *alloc)
+{
+        return alloc && alloc->malloc == invoke_malloc;
+}
+
+static inline u32 size_class_of(size_t size)
+{
+        if (size <= 128) {
+                return size <= 16 ? 0 : (u32) ((size - 1) >> 4);
+        }
+        size_t s = size - 1;
+        u32 exp = 63 - __builtin_clzll(s);
+        return 8 + (exp - 7) * 4 + (u32) ((s - ((size_t) 1 << exp)) >> (exp - 2));
+}
+
+static inline u32 size_class_block_size(u32 size_class)
+{
+        if (size_class < 8) {
+                return (size_class + 1) * 16;
+        }
+        u32 exp = 7 + (size_class - 8) / 4;
+        return (1u << exp) + (((size_class - 8) % 4 + 1) << (exp - 2));
+}
+
+static inline struct pool_slab *slab_of(void *ptr)
+{
+        return (struct pool_slab *) ((uintptr_t) ptr & ~((uintptr_t) NG5_POOL_SLAB_SIZE - 1));
+}
+
+static void *map_aligned(size_t size)
+{
+        size_t map_size = size + NG5_POOL_SLAB_SIZE;
+        char *base = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (unlikely(base == MAP_FAILED)) {
+                return NULL;
+        }
+        char *aligned = (char *) slab_of(base + NG5_POOL_SLAB_SIZE - 1);
+        if (aligned > base) {
+                munmap(base, aligned - base);
+        }
+        if (base + map_size > aligned + size) {
+                munmap(aligned + size, base + map_size - (aligned + size));
+        }
+        atomic_fetch_add(&pool_num_bytes, size);
+        return aligned;
+}
+
+static void slab_push(struct pool_slab **list, struct pool_slab *slab)
+{
+        slab->prev = NULL;
+        slab->next = *list;
+        if (*list) {
+                (*list)->prev = slab;
+        }
+        *list = slab;
+}
+
+static void slab_unlink(struct pool_slab **list, struct pool_slab *slab)
+{
+        if (slab->prev) {
+                slab->prev->next = slab->next;
+        } else {
+                *list = slab->next;
+        }
+        if (slab->next) {
+                slab->next->prev = slab->prev;
+        }
+}
+
+static struct pool_slab *slab_new(struct pool_heap *heap, u32 size_class)
+{
+        struct pool_slab *slab;
+
+        spin_acquire(&pool_lock);
+        if (pool_empty_slabs) {
+                slab = pool_empty_slabs;
+                pool_empty_slabs = slab->next;
+                pool_num_empty_slabs--;
+        } else {
+                if (pool_chunk_begin == pool_chunk_end) {
+                        pool_chunk_begin = map_aligned(NG5_POOL_SLABS_PER_CHUNK * NG5_POOL_SLAB_SIZE);
+                        if (unlikely(!pool_chunk_begin)) {
+                                pool_chunk_end = NULL;
+                                spin_release(&pool_lock);
+                                return NULL;
+                        }
+                        pool_chunk_end = pool_chunk_begin + NG5_POOL_SLABS_PER_CHUNK * NG5_POOL_SLAB_SIZE;
+                }
+                slab = (struct pool_slab *) pool_chunk_begin;
+                pool_chunk_begin += NG5_POOL_SLAB_SIZE;
+        }
+        spin_release(&pool_lock);
+
+        slab->heap = heap;
+        slab->prev = slab->next = NULL;
+        slab->free = NULL;
+        slab->bump = (char *) slab + POOL_HEADER_SIZE;
+        slab->map_size = NG5_POOL_SLAB_SIZE;
+        slab->size_class = size_class;
+        slab->block_size = size_class_block_size(size_class);
+        slab->num_used = 0;
+        slab->list = SLAB_CURRENT;
+        atomic_init(&slab->remote, NULL);
+        return slab;
+}
+
+static void slab_release(struct pool_slab *slab)
+{
+        assert(slab->num_used == 0);
+        slab->heap = NULL;
+        slab->list = SLAB_EMPTY;
+
+        spin_acquire(&pool_lock);
+        if (pool_num_empty_slabs >= POOL_NUM_CACHED_SLABS) {
+                madvise((char *) slab + POOL_PAGE_SIZE, NG5_POOL_SLAB_SIZE - POOL_PAGE_SIZE, MADV_DONTNEED);
+        }
+        slab->next = pool_empty_slabs;
+        pool_empty_slabs = slab;
+        pool_num_empty_slabs++;
+        spin_release(&pool_lock);
+}
+
+static inline void *slab_take(struct pool_slab *slab)
+{
+        struct pool_block *block = slab->free;
+        if (likely(block != NULL)) {
+                slab->free = block->next;
+                slab->num_used++;
+                return block;
+        }
+        if (likely(slab->bump + slab->block_size <= (char *) slab + NG5_POOL_SLAB_SIZE)) {
+                void *result = slab->bump;
+                slab->bump += slab->block_size;
+                slab->num_used++;
+                return result;
+        }
+        return NULL;
+}
+
+/** Moves blocks freed by other threads into the free list of <code>slab</code>, returns their number */
+static u32 slab_collect(struct pool_slab *slab)
+{
+        struct pool_block *block = atomic_exchange_explicit(&slab->remote, NULL, memory_order_acquire);
+        u32 num_blocks = 0;
+        while (block) {
+                struct pool_block *next = block->next;
+                block->next = slab->free;
+                slab->free = block;
+                block = next;
+                num_blocks++;
+        }
+        slab->num_used -= num_blocks;
+        return num_blocks;
+}
+
+static void heap_abandon(void *arg)
+{
+        struct pool_heap *heap = arg;
+        local_heap = NULL;
+        spin_acquire(&pool_lock);
+        heap->next = pool_abandoned_heaps;
+        pool_abandoned_heaps = heap;
+        spin_release(&pool_lock);
+}
+
+static void pool_init(void)
+{
+        spin_init(&pool_lock);
+        pthread_key_create(&pool_key, heap_abandon);
+}
+
+static struct pool_heap *heap_get(void)
+{
+        struct pool_heap *heap = local_heap;
+        if (likely(heap != NULL)) {
+                return heap;
+        }
+
+        pthread_once(&pool_once, pool_init);
+        spin_acquire(&pool_lock);
+        if ((heap = pool_abandoned_heaps)) {
+                pool_abandoned_heaps = heap->next;
+        }
+        spin_release(&pool_lock);
+
+        if (!heap) {
+                if (unlikely(!(heap = calloc(1, sizeof(struct pool_heap))))) {
+                        return NULL;
+                }
+                atomic_init(&heap->num_remote, 0);
+        }
+        local_heap = heap;
+        pthread_setspecific(pool_key, heap);
+        return heap;
+}
+
+/** Collects remote frees of all slabs of <code>heap</code> that are not the current one of their size class */
+static void heap_sweep(struct pool_heap *heap)
+{
+        for (u32 size_class = 0; size_class < POOL_NUM_CLASSES; size_class++) {
+                struct pool_class *cls = heap->classes + size_class;
+                for (struct pool_slab *slab = cls->partial, *next; slab; slab = next) {
+                        next = slab->next;
+                        if (slab_collect(slab) && slab->num_used == 0) {
+                                slab_unlink(&cls->partial, slab);
+                                slab_release(slab);
+                        }
+                }
+                for (struct pool_slab *slab = cls->full, *next; slab; slab = next) {
+                        next = slab->next;
+                        if (slab_collect(slab)) {
+                                slab_unlink(&cls->full, slab);
+                                if (slab->num_used == 0) {
+                                        slab_release(slab);
+                                } else {
+                                        slab->list = SLAB_PARTIAL;
+                                        slab_push(&cls->partial, slab);
+                                }
+                        }
+                }
+        }
+}
+
+static void *heap_alloc_slow(struct pool_heap *heap, u32 size_class)
+{
+        struct pool_class *cls = heap->classes + size_class;
+        struct pool_slab *slab = cls->current;
+
+        if (slab) {
+                if (slab_collect(slab)) {
+                        return slab_take(slab);
+                }
+                slab->list = SLAB_FULL;
+                slab_push(&cls->full, slab);
+                cls->current = NULL;
+        }
+        if (!cls->partial && atomic_load_explicit(&heap->num_remote, memory_order_relaxed) > 0) {
+                atomic_store_explicit(&heap->num_remote, 0, memory_order_relaxed);
+                heap_sweep(heap);
+        }
+        if ((slab = cls->partial)) {
+                slab_unlink(&cls->partial, slab);
+                slab->list = SLAB_CURRENT;
+        } else if (unlikely(!(slab = slab_new(heap, size_class)))) {
+                return NULL;
+        }
+        cls->current = slab;
+        return slab_take(slab);
+}
+
+static void heap_free(struct pool_heap *heap, struct pool_slab *slab, void *ptr)
+{
+        struct pool_class *cls = heap->classes + slab->size_class;
+        struct pool_block *block = ptr;
+
+        block->next = slab->free;
+        slab->free = block;
+        slab->num_used--;
+
+        if (unlikely(slab->list == SLAB_FULL)) {
+                slab_unlink(&cls->full, slab);
+                slab->list = SLAB_PARTIAL;
+                slab_push(&cls->partial, slab);
+        }
+        if (unlikely(slab->num_used == 0) && slab->list == SLAB_PARTIAL) {
+                slab_unlink(&cls->partial, slab);
+                slab_release(slab);
+        }
+}
+
+static void remote_free(struct pool_heap *heap, struct pool_slab *slab, void *ptr)
+{
+        struct pool_block *block = ptr;
+        struct pool_block *head = atomic_load_explicit(&slab->remote, memory_order_relaxed);
+        do {
+                block->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&slab->remote, &head, block, memory_order_release,
+                memory_order_relaxed));
+        /** the slab may be released by its heap from here on, but the heap itself is never */
+        atomic_fetch_add_explicit(&heap->num_remote, 1, memory_order_release);
+}
+
+static void *large_new(size_t size)
+{
+        size_t map_size = (POOL_HEADER_SIZE + size + POOL_PAGE_SIZE - 1) & ~((size_t) POOL_PAGE_SIZE - 1);
+        struct pool_slab *slab = map_aligned(map_size);
+        if (unlikely(!slab)) {
+                return NULL;
+        }
+        slab->heap = NULL;
+        slab->map_size = map_size;
+        slab->size_class = POOL_LARGE;
+        return (char *) slab + POOL_HEADER_SIZE;
+}
+
+static void large_drop(struct pool_slab *slab)
+{
+        atomic_fetch_sub(&pool_num_bytes, slab->map_size);
+        munmap(slab, slab->map_size);
+}
+
+static inline size_t block_capacity(struct pool_slab *slab)
+{
+        return slab->size_class == POOL_LARGE ? slab->map_size - POOL_HEADER_SIZE : slab->block_size;
+}
+
+static void *invoke_malloc(struct allocator *self, size_t size)
+{
+        ng5_unused(self);
+        void *result;
+
+        if (likely(size <= NG5_POOL_MAX_BLOCK_SIZE)) {
+                struct pool_heap *heap = heap_get();
+                if (unlikely(!heap)) {
+                        print_error_and_die(NG5_ERR_MALLOCERR)
+                }
+                u32 size_class = size_class_of(size);
+                struct pool_slab *slab = heap->classes[size_class].current;
+                if (unlikely(!slab || !(result = slab_take(slab)))) {
+                        result = heap_alloc_slow(heap, size_class);
+                }
+        } else {
+                result = large_new(size);
+        }
+
+        if (unlikely(!result)) {
+                print_error_and_die(NG5_ERR_MALLOCERR)
+        }
+        return result;
+}
+
+static void *invoke_realloc(struct allocator *self, void *ptr, size_t size)
+{
+        if (unlikely(!ptr)) {
+                return invoke_malloc(self, size);
+        }
+
+        struct pool_slab *slab = slab_of(ptr);
+        size_t capacity = block_capacity(slab);
+
+        /** keep blocks that still fit in place unless they would waste more than one size class (resp. half of
+         * their mapping) */
+        if (size <= capacity) {
+                if (slab->size_class == POOL_LARGE ? size > NG5_POOL_MAX_BLOCK_SIZE && size > capacity / 2
+                                                   : size_class_of(size) == slab->size_class) {
+                        return ptr;
+                }
+        }
+
+        void *result = invoke_malloc(self, size);
+        memcpy(result, ptr, ng5_min(size, capacity));
+        invoke_free(self, ptr);
+        return result;
+}
+
+static void invoke_free(struct allocator *self, void *ptr)
+{
+        ng5_unused(self);
+        if (unlikely(!ptr)) {
+                return;
+        }
+
+        struct pool_slab *slab = slab_of(ptr);
+        if (unlikely(slab->size_class == POOL_LARGE)) {
+                large_drop(slab);
+        } else if (likely(slab->heap == local_heap)) {
+                heap_free(slab->heap, slab, ptr);
+        } else {
+                remote_free(slab->heap, slab, ptr);
+        }
+}
+
+static void invoke_clone(struct allocator *dst, const struct allocator *self)
+{
+        *dst = *self;
+}
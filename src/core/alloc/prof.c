@@ -0,0 +1,413 @@
+/**
+ * Copyright 2018 Marcus Pinnecke
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <inttypes.h>
+#include <stdatomic.h>
+
+#include "core/alloc/prof.h"
+#include "core/async/spin.h"
+
+/** header in front of each block, keeps blocks 16-byte aligned */
+struct prof_header {
+        size_t size;
+        u32 tag;
+        u32 reserved;
+};
+
+#define PROF_TAG_NAME_LENGTH            32
+#define PROF_FLUSH_BYTES                (256 * 1024)
+#define PROF_FLUSH_OPS                  4096
+#define PROF_DUMP_SITES                 10
+#define PROF_SITE_TAG_SHIFT             48
+#define PROF_SITE_HASH_BITS             12
+
+struct prof_tag {
+        char name[PROF_TAG_NAME_LENGTH];
+        struct allocator backend;
+        u32 idx;
+        atomic_int_fast64_t live_bytes;
+        atomic_int_fast64_t high_water_bytes;
+        atomic_uint_fast64_t num_allocs;
+        atomic_uint_fast64_t num_reallocs;
+        atomic_uint_fast64_t num_frees;
+        atomic_uint_fast64_t num_bytes;
+};
+
+/** sampled call site, the key is the code address with the tag index + 1 in the upper 16 bits (0 if unused) */
+struct prof_site {
+        atomic_uintptr_t key;
+        atomic_uint_fast64_t num_samples;
+        atomic_uint_fast64_t num_bytes;
+};
+
+/** counters of one thread that are not yet flushed to the tags */
+struct prof_thread {
+        i64 live_bytes[NG5_PROF_MAX_TAGS];
+        u64 num_allocs[NG5_PROF_MAX_TAGS];
+        u64 num_reallocs[NG5_PROF_MAX_TAGS];
+        u64 num_frees[NG5_PROF_MAX_TAGS];
+        u64 num_bytes[NG5_PROF_MAX_TAGS];
+        u32 num_ops;
+        i64 countdown;
+        u64 random;
+        bool registered;
+};
+
+_Static_assert(sizeof(struct prof_header) == 16, "blocks must stay 16-byte aligned");
+_Static_assert(NG5_PROF_MAX_SITES == (1 << PROF_SITE_HASH_BITS), "call site table must match its hash");
+
+static pthread_once_t prof_once = PTHREAD_ONCE_INIT;
+static pthread_key_t prof_key;
+static struct spinlock prof_lock;
+static struct prof_tag prof_tags[NG5_PROF_MAX_TAGS];
+static atomic_uint prof_num_tags;
+static struct prof_site prof_sites[NG5_PROF_MAX_SITES];
+static atomic_uint_fast64_t prof_num_dropped_samples;
+static atomic_uint_fast64_t prof_num_unprofiled;
+static atomic_size_t prof_sample_rate = NG5_PROF_SAMPLE_RATE;
+static atomic_bool prof_enabled;
+
+static _Thread_local struct prof_thread local_counters;
+
+static void *invoke_malloc(struct allocator *self, size_t size);
+
+static void *invoke_realloc(struct allocator *self, void *ptr, size_t size);
+
+static void invoke_free(struct allocator *self, void *ptr);
+
+static void invoke_clone(struct allocator *dst, const struct allocator *self);
+
+static void thread_flush(struct prof_thread *counters);
+
+static void thread_exit(void *arg)
+{
+        thread_flush(arg);
+}
+
+static void prof_init(void)
+{
+        spin_init(&prof_lock);
+        pthread_key_create(&prof_key, thread_exit);
+}
+
+/** entry of the (tag, backend) pair, which is added if it does not exist, or NULL if all tags are taken */
+static struct prof_tag *tag_entry(const struct allocator *backend, const char *tag)
+{
+        struct allocator tag_backend;
+        alloc_this_or_std(&tag_backend, backend);
+
+        pthread_once(&prof_once, prof_init);
+        spin_acquire(&prof_lock);
+
+        unsigned num_tags = atomic_load(&prof_num_tags);
+        struct prof_tag *entry = NULL;
+        for (unsigned i = 0; i < num_tags; i++) {
+                struct prof_tag *it = prof_tags + i;
+                if (strncmp(it->name, tag, PROF_TAG_NAME_LENGTH - 1) == 0 && it->backend.malloc == tag_backend.malloc
+                        && it->backend.extra == tag_backend.extra) {
+                        entry = it;
+                        break;
+                }
+        }
+        if (!entry && num_tags < NG5_PROF_MAX_TAGS) {
+                entry = prof_tags + num_tags;
+                snprintf(entry->name, PROF_TAG_NAME_LENGTH, "%s", tag);
+                entry->backend = tag_backend;
+                entry->idx = num_tags;
+                /** counters are zero-initialized (static storage), publish the entry for prof_alloc_dump */
+                atomic_store(&prof_num_tags, num_tags + 1);
+        }
+
+        spin_release(&prof_lock);
+        return entry;
+}
+
+static void init_allocator(struct allocator *alloc, struct prof_tag *entry)
+{
+        alloc->extra = entry;
+        alloc->malloc = invoke_malloc;
+        alloc->realloc = invoke_realloc;
+        alloc->free = invoke_free;
+        alloc->clone = invoke_clone;
+        error_init(&alloc->err);
+}
+
+NG5_EXPORT(bool) prof_alloc_create(struct allocator *alloc, const struct allocator *backend, const char *tag)
+{
+        error_if_null(alloc)
+        error_if_null(tag)
+
+        struct prof_tag *entry = tag_entry(backend, tag);
+        if (unlikely(!entry)) {
+                error(&alloc->err, NG5_ERR_OUTOFBOUNDS);
+                return false;
+        }
+        init_allocator(alloc, entry);
+        return true;
+}
+
+NG5_EXPORT(bool) prof_alloc_wrap(struct allocator *alloc, const struct allocator *backend, const char *tag)
+{
+        error_if_null(alloc)
+        error_if_null(tag)
+
+        if (prof_alloc_enabled()) {
+                struct prof_tag *entry = tag_entry(backend, tag);
+                if (likely(entry != NULL)) {
+                        init_allocator(alloc, entry);
+                        return true;
+                }
+                /** all tags are taken: the subsystem works unprofiled rather than with an unusable allocator */
+                atomic_fetch_add(&prof_num_unprofiled, 1);
+        }
+        return alloc_this_or_std(alloc, backend);
+}
+
+NG5_EXPORT(bool) prof_alloc_enable(size_t sample_rate)
+{
+        atomic_store(&prof_sample_rate, sample_rate ? sample_rate : NG5_PROF_SAMPLE_RATE);
+        atomic_store(&prof_enabled, true);
+        return true;
+}
+
+NG5_EXPORT(bool) prof_alloc_enabled(void)
+{
+        return atomic_load_explicit(&prof_enabled, memory_order_relaxed);
+}
+
+NG5_EXPORT(bool) prof_alloc_is(const struct allocator *alloc)
+{
+        return alloc && alloc->malloc == invoke_malloc;
+}
+
+static void update_high_water(struct prof_tag *tag, i64 live_bytes)
+{
+        i64 high_water = atomic_load_explicit(&tag->high_water_bytes, memory_order_relaxed);
+        while (live_bytes > high_water && !atomic_compare_exchange_weak_explicit(&tag->high_water_bytes, &high_water,
+                live_bytes, memory_order_relaxed, memory_order_relaxed)) { }
+}
+
+static void thread_flush(struct prof_thread *counters)
+{
+        unsigned num_tags = atomic_load_explicit(&prof_num_tags, memory_order_acquire);
+        for (unsigned i = 0; i < num_tags; i++) {
+                struct prof_tag *tag = prof_tags + i;
+                if (counters->live_bytes[i]) {
+                        i64 live_bytes = atomic_fetch_add_explicit(&tag->live_bytes, counters->live_bytes[i],
+                                memory_order_relaxed) + counters->live_bytes[i];
+                        update_high_water(tag, live_bytes);
+                }
+                if (counters->num_allocs[i] | counters->num_reallocs[i] | counters->num_frees[i]) {
+                        atomic_fetch_add_explicit(&tag->num_allocs, counters->num_allocs[i], memory_order_relaxed);
+                        atomic_fetch_add_explicit(&tag->num_reallocs, counters->num_reallocs[i], memory_order_relaxed);
+                        atomic_fetch_add_explicit(&tag->num_frees, counters->num_frees[i], memory_order_relaxed);
+                        atomic_fetch_add_explicit(&tag->num_bytes, counters->num_bytes[i], memory_order_relaxed);
+                }
+                counters->live_bytes[i] = 0;
+                counters->num_allocs[i] = counters->num_reallocs[i] = counters->num_frees[i] = 0;
+                counters->num_bytes[i] = 0;
+        }
+        counters->num_ops = 0;
+}
+
+static i64 next_countdown(struct prof_thread *counters)
+{
+        size_t rate = atomic_load_explicit(&prof_sample_rate, memory_order_relaxed);
+        if (rate <= 1) {
+                return 1;
+        }
+        /** xorshift64, uniform in [1, 2 * rate - 1] such that the mean distance between samples is the rate */
+        u64 x = counters->random;
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        counters->random = x;
+        return 1 + (i64) (x % (2 * rate - 1));
+}
+
+static struct prof_thread *thread_counters(void)
+{
+        struct prof_thread *counters = &local_counters;
+        if (unlikely(!counters->registered)) {
+                counters->registered = true;
+                counters->random = ((uintptr_t) counters * 0x9E3779B97F4A7C15ull) | 1;
+                counters->countdown = next_countdown(counters);
+                /** e.g., prof_alloc_dump may come first, before any profiling allocator created the key */
+                pthread_once(&prof_once, prof_init);
+                pthread_setspecific(prof_key, counters);
+        }
+        return counters;
+}
+
+static void record_sample(u32 tag, const void *site, size_t size)
+{
+        uintptr_t key = ((uintptr_t) site & (((uintptr_t) 1 << PROF_SITE_TAG_SHIFT) - 1))
+                | ((uintptr_t) (tag + 1) << PROF_SITE_TAG_SHIFT);
+        size_t pos = (size_t) ((key * 0x9E3779B97F4A7C15ull) >> (64 - PROF_SITE_HASH_BITS));
+
+        for (size_t probe = 0; probe < NG5_PROF_MAX_SITES; probe++) {
+                struct prof_site *entry = prof_sites + ((pos + probe) & (NG5_PROF_MAX_SITES - 1));
+                uintptr_t entry_key = atomic_load_explicit(&entry->key, memory_order_relaxed);
+                if (entry_key == 0) {
+                        if (atomic_compare_exchange_strong_explicit(&entry->key, &entry_key, key, memory_order_relaxed,
+                                memory_order_relaxed)) {
+                                entry_key = key;
+                        }
+                }
+                if (entry_key == key) {
+                        atomic_fetch_add_explicit(&entry->num_samples, 1, memory_order_relaxed);
+                        atomic_fetch_add_explicit(&entry->num_bytes, size, memory_order_relaxed);
+                        return;
+                }
+        }
+        atomic_fetch_add_explicit(&prof_num_dropped_samples, 1, memory_order_relaxed);
+}
+
+static inline void account(struct prof_thread *counters, u32 tag, i64 live_delta)
+{
+        counters->live_bytes[tag] += live_delta;
+        if (unlikely(++counters->num_ops >= PROF_FLUSH_OPS || counters->live_bytes[tag] >= PROF_FLUSH_BYTES
+                || counters->live_bytes[tag] <= -PROF_FLUSH_BYTES)) {
+                thread_flush(counters);
+        }
+}
+
+static inline void account_alloc(u32 tag, size_t size, i64 live_delta, bool is_realloc, const void *site)
+{
+        struct prof_thread *counters = thread_counters();
+        if (is_realloc) {
+                counters->num_reallocs[tag]++;
+        } else {
+                counters->num_allocs[tag]++;
+        }
+        counters->num_bytes[tag] += size;
+        if (unlikely(--counters->countdown <= 0)) {
+                counters->countdown = next_countdown(counters);
+                record_sample(tag, site, size);
+        }
+        account(counters, tag, live_delta);
+}
+
+static void *invoke_malloc(struct allocator *self, size_t size)
+{
+        struct prof_tag *tag = self->extra;
+        struct prof_header *header = alloc_malloc(&tag->backend, sizeof(struct prof_header) + size);
+        header->size = size;
+        header->tag = tag->idx;
+
+        account_alloc(tag->idx, size, (i64) size, false, __builtin_return_address(0));
+        return header + 1;
+}
+
+static void *invoke_realloc(struct allocator *self, void *ptr, size_t size)
+{
+        if (unlikely(!ptr)) {
+                struct prof_tag *tag = self->extra;
+                struct prof_header *header = alloc_malloc(&tag->backend, sizeof(struct prof_header) + size);
+                header->size = size;
+                header->tag = tag->idx;
+                account_alloc(tag->idx, size, (i64) size, false, __builtin_return_address(0));
+                return header + 1;
+        }
+
+        struct prof_header *header = (struct prof_header *) ptr - 1;
+        struct prof_tag *tag = prof_tags + header->tag;
+        size_t old_size = header->size;
+
+        header = alloc_realloc(&tag->backend, header, sizeof(struct prof_header) + size);
+        header->size = size;
+
+        account_alloc(tag->idx, size, (i64) size - (i64) old_size, true, __builtin_return_address(0));
+        return header + 1;
+}
+
+static void invoke_free(struct allocator *self, void *ptr)
+{
+        ng5_unused(self);
+        if (unlikely(!ptr)) {
+                return;
+        }
+
+        struct prof_header *header = (struct prof_header *) ptr - 1;
+        struct prof_tag *tag = prof_tags + header->tag;
+        struct prof_thread *counters = thread_counters();
+        i64 size = (i64) header->size;
+
+        alloc_free(&tag->backend, header);
+        counters->num_frees[tag->idx]++;
+        account(counters, tag->idx, -size);
+}
+
+static void invoke_clone(struct allocator *dst, const struct allocator *self)
+{
+        *dst = *self;
+}
+
+NG5_EXPORT(bool) prof_alloc_dump(FILE *file)
+{
+        error_if_null(file)
+
+        size_t rate = atomic_load(&prof_sample_rate);
+        thread_flush(thread_counters());
+
+        unsigned num_tags = atomic_load_explicit(&prof_num_tags, memory_order_acquire);
+        fprintf(file, "allocation profile (sample rate 1/%zu, %" PRIuFAST64 " samples dropped, %" PRIuFAST64
+                " allocators not profiled since all %d tags are taken)\n", rate,
+                atomic_load(&prof_num_dropped_samples), atomic_load(&prof_num_unprofiled), NG5_PROF_MAX_TAGS);
+        fprintf(file, "%-24s %14s %14s %14s %16s %16s %16s\n", "tag", "allocs", "reallocs", "frees", "bytes",
+                "live-bytes", "high-water");
+        for (unsigned i = 0; i < num_tags; i++) {
+                struct prof_tag *tag = prof_tags + i;
+                fprintf(file, "%-24s %14" PRIuFAST64 " %14" PRIuFAST64 " %14" PRIuFAST64 " %16" PRIuFAST64
+                        " %16" PRIdFAST64 " %16" PRIdFAST64 "\n", tag->name, atomic_load(&tag->num_allocs),
+                        atomic_load(&tag->num_reallocs), atomic_load(&tag->num_frees), atomic_load(&tag->num_bytes),
+                        atomic_load(&tag->live_bytes), atomic_load(&tag->high_water_bytes));
+        }
+
+        for (unsigned i = 0; i < num_tags; i++) {
+                /** selection of the call sites with the most sampled bytes, without modifying the table */
+                u64 last_bytes = UINT64_MAX;
+                size_t last_pos = NG5_PROF_MAX_SITES;
+                fprintf(file, "top call sites of '%s' (estimated bytes, samples):\n", prof_tags[i].name);
+                for (unsigned rank = 0; rank < PROF_DUMP_SITES; rank++) {
+                        size_t best_pos = NG5_PROF_MAX_SITES;
+                        u64 best_bytes = 0;
+                        for (size_t pos = 0; pos < NG5_PROF_MAX_SITES; pos++) {
+                                struct prof_site *site = prof_sites + pos;
+                                uintptr_t key = atomic_load_explicit(&site->key, memory_order_relaxed);
+                                u64 bytes = atomic_load_explicit(&site->num_bytes, memory_order_relaxed);
+                                bool after_last = bytes < last_bytes || (bytes == last_bytes && pos > last_pos);
+                                if ((key >> PROF_SITE_TAG_SHIFT) == i + 1 && after_last
+                                        && (best_pos == NG5_PROF_MAX_SITES || bytes > best_bytes)) {
+                                        best_pos = pos;
+                                        best_bytes = bytes;
+                                }
+                        }
+                        if (best_pos == NG5_PROF_MAX_SITES) {
+                                break;
+                        }
+                        struct prof_site *site = prof_sites + best_pos;
+                        uintptr_t address = atomic_load(&site->key) & (((uintptr_t) 1 << PROF_SITE_TAG_SHIFT) - 1);
+                        fprintf(file, "    %#018" PRIxPTR " %16" PRIu64 " %14" PRIuFAST64 "\n", address,
+                                best_bytes * rate, atomic_load(&site->num_samples));
+                        last_bytes = best_bytes;
+                        last_pos = best_pos;
+                }
+        }
+        fflush(file);
+        return true;
+}
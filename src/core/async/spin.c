@@ -15,43 +15,174 @@
  * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <time.h>
+#include <sched.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "shared/error.h"
 #include "core/async/spin.h"
-#include "utils/time.h"
 
 #define SPINLOCK_TAG "spinlock"
 
-bool spin_init(struct spinlock *spinlock)
+/** waits longer than this (in nanoseconds) are reported as warning */
+#define SPIN_WARN_WAIT_NS       (10 * 1000 * 1000)
+
+/** the address of this variable identifies the calling thread */
+static _Thread_local char this_thread;
+
+#define this_token()            ((uintptr_t) &this_thread)
+
+#define load(field)             __atomic_load_n(&(field), __ATOMIC_RELAXED)
+#define store(field, value)     __atomic_store_n(&(field), (value), __ATOMIC_RELAXED)
+#define count(field, delta)     store(field, load(field) + (delta))
+
+static inline void cpu_relax()
 {
-        error_if_null(spinlock)
-        atomic_flag_clear(&spinlock->lock);
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        __asm__ __volatile__("yield" ::: "memory");
+#else
+        __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+static inline u64 now_ns()
+{
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (u64) ts.tv_sec * 1000000000ull + (u64) ts.tv_nsec;
+}
+
+/** sleepers are woken up by the ticket they hold (modulo 32), such that a release wakes up the next thread only */
+#define ticket_bit(ticket)      (1u << ((ticket) % 32))
+
+static void sleep_while_serving(struct spinlock *spinlock, u32 serving, u32 ticket)
+{
+        __atomic_fetch_add(&spinlock->sleepers, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&spinlock->serving, __ATOMIC_SEQ_CST) == serving) {
+#if defined(__linux__)
+                syscall(SYS_futex, &spinlock->serving, FUTEX_WAIT_BITSET_PRIVATE, serving, NULL, NULL,
+                        ticket_bit(ticket));
+#else
+                ng5_unused(ticket);
+                sched_yield();
+#endif
+        }
+        __atomic_fetch_sub(&spinlock->sleepers, 1, __ATOMIC_SEQ_CST);
+}
+
+static void wake_sleeper(struct spinlock *spinlock, u32 ticket)
+{
+#if defined(__linux__)
+        syscall(SYS_futex, &spinlock->serving, FUTEX_WAKE_BITSET_PRIVATE, INT32_MAX, NULL, NULL, ticket_bit(ticket));
+#else
+        ng5_unused(spinlock);
+        ng5_unused(ticket);
+#endif
+}
+
+/** pause instructions before falling asleep, zero on a single processor where the holder cannot run meanwhile */
+static u32 spin_budget()
+{
+        static u32 budget = UINT32_MAX;
+        u32 result = __atomic_load_n(&budget, __ATOMIC_RELAXED);
+        if (unlikely(result == UINT32_MAX)) {
+                result = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? NG5_SPIN_MAX_SPINS : 0;
+                __atomic_store_n(&budget, result, __ATOMIC_RELAXED);
+        }
+        return result;
+}
+
+static void wait_for_ticket(struct spinlock *spinlock, u32 ticket)
+{
+        u64 begin = now_ns();
+        u32 budget = spin_budget();
+        u64 spins = 0, sleeps = 0;
+        u32 backoff = 1;
+        u32 serving;
 
-        memset(&spinlock->owner, 0, sizeof(pthread_t));
+        while ((serving = __atomic_load_n(&spinlock->serving, __ATOMIC_ACQUIRE)) != ticket) {
+                /** threads further back in the queue fall asleep earlier... */
+                if (spins < budget / (ticket - serving)) {
+                        /** ...and poll less often */
+                        u32 delay = ng5_min(backoff * (ticket - serving), NG5_SPIN_MAX_BACKOFF);
+                        for (u32 i = 0; i < delay; i++) {
+                                cpu_relax();
+                        }
+                        spins += delay;
+                        backoff = ng5_min(2 * backoff, NG5_SPIN_MAX_BACKOFF);
+                } else {
+                        sleep_while_serving(spinlock, serving, ticket);
+                        sleeps++;
+                }
+        }
 
+        /** from here on, this thread holds the lock and is the only writer of the counters */
+        u64 wait_ns = now_ns() - begin;
+        count(spinlock->stats.contended, 1);
+        count(spinlock->stats.spins, spins);
+        count(spinlock->stats.sleeps, sleeps);
+        count(spinlock->stats.wait_ns, wait_ns);
+        if (unlikely(wait_ns > SPIN_WARN_WAIT_NS)) {
+                ng5_warn(SPINLOCK_TAG, "spin lock acquisition took exceptionally long: %f seconds", wait_ns / 1e9);
+        }
+}
+
+bool spin_init(struct spinlock *spinlock)
+{
+        error_if_null(spinlock)
+        memset(spinlock, 0, sizeof(struct spinlock));
         return true;
 }
 
 bool spin_acquire(struct spinlock *spinlock)
 {
-        timestamp_t begin = time_now_wallclock();
         error_if_null(spinlock)
-        if (!pthread_equal(spinlock->owner, pthread_self())) {
-                while (atomic_flag_test_and_set(&spinlock->lock)) { }
-                /** remeber the thread that aquires this lock */
-                spinlock->owner = pthread_self();
+        if (unlikely(load(spinlock->owner) == this_token())) {
+                /** only this thread could have stored its own token, i.e., it already holds the lock */
+                spinlock->depth++;
+                return true;
         }
-        timestamp_t end = time_now_wallclock();
-        float duration = (end - begin) / 1000.0f;
-        if (duration > 0.01f) {
-                ng5_warn(SPINLOCK_TAG, "spin lock acquisition took exceptionally long: %f seconds", duration);
+        u32 ticket = __atomic_fetch_add(&spinlock->next, 1, __ATOMIC_RELAXED);
+        if (unlikely(__atomic_load_n(&spinlock->serving, __ATOMIC_ACQUIRE) != ticket)) {
+                wait_for_ticket(spinlock, ticket);
         }
-
+        store(spinlock->owner, this_token());
+        count(spinlock->stats.acquisitions, 1);
         return true;
 }
 
 bool spin_release(struct spinlock *spinlock)
 {
         error_if_null(spinlock)
-        atomic_flag_clear(&spinlock->lock);
-        memset(&spinlock->owner, 0, sizeof(pthread_t));
+        if (unlikely(load(spinlock->owner) != this_token())) {
+                return false;
+        }
+        if (unlikely(spinlock->depth > 0)) {
+                spinlock->depth--;
+                return true;
+        }
+        store(spinlock->owner, 0);
+        u32 next = load(spinlock->serving) + 1;
+        __atomic_store_n(&spinlock->serving, next, __ATOMIC_SEQ_CST);
+        if (unlikely(__atomic_load_n(&spinlock->sleepers, __ATOMIC_SEQ_CST) > 0)) {
+                wake_sleeper(spinlock, next);
+        }
+        return true;
+}
+
+bool spin_stats(struct spin_stats *stats, const struct spinlock *spinlock)
+{
+        error_if_null(stats)
+        error_if_null(spinlock)
+        stats->acquisitions = load(spinlock->stats.acquisitions);
+        stats->contended = load(spinlock->stats.contended);
+        stats->spins = load(spinlock->stats.spins);
+        stats->sleeps = load(spinlock->stats.sleeps);
+        stats->wait_ns = load(spinlock->stats.wait_ns);
         return true;
-}
\ No newline at end of file
+}
@@ -16,6 +16,8 @@
  */
 
 #include <inttypes.h>
+#include <pthread.h>
+#include <unistd.h>
 
 #include "core/oid/oid.h"
 #include "core/encode/encode_async.h"
@@ -27,12 +29,23 @@
 #include "err.h"
 #include "core/carbon/archive.h"
 #include "core/encode/encode_sync.h"
+#include "core/alloc/arena.h"
+#include "core/alloc/pool.h"
+#include "core/alloc/prof.h"
 #include "shared/common.h"
 #include "core/mem/block.h"
 #include "core/mem/file.h"
 #include "coding/coding_huffman.h"
+#include "std/sort.h"
 #include "core/carbon/archive.h"
 
+/** below this number of values in the columns of an object's arrays of objects, these columns are serialized in
+ * place rather than concurrently (see 'write_columns_parallel') */
+#define NG5_ARCHIVE_PARALLEL_MIN        (1 << 12)
+
+/** number of entries of a column whose values are inspected to choose the encoding of the column */
+#define NG5_ARCHIVE_ENCODING_SAMPLE_ENTRIES 64
+
 #define WRITE_PRIMITIVE_VALUES(memfile, values_vec, type)                                                              \
 {                                                                                                                      \
     type *values = vec_all(values_vec, type);                                                                \
@@ -50,12 +63,16 @@
 #define PRINT_SIMPLE_PROPS(file, memfile, offset, nesting_level, value_type, type_string, format_string)               \
 {                                                                                                                      \
     struct prop_header *prop_header = NG5_MEMFILE_READ_TYPE(memfile, struct prop_header);             \
-    field_sid_t *keys = (field_sid_t *) NG5_MEMFILE_READ(memfile, prop_header->num_entries *          \
-                                   sizeof(field_sid_t));                                                        \
-    value_type *values = (value_type *) NG5_MEMFILE_READ(memfile, prop_header->num_entries * sizeof(value_type));   \
+    const field_sid_t *keys = int_read_keys(cache, memfile, prop_header->num_entries);                                 \
+    void *decoded;                                                                                                     \
+    const value_type *values = (const value_type *) int_read_values(&decoded, memfile, prop_header->encoding,          \
+                                   int_marker_to_field_type(prop_header->marker), sizeof(value_type),                  \
+                                   prop_header->num_entries);                                                          \
     fprintf(file, "0x%04x ", (unsigned) offset);                                                                       \
     INTENT_LINE(nesting_level)                                                                                         \
-    fprintf(file, "[marker: %c (" type_string ")] [num_entries: %d] [", entryMarker, prop_header->num_entries);        \
+    fprintf(file, "[marker: %c (" type_string ")] [num_entries: %d] [encoding: %s] [", entryMarker,                    \
+            prop_header->num_entries, int_encoding_str(prop_header->encoding,                                          \
+            int_marker_to_field_type(prop_header->marker)));                                                           \
     for (u32 i = 0; i < prop_header->num_entries; i++) {                                                          \
         fprintf(file, "key: %"PRIu64"%s", keys[i], i + 1 < prop_header->num_entries ? ", " : "");                      \
     }                                                                                                                  \
@@ -64,41 +81,49 @@
       fprintf(file, "value: "format_string"%s", values[i], i + 1 < prop_header->num_entries ? ", " : "");              \
     }                                                                                                                  \
     fprintf(file, "]\n");                                                                                              \
+    free(decoded);                                                                                                     \
 }
 
 #define PRINT_ARRAY_PROPS(memfile, offset, nesting_level, entryMarker, type, type_string, format_string)               \
 {                                                                                                                      \
     struct prop_header *prop_header = NG5_MEMFILE_READ_TYPE(memfile, struct prop_header);             \
                                                                                                                        \
-    field_sid_t *keys = (field_sid_t *) NG5_MEMFILE_READ(memfile, prop_header->num_entries *          \
-                                        sizeof(field_sid_t));                                                   \
+    const field_sid_t *keys = int_read_keys(cache, memfile, prop_header->num_entries);                                 \
     u32 *array_lengths;                                                                                           \
                                                                                                                        \
     fprintf(file, "0x%04x ", (unsigned) offset);                                                                       \
     INTENT_LINE(nesting_level)                                                                                         \
-    fprintf(file, "[marker: %c ("type_string")] [num_entries: %d] [", entryMarker, prop_header->num_entries);          \
+    fprintf(file, "[marker: %c ("type_string")] [num_entries: %d] [encoding: %s] [", entryMarker,                      \
+            prop_header->num_entries, int_encoding_str(prop_header->encoding,                                          \
+            int_marker_to_field_type(prop_header->marker)));                                                           \
                                                                                                                        \
     for (u32 i = 0; i < prop_header->num_entries; i++) {                                                          \
         fprintf(file, "key: %"PRIu64"%s", keys[i], i + 1 < prop_header->num_entries ? ", " : "");                      \
     }                                                                                                                  \
     fprintf(file, "] [");                                                                                              \
                                                                                                                        \
-    array_lengths = (u32 *) NG5_MEMFILE_READ(memfile, prop_header->num_entries * sizeof(u32));            \
+    array_lengths = (u32 *) int_read_lengths(cache, memfile, prop_header->num_entries);                             \
                                                                                                                        \
+    u32 num_values = 0;                                                                                                \
     for (u32 i = 0; i < prop_header->num_entries; i++) {                                                          \
         fprintf(file, "num_entries: %d%s", array_lengths[i], i + 1 < prop_header->num_entries ? ", " : "");            \
+        num_values += array_lengths[i];                                                                                \
     }                                                                                                                  \
                                                                                                                        \
     fprintf(file, "] [");                                                                                              \
                                                                                                                        \
+    void *decoded;                                                                                                     \
+    const type *values = (const type *) int_read_values(&decoded, memfile, prop_header->encoding,                      \
+                                   int_marker_to_field_type(prop_header->marker), sizeof(type), num_values);           \
     for (u32 array_idx = 0; array_idx < prop_header->num_entries; array_idx++) {                                  \
-        type *values = (type *) NG5_MEMFILE_READ(memfile, array_lengths[array_idx] * sizeof(type));                 \
         fprintf(file, "[");                                                                                            \
         for (u32 i = 0; i < array_lengths[array_idx]; i++) {                                                      \
             fprintf(file, "value: "format_string"%s", values[i], i + 1 < array_lengths[array_idx] ? ", " : "");        \
         }                                                                                                              \
+        values += array_lengths[array_idx];                                                                            \
         fprintf(file, "]%s", array_idx + 1 < prop_header->num_entries ? ", " : "");                                    \
     }                                                                                                                  \
+    free(decoded);                                                                                                     \
                                                                                                                        \
     fprintf(file, "]\n");                                                                                              \
 }
@@ -110,10 +135,18 @@
     }                                                                                                                  \
 }
 
-#define PRINT_VALUE_ARRAY(type, memfile, header, format_string)                                                        \
+#define PRINT_VALUE_ARRAY(type, memfile, header, column_values, format_string)                                         \
 {                                                                                                                      \
-    u32 num_elements = *NG5_MEMFILE_READ_TYPE(memfile, u32);                                              \
-    const type *values = (const type *) NG5_MEMFILE_READ(memfile, num_elements * sizeof(type));                     \
+    u32 num_elements = *NG5_MEMFILE_READ_TYPE(memfile, u32);                                                           \
+    void *decoded = NULL;                                                                                              \
+    const type *values;                                                                                                \
+    if (column_values) {                                                                                               \
+        values = (const type *) column_values;                                                                         \
+        column_values += num_elements * sizeof(type);                                                                  \
+    } else {                                                                                                           \
+        values = (const type *) int_read_values(&decoded, memfile, header->encoding,                                   \
+                                   int_marker_to_field_type(header->value_type), sizeof(type), num_elements);          \
+    }                                                                                                                  \
     fprintf(file, "0x%04x ", (unsigned) offset);                                                                       \
     INTENT_LINE(nesting_level);                                                                                        \
     fprintf(file, "   [num_elements: %d] [values: [", num_elements);                                                   \
@@ -121,23 +154,101 @@
         fprintf(file, "value: "format_string"%s", values[i], i + 1 < num_elements ? ", " : "");                        \
     }                                                                                                                  \
     fprintf(file, "]\n");                                                                                              \
+    free(decoded);                                                                                                     \
 }
 
+/**
+ * Collects the row-group directory of the top-level collections while the record table is written (see
+ * 'row_group_directory_header'). Objects in columns are written with no writer, since their arrays of objects are not
+ * cut into row groups.
+ */
+struct row_group_writer {
+        u64 row_group_size;
+        u32 num_collections;
+        struct memblock *block;
+        struct memfile memfile;
+};
+
 static offset_t skip_record_header(struct memfile *memfile);
+static void write_padding(struct memfile *memfile, bool aligned, size_t alignment, size_t header_size);
 static void update_record_header(struct memfile *memfile, offset_t root_object_header_offset, struct columndoc *model,
-        u64 record_size);
+        bool aligned, u64 record_size);
 static bool __serialize(offset_t *offset, struct err *err, struct memfile *memfile, struct columndoc_obj *columndoc,
-        offset_t root_object_header_offset);
+        offset_t root_object_header_offset, struct vector ofType(offset_t) *relocs, bool aligned,
+        struct row_group_writer *row_groups);
 static union object_flags *get_flags(union object_flags *flags, struct columndoc_obj *columndoc);
-static void update_file_header(struct memfile *memfile, offset_t root_object_header_offset);
+static void update_file_header(struct memfile *memfile, offset_t root_object_header_offset,
+        offset_t row_group_directory_offset);
+static offset_t write_row_group_directory(struct memfile *memfile, struct row_group_writer *row_groups);
 static void skip_file_header(struct memfile *memfile);
-static bool serialize_string_dic(struct memfile *memfile, struct err *err, const struct doc_bulk *context,
-        enum packer_type compressor);
+
+/**
+ * Maps a string id of the dictionary to its compact id, i.e., to 'base' plus the position of its string in the string
+ * table, which is sorted by string id. Hence, the mapping preserves the order of string ids (such that sorted key
+ * columns remain sorted). The null string id is mapped to itself; if it is not a string id of the dictionary, compact
+ * ids start at 1.
+ */
+struct compact_sids {
+        field_sid_t *sorted;
+        size_t num_sids;
+        field_sid_t base;
+};
+
+static bool serialize_string_dic(struct memfile *memfile, struct err *err, struct compact_sids *map,
+        const struct doc_bulk *context, enum packer_type compressor);
+static void compact_object_sids(struct columndoc_obj *columndoc, const struct compact_sids *map);
 static bool print_archive_from_memfile(FILE *file, struct err *err, struct memfile *memfile);
 
+static bool write_and_open_archive(struct archive *out, const char *file, struct err *err, struct memblock *stream,
+        struct archive_callback *callback)
+{
+        FILE *out_file;
+
+        ng5_optional_call(callback, begin_write_archive_file_to_disk);
+
+        if ((out_file = fopen(file, "w")) == NULL) {
+                error(err, NG5_ERR_FOPENWRITE);
+                memblock_drop(stream);
+                return false;
+        }
+
+        if (!archive_write(out_file, stream)) {
+                error(err, NG5_ERR_WRITEARCHIVE);
+                fclose(out_file);
+                memblock_drop(stream);
+                return false;
+        }
+
+        fclose(out_file);
+
+        ng5_optional_call(callback, end_write_archive_file_to_disk);
+
+        ng5_optional_call(callback, begin_load_archive);
+
+        if (!archive_open(out, file)) {
+                error(err, NG5_ERR_ARCHIVEOPEN);
+                return false;
+        }
+
+        ng5_optional_call(callback, end_load_archive);
+
+        memblock_drop(stream);
+
+        return true;
+}
+
 NG5_EXPORT(bool) archive_from_json(struct archive *out, const char *file, struct err *err, const char *json_string,
         enum packer_type compressor, enum strdic_tag dictionary, size_t num_async_dic_threads, bool read_optimized,
         bool bake_string_id_index, struct archive_callback *callback)
+{
+        return archive_from_json_parallel(out, file, err, json_string, 1, compressor, dictionary,
+                num_async_dic_threads, read_optimized, false, 0, bake_string_id_index, callback);
+}
+
+NG5_EXPORT(bool) archive_from_json_parallel(struct archive *out, const char *file, struct err *err,
+        const char *json_string, size_t num_import_threads, enum packer_type compressor, enum strdic_tag dictionary,
+        size_t num_async_dic_threads, bool read_optimized, bool aligned, u64 row_group_size, bool bake_string_id_index,
+        struct archive_callback *callback)
 {
         error_if_null(out);
         error_if_null(file);
@@ -147,58 +258,276 @@ NG5_EXPORT(bool) archive_from_json(struct archive *out, const char *file, struct
         ng5_optional_call(callback, begin_create_from_json);
 
         struct memblock *stream;
-        FILE *out_file;
 
-        if (!archive_stream_from_json(&stream,
+        if (!archive_stream_from_json_parallel(&stream,
                 err,
                 json_string,
+                num_import_threads,
                 compressor,
                 dictionary,
                 num_async_dic_threads,
                 read_optimized,
+                aligned,
+                row_group_size,
                 bake_string_id_index,
                 callback)) {
                 return false;
         }
 
-        ng5_optional_call(callback, begin_write_archive_file_to_disk);
+        if (!write_and_open_archive(out, file, err, stream, callback)) {
+                return false;
+        }
 
-        if ((out_file = fopen(file, "w")) == NULL) {
-                error(err, NG5_ERR_FOPENWRITE);
-                memblock_drop(stream);
+        ng5_optional_call(callback, end_create_from_json);
+
+        return true;
+}
+
+NG5_EXPORT(bool) archive_from_ndjson(struct archive *out, const char *file, struct err *err, FILE *ndjson,
+        size_t batch_size, enum packer_type compressor, enum strdic_tag dictionary, size_t num_async_dic_threads,
+        bool read_optimized, bool aligned, u64 row_group_size, bool bake_string_id_index,
+        struct archive_callback *callback)
+{
+        error_if_null(out);
+        error_if_null(file);
+        error_if_null(err);
+        error_if_null(ndjson);
+
+        ng5_optional_call(callback, begin_create_from_json);
+
+        struct memblock *stream;
+
+        if (!archive_stream_from_ndjson(&stream, err, ndjson, batch_size, compressor, dictionary,
+                num_async_dic_threads, read_optimized, aligned, row_group_size, bake_string_id_index,
+                callback)) {
                 return false;
         }
 
-        if (!archive_write(out_file, stream)) {
-                error(err, NG5_ERR_WRITEARCHIVE);
-                fclose(out_file);
-                memblock_drop(stream);
+        if (!write_and_open_archive(out, file, err, stream, callback)) {
                 return false;
         }
 
-        fclose(out_file);
+        ng5_optional_call(callback, end_create_from_json);
 
-        ng5_optional_call(callback, end_write_archive_file_to_disk);
+        return true;
+}
 
-        ng5_optional_call(callback, begin_load_archive);
+static bool stream_setup(struct strdic *dic, struct doc_bulk *bulk, struct doc_entries **partition,
+        struct err *err, enum strdic_tag dictionary, size_t num_async_dic_threads, struct archive_callback *callback)
+{
+        /** the dictionary is filled (and its results are freed) by several threads, see pool.h */
+        struct allocator pool, dic_alloc;
+        pool_alloc_create(&pool);
+        prof_alloc_wrap(&dic_alloc, &pool, "strdic");
 
-        if (!archive_open(out, file)) {
-                error(err, NG5_ERR_ARCHIVEOPEN);
+        ng5_optional_call(callback, begin_setup_string_dictionary);
+        if (dictionary == SYNC) {
+                encode_sync_create(dic, 1000, 1000, 1000, 0, &dic_alloc);
+        } else if (dictionary == ASYNC) {
+                encode_async_create(dic, 1000, 1000, 1000, num_async_dic_threads, &dic_alloc);
+        } else {
+                error(err, NG5_ERR_UNKNOWN_DIC_TYPE);
                 return false;
         }
 
-        ng5_optional_call(callback, end_load_archive);
+        ng5_optional_call(callback, end_setup_string_dictionary);
 
-        memblock_drop(stream);
+        /** all records of the bulk live in one arena, which is dropped together with the bulk */
+        struct allocator arena;
+        if (!arena_alloc_create(&arena, 0)) {
+                strdic_drop(dic);
+                error(err, NG5_ERR_BULKCREATEFAILED);
+                return false;
+        }
+        if (!doc_bulk_create(bulk, dic, &arena)) {
+                arena_alloc_drop(&arena);
+                strdic_drop(dic);
+                error(err, NG5_ERR_BULKCREATEFAILED);
+                return false;
+        }
+        *partition = doc_bulk_new_entries(bulk);
+        return true;
+}
 
-        ng5_optional_call(callback, end_create_from_json);
+/** releases everything set up by 'stream_setup' */
+static void stream_drop(struct strdic *dic, struct doc_bulk *bulk, struct doc_entries *partition)
+{
+        strdic_drop(dic);
+        doc_bulk_Drop(bulk);
+        arena_alloc_drop(&bulk->alloc);
+        doc_entries_drop(partition);
+}
+
+static bool stream_finalize(struct memblock **stream, struct err *err, struct strdic *dic, struct doc_bulk *bulk,
+        struct doc_entries *partition, enum packer_type compressor, bool read_optimized, bool aligned,
+        u64 row_group_size, bool bake_id_index, struct archive_callback *callback)
+{
+        struct columndoc *columndoc;
+        struct allocator pool, columndoc_alloc;
+
+        ng5_optional_call(callback, begin_import_json);
+        doc_bulk_shrink(bulk);
+
+        /** the columnar representation outlives the bulk's arena */
+        pool_alloc_create(&pool);
+        prof_alloc_wrap(&columndoc_alloc, &pool, "columndoc");
+        columndoc = doc_entries_columndoc(bulk, partition, read_optimized, &columndoc_alloc);
+
+        if (!archive_from_model(stream, err, columndoc, compressor, aligned, row_group_size, bake_id_index,
+                callback)) {
+                stream_drop(dic, bulk, partition);
+                columndoc_free(columndoc);
+                free(columndoc);
+                return false;
+        }
+
+        ng5_optional_call(callback, end_import_json);
+
+        ng5_optional_call(callback, begin_cleanup);
+        stream_drop(dic, bulk, partition);
+        columndoc_free(columndoc);
+        free(columndoc);
+        ng5_optional_call(callback, end_cleanup);
 
         return true;
 }
 
+static void set_json_parse_error(struct err *err, const struct json_parser *parser,
+        const struct json_err *error_desc, const char *prefix)
+{
+        char buffer[2048];
+        if (error_desc->token) {
+                snprintf(buffer, sizeof(buffer),
+                        "%s%s. Token %s was found in line %u column %u",
+                        prefix,
+                        error_desc->msg,
+                        error_desc->token_type_str,
+                        error_desc->token->line,
+                        error_desc->token->column);
+        } else {
+                snprintf(buffer, sizeof(buffer), "%s%s", prefix, error_desc->msg);
+        }
+        error_with_details(err, parser->err.code, &buffer[0]);
+}
+
 NG5_EXPORT(bool) archive_stream_from_json(struct memblock **stream, struct err *err, const char *json_string,
         enum packer_type compressor, enum strdic_tag dictionary, size_t num_async_dic_threads, bool read_optimized,
         bool bake_id_index, struct archive_callback *callback)
+{
+        return archive_stream_from_json_parallel(stream, err, json_string, 1, compressor, dictionary,
+                num_async_dic_threads, read_optimized, false, 0, bake_id_index, callback);
+}
+
+struct json_import_task {
+        const char *input;
+        struct json_record_range range;
+        struct doc_bulk bulk;
+        struct doc_entries *partition;
+        struct json_parser parser;
+        struct json_err error_desc;
+        pthread_t thread;
+        bool is_threaded;
+        bool status;
+};
+
+static void *json_import_task_run(void *args)
+{
+        ng5_cast(struct json_import_task *, task, args);
+        json_parser_create(&task->parser, &task->bulk);
+        task->status = json_parse_records_to_doc(&task->error_desc, &task->parser, task->partition, task->input,
+                &task->range) && doc_bulk_encode_strings(&task->bulk);
+        return NULL;
+}
+
+static void json_import_tasks_drop(struct json_import_task *tasks, size_t num_tasks)
+{
+        for (size_t i = 0; i < num_tasks; i++) {
+                doc_bulk_Drop(&tasks[i].bulk);
+                arena_alloc_drop(&tasks[i].bulk.alloc);
+        }
+        free(tasks);
+}
+
+/**
+ * Imports the records of each range into a partition of its own that is owned by a doc bulk (and an arena) of its
+ * own, such that ranges are parsed and imported concurrently (one range on this thread, one additional thread per
+ * further range) without contending on the global allocator.
+ * All bulks share the string dictionary of 'bulk', into which each task inserts its strings once it is done. The
+ * records are then moved in input order into 'partition', from which one columndoc is built. The bulks of the tasks
+ * still own all strings and must outlive that columndoc.
+ */
+static bool json_import_parallel(struct json_import_task **out, struct err *err, struct doc_bulk *bulk,
+        struct doc_entries *partition, const char *json_string, const struct json_record_range *ranges,
+        size_t num_ranges)
+{
+        struct json_import_task *tasks = malloc(num_ranges * sizeof(struct json_import_task));
+        bool status = true;
+
+        if (unlikely(!tasks)) {
+                error(err, NG5_ERR_MALLOCERR);
+                return false;
+        }
+
+        for (size_t i = 0; i < num_ranges; i++) {
+                struct json_import_task *task = tasks + i;
+                struct allocator arena;
+                task->input = json_string;
+                task->range = ranges[i];
+                task->is_threaded = false;
+                if (unlikely(!arena_alloc_create(&arena, 0))) {
+                        json_import_tasks_drop(tasks, i);
+                        error(err, NG5_ERR_BULKCREATEFAILED);
+                        return false;
+                }
+                if (unlikely(!doc_bulk_create(&task->bulk, bulk->dic, &arena))) {
+                        arena_alloc_drop(&arena);
+                        json_import_tasks_drop(tasks, i);
+                        error(err, NG5_ERR_BULKCREATEFAILED);
+                        return false;
+                }
+                task->partition = doc_bulk_new_entries(&task->bulk);
+        }
+
+        /** ranges whose thread cannot be started are imported on this thread, as is the first range */
+        for (size_t i = 1; i < num_ranges; i++) {
+                tasks[i].is_threaded = pthread_create(&tasks[i].thread, NULL, json_import_task_run, tasks + i) == 0;
+        }
+        for (size_t i = 0; i < num_ranges; i++) {
+                if (!tasks[i].is_threaded) {
+                        json_import_task_run(tasks + i);
+                }
+        }
+        for (size_t i = 1; i < num_ranges; i++) {
+                if (tasks[i].is_threaded) {
+                        pthread_join(tasks[i].thread, NULL);
+                }
+        }
+
+        for (size_t i = 0; status && i < num_ranges; i++) {
+                struct json_import_task *task = tasks + i;
+                if (!task->status) {
+                        set_json_parse_error(err, &task->parser, &task->error_desc, "");
+                        status = false;
+                } else {
+                        /** records are moved by value; the task partition must not drop them anymore */
+                        struct vector ofType(struct doc_obj) *records = &task->partition->values;
+                        vec_push(&partition->values, vec_all(records, struct doc_obj), vec_length(records));
+                        records->num_elems = 0;
+                }
+        }
+
+        if (!status) {
+                json_import_tasks_drop(tasks, num_ranges);
+                return false;
+        }
+        *out = tasks;
+        return true;
+}
+
+NG5_EXPORT(bool) archive_stream_from_json_parallel(struct memblock **stream, struct err *err,
+        const char *json_string, size_t num_import_threads, enum packer_type compressor, enum strdic_tag dictionary,
+        size_t num_async_dic_threads, bool read_optimized, bool aligned, u64 row_group_size, bool bake_id_index,
+        struct archive_callback *callback)
 {
         error_if_null(stream);
         error_if_null(err);
@@ -209,76 +538,167 @@ NG5_EXPORT(bool) archive_stream_from_json(struct memblock **stream, struct err *
         struct json_err error_desc;
         struct doc_bulk bulk;
         struct doc_entries *partition;
-        struct columndoc *columndoc;
-        struct json json;
+        struct json_import_task *tasks = NULL;
+        struct json_record_range *ranges = NULL;
+        size_t num_ranges = 0;
 
         ng5_optional_call(callback, begin_archive_stream_from_json)
 
-        ng5_optional_call(callback, begin_setup_string_dictionary);
-        if (dictionary == SYNC) {
-                encode_sync_create(&dic, 1000, 1000, 1000, 0, NULL);
-        } else if (dictionary == ASYNC) {
-                encode_async_create(&dic, 1000, 1000, 1000, num_async_dic_threads, NULL);
-        } else {
-                error(err, NG5_ERR_UNKNOWN_DIC_TYPE);
+        if (!stream_setup(&dic, &bulk, &partition, err, dictionary, num_async_dic_threads, callback)) {
+                return false;
         }
 
-        ng5_optional_call(callback, end_setup_string_dictionary);
-
+        /** document restrictions are tested while parsing, and parsing imports directly into the partition */
         ng5_optional_call(callback, begin_parse_json);
-        json_parser_create(&parser, &bulk);
-        if (!(json_parse(&json, &error_desc, &parser, json_string))) {
-                char buffer[2048];
-                if (error_desc.token) {
-                        sprintf(buffer,
-                                "%s. Token %s was found in line %u column %u",
-                                error_desc.msg,
-                                error_desc.token_type_str,
-                                error_desc.token->line,
-                                error_desc.token->column);
-                        error_with_details(err, NG5_ERR_JSONPARSEERR, &buffer[0]);
-                } else {
-                        sprintf(buffer, "%s", error_desc.msg);
-                        error_with_details(err, NG5_ERR_JSONPARSEERR, &buffer[0]);
+        /** if the ranges cannot be allocated, the input is imported on this thread */
+        if (num_import_threads > 1 && (ranges = malloc(num_import_threads * sizeof(struct json_record_range)))) {
+                num_ranges = json_split_records(ranges, num_import_threads, json_string);
+        }
+        if (num_ranges > 1) {
+                bool imported = json_import_parallel(&tasks, err, &bulk, partition, json_string, ranges, num_ranges);
+                free(ranges);
+                if (!imported) {
+                        stream_drop(&dic, &bulk, partition);
+                        return false;
+                }
+        } else {
+                free(ranges);
+                json_parser_create(&parser, &bulk);
+                if (!(json_parse_to_doc(NULL, &error_desc, &parser, partition, json_string))) {
+                        set_json_parse_error(err, &parser, &error_desc, "");
+                        stream_drop(&dic, &bulk, partition);
+                        return false;
                 }
-                return false;
         }
         ng5_optional_call(callback, end_parse_json);
 
-        ng5_optional_call(callback, begin_test_json);
-        if (!json_test(err, &json)) {
+        /** the bulks of the tasks own strings of the columndoc, and are dropped after 'stream_finalize' dropped it */
+        bool status = stream_finalize(stream, err, &dic, &bulk, partition, compressor, read_optimized, aligned,
+                row_group_size, bake_id_index, callback);
+        if (tasks) {
+                json_import_tasks_drop(tasks, num_ranges);
+        }
+        if (!status) {
                 return false;
         }
-        ng5_optional_call(callback, end_test_json);
 
-        ng5_optional_call(callback, begin_import_json);
-        if (!doc_bulk_create(&bulk, &dic)) {
-                error(err, NG5_ERR_BULKCREATEFAILED);
+        ng5_optional_call(callback, end_archive_stream_from_json)
+
+        return true;
+}
+
+/**
+ * Reads 'ndjson' chunk-wise into a line buffer, and imports each non-empty line as one record into 'partition'.
+ * Only the current chunk plus the remainder of an incomplete line are held in memory; the buffer grows only if a
+ * single line does not fit into it. After each 'batch_size' records, the strings seen so far are inserted into
+ * the string dictionary.
+ */
+static bool ndjson_import(struct err *err, struct json_parser *parser, struct doc_bulk *bulk,
+        struct doc_entries *partition, FILE *ndjson, size_t batch_size)
+{
+        struct json_err error_desc;
+        size_t capacity = NG5_NDJSON_CHUNK_SIZE;
+        size_t num_buffered = 0, num_records = 0, line_no = 0;
+        char *buffer = malloc(capacity + 1);
+        bool eof = false, status = true;
+
+        if (unlikely(!buffer)) {
+                error(err, NG5_ERR_MALLOCERR);
                 return false;
         }
 
-        partition = doc_bulk_new_entries(&bulk);
-        doc_bulk_add_json(partition, &json);
+        while (status && !eof) {
+                size_t num_read = fread(buffer + num_buffered, 1, capacity - num_buffered, ndjson);
+                num_buffered += num_read;
+                eof = num_read == 0;
+                if (unlikely(eof && ferror(ndjson))) {
+                        error(err, NG5_ERR_FREAD_FAILED);
+                        status = false;
+                        break;
+                }
 
-        json_drop(&json);
+                char *line = buffer, *end = buffer + num_buffered;
+                char *newline = NULL;
+                while (status && line < end && ((newline = memchr(line, '\n', end - line)) || eof)) {
+                        char *line_end = newline ? newline : end;
+                        *line_end = '\0';
+                        line_no++;
+                        /** blank lines are skipped, everything else must be exactly one JSON object */
+                        char *begin = line + strspn(line, " \t\r");
+                        if (begin != line_end) {
+                                if (unlikely(*begin != '{')) {
+                                        char details[64];
+                                        snprintf(details, sizeof(details), "In line %zu of input: Expected a JSON "
+                                                "object", line_no);
+                                        error_with_details(err, NG5_ERR_JSONPARSEERR, details);
+                                        status = false;
+                                } else if (!json_parse_to_doc(NULL, &error_desc, parser, partition, line)) {
+                                        char prefix[64];
+                                        snprintf(prefix, sizeof(prefix), "In line %zu of input: ", line_no);
+                                        set_json_parse_error(err, parser, &error_desc, prefix);
+                                        status = false;
+                                } else if (++num_records % batch_size == 0) {
+                                        doc_bulk_encode_strings(bulk);
+                                }
+                        }
+                        line = line_end + 1;
+                }
 
-        doc_bulk_shrink(&bulk);
+                /** move the incomplete last line to the front, and grow the buffer if it occupies it entirely */
+                num_buffered = line < end ? (size_t) (end - line) : 0;
+                memmove(buffer, line, num_buffered);
+                if (num_buffered == capacity) {
+                        capacity *= 2;
+                        char *grown = realloc(buffer, capacity + 1);
+                        if (!grown) {
+                                error(err, NG5_ERR_REALLOCERR);
+                                status = false;
+                        } else {
+                                buffer = grown;
+                        }
+                }
+        }
 
-        columndoc = doc_entries_columndoc(&bulk, partition, read_optimized);
+        free(buffer);
+        return status;
+}
 
-        if (!archive_from_model(stream, err, columndoc, compressor, bake_id_index, callback)) {
+NG5_EXPORT(bool) archive_stream_from_ndjson(struct memblock **stream, struct err *err, FILE *ndjson,
+        size_t batch_size, enum packer_type compressor, enum strdic_tag dictionary, size_t num_async_dic_threads,
+        bool read_optimized, bool aligned, u64 row_group_size, bool bake_id_index, struct archive_callback *callback)
+{
+        error_if_null(stream);
+        error_if_null(err);
+        error_if_null(ndjson);
+
+        struct strdic dic;
+        struct json_parser parser;
+        struct doc_bulk bulk;
+        struct doc_entries *partition;
+
+        ng5_optional_call(callback, begin_archive_stream_from_json)
+
+        if (!stream_setup(&dic, &bulk, &partition, err, dictionary, num_async_dic_threads, callback)) {
                 return false;
         }
 
-        ng5_optional_call(callback, end_import_json);
+        ng5_optional_call(callback, begin_parse_json);
+        json_parser_create(&parser, &bulk);
+        if (!ndjson_import(err, &parser, &bulk, partition, ndjson, ng5_max(1, batch_size))) {
+                stream_drop(&dic, &bulk, partition);
+                return false;
+        }
+        if (unlikely(vec_length(&partition->values) == 0)) {
+                error_with_details(err, NG5_ERR_JSONPARSEERR, "Input does not contain any record");
+                stream_drop(&dic, &bulk, partition);
+                return false;
+        }
+        ng5_optional_call(callback, end_parse_json);
 
-        ng5_optional_call(callback, begin_cleanup);
-        strdic_drop(&dic);
-        doc_bulk_Drop(&bulk);
-        doc_entries_drop(partition);
-        columndoc_free(columndoc);
-        free(columndoc);
-        ng5_optional_call(callback, end_cleanup);
+        if (!stream_finalize(stream, err, &dic, &bulk, partition, compressor, read_optimized, aligned,
+                row_group_size, bake_id_index, callback)) {
+                return false;
+        }
 
         ng5_optional_call(callback, end_archive_stream_from_json)
 
@@ -362,7 +782,7 @@ static bool run_string_id_baking(struct err *err, struct memblock **stream)
 }
 
 bool archive_from_model(struct memblock **stream, struct err *err, struct columndoc *model, enum packer_type compressor,
-        bool bake_string_id_index, struct archive_callback *callback)
+        bool aligned, u64 row_group_size, bool bake_string_id_index, struct archive_callback *callback)
 {
         error_if_null(model)
         error_if_null(stream)
@@ -376,20 +796,33 @@ bool archive_from_model(struct memblock **stream, struct err *err, struct column
 
         ng5_optional_call(callback, begin_write_string_table);
         skip_file_header(&memfile);
-        if (!serialize_string_dic(&memfile, err, model->bulk, compressor)) {
+        struct compact_sids compact_sids;
+        if (!serialize_string_dic(&memfile, err, &compact_sids, model->bulk, compressor)) {
                 return false;
         }
         ng5_optional_call(callback, end_write_string_table);
 
         ng5_optional_call(callback, begin_write_record_table);
+        compact_object_sids(&model->columndoc, &compact_sids);
+        free(compact_sids.sorted);
+        /** the record table (i.e., the root object that follows the record header) starts at a cache line */
+        write_padding(&memfile, aligned, NG5_ARCHIVE_CACHE_LINE, sizeof(struct record_header));
         offset_t record_header_offset = skip_record_header(&memfile);
-        update_file_header(&memfile, record_header_offset);
         offset_t root_object_header_offset = memfile_tell(&memfile);
-        if (!__serialize(NULL, err, &memfile, &model->columndoc, root_object_header_offset)) {
+        struct row_group_writer row_groups = {.row_group_size = row_group_size, .num_collections = 0};
+        memblock_create(&row_groups.block, 1024);
+        memfile_open(&row_groups.memfile, row_groups.block, READ_WRITE);
+        if (!__serialize(NULL, err, &memfile, &model->columndoc, root_object_header_offset, NULL, aligned,
+                row_group_size ? &row_groups : NULL)) {
+                memblock_drop(row_groups.block);
                 return false;
         }
         u64 record_size = memfile_tell(&memfile) - (record_header_offset + sizeof(struct record_header));
-        update_record_header(&memfile, record_header_offset, model, record_size);
+        update_record_header(&memfile, record_header_offset, model, aligned, record_size);
+        /** the row-group directory follows the record table */
+        offset_t row_group_directory_offset = write_row_group_directory(&memfile, &row_groups);
+        memblock_drop(row_groups.block);
+        update_file_header(&memfile, record_header_offset, row_group_directory_offset);
         ng5_optional_call(callback, end_write_record_table);
 
         memfile_shrink(&memfile);
@@ -451,7 +884,8 @@ bool archive_print(FILE *file, struct err *err, struct memblock *stream)
         }
 }
 
-bool print_object(FILE *file, struct err *err, struct memfile *memfile, unsigned nesting_level);
+bool print_object(FILE *file, struct err *err, struct memfile *memfile, struct decode_cache *cache,
+        unsigned nesting_level);
 
 static u32 flags_to_int32(union object_flags *flags)
 {
@@ -494,10 +928,33 @@ static const char *array_value_type_to_string(struct err *err, field_e type)
         }
 }
 
-static void write_primitive_key_column(struct memfile *memfile, struct vector ofType(field_sid_t) *keys)
+/**
+ * writes zero bytes such that the 'header_size' bytes that are written next end at a multiple of 'alignment', if the
+ * record table is 'aligned' (see 'record_flags')
+ */
+static void write_padding(struct memfile *memfile, bool aligned, size_t alignment, size_t header_size)
 {
-        field_sid_t *string_ids = vec_all(keys, field_sid_t);
-        memfile_write(memfile, string_ids, keys->num_elems * sizeof(field_sid_t));
+        static const char zeros[NG5_ARCHIVE_CACHE_LINE] = {0};
+        if (aligned) {
+                offset_t pos = memfile_tell(memfile);
+                memfile_write(memfile, zeros, int_align_offset(pos + header_size, alignment) - header_size - pos);
+        }
+}
+
+/**
+ * writes the compact string ids in 'keys' (see 'compact_sids') as u32, such that the key column has 'sid32' layout;
+ * in aligned record tables, the keys are aligned to 4 bytes, and the column is padded to 8 bytes
+ */
+static void write_primitive_key_column(struct memfile *memfile, struct vector ofType(field_sid_t) *keys, bool aligned)
+{
+        write_padding(memfile, aligned, sizeof(u32), 0);
+        const field_sid_t *string_ids = vec_all(keys, field_sid_t);
+        u32 *compact_ids = (u32 *) memfile_current_pos(memfile, keys->num_elems * sizeof(u32));
+        for (u32 i = 0; i < keys->num_elems; i++) {
+                compact_ids[i] = string_ids[i];
+        }
+        memfile_skip(memfile, keys->num_elems * sizeof(u32));
+        write_padding(memfile, aligned, sizeof(u64), 0);
 }
 
 static offset_t skip_var_value_offset_column(struct memfile *memfile, size_t num_keys)
@@ -507,11 +964,25 @@ static offset_t skip_var_value_offset_column(struct memfile *memfile, size_t num
         return result;
 }
 
-static void write_var_value_offset_column(struct memfile *file, offset_t where, offset_t after, const offset_t *values,
+/** Writes 'n' offsets that are relative to the root object header and, if 'relocs' is non-null, remembers their
+ * positions such that they can be relocated once the memfile is appended to another one (see 'append_column') */
+static void write_offsets(struct memfile *memfile, struct vector ofType(offset_t) *relocs, const offset_t *values,
         size_t n)
+{
+        if (relocs) {
+                offset_t pos = memfile_tell(memfile);
+                for (size_t i = 0; i < n; i++, pos += sizeof(offset_t)) {
+                        vec_push(relocs, &pos, 1);
+                }
+        }
+        memfile_write(memfile, values, n * sizeof(offset_t));
+}
+
+static void write_var_value_offset_column(struct memfile *file, offset_t where, offset_t after, const offset_t *values,
+        size_t n, struct vector ofType(offset_t) *relocs)
 {
         memfile_seek(file, where);
-        memfile_write(file, values, n * sizeof(offset_t));
+        write_offsets(file, relocs, values, n);
         memfile_seek(file, after);
 }
 
@@ -552,14 +1023,15 @@ static bool write_primitive_fixed_value_column(struct memfile *memfile, struct e
 }
 
 static offset_t *__write_primitive_column(struct memfile *memfile, struct err *err,
-        struct vector ofType(struct columndoc_obj) *values_vec, offset_t root_offset)
+        struct vector ofType(struct columndoc_obj) *values_vec, offset_t root_offset,
+        struct vector ofType(offset_t) *relocs, bool aligned, struct row_group_writer *row_groups)
 {
         offset_t *result = malloc(values_vec->num_elems * sizeof(offset_t));
         struct columndoc_obj *mapped = vec_all(values_vec, struct columndoc_obj);
         for (u32 i = 0; i < values_vec->num_elems; i++) {
                 struct columndoc_obj *obj = mapped + i;
                 result[i] = memfile_tell(memfile) - root_offset;
-                if (!__serialize(NULL, err, memfile, obj, root_offset)) {
+                if (!__serialize(NULL, err, memfile, obj, root_offset, relocs, aligned, row_groups)) {
                         return NULL;
                 }
         }
@@ -634,9 +1106,58 @@ static bool write_array_value_column(struct memfile *memfile, struct err *err, f
         return true;
 }
 
+/**
+ * chooses the encoding of the 'num_values' values of 'type' in 'values', i.e., an 'enum intpack_type' for integers,
+ * booleans and strings, an 'enum floatpack_type' for floating-point numbers, and plain for any other type
+ */
+static u8 choose_encoding(const void *values, size_t num_values, field_e type)
+{
+        size_t width;
+        bool is_signed;
+        if (type == FIELD_FLOAT) {
+                size_t sizes[NG5_FLOATPACK_NUM_TYPES] = {0};
+                floatpack_estimate(sizes, values, num_values);
+                return floatpack_choose(sizes);
+        } else if (int_get_intpack_params(&width, &is_signed, type)) {
+                size_t sizes[NG5_INTPACK_NUM_TYPES] = {0};
+                intpack_estimate(sizes, values, num_values, width, is_signed);
+                return intpack_choose(sizes);
+        }
+        return INTPACK_PLAIN;
+}
+
+/** writes the 'num_values' values of 'type' in 'values' with an 'encoding' that is chosen by 'choose_encoding' */
+static bool write_encoded_values(struct memfile *memfile, u8 encoding, const void *values, size_t num_values,
+        field_e type)
+{
+        size_t width;
+        bool is_signed;
+        if (type == FIELD_FLOAT) {
+                return floatpack_encode(memfile, encoding, values, num_values);
+        }
+        int_get_intpack_params(&width, &is_signed, type);
+        return intpack_encode(memfile, encoding, values, num_values, width, is_signed);
+}
+
+/** concatenates the values of all arrays in 'values_vec' into one run of values of 'width' bytes each */
+static void *concat_array_values(size_t *num_values, struct vector ofType(...) *values_vec, size_t width)
+{
+        *num_values = 0;
+        const struct vector ofType(T) *nested_values = vec_all(values_vec, struct vector);
+        for (u32 i = 0; i < values_vec->num_elems; i++) {
+                *num_values += nested_values[i].num_elems;
+        }
+        char *run = malloc(ng5_max(*num_values * width, 1u)), *pos = run;
+        for (u32 i = 0; i < values_vec->num_elems; i++) {
+                memcpy(pos, nested_values[i].base, nested_values[i].num_elems * width);
+                pos += nested_values[i].num_elems * width;
+        }
+        return run;
+}
+
 static bool write_array_prop(offset_t *offset, struct err *err, struct memfile *memfile,
         struct vector ofType(field_sid_t) *keys, field_e type, struct vector ofType(...) *values,
-        offset_t root_object_header_offset)
+        offset_t root_object_header_offset, bool aligned)
 {
         assert(keys->num_elems == values->num_elems);
 
@@ -644,16 +1165,35 @@ static bool write_array_prop(offset_t *offset, struct err *err, struct memfile *
                 struct prop_header header =
                         {.marker = marker_symbols[value_array_marker_mapping[type].marker].symbol, .num_entries = keys
                                 ->num_elems};
+
+                size_t width, num_values = 0;
+                bool is_signed;
+                void *run = NULL;
+                if (type == FIELD_FLOAT || int_get_intpack_params(&width, &is_signed, type)) {
+                        run = concat_array_values(&num_values, values, GET_TYPE_SIZE(type));
+                        header.encoding = choose_encoding(run, num_values, type);
+                }
+
                 offset_t prop_ofOffset = memfile_tell(memfile);
                 memfile_write(memfile, &header, sizeof(struct prop_header));
 
-                write_primitive_key_column(memfile, keys);
+                write_primitive_key_column(memfile, keys, aligned);
                 if (!__write_array_len_column(err, memfile, type, values)) {
+                        free(run);
                         return false;
                 }
-                if (!write_array_value_column(memfile, err, type, values)) {
+                write_padding(memfile, aligned, sizeof(u64), 0);
+                if (header.encoding != INTPACK_PLAIN) {
+                        write_encoded_values(memfile, header.encoding, run, num_values, type);
+                } else if (!write_array_value_column(memfile, err, type, values)) {
+                        free(run);
                         return false;
                 }
+                if (type == FIELD_NULL) {
+                        /** null arrays store their lengths only, which are read as lengths (see 'int_read_lengths') */
+                        write_padding(memfile, aligned, sizeof(u64), 0);
+                }
+                free(run);
                 *offset = (prop_ofOffset - root_object_header_offset);
         } else {
                 *offset = 0;
@@ -662,114 +1202,126 @@ static bool write_array_prop(offset_t *offset, struct err *err, struct memfile *
 }
 
 static bool write_array_props(struct memfile *memfile, struct err *err, struct columndoc_obj *columndoc,
-        struct archive_prop_offs *offsets, offset_t root_object_header_offset)
+        struct archive_prop_offs *offsets, offset_t root_object_header_offset, bool aligned)
 {
         if (!write_array_prop(&offsets->null_arrays,
                 err,
                 memfile,
-                &columndoc->null_array_prop_keys,
+                columndoc->null_array_prop_keys,
                 FIELD_NULL,
-                &columndoc->null_array_prop_vals,
-                root_object_header_offset)) {
+                columndoc->null_array_prop_vals,
+                root_object_header_offset,
+                aligned)) {
                 return false;
         }
         if (!write_array_prop(&offsets->bool_arrays,
                 err,
                 memfile,
-                &columndoc->bool_array_prop_keys,
+                columndoc->bool_array_prop_keys,
                 FIELD_BOOLEAN,
-                &columndoc->bool_array_prop_vals,
-                root_object_header_offset)) {
+                columndoc->bool_array_prop_vals,
+                root_object_header_offset,
+                aligned)) {
                 return false;
         }
         if (!write_array_prop(&offsets->int8_arrays,
                 err,
                 memfile,
-                &columndoc->int8_array_prop_keys,
+                columndoc->int8_array_prop_keys,
                 FIELD_INT8,
-                &columndoc->int8_array_prop_vals,
-                root_object_header_offset)) {
+                columndoc->int8_array_prop_vals,
+                root_object_header_offset,
+                aligned)) {
                 return false;
         }
         if (!write_array_prop(&offsets->int16_arrays,
                 err,
                 memfile,
-                &columndoc->int16_array_prop_keys,
+                columndoc->int16_array_prop_keys,
                 FIELD_INT16,
-                &columndoc->int16_array_prop_vals,
-                root_object_header_offset)) {
+                columndoc->int16_array_prop_vals,
+                root_object_header_offset,
+                aligned)) {
                 return false;
         }
         if (!write_array_prop(&offsets->int32_arrays,
                 err,
                 memfile,
-                &columndoc->int32_array_prop_keys,
+                columndoc->int32_array_prop_keys,
                 FIELD_INT32,
-                &columndoc->int32_array_prop_vals,
-                root_object_header_offset)) {
+                columndoc->int32_array_prop_vals,
+                root_object_header_offset,
+                aligned)) {
                 return false;
         }
         if (!write_array_prop(&offsets->int64_arrays,
                 err,
                 memfile,
-                &columndoc->int64_array_prop_keys,
+                columndoc->int64_array_prop_keys,
                 FIELD_INT64,
-                &columndoc->int64_array_prop_vals,
-                root_object_header_offset)) {
+                columndoc->int64_array_prop_vals,
+                root_object_header_offset,
+                aligned)) {
                 return false;
         }
         if (!write_array_prop(&offsets->uint8_arrays,
                 err,
                 memfile,
-                &columndoc->uint8_array_prop_keys,
+                columndoc->uint8_array_prop_keys,
                 FIELD_UINT8,
-                &columndoc->uint8_array_prop_vals,
-                root_object_header_offset)) {
+                columndoc->uint8_array_prop_vals,
+                root_object_header_offset,
+                aligned)) {
                 return false;
         }
         if (!write_array_prop(&offsets->uint16_arrays,
                 err,
                 memfile,
-                &columndoc->uint16_array_prop_keys,
+                columndoc->uint16_array_prop_keys,
                 FIELD_UINT16,
-                &columndoc->uint16_array_prop_vals,
-                root_object_header_offset)) {
+                columndoc->uint16_array_prop_vals,
+                root_object_header_offset,
+                aligned)) {
                 return false;
         }
         if (!write_array_prop(&offsets->uint32_arrays,
                 err,
                 memfile,
-                &columndoc->uint32_array_prop_keys,
+                columndoc->uint32_array_prop_keys,
                 FIELD_UINT32,
-                &columndoc->uint32_array_prop_vals,
-                root_object_header_offset)) {
+                columndoc->uint32_array_prop_vals,
+                root_object_header_offset,
+                aligned)) {
                 return false;
         }
         if (!write_array_prop(&offsets->uint64_arrays,
                 err,
                 memfile,
-                &columndoc->uint64_array_prop_keys,
+                columndoc->uint64_array_prop_keys,
                 FIELD_UINT64,
-                &columndoc->ui64_array_prop_vals,
-                root_object_header_offset)) {
+                columndoc->ui64_array_prop_vals,
+                root_object_header_offset,
+                aligned)) {
                 return false;
         }
         if (!write_array_prop(&offsets->float_arrays,
                 err,
                 memfile,
-                &columndoc->float_array_prop_keys,
+                columndoc->float_array_prop_keys,
                 FIELD_FLOAT,
-                &columndoc->float_array_prop_vals,
-                root_object_header_offset)) {
+                columndoc->float_array_prop_vals,
+                root_object_header_offset,
+                aligned)) {
                 return false;
         }
         if (!write_array_prop(&offsets->string_arrays,
                 err,
                 memfile,
-                &columndoc->string_array_prop_keys,
+                columndoc->string_array_prop_keys,
                 FIELD_STRING,
-                &columndoc->string_array_prop_vals,
-                root_object_header_offset)) {
+                columndoc->string_array_prop_vals,
+                root_object_header_offset,
+                aligned)) {
                 return false;
         }
         return true;
@@ -778,7 +1330,7 @@ static bool write_array_props(struct memfile *memfile, struct err *err, struct c
 /** Fixed-length property lists; value position can be determined by size of value and position of key in key column.
  * In contrast, variable-length property list require an additional offset column (see 'write_var_props') */
 static bool write_fixed_props(offset_t *offset, struct err *err, struct memfile *memfile,
-        struct vector ofType(field_sid_t) *keys, field_e type, struct vector ofType(T) *values)
+        struct vector ofType(field_sid_t) *keys, field_e type, struct vector ofType(T) *values, bool aligned)
 {
         assert(!values || keys->num_elems == values->num_elems);
         assert(type != FIELD_OBJECT); /** use 'write_var_props' instead */
@@ -788,11 +1340,16 @@ static bool write_fixed_props(offset_t *offset, struct err *err, struct memfile
                         {.marker = marker_symbols[valueMarkerMapping[type].marker].symbol, .num_entries = keys
                                 ->num_elems};
 
+                /** null properties have no values */
+                header.encoding = values ? choose_encoding(values->base, values->num_elems, type) : INTPACK_PLAIN;
+
                 offset_t prop_ofOffset = memfile_tell(memfile);
                 memfile_write(memfile, &header, sizeof(struct prop_header));
 
-                write_primitive_key_column(memfile, keys);
-                if (!write_primitive_fixed_value_column(memfile, err, type, values)) {
+                write_primitive_key_column(memfile, keys, aligned);
+                if (header.encoding != INTPACK_PLAIN) {
+                        write_encoded_values(memfile, header.encoding, values->base, values->num_elems, type);
+                } else if (!write_primitive_fixed_value_column(memfile, err, type, values)) {
                         return false;
                 }
                 *offset = prop_ofOffset;
@@ -809,7 +1366,8 @@ static bool write_fixed_props(offset_t *offset, struct err *err, struct memfile
  * In contrast, fixed-length property list doesn't require an additional offset column (see 'write_fixed_props') */
 static bool write_var_props(offset_t *offset, struct err *err, struct memfile *memfile,
         struct vector ofType(field_sid_t) *keys, struct vector ofType(struct columndoc_obj) *objects,
-        offset_t root_object_header_offset)
+        offset_t root_object_header_offset, struct vector ofType(offset_t) *relocs, bool aligned,
+        struct row_group_writer *row_groups)
 {
         assert(!objects || keys->num_elems == objects->num_elems);
 
@@ -819,15 +1377,16 @@ static bool write_var_props(offset_t *offset, struct err *err, struct memfile *m
                 offset_t prop_ofOffset = memfile_tell(memfile);
                 memfile_write(memfile, &header, sizeof(struct prop_header));
 
-                write_primitive_key_column(memfile, keys);
+                write_primitive_key_column(memfile, keys, aligned);
                 offset_t value_offset = skip_var_value_offset_column(memfile, keys->num_elems);
-                offset_t *value_offsets = __write_primitive_column(memfile, err, objects, root_object_header_offset);
+                offset_t *value_offsets = __write_primitive_column(memfile, err, objects, root_object_header_offset,
+                        relocs, aligned, row_groups);
                 if (!value_offsets) {
                         return false;
                 }
 
                 offset_t last = memfile_tell(memfile);
-                write_var_value_offset_column(memfile, value_offset, last, value_offsets, keys->num_elems);
+                write_var_value_offset_column(memfile, value_offset, last, value_offsets, keys->num_elems, relocs);
                 free(value_offsets);
                 *offset = prop_ofOffset;
         } else {
@@ -837,202 +1396,590 @@ static bool write_var_props(offset_t *offset, struct err *err, struct memfile *m
 }
 
 static bool write_primitive_props(struct memfile *memfile, struct err *err, struct columndoc_obj *columndoc,
-        struct archive_prop_offs *offsets, offset_t root_object_header_offset)
+        struct archive_prop_offs *offsets, offset_t root_object_header_offset, struct vector ofType(offset_t) *relocs,
+        bool aligned, struct row_group_writer *row_groups)
 {
-        if (!write_fixed_props(&offsets->nulls, err, memfile, &columndoc->null_prop_keys, FIELD_NULL, NULL)) {
+        if (!write_fixed_props(&offsets->nulls, err, memfile, columndoc->null_prop_keys, FIELD_NULL, NULL, aligned)) {
                 return false;
         }
         if (!write_fixed_props(&offsets->bools,
                 err,
                 memfile,
-                &columndoc->bool_prop_keys,
+                columndoc->bool_prop_keys,
                 FIELD_BOOLEAN,
-                &columndoc->bool_prop_vals)) {
+                columndoc->bool_prop_vals,
+                aligned)) {
                 return false;
         }
         if (!write_fixed_props(&offsets->int8s,
                 err,
                 memfile,
-                &columndoc->int8_prop_keys,
+                columndoc->int8_prop_keys,
                 FIELD_INT8,
-                &columndoc->int8_prop_vals)) {
+                columndoc->int8_prop_vals,
+                aligned)) {
                 return false;
         }
         if (!write_fixed_props(&offsets->int16s,
                 err,
                 memfile,
-                &columndoc->int16_prop_keys,
+                columndoc->int16_prop_keys,
                 FIELD_INT16,
-                &columndoc->int16_prop_vals)) {
+                columndoc->int16_prop_vals,
+                aligned)) {
                 return false;
         }
         if (!write_fixed_props(&offsets->int32s,
                 err,
                 memfile,
-                &columndoc->int32_prop_keys,
+                columndoc->int32_prop_keys,
                 FIELD_INT32,
-                &columndoc->int32_prop_vals)) {
+                columndoc->int32_prop_vals,
+                aligned)) {
                 return false;
         }
         if (!write_fixed_props(&offsets->int64s,
                 err,
                 memfile,
-                &columndoc->int64_prop_keys,
+                columndoc->int64_prop_keys,
                 FIELD_INT64,
-                &columndoc->int64_prop_vals)) {
+                columndoc->int64_prop_vals,
+                aligned)) {
                 return false;
         }
         if (!write_fixed_props(&offsets->uint8s,
                 err,
                 memfile,
-                &columndoc->uint8_prop_keys,
+                columndoc->uint8_prop_keys,
                 FIELD_UINT8,
-                &columndoc->uint8_prop_vals)) {
+                columndoc->uint8_prop_vals,
+                aligned)) {
                 return false;
         }
         if (!write_fixed_props(&offsets->uint16s,
                 err,
                 memfile,
-                &columndoc->uint16_prop_keys,
+                columndoc->uint16_prop_keys,
                 FIELD_UINT16,
-                &columndoc->uint16_prop_vals)) {
+                columndoc->uint16_prop_vals,
+                aligned)) {
                 return false;
         }
         if (!write_fixed_props(&offsets->uint32s,
                 err,
                 memfile,
-                &columndoc->uin32_prop_keys,
+                columndoc->uin32_prop_keys,
                 FIELD_UINT32,
-                &columndoc->uint32_prop_vals)) {
+                columndoc->uint32_prop_vals,
+                aligned)) {
                 return false;
         }
         if (!write_fixed_props(&offsets->uint64s,
                 err,
                 memfile,
-                &columndoc->uint64_prop_keys,
+                columndoc->uint64_prop_keys,
                 FIELD_UINT64,
-                &columndoc->uint64_prop_vals)) {
+                columndoc->uint64_prop_vals,
+                aligned)) {
                 return false;
         }
         if (!write_fixed_props(&offsets->floats,
                 err,
                 memfile,
-                &columndoc->float_prop_keys,
+                columndoc->float_prop_keys,
                 FIELD_FLOAT,
-                &columndoc->float_prop_vals)) {
+                columndoc->float_prop_vals,
+                aligned)) {
+                return false;
+        }
+        if (!write_fixed_props(&offsets->strings,
+                err,
+                memfile,
+                columndoc->string_prop_keys,
+                FIELD_STRING,
+                columndoc->string_prop_vals,
+                aligned)) {
+                return false;
+        }
+        if (!write_var_props(&offsets->objects,
+                err,
+                memfile,
+                columndoc->obj_prop_keys,
+                columndoc->obj_prop_vals,
+                root_object_header_offset,
+                relocs,
+                aligned,
+                row_groups)) {
+                return false;
+        }
+
+        offsets->nulls -= root_object_header_offset;
+        offsets->bools -= root_object_header_offset;
+        offsets->int8s -= root_object_header_offset;
+        offsets->int16s -= root_object_header_offset;
+        offsets->int32s -= root_object_header_offset;
+        offsets->int64s -= root_object_header_offset;
+        offsets->uint8s -= root_object_header_offset;
+        offsets->uint16s -= root_object_header_offset;
+        offsets->uint32s -= root_object_header_offset;
+        offsets->uint64s -= root_object_header_offset;
+        offsets->floats -= root_object_header_offset;
+        offsets->strings -= root_object_header_offset;
+        offsets->objects -= root_object_header_offset;
+        return true;
+}
+
+static bool write_column_entry(struct memfile *memfile, struct err *err, field_e type, enum intpack_type encoding,
+        struct vector ofType(<T>) *column, offset_t root_object_header_offset, struct vector ofType(offset_t) *relocs,
+        bool aligned)
+{
+        size_t width;
+        bool is_signed;
+
+        memfile_write(memfile, &column->num_elems, sizeof(u32));
+        switch (type) {
+        case FIELD_NULL:
+                memfile_write(memfile, column->base, column->num_elems * sizeof(u32));
+                break;
+        case FIELD_BOOLEAN:
+        case FIELD_INT8:
+        case FIELD_INT16:
+        case FIELD_INT32:
+        case FIELD_INT64:
+        case FIELD_UINT8:
+        case FIELD_UINT16:
+        case FIELD_UINT32:
+        case FIELD_UINT64:
+        case FIELD_STRING:
+                if (encoding != INTPACK_PLAIN) {
+                        int_get_intpack_params(&width, &is_signed, type);
+                        intpack_encode(memfile, encoding, column->base, column->num_elems, width, is_signed);
+                } else {
+                        memfile_write(memfile, column->base, column->num_elems * GET_TYPE_SIZE(type));
+                }
+                break;
+        case FIELD_FLOAT:
+                memfile_write(memfile, column->base, column->num_elems * GET_TYPE_SIZE(type));
+                break;
+        case FIELD_OBJECT: {
+                offset_t preObjectNext = 0;
+                for (size_t i = 0; i < column->num_elems; i++) {
+                        struct columndoc_obj *object = vec_get(column, i, struct columndoc_obj);
+                        if (likely(preObjectNext != 0)) {
+                                offset_t continuePos = memfile_tell(memfile);
+                                offset_t relativeContinuePos = continuePos - root_object_header_offset;
+                                memfile_seek(memfile, preObjectNext);
+                                write_offsets(memfile, relocs, &relativeContinuePos, 1);
+                                memfile_seek(memfile, continuePos);
+                        }
+                        if (!__serialize(&preObjectNext, err, memfile, object, root_object_header_offset, relocs,
+                                aligned, NULL)) {
+                                return false;
+                        }
+                }
+        }
+                break;
+        default: error(err, NG5_ERR_NOTYPE)
                 return false;
         }
-        if (!write_fixed_props(&offsets->strings,
-                err,
-                memfile,
-                &columndoc->string_prop_keys,
-                FIELD_STRING,
-                &columndoc->string_prop_vals)) {
-                return false;
+        return true;
+}
+
+/**
+ * chooses one encoding for all entries of an integer, boolean or string column by the estimated sizes of some entries,
+ * or 'INTPACK_RLE' if the values of all entries ('run', which is then owned by the caller) are smaller as runs. The
+ * values of all entries of a floating-point column are stored as a run with 'FLOATPACK_ALP' if that is smaller.
+ */
+static u8 choose_column_encoding(void **run, size_t *num_values, struct columndoc_column *column)
+{
+        size_t width;
+        bool is_signed;
+        size_t sizes[NG5_INTPACK_NUM_TYPES] = {0}, run_sizes[NG5_INTPACK_NUM_TYPES] = {0};
+
+        *run = NULL;
+        *num_values = 0;
+        if (column->type == FIELD_FLOAT) {
+                /** entries hold few numbers each, such that floating-point numbers are rather encoded as one run */
+                size_t float_sizes[NG5_FLOATPACK_NUM_TYPES] = {0};
+                *run = concat_array_values(num_values, &column->values, sizeof(field_number_t));
+                floatpack_estimate(float_sizes, *run, *num_values);
+                if (float_sizes[FLOATPACK_ALP] + sizeof(u32) < float_sizes[FLOATPACK_PLAIN]) {
+                        return FLOATPACK_ALP;
+                }
+                free(*run);
+                *run = NULL;
+                return FLOATPACK_PLAIN;
+        } else if (!int_get_intpack_params(&width, &is_signed, column->type)) {
+                return INTPACK_PLAIN;
+        }
+        size_t step = ng5_max(column->values.num_elems / NG5_ARCHIVE_ENCODING_SAMPLE_ENTRIES, 1u), num_sampled = 0;
+        for (size_t i = 0; i < column->values.num_elems; i += step, num_sampled++) {
+                struct vector ofType(<T>) *column_data = vec_get(&column->values, i, struct vector);
+                intpack_estimate(sizes, column_data->base, column_data->num_elems, width, is_signed);
+        }
+        /** runs of single entries are too short to pay off; runs are rather formed across all entries */
+        sizes[INTPACK_RLE] = SIZE_MAX;
+        /** entries that are not sampled may hold values other than 0, 1 or null, unless these values are booleans */
+        sizes[INTPACK_BITMAP] = column->type == FIELD_BOOLEAN ? sizes[INTPACK_BITMAP] : SIZE_MAX;
+        enum intpack_type encoding = intpack_choose(sizes);
+        size_t entries_size = sizes[encoding] / ng5_max(num_sampled, 1u) * column->values.num_elems;
+
+        *run = concat_array_values(num_values, &column->values, width);
+        intpack_estimate(run_sizes, *run, *num_values, width, is_signed);
+        /** entries store their lengths only, such that they are consecutive slices of the run */
+        if (run_sizes[INTPACK_RLE] + sizeof(u32) < entries_size) {
+                return INTPACK_RLE;
+        }
+        free(*run);
+        *run = NULL;
+        return encoding;
+}
+
+/** returns the number of objects of a column group, i.e., one more than the largest position of any column entry */
+static u32 column_group_num_objects(struct columndoc_group *column_group)
+{
+        size_t max_pos = 0;
+        for (size_t k = 0; k < column_group->columns.num_elems; k++) {
+                struct columndoc_column *column = vec_get(&column_group->columns, k, struct columndoc_column);
+                const u32 *array_pos = vec_all(&column->array_positions, u32);
+                for (size_t m = 0; m < column->array_positions.num_elems; m++) {
+                        max_pos = ng5_max(max_pos, array_pos[m]);
+                }
+        }
+        return max_pos + 1;
+}
+
+/** writes a bitmap of 'num_objects' bits in which the bits at the positions of the entries of 'column' are set */
+static bool write_column_validity(struct memfile *memfile, struct columndoc_column *column, u32 num_objects)
+{
+        size_t size = (num_objects + 7) / 8;
+        u8 *validity = calloc(ng5_max(size, 1u), 1);
+        const u32 *array_pos = vec_all(&column->array_positions, u32);
+        for (size_t m = 0; m < column->array_positions.num_elems; m++) {
+                validity[array_pos[m] >> 3] |= (u8) (1 << (array_pos[m] & 7));
+        }
+        bool status = memfile_write(memfile, validity, size);
+        free(validity);
+        return status;
+}
+
+/**
+ * writes the offsets of the entries of a column (relative to its column header, hence ascending) as an 'enum
+ * intpack_type' (1 byte), followed by the offsets encoded with that type
+ */
+static bool write_entry_offsets(struct memfile *memfile, const u64 *offsets, size_t num_offsets)
+{
+        size_t sizes[NG5_INTPACK_NUM_TYPES] = {0};
+        intpack_estimate(sizes, offsets, num_offsets, sizeof(u64), false);
+        u8 encoding = intpack_choose(sizes);
+        memfile_write(memfile, &encoding, sizeof(u8));
+        return intpack_encode(memfile, encoding, offsets, num_offsets, sizeof(u64), false);
+}
+
+/** returns the width of the values of entries of a column of 'type' that are stored plain, and 0 otherwise */
+static size_t plain_entry_width(u8 encoding, field_e type)
+{
+        size_t width;
+        bool is_signed;
+        if (type == FIELD_NULL) {
+                return sizeof(u32);
+        } else if (type == FIELD_FLOAT) {
+                return encoding == FLOATPACK_PLAIN ? sizeof(field_number_t) : 0;
+        } else if (int_get_intpack_params(&width, &is_signed, type)) {
+                return encoding == INTPACK_PLAIN ? width : 0;
+        }
+        return 0;
+}
+
+static bool write_column(struct memfile *memfile, struct err *err, struct columndoc_column *column, u32 num_objects,
+        offset_t root_object_header_offset, struct vector ofType(offset_t) *relocs, bool aligned)
+{
+        assert(column->array_positions.num_elems == column->values.num_elems);
+
+        void *run;
+        size_t num_values;
+        union column_flags flags = {.bits.has_validity = column->values.num_elems < num_objects};
+        struct column_header header = {.marker = marker_symbols[MARKER_TYPE_COLUMN].symbol, .column_name = column
+                ->key_name, .value_type = marker_symbols[value_array_marker_mapping[column->type].marker]
+                .symbol, .num_entries = column->values.num_elems, .encoding = choose_column_encoding(&run,
+                &num_values, column), .flags = flags.value};
+
+        /** the header is rewritten once the position of the offsets of the entries is known */
+        offset_t header_offset = memfile_tell(memfile);
+        memfile_skip(memfile, sizeof(struct column_header));
+
+        write_padding(memfile, aligned, NG5_ARCHIVE_CACHE_LINE, 0);
+        memfile_write(memfile, column->array_positions.base, column->array_positions.num_elems * sizeof(u32));
+        if (flags.bits.has_validity) {
+                write_column_validity(memfile, column, num_objects);
+        }
+
+        if (int_column_is_run(header.encoding, column->type)) {
+                u32 num_run_values = num_values;
+                memfile_write(memfile, &num_run_values, sizeof(u32));
+                write_encoded_values(memfile, header.encoding, run, num_values, column->type);
+                free(run);
+        }
+
+        u64 *entry_offsets = malloc(ng5_max(column->values.num_elems, 1u) * sizeof(u64));
+        for (size_t i = 0; i < column->values.num_elems; i++) {
+                struct vector ofType(<T>) *column_data = vec_get(&column->values, i, struct vector);
+                size_t width = plain_entry_width(header.encoding, column->type);
+                if (width) {
+                        /** the values that follow the length of the entry are aligned */
+                        write_padding(memfile, aligned, int_array_alignment(width, column_data->num_elems * width),
+                                sizeof(u32));
+                }
+                entry_offsets[i] = memfile_tell(memfile) - header_offset;
+                if (int_column_is_run(header.encoding, column->type)) {
+                        memfile_write(memfile, &column_data->num_elems, sizeof(u32));
+                } else if (!write_column_entry(memfile, err, column->type, header.encoding, column_data,
+                        root_object_header_offset,
+                        relocs, aligned)) {
+                        free(entry_offsets);
+                        return false;
+                }
+        }
+
+        offset_t continue_write = memfile_tell(memfile);
+        header.entry_offsets = continue_write - header_offset;
+        memfile_seek(memfile, header_offset);
+        memfile_write(memfile, &header, sizeof(struct column_header));
+        memfile_seek(memfile, continue_write);
+        bool status = write_entry_offsets(memfile, entry_offsets, column->values.num_elems);
+        free(entry_offsets);
+        return status;
+}
+
+/**
+ * Runs 'pool_run' on 'pool' with this thread and up to 'num_threads' - 1 additional threads. Since the threads of a
+ * pool take tasks until none is left, the tasks of threads that cannot be started are taken by the others.
+ */
+static void run_pool_threads(void *pool, void *(*pool_run)(void *), size_t num_threads)
+{
+        pthread_t *threads = malloc((num_threads - 1) * sizeof(pthread_t));
+        size_t num_started = 0;
+        for (size_t i = 1; threads && i < num_threads; i++) {
+                num_started += pthread_create(threads + num_started, NULL, pool_run, pool) == 0;
+        }
+        pool_run(pool);
+        for (size_t i = 0; i < num_started; i++) {
+                pthread_join(threads[i], NULL);
+        }
+        free(threads);
+}
+
+/** a column of an array of objects that is serialized into a memfile of its own, see 'write_columns_parallel' */
+struct column_write_task {
+        struct columndoc_column *column;
+        u32 num_objects;
+        bool aligned;
+        struct memblock *block;
+        offset_t size;
+        /** positions of the offsets in 'block' that must be relocated once 'block' is appended, see 'append_column' */
+        struct vector ofType(offset_t) relocs;
+        struct err err;
+        bool status;
+};
+
+struct column_write_pool {
+        struct column_write_task *tasks;
+        size_t num_tasks;
+        size_t next_task;
+};
+
+static void *column_write_pool_run(void *args)
+{
+        ng5_cast(struct column_write_pool *, pool, args);
+        size_t i;
+        while ((i = __atomic_fetch_add(&pool->next_task, 1, __ATOMIC_RELAXED)) < pool->num_tasks) {
+                struct column_write_task *task = pool->tasks + i;
+                struct memfile memfile;
+                memblock_create(&task->block, 1024);
+                memfile_open(&memfile, task->block, READ_WRITE);
+                vec_create(&task->relocs, NULL, sizeof(offset_t), 64);
+                error_init(&task->err);
+                /** offsets are relative to the begin of the block until the block is appended */
+                task->status = write_column(&memfile, &task->err, task->column, task->num_objects, 0,
+                        &task->relocs, task->aligned);
+                task->size = memfile_tell(&memfile);
+        }
+        return NULL;
+}
+
+static void column_write_tasks_drop(struct column_write_task *tasks, size_t num_tasks)
+{
+        for (size_t i = 0; tasks && i < num_tasks; i++) {
+                memblock_drop(tasks[i].block);
+                vec_drop(&tasks[i].relocs);
+        }
+        free(tasks);
+}
+
+/**
+ * Serializes the columns of all arrays of objects in 'groups' concurrently, each into a memfile of its own, if there
+ * are enough values in these columns to pay off (see NG5_ARCHIVE_PARALLEL_MIN) and more than one core. Returns the
+ * serialized columns in the order in which 'write_object_array_props' writes them, or NULL if the columns should be
+ * serialized in place.
+ */
+static struct column_write_task *write_columns_parallel(size_t *num_tasks,
+        struct vector ofType(struct columndoc_group) *groups, bool aligned)
+{
+        size_t num_columns = 0, num_values = 0;
+        for (size_t i = 0; i < groups->num_elems; i++) {
+                struct columndoc_group *group = vec_get(groups, i, struct columndoc_group);
+                const struct columndoc_column *columns = vec_all(&group->columns, struct columndoc_column);
+                for (size_t k = 0; k < group->columns.num_elems; k++) {
+                        num_values += columns[k].values.num_elems;
+                }
+                num_columns += group->columns.num_elems;
+        }
+
+        size_t num_threads = ng5_min((size_t) ng5_max(1, sysconf(_SC_NPROCESSORS_ONLN)), num_columns);
+        if (num_threads < 2 || num_values < NG5_ARCHIVE_PARALLEL_MIN) {
+                return NULL;
+        }
+
+        struct column_write_task *tasks = malloc(num_columns * sizeof(struct column_write_task));
+        if (unlikely(!tasks)) {
+                return NULL;
         }
-        if (!write_var_props(&offsets->objects,
-                err,
-                memfile,
-                &columndoc->obj_prop_keys,
-                &columndoc->obj_prop_vals,
-                root_object_header_offset)) {
+        struct column_write_pool pool = {.tasks = tasks, .num_tasks = num_columns, .next_task = 0};
+        for (size_t i = 0, t = 0; i < groups->num_elems; i++) {
+                struct columndoc_group *group = vec_get(groups, i, struct columndoc_group);
+                u32 num_objects = column_group_num_objects(group);
+                for (size_t k = 0; k < group->columns.num_elems; k++, t++) {
+                        tasks[t].column = vec_get(&group->columns, k, struct columndoc_column);
+                        tasks[t].num_objects = num_objects;
+                        tasks[t].aligned = aligned;
+                }
+        }
+        run_pool_threads(&pool, column_write_pool_run, num_threads);
+        *num_tasks = num_columns;
+        return tasks;
+}
+
+/** Appends a column serialized by 'write_columns_parallel' to 'memfile', and rebases its offsets from the begin of
+ * the column to 'root_object_header_offset' */
+static bool append_column(struct memfile *memfile, struct err *err, struct column_write_task *task,
+        offset_t root_object_header_offset)
+{
+        if (unlikely(!task->status)) {
+                error_cpy(err, &task->err);
                 return false;
         }
 
-        offsets->nulls -= root_object_header_offset;
-        offsets->bools -= root_object_header_offset;
-        offsets->int8s -= root_object_header_offset;
-        offsets->int16s -= root_object_header_offset;
-        offsets->int32s -= root_object_header_offset;
-        offsets->int64s -= root_object_header_offset;
-        offsets->uint8s -= root_object_header_offset;
-        offsets->uint16s -= root_object_header_offset;
-        offsets->uint32s -= root_object_header_offset;
-        offsets->uint64s -= root_object_header_offset;
-        offsets->floats -= root_object_header_offset;
-        offsets->strings -= root_object_header_offset;
-        offsets->objects -= root_object_header_offset;
-        return true;
+        struct memfile column;
+        offset_t delta = memfile_tell(memfile) - root_object_header_offset;
+        const offset_t *positions = vec_all(&task->relocs, offset_t);
+
+        memfile_open(&column, task->block, READ_WRITE);
+        for (size_t i = 0; i < task->relocs.num_elems; i++) {
+                memfile_seek(&column, positions[i]);
+                offset_t relocated = *NG5_MEMFILE_PEEK(&column, offset_t) + delta;
+                memfile_write(&column, &relocated, sizeof(offset_t));
+        }
+        return memfile_write(memfile, memblock_raw_data(task->block), task->size);
 }
 
-static bool write_column_entry(struct memfile *memfile, struct err *err, field_e type,
-        struct vector ofType(<T>) *column, offset_t root_object_header_offset)
+/** returns true if the entries of all columns of 'column_group' are ordered by position */
+static bool column_group_is_ordered(struct columndoc_group *column_group)
 {
-        memfile_write(memfile, &column->num_elems, sizeof(u32));
-        switch (type) {
-        case FIELD_NULL:
-                memfile_write(memfile, column->base, column->num_elems * sizeof(u32));
-                break;
-        case FIELD_BOOLEAN:
-        case FIELD_INT8:
-        case FIELD_INT16:
-        case FIELD_INT32:
-        case FIELD_INT64:
-        case FIELD_UINT8:
-        case FIELD_UINT16:
-        case FIELD_UINT32:
-        case FIELD_UINT64:
-        case FIELD_FLOAT:
-        case FIELD_STRING:
-                memfile_write(memfile, column->base, column->num_elems * GET_TYPE_SIZE(type));
-                break;
-        case FIELD_OBJECT: {
-                offset_t preObjectNext = 0;
-                for (size_t i = 0; i < column->num_elems; i++) {
-                        struct columndoc_obj *object = vec_get(column, i, struct columndoc_obj);
-                        if (likely(preObjectNext != 0)) {
-                                offset_t continuePos = memfile_tell(memfile);
-                                offset_t relativeContinuePos = continuePos - root_object_header_offset;
-                                memfile_seek(memfile, preObjectNext);
-                                memfile_write(memfile, &relativeContinuePos, sizeof(offset_t));
-                                memfile_seek(memfile, continuePos);
-                        }
-                        if (!__serialize(&preObjectNext, err, memfile, object, root_object_header_offset)) {
+        for (size_t k = 0; k < column_group->columns.num_elems; k++) {
+                struct columndoc_column *column = vec_get(&column_group->columns, k, struct columndoc_column);
+                const u32 *array_pos = vec_all(&column->array_positions, u32);
+                for (size_t m = 1; m < column->array_positions.num_elems; m++) {
+                        if (array_pos[m] <= array_pos[m - 1]) {
                                 return false;
                         }
                 }
-        }
-                break;
-        default: error(err, NG5_ERR_NOTYPE)
-                return false;
         }
         return true;
 }
 
-static bool write_column(struct memfile *memfile, struct err *err, struct columndoc_column *column,
-        offset_t root_object_header_offset)
+/** writes the zones of the row groups of 'column' to 'memfile' (see 'row_group_zone') */
+static void write_row_group_zones(struct memfile *memfile, struct columndoc_column *column, u64 row_group_size,
+        u32 num_row_groups)
 {
-        assert(column->array_positions.num_elems == column->values.num_elems);
-
-        struct column_header header = {.marker = marker_symbols[MARKER_TYPE_COLUMN].symbol, .column_name = column
-                ->key_name, .value_type = marker_symbols[value_array_marker_mapping[column->type].marker]
-                .symbol, .num_entries = column->values.num_elems};
-
-        memfile_write(memfile, &header, sizeof(struct column_header));
+        size_t width;
+        bool is_signed;
+        bool zone_map = int_get_intpack_params(&width, &is_signed, column->type);
+        const u32 *array_pos = vec_all(&column->array_positions, u32);
+        u64 entry = 0, value = 0;
+
+        for (u32 row_group = 0; row_group < num_row_groups; row_group++) {
+                struct row_group_zone zone = {.first_entry = entry, .first_value = value};
+                u64 end = (row_group + 1) * row_group_size;
+                for (; entry < column->values.num_elems && array_pos[entry] < end; entry++) {
+                        struct vector ofType(<T>) *column_data = vec_get(&column->values, entry, struct vector);
+                        for (size_t i = 0; zone_map && i < column_data->num_elems; i++) {
+                                u64 v = intpack_value_at(column_data->base, i, width, is_signed);
+                                bool first = value + i == zone.first_value;
+                                if (first || (is_signed ? (i64) v < (i64) zone.min : v < zone.min)) {
+                                        zone.min = v;
+                                }
+                                if (first || (is_signed ? (i64) v > (i64) zone.max : v > zone.max)) {
+                                        zone.max = v;
+                                }
+                        }
+                        value += column_data->num_elems;
+                }
+                zone.num_entries = entry - zone.first_entry;
+                zone.num_values = value - zone.first_value;
+                memfile_write(memfile, &zone, sizeof(struct row_group_zone));
+        }
+}
 
-        /** skip offset column to value entry points */
-        offset_t value_entry_offsets = memfile_tell(memfile);
-        memfile_skip(memfile, column->values.num_elems * sizeof(offset_t));
+/**
+ * Adds the row groups of 'column_group' (at 'column_group_off' in the record table) to the directory of 'row_groups',
+ * if the column group is a top-level collection (i.e., 'row_groups' is set) of more than one row group, and if its
+ * entries are ordered by position.
+ */
+static void write_row_groups(struct row_group_writer *row_groups, struct columndoc_group *column_group,
+        offset_t column_group_off, u64 num_objects)
+{
+        if (!row_groups || num_objects <= row_groups->row_group_size || !column_group_is_ordered(column_group)) {
+                return;
+        }
 
-        memfile_write(memfile, column->array_positions.base, column->array_positions.num_elems * sizeof(u32));
+        struct row_group_collection collection = {.column_group = column_group_off, .num_objects = num_objects,
+                .num_columns = column_group->columns.num_elems, .num_row_groups = (num_objects + row_groups
+                        ->row_group_size - 1) / row_groups->row_group_size};
+        memfile_write(&row_groups->memfile, &collection, sizeof(struct row_group_collection));
+        for (size_t k = 0; k < column_group->columns.num_elems; k++) {
+                struct columndoc_column *column = vec_get(&column_group->columns, k, struct columndoc_column);
+                size_t width;
+                bool is_signed;
+                u8 zone_map = int_get_intpack_params(&width, &is_signed, column->type);
+                memfile_write(&row_groups->memfile, &zone_map, sizeof(u8));
+        }
+        for (size_t k = 0; k < column_group->columns.num_elems; k++) {
+                write_row_group_zones(&row_groups->memfile, vec_get(&column_group->columns, k,
+                        struct columndoc_column), row_groups->row_group_size, collection.num_row_groups);
+        }
+        row_groups->num_collections++;
+}
 
-        for (size_t i = 0; i < column->values.num_elems; i++) {
-                struct vector ofType(<T>) *column_data = vec_get(&column->values, i, struct vector);
-                offset_t column_entry_offset = memfile_tell(memfile);
-                offset_t relative_entry_offset = column_entry_offset - root_object_header_offset;
-                memfile_seek(memfile, value_entry_offsets + i * sizeof(offset_t));
-                memfile_write(memfile, &relative_entry_offset, sizeof(offset_t));
-                memfile_seek(memfile, column_entry_offset);
-                if (!write_column_entry(memfile, err, column->type, column_data, root_object_header_offset)) {
-                        return false;
-                }
+/** appends the row-group directory of 'row_groups' to 'memfile', and returns its offset, or 0 if it is empty */
+static offset_t write_row_group_directory(struct memfile *memfile, struct row_group_writer *row_groups)
+{
+        if (!row_groups->num_collections) {
+                return 0;
         }
-        return true;
+        offset_t offset = memfile_tell(memfile);
+        offset_t size = memfile_tell(&row_groups->memfile);
+        struct row_group_directory_header header = {.marker = marker_symbols[MARKER_TYPE_ROW_GROUP_DIRECTORY]
+                .symbol, .size = sizeof(struct row_group_directory_header) + size, .row_group_size = row_groups
+                ->row_group_size, .num_collections = row_groups->num_collections};
+        memfile_write(memfile, &header, sizeof(struct row_group_directory_header));
+        memfile_write(memfile, memblock_raw_data(row_groups->block), size);
+        return offset;
 }
 
-static bool write_object_array_props(struct memfile *memfile, struct err *err,
+static bool write_column_groups(struct memfile *memfile, struct err *err,
         struct vector ofType(struct columndoc_group) *object_key_columns, struct archive_prop_offs *offsets,
-        offset_t root_object_header_offset)
+        offset_t root_object_header_offset, struct vector ofType(offset_t) *relocs, struct column_write_task *tasks,
+        bool aligned, struct row_group_writer *row_groups)
 {
         if (object_key_columns->num_elems > 0) {
                 struct object_array_header header = {.marker = marker_symbols[MARKER_TYPE_PROP_OBJECT_ARRAY]
@@ -1041,10 +1988,13 @@ static bool write_object_array_props(struct memfile *memfile, struct err *err,
                 offsets->object_arrays = memfile_tell(memfile) - root_object_header_offset;
                 memfile_write(memfile, &header, sizeof(struct object_array_header));
 
+                write_padding(memfile, aligned, sizeof(u32), 0);
                 for (size_t i = 0; i < object_key_columns->num_elems; i++) {
                         struct columndoc_group *column_group = vec_get(object_key_columns, i, struct columndoc_group);
-                        memfile_write(memfile, &column_group->key, sizeof(field_sid_t));
+                        u32 key = column_group->key;
+                        memfile_write(memfile, &key, sizeof(u32));
                 }
+                write_padding(memfile, aligned, sizeof(u64), 0);
 
                 // skip offset column to column groups
                 offset_t column_offsets = memfile_tell(memfile);
@@ -1055,20 +2005,14 @@ static bool write_object_array_props(struct memfile *memfile, struct err *err,
                         offset_t this_column_offset_relative = memfile_tell(memfile) - root_object_header_offset;
 
                         /* write an object-id for each position number */
-                        size_t max_pos = 0;
-                        for (size_t k = 0; k < column_group->columns.num_elems; k++) {
-                                struct columndoc_column
-                                        *column = vec_get(&column_group->columns, k, struct columndoc_column);
-                                const u32 *array_pos = vec_all(&column->array_positions, u32);
-                                for (size_t m = 0; m < column->array_positions.num_elems; m++) {
-                                        max_pos = ng5_max(max_pos, array_pos[m]);
-                                }
-                        }
                         struct column_group_header column_group_header =
                                 {.marker = marker_symbols[MARKER_TYPE_COLUMN_GROUP].symbol, .num_columns = column_group
-                                        ->columns.num_elems, .num_objects = max_pos + 1};
+                                        ->columns.num_elems, .num_objects = column_group_num_objects(column_group)};
                         memfile_write(memfile, &column_group_header, sizeof(struct column_group_header));
+                        write_row_groups(row_groups, column_group, this_column_offset_relative,
+                                column_group_header.num_objects);
 
+                        write_padding(memfile, aligned, sizeof(object_id_t), 0);
                         for (size_t i = 0; i < column_group_header.num_objects; i++) {
                                 object_id_t oid;
                                 if (!object_id_create(&oid)) {
@@ -1080,7 +2024,7 @@ static bool write_object_array_props(struct memfile *memfile, struct err *err,
 
                         offset_t continue_write = memfile_tell(memfile);
                         memfile_seek(memfile, column_offsets + i * sizeof(offset_t));
-                        memfile_write(memfile, &this_column_offset_relative, sizeof(offset_t));
+                        write_offsets(memfile, relocs, &this_column_offset_relative, 1);
                         memfile_seek(memfile, continue_write);
 
                         offset_t offset_column_to_columns = continue_write;
@@ -1089,12 +2033,19 @@ static bool write_object_array_props(struct memfile *memfile, struct err *err,
                         for (size_t k = 0; k < column_group->columns.num_elems; k++) {
                                 struct columndoc_column
                                         *column = vec_get(&column_group->columns, k, struct columndoc_column);
+                                /** columns that are serialized concurrently are aligned relative to their begin */
+                                write_padding(memfile, aligned, NG5_ARCHIVE_CACHE_LINE, 0);
                                 offset_t continue_write = memfile_tell(memfile);
                                 offset_t column_off = continue_write - root_object_header_offset;
                                 memfile_seek(memfile, offset_column_to_columns + k * sizeof(offset_t));
-                                memfile_write(memfile, &column_off, sizeof(offset_t));
+                                write_offsets(memfile, relocs, &column_off, 1);
                                 memfile_seek(memfile, continue_write);
-                                if (!write_column(memfile, err, column, root_object_header_offset)) {
+                                if (tasks) {
+                                        if (!append_column(memfile, err, tasks++, root_object_header_offset)) {
+                                                return false;
+                                        }
+                                } else if (!write_column(memfile, err, column, column_group_header.num_objects,
+                                        root_object_header_offset, relocs, aligned)) {
                                         return false;
                                 }
                         }
@@ -1107,6 +2058,21 @@ static bool write_object_array_props(struct memfile *memfile, struct err *err,
         return true;
 }
 
+static bool write_object_array_props(struct memfile *memfile, struct err *err,
+        struct vector ofType(struct columndoc_group) *object_key_columns, struct archive_prop_offs *offsets,
+        offset_t root_object_header_offset, struct vector ofType(offset_t) *relocs, bool aligned,
+        struct row_group_writer *row_groups)
+{
+        size_t num_tasks = 0;
+        /** columns inside a column that is serialized concurrently are serialized in place */
+        struct column_write_task *tasks = relocs ? NULL : write_columns_parallel(&num_tasks, object_key_columns,
+                aligned);
+        bool status = write_column_groups(memfile, err, object_key_columns, offsets, root_object_header_offset,
+                relocs, tasks, aligned, row_groups);
+        column_write_tasks_drop(tasks, num_tasks);
+        return status;
+}
+
 static offset_t skip_record_header(struct memfile *memfile)
 {
         offset_t offset = memfile_tell(memfile);
@@ -1115,9 +2081,10 @@ static offset_t skip_record_header(struct memfile *memfile)
 }
 
 static void update_record_header(struct memfile *memfile, offset_t root_object_header_offset, struct columndoc *model,
-        u64 record_size)
+        bool aligned, u64 record_size)
 {
-        struct record_flags flags = {.bits.is_sorted = model->read_optimized};
+        union record_flags flags =
+                {.bits.is_sorted = model->read_optimized, .bits.sid32 = true, .bits.aligned = aligned};
         struct record_header
                 header = {.marker = MARKER_SYMBOL_RECORD_HEADER, .flags = flags.value, .record_size = record_size};
         offset_t offset;
@@ -1128,85 +2095,85 @@ static void update_record_header(struct memfile *memfile, offset_t root_object_h
 }
 
 static void propOffsetsWrite(struct memfile *memfile, const union object_flags *flags,
-        struct archive_prop_offs *prop_offsets)
+        struct archive_prop_offs *prop_offsets, struct vector ofType(offset_t) *relocs)
 {
         if (flags->bits.has_null_props) {
-                memfile_write(memfile, &prop_offsets->nulls, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->nulls, 1);
         }
         if (flags->bits.has_bool_props) {
-                memfile_write(memfile, &prop_offsets->bools, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->bools, 1);
         }
         if (flags->bits.has_int8_props) {
-                memfile_write(memfile, &prop_offsets->int8s, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->int8s, 1);
         }
         if (flags->bits.has_int16_props) {
-                memfile_write(memfile, &prop_offsets->int16s, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->int16s, 1);
         }
         if (flags->bits.has_int32_props) {
-                memfile_write(memfile, &prop_offsets->int32s, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->int32s, 1);
         }
         if (flags->bits.has_int64_props) {
-                memfile_write(memfile, &prop_offsets->int64s, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->int64s, 1);
         }
         if (flags->bits.has_uint8_props) {
-                memfile_write(memfile, &prop_offsets->uint8s, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->uint8s, 1);
         }
         if (flags->bits.has_uint16_props) {
-                memfile_write(memfile, &prop_offsets->uint16s, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->uint16s, 1);
         }
         if (flags->bits.has_uint32_props) {
-                memfile_write(memfile, &prop_offsets->uint32s, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->uint32s, 1);
         }
         if (flags->bits.has_uint64_props) {
-                memfile_write(memfile, &prop_offsets->uint64s, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->uint64s, 1);
         }
         if (flags->bits.has_float_props) {
-                memfile_write(memfile, &prop_offsets->floats, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->floats, 1);
         }
         if (flags->bits.has_string_props) {
-                memfile_write(memfile, &prop_offsets->strings, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->strings, 1);
         }
         if (flags->bits.has_object_props) {
-                memfile_write(memfile, &prop_offsets->objects, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->objects, 1);
         }
         if (flags->bits.has_null_array_props) {
-                memfile_write(memfile, &prop_offsets->null_arrays, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->null_arrays, 1);
         }
         if (flags->bits.has_bool_array_props) {
-                memfile_write(memfile, &prop_offsets->bool_arrays, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->bool_arrays, 1);
         }
         if (flags->bits.has_int8_array_props) {
-                memfile_write(memfile, &prop_offsets->int8_arrays, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->int8_arrays, 1);
         }
         if (flags->bits.has_int16_array_props) {
-                memfile_write(memfile, &prop_offsets->int16_arrays, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->int16_arrays, 1);
         }
         if (flags->bits.has_int32_array_props) {
-                memfile_write(memfile, &prop_offsets->int32_arrays, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->int32_arrays, 1);
         }
         if (flags->bits.has_int64_array_props) {
-                memfile_write(memfile, &prop_offsets->int64_arrays, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->int64_arrays, 1);
         }
         if (flags->bits.has_uint8_array_props) {
-                memfile_write(memfile, &prop_offsets->uint8_arrays, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->uint8_arrays, 1);
         }
         if (flags->bits.has_uint16_array_props) {
-                memfile_write(memfile, &prop_offsets->uint16_arrays, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->uint16_arrays, 1);
         }
         if (flags->bits.has_uint32_array_props) {
-                memfile_write(memfile, &prop_offsets->uint32_arrays, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->uint32_arrays, 1);
         }
         if (flags->bits.has_uint64_array_props) {
-                memfile_write(memfile, &prop_offsets->uint64_arrays, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->uint64_arrays, 1);
         }
         if (flags->bits.has_float_array_props) {
-                memfile_write(memfile, &prop_offsets->float_arrays, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->float_arrays, 1);
         }
         if (flags->bits.has_string_array_props) {
-                memfile_write(memfile, &prop_offsets->string_arrays, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->string_arrays, 1);
         }
         if (flags->bits.has_object_array_props) {
-                memfile_write(memfile, &prop_offsets->object_arrays, sizeof(offset_t));
+                write_offsets(memfile, relocs, &prop_offsets->object_arrays, 1);
         }
 }
 
@@ -1296,7 +2263,8 @@ static void prop_offsets_skip_write(struct memfile *memfile, const union object_
 }
 
 static bool __serialize(offset_t *offset, struct err *err, struct memfile *memfile, struct columndoc_obj *columndoc,
-        offset_t root_object_header_offset)
+        offset_t root_object_header_offset, struct vector ofType(offset_t) *relocs, bool aligned,
+        struct row_group_writer *row_groups)
 {
         union object_flags flags;
         struct archive_prop_offs prop_offsets;
@@ -1310,17 +2278,21 @@ static bool __serialize(offset_t *offset, struct err *err, struct memfile *memfi
         offset_t default_next_nil = 0;
         memfile_write(memfile, &default_next_nil, sizeof(offset_t));
 
-        if (!write_primitive_props(memfile, err, columndoc, &prop_offsets, root_object_header_offset)) {
+        if (!write_primitive_props(memfile, err, columndoc, &prop_offsets, root_object_header_offset, relocs,
+                aligned, row_groups)) {
                 return false;
         }
-        if (!write_array_props(memfile, err, columndoc, &prop_offsets, root_object_header_offset)) {
+        if (!write_array_props(memfile, err, columndoc, &prop_offsets, root_object_header_offset, aligned)) {
                 return false;
         }
         if (!write_object_array_props(memfile,
                 err,
-                &columndoc->obj_array_props,
+                columndoc->obj_array_props,
                 &prop_offsets,
-                root_object_header_offset)) {
+                root_object_header_offset,
+                relocs,
+                aligned,
+                row_groups)) {
                 return false;
         }
 
@@ -1342,7 +2314,7 @@ static bool __serialize(offset_t *offset, struct err *err, struct memfile *memfi
 
         memfile_write(memfile, &header, sizeof(struct object_header));
 
-        propOffsetsWrite(memfile, &flags, &prop_offsets);
+        propOffsetsWrite(memfile, &flags, &prop_offsets, relocs);
 
         memfile_seek(memfile, object_end_offset);
         ng5_optional_set(offset, next_offset);
@@ -1374,7 +2346,7 @@ static char *embedded_dic_flags_to_string(const union string_tab_flags *flags)
         return string;
 }
 
-static char *record_header_flags_to_string(const struct record_flags *flags)
+static char *record_header_flags_to_string(const union record_flags *flags)
 {
         size_t max = 2048;
         char *string = malloc(max + 1);
@@ -1390,17 +2362,249 @@ static char *record_header_flags_to_string(const struct record_flags *flags)
                         length = strlen(string);
                         assert(length <= max);
                 }
+                if (flags->bits.sid32) {
+                        strcpy(string + length, " sid32");
+                        length = strlen(string);
+                        assert(length <= max);
+                }
+                if (flags->bits.aligned) {
+                        strcpy(string + length, " aligned");
+                        length = strlen(string);
+                        assert(length <= max);
+                }
         }
         string[length] = '\0';
         return string;
 }
 
-static bool serialize_string_dic(struct memfile *memfile, struct err *err, const struct doc_bulk *context,
-        enum packer_type compressor)
+/**
+ * Writes the entries of the strings 'begin' to 'end' to 'memfile'. The 'next_entry_off' of each entry is the offset
+ * in 'memfile' behind that entry, except for the very last entry of the string table ('is_last'), which has none.
+ */
+static bool write_string_entries(struct memfile *memfile, struct err *err, struct packer *strategy,
+        const char *const *strings, const field_sid_t *string_ids, size_t begin, size_t end, bool is_last)
+{
+        for (size_t i = begin; i < end; i++) {
+                struct string_entry_header header = {.marker = marker_symbols[MARKER_TYPE_EMBEDDED_UNCOMP_STR]
+                        .symbol, .next_entry_off = 0, .string_id = string_ids[i], .string_len = strlen(strings[i])};
+
+                offset_t header_pos_off = memfile_tell(memfile);
+                memfile_skip(memfile, sizeof(struct string_entry_header));
+
+                if (!pack_encode(err, strategy, memfile, strings[i])) {
+                        return false;
+                }
+                offset_t continue_off = memfile_tell(memfile);
+                memfile_seek(memfile, header_pos_off);
+                header.next_entry_off = i + 1 < end || !is_last ? continue_off : 0;
+                memfile_write(memfile, &header, sizeof(struct string_entry_header));
+                memfile_seek(memfile, continue_off);
+        }
+        return true;
+}
+
+/** a range of strings that is encoded into a memfile of its own, see 'write_string_entries_parallel' */
+struct string_encode_task {
+        size_t begin, end;
+        bool is_last;
+        struct memblock *block;
+        offset_t size;
+        struct err err;
+        bool status;
+};
+
+struct string_encode_pool {
+        const struct packer *strategy;
+        const char *const *strings;
+        const field_sid_t *string_ids;
+        struct string_encode_task *tasks;
+        size_t num_tasks;
+        size_t next_task;
+};
+
+static void *string_encode_pool_run(void *args)
+{
+        ng5_cast(struct string_encode_pool *, pool, args);
+        struct packer strategy;
+        struct err err;
+        size_t i;
+
+        /** each thread encodes with a copy of the packer, since packers keep their errors */
+        error_init(&err);
+        bool has_strategy = pack_cpy(&err, &strategy, pool->strategy);
+        while ((i = __atomic_fetch_add(&pool->next_task, 1, __ATOMIC_RELAXED)) < pool->num_tasks) {
+                struct string_encode_task *task = pool->tasks + i;
+                struct memfile memfile;
+                memblock_create(&task->block, 1024);
+                memfile_open(&memfile, task->block, READ_WRITE);
+                error_init(&task->err);
+                /** offsets are relative to the begin of the block until the block is appended */
+                error_cpy(&task->err, &err);
+                task->status = has_strategy && write_string_entries(&memfile, &task->err, &strategy, pool->strings,
+                        pool->string_ids, task->begin, task->end, task->is_last);
+                task->size = memfile_tell(&memfile);
+        }
+        if (has_strategy) {
+                pack_drop(&err, &strategy);
+        }
+        return NULL;
+}
+
+/** Appends the entries encoded by 'string_encode_pool_run' to 'memfile', and rebases their 'next_entry_off' */
+static bool append_string_entries(struct memfile *memfile, struct err *err, struct string_encode_task *task)
+{
+        if (unlikely(!task->status)) {
+                error_cpy(err, &task->err);
+                return false;
+        }
+
+        struct memfile entries;
+        offset_t base = memfile_tell(memfile);
+
+        memfile_open(&entries, task->block, READ_WRITE);
+        for (offset_t pos = 0; pos < task->size; ) {
+                memfile_seek(&entries, pos);
+                struct string_entry_header header = *NG5_MEMFILE_PEEK(&entries, struct string_entry_header);
+                if (header.next_entry_off == 0) {
+                        break;
+                }
+                pos = header.next_entry_off;
+                header.next_entry_off += base;
+                memfile_write(&entries, &header, sizeof(struct string_entry_header));
+        }
+        return memfile_write(memfile, memblock_raw_data(task->block), task->size);
+}
+
+/**
+ * Encodes the strings in ranges concurrently, each range into a memfile of its own that is appended to 'memfile' once
+ * encoded, if there are enough strings to pay off (see NG5_ARCHIVE_PARALLEL_MIN) and more than one core. Returns
+ * false if the strings should be encoded in place, or if encoding failed (see 'err').
+ */
+static bool write_string_entries_parallel(bool *done, struct memfile *memfile, struct err *err,
+        const struct packer *strategy, const char *const *strings, const field_sid_t *string_ids, size_t num_strings)
+{
+        size_t num_threads = ng5_max(1, sysconf(_SC_NPROCESSORS_ONLN));
+        *done = false;
+        if (num_threads < 2 || num_strings < NG5_ARCHIVE_PARALLEL_MIN) {
+                return true;
+        }
+
+        /** ranges are smaller than num_strings / num_threads to balance strings of different lengths */
+        size_t num_tasks = ng5_min(num_threads * 4, num_strings);
+        size_t range_len = (num_strings + num_tasks - 1) / num_tasks;
+        num_tasks = (num_strings + range_len - 1) / range_len;
+        struct string_encode_task *tasks = malloc(num_tasks * sizeof(struct string_encode_task));
+        if (unlikely(!tasks)) {
+                return true;
+        }
+        for (size_t i = 0; i < num_tasks; i++) {
+                tasks[i].begin = i * range_len;
+                tasks[i].end = ng5_min(tasks[i].begin + range_len, num_strings);
+                tasks[i].is_last = i + 1 == num_tasks;
+                tasks[i].block = NULL;
+        }
+
+        struct string_encode_pool pool = {.strategy = strategy, .strings = strings, .string_ids = string_ids,
+                .tasks = tasks, .num_tasks = num_tasks, .next_task = 0};
+        run_pool_threads(&pool, string_encode_pool_run, num_threads);
+
+        bool status = true;
+        for (size_t i = 0; i < num_tasks; i++) {
+                status = status && append_string_entries(memfile, err, tasks + i);
+                memblock_drop(tasks[i].block);
+        }
+        free(tasks);
+        *done = true;
+        return status;
+}
+
+static field_sid_t compact_sid(const struct compact_sids *map, field_sid_t sid)
+{
+        size_t lo = 0, hi = map->num_sids;
+        while (lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (map->sorted[mid] < sid) {
+                        lo = mid + 1;
+                } else {
+                        hi = mid;
+                }
+        }
+        if (unlikely(lo == map->num_sids || map->sorted[lo] != sid)) {
+                assert(sid == NG5_NULL_ENCODED_STRING);
+                return NG5_NULL_ENCODED_STRING;
+        }
+        return map->base + lo;
+}
+
+static void compact_sid_vector(struct vector ofType(field_sid_t) *sids, const struct compact_sids *map)
+{
+        field_sid_t *data = vec_all(sids, field_sid_t);
+        for (u32 i = 0; i < sids->num_elems; i++) {
+                data[i] = compact_sid(map, data[i]);
+        }
+}
+
+static void compact_objects_sids(struct vector ofType(struct columndoc_obj) *objects, const struct compact_sids *map)
+{
+        for (u32 i = 0; i < objects->num_elems; i++) {
+                compact_object_sids(vec_get(objects, i, struct columndoc_obj), map);
+        }
+}
+
+/** replaces all string ids in 'columndoc' and its nested objects by their compact ids */
+static void compact_object_sids(struct columndoc_obj *columndoc, const struct compact_sids *map)
+{
+        /** key columns, and string values of properties */
+        struct vector ofType(field_sid_t) *sids[] =
+                {columndoc->bool_prop_keys, columndoc->int8_prop_keys, columndoc->int16_prop_keys,
+                 columndoc->int32_prop_keys, columndoc->int64_prop_keys, columndoc->uint8_prop_keys,
+                 columndoc->uint16_prop_keys, columndoc->uin32_prop_keys, columndoc->uint64_prop_keys,
+                 columndoc->string_prop_keys, columndoc->float_prop_keys, columndoc->null_prop_keys,
+                 columndoc->obj_prop_keys, columndoc->bool_array_prop_keys, columndoc->int8_array_prop_keys,
+                 columndoc->int16_array_prop_keys, columndoc->int32_array_prop_keys, columndoc->int64_array_prop_keys,
+                 columndoc->uint8_array_prop_keys, columndoc->uint16_array_prop_keys,
+                 columndoc->uint32_array_prop_keys, columndoc->uint64_array_prop_keys,
+                 columndoc->string_array_prop_keys, columndoc->float_array_prop_keys,
+                 columndoc->null_array_prop_keys, columndoc->string_prop_vals};
+
+        columndoc->parent_key = compact_sid(map, columndoc->parent_key);
+        for (size_t i = 0; i < sizeof(sids) / sizeof(sids[0]); i++) {
+                compact_sid_vector(sids[i], map);
+        }
+        for (u32 i = 0; i < columndoc->string_array_prop_vals->num_elems; i++) {
+                compact_sid_vector(vec_get(columndoc->string_array_prop_vals, i, struct vector), map);
+        }
+        compact_objects_sids(columndoc->obj_prop_vals, map);
+
+        for (u32 i = 0; i < columndoc->obj_array_props->num_elems; i++) {
+                struct columndoc_group *group = vec_get(columndoc->obj_array_props, i, struct columndoc_group);
+                group->key = compact_sid(map, group->key);
+                for (u32 k = 0; k < group->columns.num_elems; k++) {
+                        struct columndoc_column *column = vec_get(&group->columns, k, struct columndoc_column);
+                        column->key_name = compact_sid(map, column->key_name);
+                        for (u32 e = 0; e < column->values.num_elems; e++) {
+                                struct vector *entry = vec_get(&column->values, e, struct vector);
+                                if (column->type == FIELD_STRING) {
+                                        compact_sid_vector(entry, map);
+                                } else if (column->type == FIELD_OBJECT) {
+                                        compact_objects_sids(entry, map);
+                                }
+                        }
+                }
+        }
+}
+
+/**
+ * Writes the string table sorted by string id, in which each string has its compact id, and returns the mapping of
+ * string ids to compact ids in 'map' (whose 'sorted' ids are owned by the caller)
+ */
+static bool serialize_string_dic(struct memfile *memfile, struct err *err, struct compact_sids *map,
+        const struct doc_bulk *context, enum packer_type compressor)
 {
         union string_tab_flags flags;
         struct packer strategy;
         struct string_table_header header;
+        struct allocator alloc;
 
         struct vector ofType (const char *) *strings;
         struct vector ofType(field_sid_t) *string_ids;
@@ -1416,6 +2620,25 @@ static bool serialize_string_dic(struct memfile *memfile, struct err *err, const
         u8 flag_bit = pack_flagbit_by_type(compressor);
         ng5_set_bits(flags.value, flag_bit);
 
+        size_t num_strings = strings->num_elems;
+        const char **sorted_strings = malloc(ng5_max(num_strings * sizeof(const char *), 1u));
+        field_sid_t *compact_ids = malloc(ng5_max(num_strings * sizeof(field_sid_t), 1u));
+        size_t *order = malloc(ng5_max(num_strings * sizeof(size_t), 1u));
+        alloc_create_std(&alloc);
+        sort_argsort(order, vec_all(string_ids, field_sid_t), SORT_KEY_SID, num_strings, &alloc);
+
+        map->sorted = malloc(ng5_max(num_strings * sizeof(field_sid_t), 1u));
+        map->num_sids = num_strings;
+        for (size_t i = 0; i < num_strings; i++) {
+                map->sorted[i] = *vec_get(string_ids, order[i], field_sid_t);
+                sorted_strings[i] = *vec_get(strings, order[i], const char *);
+        }
+        map->base = num_strings > 0 && map->sorted[0] == NG5_NULL_ENCODED_STRING ? 0 : 1;
+        for (size_t i = 0; i < num_strings; i++) {
+                compact_ids[i] = map->base + i;
+        }
+        free(order);
+
         offset_t header_pos = memfile_tell(memfile);
         memfile_skip(memfile, sizeof(struct string_table_header));
 
@@ -1428,26 +2651,16 @@ static bool serialize_string_dic(struct memfile *memfile, struct err *err, const
                 ->num_elems, .first_entry = memfile_tell(memfile), .compressor_extra_size = (extra_end_off
                 - extra_begin_off)};
 
-        for (size_t i = 0; i < strings->num_elems; i++) {
-                field_sid_t id = *vec_get(string_ids, i, field_sid_t);
-                const char *string = *vec_get(strings, i, char *);
-
-                struct string_entry_header header = {.marker = marker_symbols[MARKER_TYPE_EMBEDDED_UNCOMP_STR]
-                        .symbol, .next_entry_off = 0, .string_id = id, .string_len = strlen(string)};
-
-                offset_t header_pos_off = memfile_tell(memfile);
-                memfile_skip(memfile, sizeof(struct string_entry_header));
-
-                if (!pack_encode(err, &strategy, memfile, string)) {
-                        error_print(err.code);
-                        return false;
-                }
-                offset_t continue_off = memfile_tell(memfile);
-                memfile_seek(memfile, header_pos_off);
-                header.next_entry_off = i + 1 < strings->num_elems ? continue_off : 0;
-                memfile_write(memfile, &header, sizeof(struct string_entry_header));
-                memfile_seek(memfile, continue_off);
+        bool encoded_parallel;
+        if (!write_string_entries_parallel(&encoded_parallel, memfile, err, &strategy, sorted_strings, compact_ids,
+                        num_strings)
+                || (!encoded_parallel && !write_string_entries(memfile, err, &strategy, sorted_strings, compact_ids,
+                        0, num_strings, true))) {
+                error_print(err.code);
+                return false;
         }
+        free(sorted_strings);
+        free(compact_ids);
 
         offset_t continue_pos = memfile_tell(memfile);
         memfile_seek(memfile, header_pos);
@@ -1467,7 +2680,8 @@ static void skip_file_header(struct memfile *memfile)
         memfile_skip(memfile, sizeof(struct archive_header));
 }
 
-static void update_file_header(struct memfile *memfile, offset_t record_header_offset)
+static void update_file_header(struct memfile *memfile, offset_t record_header_offset,
+        offset_t row_group_directory_offset)
 {
         offset_t current_pos;
         memfile_get_offset(&current_pos, memfile);
@@ -1475,11 +2689,13 @@ static void update_file_header(struct memfile *memfile, offset_t record_header_o
         memcpy(&this_file_header.magic, CARBON_ARCHIVE_MAGIC, strlen(CARBON_ARCHIVE_MAGIC));
         this_file_header.root_object_header_offset = record_header_offset;
         this_file_header.string_id_to_offset_index_offset = 0;
+        this_file_header.row_group_directory_offset = row_group_directory_offset;
         memfile_write(memfile, &this_file_header, sizeof(struct archive_header));
         memfile_seek(memfile, current_pos);
 }
 
-static bool print_column_form_memfile(FILE *file, struct err *err, struct memfile *memfile, unsigned nesting_level)
+static bool print_column_form_memfile(FILE *file, struct err *err, struct memfile *memfile, struct decode_cache *cache,
+        u32 num_objects, unsigned nesting_level)
 {
         offset_t offset;
         memfile_get_offset(&offset, memfile);
@@ -1498,79 +2714,110 @@ static bool print_column_form_memfile(FILE *file, struct err *err, struct memfil
         }
 
         fprintf(file,
-                "[marker: %c (Column)] [column_name: '%"PRIu64"'] [value_type: %c (%s)] [nentries: %d] [",
+                "[marker: %c (Column)] [column_name: '%"PRIu64"'] [value_type: %c (%s)] [nentries: %"PRIu64"] "
+                "[encoding: %s] [",
                 header->marker,
                 header->column_name,
                 header->value_type,
                 type_name,
-                header->num_entries);
+                header->num_entries,
+                int_encoding_str(header->encoding, int_marker_to_field_type(header->value_type)));
 
+        const u8 *entry_offsets = (const u8 *) header + header->entry_offsets;
+        const offset_t *entry_offs = int_read_entry_offsets(cache, entry_offsets, header->num_entries, offset);
         for (size_t i = 0; i < header->num_entries; i++) {
-                offset_t entry_off = *NG5_MEMFILE_READ_TYPE(memfile, offset_t);
-                fprintf(file, "offset: 0x%04x%s", (unsigned) entry_off, i + 1 < header->num_entries ? ", " : "");
+                fprintf(file, "offset: 0x%04x%s", (unsigned) entry_offs[i], i + 1 < header->num_entries ? ", " : "");
         }
 
+        int_align(cache, memfile, NG5_ARCHIVE_CACHE_LINE);
         u32 *positions = (u32 *) NG5_MEMFILE_READ(memfile, header->num_entries * sizeof(u32));
         fprintf(file, "] [positions: [");
         for (size_t i = 0; i < header->num_entries; i++) {
                 fprintf(file, "%d%s", positions[i], i + 1 < header->num_entries ? ", " : "");
         }
+        fprintf(file, "]");
 
-        fprintf(file, "]]\n");
+        union column_flags flags = {.value = header->flags};
+        if (flags.bits.has_validity) {
+                const u8 *validity = NG5_MEMFILE_READ_TYPE_LIST(memfile, u8, (num_objects + 7) / 8);
+                fprintf(file, " [validity: ");
+                for (u32 i = 0; i < num_objects; i++) {
+                        fprintf(file, "%d", (validity[i >> 3] >> (i & 7)) & 1);
+                }
+                fprintf(file, "]");
+        }
+
+        fprintf(file, "]\n");
 
         field_e data_type = int_marker_to_field_type(header->value_type);
 
-        //fprintf(file, "[");
+        /** values of columns that are stored as a run are decoded at once; entries are consecutive slices of them */
+        void *run_values = NULL;
+        const char *column_values = NULL;
+        if (int_column_is_run(header->encoding, data_type)) {
+                u32 num_values = *NG5_MEMFILE_READ_TYPE(memfile, u32);
+                offset_t run_offset;
+                memfile_get_offset(&run_offset, memfile);
+                int_read_values(&run_values, memfile, header->encoding, data_type, GET_TYPE_SIZE(data_type),
+                        num_values);
+                column_values = run_values;
+                fprintf(file, "0x%04x ", (unsigned) run_offset);
+                INTENT_LINE(nesting_level);
+                fprintf(file, "   [num_values: %d]\n", num_values);
+        }
+
         for (size_t i = 0; i < header->num_entries; i++) {
+                /** entries may be preceded by padding in aligned record tables */
+                memfile_seek(memfile, entry_offs[i]);
                 switch (data_type) {
                 case FIELD_NULL: {
-                        PRINT_VALUE_ARRAY(u32, memfile, header, "%d");
+                        PRINT_VALUE_ARRAY(u32, memfile, header, column_values, "%d");
                 }
                         break;
                 case FIELD_BOOLEAN: {
-                        PRINT_VALUE_ARRAY(FIELD_BOOLEANean_t, memfile, header, "%d");
+                        PRINT_VALUE_ARRAY(FIELD_BOOLEANean_t, memfile, header, column_values, "%d");
                 }
                         break;
                 case FIELD_INT8: {
-                        PRINT_VALUE_ARRAY(field_i8_t, memfile, header, "%d");
+                        PRINT_VALUE_ARRAY(field_i8_t, memfile, header, column_values, "%d");
                 }
                         break;
                 case FIELD_INT16: {
-                        PRINT_VALUE_ARRAY(field_i16_t, memfile, header, "%d");
+                        PRINT_VALUE_ARRAY(field_i16_t, memfile, header, column_values, "%d");
                 }
                         break;
                 case FIELD_INT32: {
-                        PRINT_VALUE_ARRAY(field_i32_t, memfile, header, "%d");
+                        PRINT_VALUE_ARRAY(field_i32_t, memfile, header, column_values, "%d");
                 }
                         break;
                 case FIELD_INT64: {
-                        PRINT_VALUE_ARRAY(field_i64_t, memfile, header, "%"
+                        PRINT_VALUE_ARRAY(field_i64_t, memfile, header, column_values, "%"
                                 PRIi64);
                 }
                         break;
                 case FIELD_UINT8: {
-                        PRINT_VALUE_ARRAY(field_u8_t, memfile, header, "%d");
+                        PRINT_VALUE_ARRAY(field_u8_t, memfile, header, column_values, "%d");
                 }
                         break;
                 case FIELD_UINT16: {
-                        PRINT_VALUE_ARRAY(field_u16_t, memfile, header, "%d");
+                        PRINT_VALUE_ARRAY(field_u16_t, memfile, header, column_values, "%d");
                 }
                         break;
                 case FIELD_UINT32: {
-                        PRINT_VALUE_ARRAY(field_u32_t, memfile, header, "%d");
+                        PRINT_VALUE_ARRAY(field_u32_t, memfile, header, column_values, "%d");
                 }
                         break;
                 case FIELD_UINT64: {
-                        PRINT_VALUE_ARRAY(field_u64_t, memfile, header, "%"
+                        PRINT_VALUE_ARRAY(field_u64_t, memfile, header, column_values, "%"
                                 PRIu64);
                 }
                         break;
                 case FIELD_FLOAT: {
-                        PRINT_VALUE_ARRAY(field_number_t, memfile, header, "%f");
+                        PRINT_VALUE_ARRAY(field_number_t, memfile, header, column_values, "%f");
                 }
                         break;
                 case FIELD_STRING: {
-                        PRINT_VALUE_ARRAY(field_sid_t, memfile, header, "%"
+                        PRINT_VALUE_ARRAY(field_sid_t, memfile, header, column_values, "%"
                                 PRIu64
                                 "");
                 }
@@ -1580,7 +2827,7 @@ static bool print_column_form_memfile(FILE *file, struct err *err, struct memfil
                         INTENT_LINE(nesting_level);
                         fprintf(file, "   [num_elements: %d] [values: [\n", num_elements);
                         for (size_t i = 0; i < num_elements; i++) {
-                                if (!print_object(file, err, memfile, nesting_level + 2)) {
+                                if (!print_object(file, err, memfile, cache, nesting_level + 2)) {
                                         return false;
                                 }
                         }
@@ -1589,14 +2836,21 @@ static bool print_column_form_memfile(FILE *file, struct err *err, struct memfil
                 }
                         break;
                 default: error(err, NG5_ERR_NOTYPE)
+                        free(run_values);
                         return false;
                 }
         }
+        free(run_values);
+
+        /** the offsets of the entries follow the last entry */
+        memfile_seek(memfile, offset + header->entry_offsets);
+        memfile_skip(memfile, sizeof(u8) + intpack_encoded_size(entry_offsets + 1, entry_offsets[0],
+                header->num_entries, sizeof(offset_t)));
         return true;
 }
 
 static bool print_object_array_from_memfile(FILE *file, struct err *err, struct memfile *memfile,
-        unsigned nesting_level)
+        struct decode_cache *cache, unsigned nesting_level)
 {
         unsigned offset = (unsigned) memfile_tell(memfile);
         struct object_array_header *header = NG5_MEMFILE_READ_TYPE(memfile, struct object_array_header);
@@ -1611,9 +2865,9 @@ static bool print_object_array_from_memfile(FILE *file, struct err *err, struct
         INTENT_LINE(nesting_level);
         fprintf(file, "[marker: %c (Object Array)] [nentries: %d] [", header->marker, header->num_entries);
 
+        const field_sid_t *keys = int_read_keys(cache, memfile, header->num_entries);
         for (size_t i = 0; i < header->num_entries; i++) {
-                field_sid_t string_id = *NG5_MEMFILE_READ_TYPE(memfile, field_sid_t);
-                fprintf(file, "key: %"PRIu64"%s", string_id, i + 1 < header->num_entries ? ", " : "");
+                fprintf(file, "key: %"PRIu64"%s", keys[i], i + 1 < header->num_entries ? ", " : "");
         }
         fprintf(file, "] [");
         for (size_t i = 0; i < header->num_entries; i++) {
@@ -1643,10 +2897,11 @@ static bool print_object_array_from_memfile(FILE *file, struct err *err, struct
                 fprintf(file, "0x%04x ", offset);
                 INTENT_LINE(nesting_level);
                 fprintf(file,
-                        "[marker: %c (Column Group)] [num_columns: %d] [num_objects: %d] [object_ids: ",
+                        "[marker: %c (Column Group)] [num_columns: %d] [num_objects: %"PRIu64"] [object_ids: ",
                         column_group_header->marker,
                         column_group_header->num_columns,
                         column_group_header->num_objects);
+                int_align(cache, memfile, sizeof(object_id_t));
                 const object_id_t
                         *oids = NG5_MEMFILE_READ_TYPE_LIST(memfile, object_id_t, column_group_header->num_objects);
                 for (size_t k = 0; k < column_group_header->num_objects; k++) {
@@ -1664,7 +2919,9 @@ static bool print_object_array_from_memfile(FILE *file, struct err *err, struct
                 fprintf(file, "]\n");
 
                 for (size_t k = 0; k < column_group_header->num_columns; k++) {
-                        if (!print_column_form_memfile(file, err, memfile, nesting_level + 1)) {
+                        int_align(cache, memfile, NG5_ARCHIVE_CACHE_LINE);
+                        if (!print_column_form_memfile(file, err, memfile, cache, column_group_header->num_objects,
+                                nesting_level + 1)) {
                                 return false;
                         }
                 }
@@ -1759,7 +3016,8 @@ static void print_prop_offsets(FILE *file, const union object_flags *flags,
         }
 }
 
-bool print_object(FILE *file, struct err *err, struct memfile *memfile, unsigned nesting_level)
+bool print_object(FILE *file, struct err *err, struct memfile *memfile, struct decode_cache *cache,
+        unsigned nesting_level)
 {
         unsigned offset = (unsigned) memfile_tell(memfile);
         struct object_header *header = NG5_MEMFILE_READ_TYPE(memfile, struct object_header);
@@ -1796,8 +3054,7 @@ bool print_object(FILE *file, struct err *err, struct memfile *memfile, unsigned
                 switch (entryMarker) {
                 case MARKER_SYMBOL_PROP_NULL: {
                         struct prop_header *prop_header = NG5_MEMFILE_READ_TYPE(memfile, struct prop_header);
-                        field_sid_t *keys = (field_sid_t *) NG5_MEMFILE_READ(memfile,
-                                prop_header->num_entries * sizeof(field_sid_t));
+                        const field_sid_t *keys = int_read_keys(cache, memfile, prop_header->num_entries);
                         fprintf(file, "0x%04x ", offset);
                         INTENT_LINE(nesting_level)
                         fprintf(file, "[marker: %c (null)] [nentries: %d] [", entryMarker, prop_header->num_entries);
@@ -1810,13 +3067,14 @@ bool print_object(FILE *file, struct err *err, struct memfile *memfile, unsigned
                         break;
                 case MARKER_SYMBOL_PROP_BOOLEAN: {
                         struct prop_header *prop_header = NG5_MEMFILE_READ_TYPE(memfile, struct prop_header);
-                        field_sid_t *keys = (field_sid_t *) NG5_MEMFILE_READ(memfile,
-                                prop_header->num_entries * sizeof(field_sid_t));
-                        FIELD_BOOLEANean_t *values = (FIELD_BOOLEANean_t *) NG5_MEMFILE_READ(memfile,
-                                prop_header->num_entries * sizeof(FIELD_BOOLEANean_t));
+                        const field_sid_t *keys = int_read_keys(cache, memfile, prop_header->num_entries);
+                        void *decoded;
+                        const FIELD_BOOLEANean_t *values = int_read_values(&decoded, memfile, prop_header->encoding,
+                                FIELD_BOOLEAN, sizeof(FIELD_BOOLEANean_t), prop_header->num_entries);
                         fprintf(file, "0x%04x ", offset);
                         INTENT_LINE(nesting_level)
-                        fprintf(file, "[marker: %c (boolean)] [nentries: %d] [", entryMarker, prop_header->num_entries);
+                        fprintf(file, "[marker: %c (boolean)] [nentries: %d] [encoding: %s] [", entryMarker,
+                                prop_header->num_entries, intpack_type_str(prop_header->encoding));
                         for (u32 i = 0; i < prop_header->num_entries; i++) {
                                 fprintf(file, "%"PRIu64"%s", keys[i], i + 1 < prop_header->num_entries ? ", " : "");
                         }
@@ -1828,6 +3086,7 @@ bool print_object(FILE *file, struct err *err, struct memfile *memfile, unsigned
                                         i + 1 < prop_header->num_entries ? ", " : "");
                         }
                         fprintf(file, "]\n");
+                        free(decoded);
                 }
                         break;
                 case MARKER_SYMBOL_PROP_INT8: PRINT_SIMPLE_PROPS(file,
@@ -1916,7 +3175,7 @@ bool print_object(FILE *file, struct err *err, struct memfile *memfile, unsigned
                         break;
                 case MARKER_SYMBOL_PROP_OBJECT: {
                         struct var_prop prop;
-                        int_embedded_var_props_read(&prop, memfile);
+                        int_embedded_var_props_read(&prop, memfile, cache);
                         fprintf(file, "0x%04x ", offset);
                         INTENT_LINE(nesting_level)
                         fprintf(file, "[marker: %c (Object)] [nentries: %d] [", entryMarker, prop.header->num_entries);
@@ -1937,7 +3196,7 @@ bool print_object(FILE *file, struct err *err, struct memfile *memfile, unsigned
 
                         char nextEntryMarker;
                         do {
-                                if (!print_object(file, err, memfile, nesting_level + 1)) {
+                                if (!print_object(file, err, memfile, cache, nesting_level + 1)) {
                                         return false;
                                 }
                                 nextEntryMarker = *NG5_MEMFILE_PEEK(memfile, char);
@@ -1949,8 +3208,7 @@ bool print_object(FILE *file, struct err *err, struct memfile *memfile, unsigned
                 case MARKER_SYMBOL_PROP_NULL_ARRAY: {
                         struct prop_header *prop_header = NG5_MEMFILE_READ_TYPE(memfile, struct prop_header);
 
-                        field_sid_t *keys = (field_sid_t *) NG5_MEMFILE_READ(memfile,
-                                prop_header->num_entries * sizeof(field_sid_t));
+                        const field_sid_t *keys = int_read_keys(cache, memfile, prop_header->num_entries);
                         u32 *nullArrayLengths;
 
                         fprintf(file, "0x%04x ", offset);
@@ -1965,7 +3223,7 @@ bool print_object(FILE *file, struct err *err, struct memfile *memfile, unsigned
                         }
                         fprintf(file, "] [");
 
-                        nullArrayLengths = (u32 *) NG5_MEMFILE_READ(memfile, prop_header->num_entries * sizeof(u32));
+                        nullArrayLengths = (u32 *) int_read_lengths(cache, memfile, prop_header->num_entries);
 
                         for (u32 i = 0; i < prop_header->num_entries; i++) {
                                 fprintf(file,
@@ -1980,36 +3238,39 @@ bool print_object(FILE *file, struct err *err, struct memfile *memfile, unsigned
                 case MARKER_SYMBOL_PROP_BOOLEAN_ARRAY: {
                         struct prop_header *prop_header = NG5_MEMFILE_READ_TYPE(memfile, struct prop_header);
 
-                        field_sid_t *keys = (field_sid_t *) NG5_MEMFILE_READ(memfile,
-                                prop_header->num_entries * sizeof(field_sid_t));
+                        const field_sid_t *keys = int_read_keys(cache, memfile, prop_header->num_entries);
                         u32 *array_lengths;
 
                         fprintf(file, "0x%04x ", offset);
                         INTENT_LINE(nesting_level)
                         fprintf(file,
-                                "[marker: %c (Boolean Array)] [nentries: %d] [",
+                                "[marker: %c (Boolean Array)] [nentries: %d] [encoding: %s] [",
                                 entryMarker,
-                                prop_header->num_entries);
+                                prop_header->num_entries,
+                                intpack_type_str(prop_header->encoding));
 
                         for (u32 i = 0; i < prop_header->num_entries; i++) {
                                 fprintf(file, "%"PRIu64"%s", keys[i], i + 1 < prop_header->num_entries ? ", " : "");
                         }
                         fprintf(file, "] [");
 
-                        array_lengths = (u32 *) NG5_MEMFILE_READ(memfile, prop_header->num_entries * sizeof(u32));
+                        array_lengths = (u32 *) int_read_lengths(cache, memfile, prop_header->num_entries);
 
+                        u32 num_values = 0;
                         for (u32 i = 0; i < prop_header->num_entries; i++) {
                                 fprintf(file,
                                         "arrayLength: %d%s",
                                         array_lengths[i],
                                         i + 1 < prop_header->num_entries ? ", " : "");
+                                num_values += array_lengths[i];
                         }
 
                         fprintf(file, "] [");
 
+                        void *decoded;
+                        const FIELD_BOOLEANean_t *values = int_read_values(&decoded, memfile, prop_header->encoding,
+                                FIELD_BOOLEAN, sizeof(FIELD_BOOLEANean_t), num_values);
                         for (u32 array_idx = 0; array_idx < prop_header->num_entries; array_idx++) {
-                                FIELD_BOOLEANean_t *values = (FIELD_BOOLEANean_t *) NG5_MEMFILE_READ(memfile,
-                                        array_lengths[array_idx] * sizeof(FIELD_BOOLEANean_t));
                                 fprintf(file, "[");
                                 for (u32 i = 0; i < array_lengths[array_idx]; i++) {
                                         fprintf(file,
@@ -2017,8 +3278,10 @@ bool print_object(FILE *file, struct err *err, struct memfile *memfile, unsigned
                                                 values[i] ? "true" : "false",
                                                 i + 1 < array_lengths[array_idx] ? ", " : "");
                                 }
+                                values += array_lengths[array_idx];
                                 fprintf(file, "]%s", array_idx + 1 < prop_header->num_entries ? ", " : "");
                         }
+                        free(decoded);
 
                         fprintf(file, "]\n");
                 }
@@ -2111,7 +3374,7 @@ bool print_object(FILE *file, struct err *err, struct memfile *memfile, unsigned
                         "");
                         break;
                 case MARKER_SYMBOL_PROP_OBJECT_ARRAY:
-                        if (!print_object_array_from_memfile(file, err, memfile, nesting_level)) {
+                        if (!print_object_array_from_memfile(file, err, memfile, cache, nesting_level)) {
                                 return false;
                         }
                         break;
@@ -2160,12 +3423,12 @@ static bool is_valid_file(const struct archive_header *header)
         }
 }
 
-static void print_record_header_from_memfile(FILE *file, struct memfile *memfile)
+static union record_flags print_record_header_from_memfile(FILE *file, struct memfile *memfile)
 {
         unsigned offset = memfile_tell(memfile);
         struct record_header *header = NG5_MEMFILE_READ_TYPE(memfile, struct record_header);
-        struct record_flags flags;
-        memset(&flags, 0, sizeof(struct record_flags));
+        union record_flags flags;
+        memset(&flags, 0, sizeof(union record_flags));
         flags.value = header->flags;
         char *flags_string = record_header_flags_to_string(&flags);
         fprintf(file, "0x%04x ", offset);
@@ -2175,9 +3438,11 @@ static void print_record_header_from_memfile(FILE *file, struct memfile *memfile
                 flags_string,
                 (unsigned) header->record_size);
         free(flags_string);
+        return flags;
 }
 
-static bool print_header_from_memfile(FILE *file, struct err *err, struct memfile *memfile)
+static bool print_header_from_memfile(offset_t *record_header_offset, offset_t *row_group_directory_offset, FILE *file,
+        struct err *err, struct memfile *memfile)
 {
         unsigned offset = memfile_tell(memfile);
         assert(memfile_size(memfile) > sizeof(struct archive_header));
@@ -2189,10 +3454,54 @@ static bool print_header_from_memfile(FILE *file, struct err *err, struct memfil
 
         fprintf(file, "0x%04x ", offset);
         fprintf(file,
-                "[magic: " CARBON_ARCHIVE_MAGIC "] [version: %d] [recordOffset: 0x%04x] [string-id-offset-index: 0x%04x]\n",
+                "[magic: " CARBON_ARCHIVE_MAGIC "] [version: %d] [recordOffset: 0x%04x] "
+                "[string-id-offset-index: 0x%04x] [row-group-directory: 0x%04x]\n",
                 header->version,
                 (unsigned) header->root_object_header_offset,
-                (unsigned) header->string_id_to_offset_index_offset);
+                (unsigned) header->string_id_to_offset_index_offset,
+                (unsigned) header->row_group_directory_offset);
+        *record_header_offset = header->root_object_header_offset;
+        *row_group_directory_offset = header->row_group_directory_offset;
+        return true;
+}
+
+static bool print_row_group_directory_from_memfile(FILE *file, struct err *err, struct memfile *memfile)
+{
+        unsigned offset = memfile_tell(memfile);
+        const struct row_group_directory_header *header =
+                NG5_MEMFILE_READ_TYPE(memfile, struct row_group_directory_header);
+        if (header->marker != marker_symbols[MARKER_TYPE_ROW_GROUP_DIRECTORY].symbol) {
+                error(err, NG5_ERR_CORRUPTED);
+                return false;
+        }
+        fprintf(file, "0x%04x ", offset);
+        fprintf(file, "[marker: %c] [size: %" PRIu64 "] [row-group-size: %" PRIu64 "] [num-collections: %" PRIu32 "]\n",
+                header->marker, header->size, header->row_group_size, header->num_collections);
+
+        for (u32 i = 0; i < header->num_collections; i++) {
+                offset = memfile_tell(memfile);
+                const struct row_group_collection *collection =
+                        NG5_MEMFILE_READ_TYPE(memfile, struct row_group_collection);
+                fprintf(file, "0x%04x    [column-group: 0x%04x] [num-objects: %" PRIu64 "] [num-columns: %" PRIu32 "] "
+                        "[num-row-groups: %" PRIu32 "]\n", offset, (unsigned) collection->column_group,
+                        collection->num_objects, collection->num_columns, collection->num_row_groups);
+                const u8 *zone_maps = NG5_MEMFILE_READ_TYPE_LIST(memfile, u8, collection->num_columns);
+                for (u32 k = 0; k < collection->num_columns; k++) {
+                        for (u32 g = 0; g < collection->num_row_groups; g++) {
+                                offset = memfile_tell(memfile);
+                                const struct row_group_zone *zone =
+                                        NG5_MEMFILE_READ_TYPE(memfile, struct row_group_zone);
+                                fprintf(file, "0x%04x       [column: %" PRIu32 "] [row-group: %" PRIu32 "] "
+                                        "[entries: %" PRIu64 "+%" PRIu64 "] [values: %" PRIu64 "+%" PRIu64 "]",
+                                        offset, k, g, zone->first_entry, zone->num_entries, zone->first_value,
+                                        zone->num_values);
+                                if (zone_maps[k]) {
+                                        fprintf(file, " [min: %" PRIu64 "] [max: %" PRIu64 "]", zone->min, zone->max);
+                                }
+                                fprintf(file, "\n");
+                        }
+                }
+        }
         return true;
 }
 
@@ -2217,7 +3526,8 @@ static bool print_embedded_dic_from_memfile(FILE *file, struct err *err, struct
         char *flagsStr = embedded_dic_flags_to_string(&flags);
         fprintf(file, "0x%04x ", offset);
         fprintf(file,
-                "[marker: %c] [nentries: %d] [flags: %s] [first-entry-off: 0x%04x] [extra-size: %" PRIu64 "]\n",
+                "[marker: %c] [nentries: %" PRIu64 "] [flags: %s] [first-entry-off: 0x%04x] "
+                "[extra-size: %" PRIu64 "]\n",
                 header->marker,
                 header->num_entries,
                 flagsStr,
@@ -2251,48 +3561,56 @@ static bool print_embedded_dic_from_memfile(FILE *file, struct err *err, struct
 
 static bool print_archive_from_memfile(FILE *file, struct err *err, struct memfile *memfile)
 {
-        if (!print_header_from_memfile(file, err, memfile)) {
+        offset_t record_header_offset, row_group_directory_offset;
+        if (!print_header_from_memfile(&record_header_offset, &row_group_directory_offset, file, err, memfile)) {
                 return false;
         }
         if (!print_embedded_dic_from_memfile(file, err, memfile)) {
                 return false;
         }
-        print_record_header_from_memfile(file, memfile);
-        if (!print_object(file, err, memfile, 0)) {
-                return false;
+        /** aligned record tables may be preceded by padding */
+        memfile_seek(memfile, record_header_offset);
+        struct decode_cache cache;
+        union record_flags flags = print_record_header_from_memfile(file, memfile);
+        int_decode_cache_create(&cache, flags);
+        bool status = print_object(file, err, memfile, &cache, 0);
+        int_decode_cache_drop(&cache);
+        if (status && row_group_directory_offset) {
+                memfile_seek(memfile, row_group_directory_offset);
+                status = print_row_group_directory_from_memfile(file, err, memfile);
         }
-        return true;
+        return status;
 }
 
 static union object_flags *get_flags(union object_flags *flags, struct columndoc_obj *columndoc)
 {
         ng5_zero_memory(flags, sizeof(union object_flags));
-        flags->bits.has_null_props = (columndoc->null_prop_keys.num_elems > 0);
-        flags->bits.has_bool_props = (columndoc->bool_prop_keys.num_elems > 0);
-        flags->bits.has_int8_props = (columndoc->int8_prop_keys.num_elems > 0);
-        flags->bits.has_int16_props = (columndoc->int16_prop_keys.num_elems > 0);
-        flags->bits.has_int32_props = (columndoc->int32_prop_keys.num_elems > 0);
-        flags->bits.has_int64_props = (columndoc->int64_prop_keys.num_elems > 0);
-        flags->bits.has_uint8_props = (columndoc->uint8_prop_keys.num_elems > 0);
-        flags->bits.has_uint16_props = (columndoc->uint16_prop_keys.num_elems > 0);
-        flags->bits.has_uint32_props = (columndoc->uin32_prop_keys.num_elems > 0);
-        flags->bits.has_uint64_props = (columndoc->uint64_prop_keys.num_elems > 0);
-        flags->bits.has_float_props = (columndoc->float_prop_keys.num_elems > 0);
-        flags->bits.has_string_props = (columndoc->string_prop_keys.num_elems > 0);
-        flags->bits.has_object_props = (columndoc->obj_prop_keys.num_elems > 0);
-        flags->bits.has_null_array_props = (columndoc->null_array_prop_keys.num_elems > 0);
-        flags->bits.has_bool_array_props = (columndoc->bool_array_prop_keys.num_elems > 0);
-        flags->bits.has_int8_array_props = (columndoc->int8_array_prop_keys.num_elems > 0);
-        flags->bits.has_int16_array_props = (columndoc->int16_array_prop_keys.num_elems > 0);
-        flags->bits.has_int32_array_props = (columndoc->int32_array_prop_keys.num_elems > 0);
-        flags->bits.has_int64_array_props = (columndoc->int64_array_prop_keys.num_elems > 0);
-        flags->bits.has_uint8_array_props = (columndoc->uint8_array_prop_keys.num_elems > 0);
-        flags->bits.has_uint16_array_props = (columndoc->uint16_array_prop_keys.num_elems > 0);
-        flags->bits.has_uint32_array_props = (columndoc->uint32_array_prop_keys.num_elems > 0);
-        flags->bits.has_uint64_array_props = (columndoc->uint64_array_prop_keys.num_elems > 0);
-        flags->bits.has_float_array_props = (columndoc->float_array_prop_keys.num_elems > 0);
-        flags->bits.has_string_array_props = (columndoc->string_array_prop_keys.num_elems > 0);
-        flags->bits.has_object_array_props = (columndoc->obj_array_props.num_elems > 0);
+        flags->bits.has_null_props = (columndoc->null_prop_keys->num_elems > 0);
+        flags->bits.has_bool_props = (columndoc->bool_prop_keys->num_elems > 0);
+        flags->bits.has_int8_props = (columndoc->int8_prop_keys->num_elems > 0);
+        flags->bits.has_int16_props = (columndoc->int16_prop_keys->num_elems > 0);
+        flags->bits.has_int32_props = (columndoc->int32_prop_keys->num_elems > 0);
+        flags->bits.has_int64_props = (columndoc->int64_prop_keys->num_elems > 0);
+        flags->bits.has_uint8_props = (columndoc->uint8_prop_keys->num_elems > 0);
+        flags->bits.has_uint16_props = (columndoc->uint16_prop_keys->num_elems > 0);
+        flags->bits.has_uint32_props = (columndoc->uin32_prop_keys->num_elems > 0);
+        flags->bits.has_uint64_props = (columndoc->uint64_prop_keys->num_elems > 0);
+        flags->bits.has_float_props = (columndoc->float_prop_keys->num_elems > 0);
+        flags->bits.has_string_props = (columndoc->string_prop_keys->num_elems > 0);
+        flags->bits.has_object_props = (columndoc->obj_prop_keys->num_elems > 0);
+        flags->bits.has_null_array_props = (columndoc->null_array_prop_keys->num_elems > 0);
+        flags->bits.has_bool_array_props = (columndoc->bool_array_prop_keys->num_elems > 0);
+        flags->bits.has_int8_array_props = (columndoc->int8_array_prop_keys->num_elems > 0);
+        flags->bits.has_int16_array_props = (columndoc->int16_array_prop_keys->num_elems > 0);
+        flags->bits.has_int32_array_props = (columndoc->int32_array_prop_keys->num_elems > 0);
+        flags->bits.has_int64_array_props = (columndoc->int64_array_prop_keys->num_elems > 0);
+        flags->bits.has_uint8_array_props = (columndoc->uint8_array_prop_keys->num_elems > 0);
+        flags->bits.has_uint16_array_props = (columndoc->uint16_array_prop_keys->num_elems > 0);
+        flags->bits.has_uint32_array_props = (columndoc->uint32_array_prop_keys->num_elems > 0);
+        flags->bits.has_uint64_array_props = (columndoc->uint64_array_prop_keys->num_elems > 0);
+        flags->bits.has_float_array_props = (columndoc->float_array_prop_keys->num_elems > 0);
+        flags->bits.has_string_array_props = (columndoc->string_array_prop_keys->num_elems > 0);
+        flags->bits.has_object_array_props = (columndoc->obj_array_props->num_elems > 0);
         //assert(flags->value != 0);
         return flags;
 }
@@ -2307,6 +3625,8 @@ static bool read_record(struct record_header *header_read, struct archive *archi
 static bool read_string_id_to_offset_index(struct err *err, struct archive *archive, const char *file_path,
         offset_t string_id_to_offset_index_offset);
 
+static bool read_row_group_directory(struct archive *archive, FILE *disk_file, offset_t row_group_directory_offset);
+
 bool archive_open(struct archive *out, const char *file_path)
 {
         int status;
@@ -2344,6 +3664,10 @@ bool archive_open(struct archive *out, const char *file_path)
                                         header.root_object_header_offset)) != true) {
                                         return status;
                                 }
+                                if ((status = read_row_group_directory(out, disk_file,
+                                        header.row_group_directory_offset)) != true) {
+                                        return status;
+                                }
 
                                 if (header.string_id_to_offset_index_offset != 0) {
                                         struct err err;
@@ -2374,6 +3698,7 @@ bool archive_open(struct archive *out, const char *file_path)
                                 out->info.string_id_index_size = string_id_index;
                                 out->default_query = malloc(sizeof(struct archive_query));
                                 query_create(out->default_query, out);
+                                int_decode_cache_create(&out->decode_cache, out->record_table.flags);
 
                         }
                 }
@@ -2399,6 +3724,8 @@ NG5_EXPORT(bool) archive_close(struct archive *archive)
         memblock_drop(archive->record_table.recordDataBase);
         query_drop(archive->default_query);
         free(archive->default_query);
+        int_decode_cache_drop(&archive->decode_cache);
+        int_row_groups_drop(&archive->row_groups);
         return true;
 }
 
@@ -2537,6 +3864,33 @@ static bool read_record(struct record_header *header_read, struct archive *archi
         }
 }
 
+static bool read_row_group_directory(struct archive *archive, FILE *disk_file, offset_t row_group_directory_offset)
+{
+        ng5_zero_memory(&archive->row_groups, sizeof(struct row_group_directory));
+        if (row_group_directory_offset == 0) {
+                return true;
+        }
+
+        struct row_group_directory_header header;
+        fseek(disk_file, row_group_directory_offset, SEEK_SET);
+        if (fread(&header, sizeof(struct row_group_directory_header), 1, disk_file) != 1) {
+                error(&archive->err, NG5_ERR_CORRUPTED);
+                return false;
+        }
+        void *data = malloc(header.size);
+        fseek(disk_file, row_group_directory_offset, SEEK_SET);
+        if (!data || fread(data, header.size, 1, disk_file) != 1) {
+                free(data);
+                error(&archive->err, NG5_ERR_CORRUPTED);
+                return false;
+        }
+        if (!int_row_groups_create(&archive->row_groups, data)) {
+                error(&archive->err, NG5_ERR_CORRUPTED);
+                return false;
+        }
+        return true;
+}
+
 static bool read_string_id_to_offset_index(struct err *err, struct archive *archive, const char *file_path,
         offset_t string_id_to_offset_index_offset)
 {
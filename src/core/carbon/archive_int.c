@@ -102,40 +102,40 @@ void int_read_prop_offsets(struct archive_prop_offs *prop_offsets, struct memfil
         }
 }
 
-void int_embedded_fixed_props_read(struct fixed_prop *prop, struct memfile *memfile)
+void int_embedded_fixed_props_read(struct fixed_prop *prop, struct memfile *memfile, struct decode_cache *cache)
 {
         prop->header = NG5_MEMFILE_READ_TYPE(memfile, struct prop_header);
-        prop->keys = (field_sid_t *) NG5_MEMFILE_READ(memfile, prop->header->num_entries * sizeof(field_sid_t));
+        prop->keys = int_read_keys(cache, memfile, prop->header->num_entries);
         prop->values = memfile_peek(memfile, 1);
 }
 
-void int_embedded_var_props_read(struct var_prop *prop, struct memfile *memfile)
+void int_embedded_var_props_read(struct var_prop *prop, struct memfile *memfile, struct decode_cache *cache)
 {
         prop->header = NG5_MEMFILE_READ_TYPE(memfile, struct prop_header);
-        prop->keys = (field_sid_t *) NG5_MEMFILE_READ(memfile, prop->header->num_entries * sizeof(field_sid_t));
+        prop->keys = int_read_keys(cache, memfile, prop->header->num_entries);
         prop->offsets = (offset_t *) NG5_MEMFILE_READ(memfile, prop->header->num_entries * sizeof(offset_t));
         prop->values = memfile_peek(memfile, 1);
 }
 
-void int_embedded_null_props_read(struct null_prop *prop, struct memfile *memfile)
+void int_embedded_null_props_read(struct null_prop *prop, struct memfile *memfile, struct decode_cache *cache)
 {
         prop->header = NG5_MEMFILE_READ_TYPE(memfile, struct prop_header);
-        prop->keys = (field_sid_t *) NG5_MEMFILE_READ(memfile, prop->header->num_entries * sizeof(field_sid_t));
+        prop->keys = int_read_keys(cache, memfile, prop->header->num_entries);
 }
 
-void int_embedded_array_props_read(struct array_prop *prop, struct memfile *memfile)
+void int_embedded_array_props_read(struct array_prop *prop, struct memfile *memfile, struct decode_cache *cache)
 {
         prop->header = NG5_MEMFILE_READ_TYPE(memfile, struct prop_header);
-        prop->keys = (field_sid_t *) NG5_MEMFILE_READ(memfile, prop->header->num_entries * sizeof(field_sid_t));
-        prop->lengths = (u32 *) NG5_MEMFILE_READ(memfile, prop->header->num_entries * sizeof(u32));
+        prop->keys = int_read_keys(cache, memfile, prop->header->num_entries);
+        prop->lengths = int_read_lengths(cache, memfile, prop->header->num_entries);
         prop->values_begin = memfile_tell(memfile);
 }
 
-void int_embedded_table_props_read(struct table_prop *prop, struct memfile *memfile)
+void int_embedded_table_props_read(struct table_prop *prop, struct memfile *memfile, struct decode_cache *cache)
 {
         prop->header->marker = *NG5_MEMFILE_READ_TYPE(memfile, char);
         prop->header->num_entries = *NG5_MEMFILE_READ_TYPE(memfile, u8);
-        prop->keys = (field_sid_t *) NG5_MEMFILE_READ(memfile, prop->header->num_entries * sizeof(field_sid_t));
+        prop->keys = int_read_keys(cache, memfile, prop->header->num_entries);
         prop->groupOffs = (offset_t *) NG5_MEMFILE_READ(memfile, prop->header->num_entries * sizeof(offset_t));
 }
 
@@ -197,4 +197,282 @@ int_marker_to_field_type(char symbol)
                 print_error_and_die(NG5_ERR_MARKERMAPPING);
         }
         }
-}
\ No newline at end of file
+}
+bool int_get_intpack_params(size_t *width, bool *is_signed, field_e type)
+{
+        switch (type) {
+        case FIELD_BOOLEAN:
+                *width = sizeof(FIELD_BOOLEANean_t);
+                break;
+        case FIELD_INT8:
+        case FIELD_UINT8:
+                *width = sizeof(field_i8_t);
+                break;
+        case FIELD_INT16:
+        case FIELD_UINT16:
+                *width = sizeof(field_i16_t);
+                break;
+        case FIELD_INT32:
+        case FIELD_UINT32:
+                *width = sizeof(field_i32_t);
+                break;
+        case FIELD_INT64:
+        case FIELD_UINT64:
+                *width = sizeof(field_i64_t);
+                break;
+        case FIELD_STRING:
+                *width = sizeof(field_sid_t);
+                break;
+        default:
+                return false;
+        }
+        *is_signed = type == FIELD_INT8 || type == FIELD_INT16 || type == FIELD_INT32 || type == FIELD_INT64;
+        return true;
+}
+
+const char *int_encoding_str(u8 encoding, field_e type)
+{
+        return type == FIELD_FLOAT ? floatpack_type_str(encoding) : intpack_type_str(encoding);
+}
+
+bool int_column_is_run(u8 encoding, field_e type)
+{
+        return type == FIELD_FLOAT ? encoding != FLOATPACK_PLAIN : encoding == INTPACK_RLE;
+}
+
+/** returns false if values of 'type' that are stored with 'encoding' are plain, and otherwise their width */
+static bool must_decode(size_t *width, u8 encoding, field_e type)
+{
+        bool is_signed;
+        if (type == FIELD_FLOAT) {
+                *width = sizeof(field_number_t);
+                return encoding != FLOATPACK_PLAIN;
+        }
+        return encoding != INTPACK_PLAIN && int_get_intpack_params(width, &is_signed, type);
+}
+
+/** decodes the 'num_values' values of 'type' that are stored with 'encoding' at 'src', and returns their size */
+static size_t decode(void *dst, const void *src, u8 encoding, field_e type, u32 num_values)
+{
+        size_t width = 0;
+        bool is_signed = false;
+        if (type == FIELD_FLOAT) {
+                return floatpack_decode(dst, src, encoding, num_values);
+        }
+        int_get_intpack_params(&width, &is_signed, type);
+        return intpack_decode(dst, src, encoding, num_values, width, is_signed);
+}
+
+bool int_decode_cache_create(struct decode_cache *cache, union record_flags flags)
+{
+        error_if_null(cache)
+        spin_init(&cache->lock);
+        cache->sid32 = flags.bits.sid32;
+        cache->aligned = flags.bits.aligned;
+        return hashmap_decoded_runs_create(&cache->runs, NULL, 64);
+}
+
+bool int_decode_cache_drop(struct decode_cache *cache)
+{
+        error_if_null(cache)
+        u64 src;
+        void **decoded;
+        u32 it = 0;
+        while (hashmap_decoded_runs_next(&src, &decoded, &it, &cache->runs)) {
+                free(*decoded);
+        }
+        return hashmap_decoded_runs_drop(&cache->runs);
+}
+
+const void *int_decode_cache_get(struct decode_cache *cache, const void *src, u8 encoding, field_e type,
+        u32 num_values)
+{
+        size_t width;
+        if (!must_decode(&width, encoding, type)) {
+                return src;
+        }
+
+        u64 key = (u64) (uintptr_t) src;
+        spin_acquire(&cache->lock);
+        void **cached = hashmap_decoded_runs_get(&cache->runs, key);
+        void *decoded = cached ? *cached : NULL;
+        spin_release(&cache->lock);
+
+        if (!decoded) {
+                /** decode outside the lock; if another thread decoded the same run meanwhile, its result is kept */
+                decoded = malloc(ng5_max(num_values * width, 1u));
+                decode(decoded, src, encoding, type, num_values);
+                spin_acquire(&cache->lock);
+                if ((cached = hashmap_decoded_runs_get(&cache->runs, key))) {
+                        free(decoded);
+                        decoded = *cached;
+                } else {
+                        hashmap_decoded_runs_put(&cache->runs, key, decoded);
+                }
+                spin_release(&cache->lock);
+        }
+        return decoded;
+}
+
+const field_sid_t *int_read_keys(struct decode_cache *cache, struct memfile *memfile, u32 num_keys)
+{
+        int_align(cache, memfile, sizeof(u32));
+        if (!cache->sid32) {
+                const field_sid_t *keys = (const field_sid_t *) NG5_MEMFILE_READ(memfile,
+                        num_keys * sizeof(field_sid_t));
+                int_align(cache, memfile, sizeof(u64));
+                return keys;
+        }
+
+        const u32 *keys = (const u32 *) NG5_MEMFILE_READ(memfile, num_keys * sizeof(u32));
+        int_align(cache, memfile, sizeof(u64));
+        u64 key = (u64) (uintptr_t) keys;
+        spin_acquire(&cache->lock);
+        void **cached = hashmap_decoded_runs_get(&cache->runs, key);
+        field_sid_t *widened = cached ? *cached : NULL;
+        spin_release(&cache->lock);
+
+        if (!widened) {
+                widened = malloc(ng5_max(num_keys * sizeof(field_sid_t), 1u));
+                for (u32 i = 0; i < num_keys; i++) {
+                        widened[i] = keys[i];
+                }
+                spin_acquire(&cache->lock);
+                if ((cached = hashmap_decoded_runs_get(&cache->runs, key))) {
+                        free(widened);
+                        widened = *cached;
+                } else {
+                        hashmap_decoded_runs_put(&cache->runs, key, widened);
+                }
+                spin_release(&cache->lock);
+        }
+        return widened;
+}
+
+const u32 *int_read_lengths(struct decode_cache *cache, struct memfile *memfile, u32 num_lengths)
+{
+        const u32 *lengths = NG5_MEMFILE_READ_TYPE_LIST(memfile, u32, num_lengths);
+        int_align(cache, memfile, sizeof(u64));
+        return lengths;
+}
+
+size_t int_array_alignment(size_t width, size_t num_bytes)
+{
+        return num_bytes >= NG5_ARCHIVE_ALIGN_LARGE ? NG5_ARCHIVE_CACHE_LINE : width;
+}
+
+offset_t int_align_offset(offset_t pos, size_t alignment)
+{
+        return (pos + alignment - 1) & ~((offset_t) alignment - 1);
+}
+
+void int_align(struct decode_cache *cache, struct memfile *memfile, size_t alignment)
+{
+        if (cache->aligned) {
+                offset_t pos = memfile_tell(memfile);
+                memfile_skip(memfile, int_align_offset(pos, alignment) - pos);
+        }
+}
+
+const offset_t *int_read_entry_offsets(struct decode_cache *cache, const void *src, u32 num_entries,
+        offset_t column_off)
+{
+        u64 key = (u64) (uintptr_t) src;
+        spin_acquire(&cache->lock);
+        void **cached = hashmap_decoded_runs_get(&cache->runs, key);
+        offset_t *offsets = cached ? *cached : NULL;
+        spin_release(&cache->lock);
+
+        if (!offsets) {
+                const u8 *in = src;
+                offsets = malloc(ng5_max(num_entries * sizeof(offset_t), 1u));
+                intpack_decode(offsets, in + 1, in[0], num_entries, sizeof(offset_t), false);
+                for (u32 i = 0; i < num_entries; i++) {
+                        offsets[i] += column_off;
+                }
+                spin_acquire(&cache->lock);
+                if ((cached = hashmap_decoded_runs_get(&cache->runs, key))) {
+                        free(offsets);
+                        offsets = *cached;
+                } else {
+                        hashmap_decoded_runs_put(&cache->runs, key, offsets);
+                }
+                spin_release(&cache->lock);
+        }
+        return offsets;
+}
+
+const void *int_read_values(void **decoded, struct memfile *memfile, u8 encoding, field_e type, size_t value_size,
+        u32 num_values)
+{
+        size_t width;
+        *decoded = NULL;
+        if (!must_decode(&width, encoding, type)) {
+                return NG5_MEMFILE_READ(memfile, num_values * value_size);
+        }
+        *decoded = malloc(ng5_max(num_values * width, 1u));
+        memfile_skip(memfile, decode(*decoded, memfile_peek(memfile, 1), encoding, type, num_values));
+        return *decoded;
+}
+
+static size_t row_group_collection_size(const struct row_group_collection *collection)
+{
+        return sizeof(struct row_group_collection) + collection->num_columns +
+                (size_t) collection->num_columns * collection->num_row_groups * sizeof(struct row_group_zone);
+}
+
+bool int_row_groups_create(struct row_group_directory *dir, void *data)
+{
+        const struct row_group_directory_header *header = data;
+        if (header->marker != MARKER_SYMBOL_ROW_GROUP_DIRECTORY) {
+                free(data);
+                return false;
+        }
+        dir->data = data;
+        dir->row_group_size = header->row_group_size;
+        dir->num_collections = header->num_collections;
+        dir->collections = malloc(ng5_max(header->num_collections, 1u) * sizeof(struct row_group_collection *));
+
+        const char *pos = (const char *) (header + 1);
+        for (u32 i = 0; i < header->num_collections; i++) {
+                dir->collections[i] = (const struct row_group_collection *) pos;
+                pos += row_group_collection_size(dir->collections[i]);
+        }
+        return true;
+}
+
+void int_row_groups_drop(struct row_group_directory *dir)
+{
+        free(dir->data);
+        free(dir->collections);
+        ng5_zero_memory(dir, sizeof(struct row_group_directory));
+}
+
+const struct row_group_collection *int_row_groups_find(const struct row_group_directory *dir,
+        offset_t column_group)
+{
+        /** collections are stored in the order of their column groups in the record table */
+        u32 begin = 0, end = dir->num_collections;
+        while (begin < end) {
+                u32 mid = begin + (end - begin) / 2;
+                offset_t off = dir->collections[mid]->column_group;
+                if (off == column_group) {
+                        return dir->collections[mid];
+                } else if (off < column_group) {
+                        begin = mid + 1;
+                } else {
+                        end = mid;
+                }
+        }
+        return NULL;
+}
+
+const struct row_group_zone *int_row_groups_zones(bool *zone_map, const struct row_group_collection *collection,
+        u32 column_idx)
+{
+        assert(column_idx < collection->num_columns);
+        const u8 *zone_maps = (const u8 *) (collection + 1);
+        const struct row_group_zone *zones = (const struct row_group_zone *) (zone_maps + collection->num_columns);
+        *zone_map = zone_maps[column_idx];
+        return zones + (size_t) column_idx * collection->num_row_groups;
+}
@@ -18,7 +18,7 @@
 #include "core/carbon/archive_iter.h"
 #include "core/carbon/archive_int.h"
 
-static bool init_object_from_memfile(struct archive_object *obj, struct memfile *memfile)
+static bool init_object_from_memfile(struct archive_object *obj, struct memfile *memfile, struct archive *archive)
 {
         assert(obj);
         offset_t object_off;
@@ -37,6 +37,7 @@ static bool init_object_from_memfile(struct archive_object *obj, struct memfile
         obj->object_id = header->oid;
         obj->offset = object_off;
         obj->next_obj_off = *NG5_MEMFILE_READ_TYPE(memfile, offset_t);
+        obj->archive = archive;
         memfile_open(&obj->memfile, memfile->memblock, READ_ONLY);
 
         return true;
@@ -114,7 +115,25 @@ static bool prop_iter_read_colum_entry(struct collection_iter_state *state, stru
         memfile_seek(memfile, entry_off);
 
         state->current_column_group.current_column.current_entry.array_length = *NG5_MEMFILE_READ_TYPE(memfile, u32);
-        state->current_column_group.current_column.current_entry.array_base = NG5_MEMFILE_PEEK(memfile, void);
+        if (state->current_column_group.current_column.run) {
+                /** entries of columns that are stored as a run are consecutive slices of the values of all entries */
+                size_t width = GET_TYPE_SIZE(state->current_column_group.current_column.type);
+                const char *values = int_decode_cache_get(&state->archive->decode_cache,
+                        state->current_column_group.current_column.run,
+                        state->current_column_group.current_column.encoding,
+                        state->current_column_group.current_column.type,
+                        state->current_column_group.current_column.num_values);
+                state->current_column_group.current_column.current_entry.array_base =
+                        values + state->current_column_group.current_column.run_pos * width;
+                state->current_column_group.current_column.run_pos +=
+                        state->current_column_group.current_column.current_entry.array_length;
+        } else {
+                state->current_column_group.current_column.current_entry.array_base =
+                        int_decode_cache_get(&state->archive->decode_cache, NG5_MEMFILE_PEEK(memfile, void),
+                                state->current_column_group.current_column.encoding,
+                                state->current_column_group.current_column.type,
+                                state->current_column_group.current_column.current_entry.array_length);
+        }
 
         return (++state->current_column_group.current_column.current_entry.idx)
                 < state->current_column_group.current_column.num_elem;
@@ -132,12 +151,33 @@ static bool prop_iter_read_column(struct collection_iter_state *state, struct me
         assert(header->marker == MARKER_SYMBOL_COLUMN);
         state->current_column_group.current_column.name = header->column_name;
         state->current_column_group.current_column.type = int_marker_to_field_type(header->value_type);
+        state->current_column_group.current_column.encoding = header->encoding;
 
         state->current_column_group.current_column.num_elem = header->num_entries;
-        state->current_column_group.current_column.elem_offsets =
-                NG5_MEMFILE_READ_TYPE_LIST(memfile, offset_t, header->num_entries);
+        state->current_column_group.current_column.elem_offsets = int_read_entry_offsets(&state->archive->decode_cache,
+                (const char *) header + header->entry_offsets, header->num_entries, column_off);
+        int_align(&state->archive->decode_cache, memfile, NG5_ARCHIVE_CACHE_LINE);
         state->current_column_group.current_column.elem_positions =
                 NG5_MEMFILE_READ_TYPE_LIST(memfile, u32, header->num_entries);
+        union column_flags flags = {.value = header->flags};
+        state->current_column_group.current_column.validity = flags.bits.has_validity ?
+                NG5_MEMFILE_READ_TYPE_LIST(memfile, u8, (state->current_column_group.num_objects + 7) / 8) : NULL;
+        if (int_column_is_run(header->encoding, state->current_column_group.current_column.type)) {
+                state->current_column_group.current_column.num_values = *NG5_MEMFILE_READ_TYPE(memfile, u32);
+                state->current_column_group.current_column.run = NG5_MEMFILE_PEEK(memfile, void);
+        } else {
+                state->current_column_group.current_column.num_values = 0;
+                state->current_column_group.current_column.run = NULL;
+        }
+        if (state->current_column_group.row_groups) {
+                state->current_column_group.current_column.zones = int_row_groups_zones(
+                        &state->current_column_group.current_column.zone_map, state->current_column_group.row_groups,
+                        current_idx);
+        } else {
+                state->current_column_group.current_column.zones = NULL;
+                state->current_column_group.current_column.zone_map = false;
+        }
+        state->current_column_group.current_column.run_pos = 0;
         state->current_column_group.current_column.current_entry.idx = 0;
 
         return (++state->current_column_group.current_column.idx) < state->current_column_group.num_columns;
@@ -149,8 +189,11 @@ static bool collection_iter_read_next_column_group(struct collection_iter_state
         memfile_seek(memfile, state->column_group_offsets[state->current_column_group_idx]);
         const struct column_group_header *header = NG5_MEMFILE_READ_TYPE(memfile, struct column_group_header);
         assert(header->marker == MARKER_SYMBOL_COLUMN_GROUP);
+        state->current_column_group.row_groups = int_row_groups_find(&state->archive->row_groups,
+                state->column_group_offsets[state->current_column_group_idx]);
         state->current_column_group.num_columns = header->num_columns;
         state->current_column_group.num_objects = header->num_objects;
+        int_align(&state->archive->decode_cache, memfile, sizeof(object_id_t));
         state->current_column_group.object_ids = NG5_MEMFILE_READ_TYPE_LIST(memfile, object_id_t, header->num_objects);
         state->current_column_group.column_offs = NG5_MEMFILE_READ_TYPE_LIST(memfile, offset_t, header->num_columns);
         state->current_column_group.current_column.idx = 0;
@@ -188,15 +231,15 @@ static void prop_iter_cursor_init(struct prop_iter *iter)
         assert(STATE_AND_PROPERTY_EXISTS(PROP_ITER_OBJECT_ARRAYS, prop_offsets.object_arrays));
 
         if (iter->mode == PROP_ITER_MODE_COLLECTION) {
+                iter->mode_collection.archive = iter->object.archive;
                 iter->mode_collection.collection_start_off = offset_by_state(iter);
                 memfile_seek(&iter->record_table_memfile, iter->mode_collection.collection_start_off);
                 const struct object_array_header
                         *header = NG5_MEMFILE_READ_TYPE(&iter->record_table_memfile, struct object_array_header);
                 iter->mode_collection.num_column_groups = header->num_entries;
                 iter->mode_collection.current_column_group_idx = 0;
-                iter->mode_collection.column_group_keys = NG5_MEMFILE_READ_TYPE_LIST(&iter->record_table_memfile,
-                        field_sid_t,
-                        iter->mode_collection.num_column_groups);
+                iter->mode_collection.column_group_keys = int_read_keys(&iter->object.archive->decode_cache,
+                        &iter->record_table_memfile, iter->mode_collection.num_column_groups);
                 iter->mode_collection.column_group_offsets = NG5_MEMFILE_READ_TYPE_LIST(&iter->record_table_memfile,
                         offset_t,
                         iter->mode_collection.num_column_groups);
@@ -204,7 +247,8 @@ static void prop_iter_cursor_init(struct prop_iter *iter)
         } else {
                 iter->mode_object.current_prop_group_off = offset_by_state(iter);
                 memfile_seek(&iter->record_table_memfile, iter->mode_object.current_prop_group_off);
-                int_embedded_fixed_props_read(&iter->mode_object.prop_group_header, &iter->record_table_memfile);
+                int_embedded_fixed_props_read(&iter->mode_object.prop_group_header, &iter->record_table_memfile,
+                        &iter->object.archive->decode_cache);
                 iter->mode_object.prop_data_off = memfile_tell(&iter->record_table_memfile);
         }
 
@@ -382,7 +426,7 @@ static void prop_iter_state_init(struct prop_iter *iter)
 }
 
 static bool archive_prop_iter_from_memblock(struct prop_iter *iter, struct err *err, u16 mask,
-        struct memblock *memblock, offset_t object_offset)
+        struct memblock *memblock, offset_t object_offset, struct archive *archive)
 {
         error_if_null(iter)
         error_if_null(err)
@@ -397,7 +441,7 @@ static bool archive_prop_iter_from_memblock(struct prop_iter *iter, struct err *
                 error(err, NG5_ERR_MEMFILESEEK_FAILED)
                 return false;
         }
-        if (!init_object_from_memfile(&iter->object, &iter->record_table_memfile)) {
+        if (!init_object_from_memfile(&iter->object, &iter->record_table_memfile, archive)) {
                 error(err, NG5_ERR_INTERNALERR);
                 return false;
         }
@@ -412,13 +456,13 @@ static bool archive_prop_iter_from_memblock(struct prop_iter *iter, struct err *
 NG5_EXPORT(bool) archive_prop_iter_from_archive(struct prop_iter *iter, struct err *err, u16 mask,
         struct archive *archive)
 {
-        return archive_prop_iter_from_memblock(iter, err, mask, archive->record_table.recordDataBase, 0);
+        return archive_prop_iter_from_memblock(iter, err, mask, archive->record_table.recordDataBase, 0, archive);
 }
 
 NG5_EXPORT(bool) archive_prop_iter_from_object(struct prop_iter *iter, u16 mask, struct err *err,
         const struct archive_object *obj)
 {
-        return archive_prop_iter_from_memblock(iter, err, mask, obj->memfile.memblock, obj->offset);
+        return archive_prop_iter_from_memblock(iter, err, mask, obj->memfile.memblock, obj->offset, obj->archive);
 }
 
 static enum field_type get_basic_type(enum prop_iter_state state)
@@ -620,6 +664,256 @@ NG5_EXPORT(const u32 *)archive_column_get_entry_positions(u32 *num_entry, archiv
         }
 }
 
+NG5_EXPORT(bool) archive_column_count_range(u64 *count, u64 lo, u64 hi, archive_column_iter_t *column_iter)
+{
+        return archive_column_count_range_in_row_groups(count, 0, UINT32_MAX, lo, hi, column_iter);
+}
+
+NG5_EXPORT(bool) archive_column_group_get_row_groups(u32 *num_row_groups, u64 *row_group_size,
+        archive_column_group_iter_t *iter)
+{
+        error_if_null(num_row_groups)
+        error_if_null(iter)
+
+        const struct row_group_collection *row_groups = iter->state.current_column_group.row_groups;
+        *num_row_groups = row_groups ? row_groups->num_row_groups : 1;
+        ng5_optional_set(row_group_size, row_groups ? iter->state.archive->row_groups.row_group_size :
+                iter->state.current_column_group.num_objects)
+        return true;
+}
+
+/**
+ * Returns the zone of 'row_group' of the current column. A column of a column group that is not cut into row groups
+ * is a single row group of all entries, whose values are counted for runs only.
+ */
+static struct row_group_zone column_row_group_zone(const struct collection_iter_state *state, u32 row_group)
+{
+        if (state->current_column_group.current_column.zones) {
+                return state->current_column_group.current_column.zones[row_group];
+        } else {
+                struct row_group_zone zone = {.first_entry = 0, .num_entries = state->current_column_group
+                        .current_column.num_elem, .first_value = 0, .num_values = state->current_column_group
+                        .current_column.num_values};
+                return zone;
+        }
+}
+
+static bool value_less(u64 lhs, u64 rhs, bool is_signed)
+{
+        return is_signed ? (i64) lhs < (i64) rhs : lhs < rhs;
+}
+
+/** counts the values within 'lo' and 'hi' at the positions 'begin' to 'end - 1' of the run 'src' */
+static u64 count_range_in_run(const void *src, u64 begin, u64 end, size_t width, bool is_signed, u64 lo, u64 hi)
+{
+        const void *values;
+        const u32 *ends;
+        u32 num_runs = intpack_rle_runs(&values, &ends, src, width);
+        u32 run_end, first = 0, last = num_runs;
+        /** the first run that ends after 'begin' */
+        while (first < last) {
+                u32 mid = first + (last - first) / 2;
+                memcpy(&run_end, ends + mid, sizeof(u32));
+                if (run_end <= begin) {
+                        first = mid + 1;
+                } else {
+                        last = mid;
+                }
+        }
+
+        u64 count = 0;
+        for (u32 run = first; run < num_runs && begin < end; run++) {
+                memcpy(&run_end, ends + run, sizeof(u32));
+                u64 value = intpack_value_at(values, run, width, is_signed);
+                u64 slice_end = ng5_min((u64) run_end, end);
+                if (!value_less(value, lo, is_signed) && !value_less(hi, value, is_signed)) {
+                        count += slice_end - begin;
+                }
+                begin = slice_end;
+        }
+        return count;
+}
+
+NG5_EXPORT(bool) archive_column_count_range_in_row_groups(u64 *count, u32 first_row_group, u32 num_row_groups,
+        u64 lo, u64 hi, archive_column_iter_t *column_iter)
+{
+        error_if_null(count)
+        error_if_null(column_iter)
+
+        size_t width;
+        bool is_signed;
+        struct memfile *memfile = &column_iter->record_table_memfile;
+        const struct collection_iter_state *state = &column_iter->state;
+        if (!int_get_intpack_params(&width, &is_signed, state->current_column_group.current_column.type)) {
+                error(&column_iter->err, NG5_ERR_TYPEMISMATCH);
+                return false;
+        }
+
+        const void *run = state->current_column_group.current_column.run;
+        bool zone_map = state->current_column_group.current_column.zone_map;
+        u32 total = state->current_column_group.row_groups ? state->current_column_group.row_groups->num_row_groups : 1;
+        u32 end = (u32) ng5_min((u64) first_row_group + num_row_groups, (u64) total);
+        *count = 0;
+        for (u32 row_group = first_row_group; row_group < end; row_group++) {
+                struct row_group_zone zone = column_row_group_zone(state, row_group);
+                if (zone_map) {
+                        if (zone.num_values == 0 || value_less(zone.max, lo, is_signed)
+                                || value_less(hi, zone.min, is_signed)) {
+                                continue;
+                        } else if (!value_less(zone.min, lo, is_signed) && !value_less(hi, zone.max, is_signed)) {
+                                *count += zone.num_values;
+                                continue;
+                        }
+                }
+                if (run && zone.first_value == 0 && zone.num_values == state->current_column_group.current_column
+                        .num_values) {
+                        *count += intpack_count_range(run, INTPACK_RLE, zone.num_values, width, is_signed, lo, hi);
+                } else if (run) {
+                        *count += count_range_in_run(run, zone.first_value, zone.first_value + zone.num_values, width,
+                                is_signed, lo, hi);
+                } else {
+                        for (u64 i = zone.first_entry; i < zone.first_entry + zone.num_entries; i++) {
+                                memfile_seek(memfile, state->current_column_group.current_column.elem_offsets[i]);
+                                u32 num_values = *NG5_MEMFILE_READ_TYPE(memfile, u32);
+                                *count += intpack_count_range(NG5_MEMFILE_PEEK(memfile, void),
+                                        state->current_column_group.current_column.encoding, num_values, width,
+                                        is_signed, lo, hi);
+                        }
+                }
+        }
+        return true;
+}
+
+NG5_EXPORT(bool) archive_column_seek_row_group(u32 row_group, archive_column_iter_t *column_iter)
+{
+        error_if_null(column_iter)
+
+        struct collection_iter_state *state = &column_iter->state;
+        const struct row_group_collection *row_groups = state->current_column_group.row_groups;
+        if (row_group >= (row_groups ? row_groups->num_row_groups : 1)) {
+                error(&column_iter->err, NG5_ERR_OUTOFBOUNDS);
+                return false;
+        }
+        struct row_group_zone zone = column_row_group_zone(state, row_group);
+        state->current_column_group.current_column.current_entry.idx = zone.first_entry;
+        state->current_column_group.current_column.run_pos = zone.first_value;
+        return true;
+}
+
+NG5_EXPORT(bool) archive_column_count_values(struct hashmap_u64_u32 *counts, archive_column_iter_t *column_iter)
+{
+        error_if_null(counts)
+        error_if_null(column_iter)
+
+        size_t width;
+        bool is_signed;
+        struct memfile *memfile = &column_iter->record_table_memfile;
+        const struct collection_iter_state *state = &column_iter->state;
+        if (!int_get_intpack_params(&width, &is_signed, state->current_column_group.current_column.type)) {
+                error(&column_iter->err, NG5_ERR_TYPEMISMATCH);
+                return false;
+        }
+
+        if (state->current_column_group.current_column.run) {
+                const void *values;
+                const u32 *ends;
+                u32 num_runs = intpack_rle_runs(&values, &ends, state->current_column_group.current_column.run, width);
+                u32 begin = 0, end;
+                for (u32 run = 0; run < num_runs; run++) {
+                        memcpy(&end, ends + run, sizeof(u32));
+                        u32 *count = hashmap_u64_u32_upsert(counts, intpack_value_at(values, run, width, is_signed),
+                                NULL);
+                        if (unlikely(!count)) {
+                                error(&column_iter->err, NG5_ERR_MALLOCERR);
+                                return false;
+                        }
+                        *count += end - begin;
+                        begin = end;
+                }
+        } else {
+                for (u32 i = 0; i < state->current_column_group.current_column.num_elem; i++) {
+                        void *decoded;
+                        memfile_seek(memfile, state->current_column_group.current_column.elem_offsets[i]);
+                        u32 num_values = *NG5_MEMFILE_READ_TYPE(memfile, u32);
+                        const void *values = int_read_values(&decoded, memfile,
+                                state->current_column_group.current_column.encoding,
+                                state->current_column_group.current_column.type, width, num_values);
+                        for (u32 j = 0; j < num_values; j++) {
+                                u32 *count = hashmap_u64_u32_upsert(counts,
+                                        intpack_value_at(values, j, width, is_signed), NULL);
+                                if (unlikely(!count)) {
+                                        free(decoded);
+                                        error(&column_iter->err, NG5_ERR_MALLOCERR);
+                                        return false;
+                                }
+                                (*count)++;
+                        }
+                        free(decoded);
+                }
+        }
+        return true;
+}
+
+NG5_EXPORT(bool) archive_column_count_booleans(u64 *num_true, u64 *num_false, u64 *num_null,
+        archive_column_iter_t *column_iter)
+{
+        error_if_null(column_iter)
+
+        struct memfile *memfile = &column_iter->record_table_memfile;
+        const struct collection_iter_state *state = &column_iter->state;
+        if (state->current_column_group.current_column.type != FIELD_BOOLEAN) {
+                error(&column_iter->err, NG5_ERR_TYPEMISMATCH);
+                return false;
+        }
+
+        u64 trues = 0, nulls = 0, total = 0;
+        if (state->current_column_group.current_column.run) {
+                const void *run = state->current_column_group.current_column.run;
+                total = state->current_column_group.current_column.num_values;
+                trues = intpack_count_range(run, INTPACK_RLE, total, sizeof(FIELD_BOOLEANean_t), false, 1, 1);
+                nulls = intpack_count_range(run, INTPACK_RLE, total, sizeof(FIELD_BOOLEANean_t), false,
+                        NG5_NULL_BOOLEAN, NG5_NULL_BOOLEAN);
+        } else {
+                u8 encoding = state->current_column_group.current_column.encoding;
+                for (u32 i = 0; i < state->current_column_group.current_column.num_elem; i++) {
+                        memfile_seek(memfile, state->current_column_group.current_column.elem_offsets[i]);
+                        u32 num_values = *NG5_MEMFILE_READ_TYPE(memfile, u32);
+                        const void *values = NG5_MEMFILE_PEEK(memfile, void);
+                        if (encoding == INTPACK_BITMAP) {
+                                size_t entry_nulls;
+                                trues += intpack_bitmap_count(&entry_nulls, values, num_values);
+                                nulls += entry_nulls;
+                        } else {
+                                trues += intpack_count_range(values, encoding, num_values,
+                                        sizeof(FIELD_BOOLEANean_t), false, 1, 1);
+                                nulls += intpack_count_range(values, encoding, num_values,
+                                        sizeof(FIELD_BOOLEANean_t), false, NG5_NULL_BOOLEAN, NG5_NULL_BOOLEAN);
+                        }
+                        total += num_values;
+                }
+        }
+        ng5_optional_set(num_true, trues)
+        ng5_optional_set(num_false, total - trues - nulls)
+        ng5_optional_set(num_null, nulls)
+        return true;
+}
+
+NG5_EXPORT(bool) archive_column_count_present(u32 *count, u32 begin, u32 end, archive_column_iter_t *column_iter)
+{
+        error_if_null(count)
+        error_if_null(column_iter)
+
+        const struct collection_iter_state *state = &column_iter->state;
+        end = ng5_min(end, state->current_column_group.num_objects);
+        begin = ng5_min(begin, end);
+        if (state->current_column_group.current_column.validity) {
+                *count = intpack_popcount(state->current_column_group.current_column.validity, begin, end);
+        } else {
+                *count = end - begin;
+        }
+        return true;
+}
+
 NG5_EXPORT(bool) archive_column_next_entry(archive_column_entry_iter_t *entry_iter, archive_column_iter_t *iter)
 {
         error_if_null(entry_iter)
@@ -709,7 +1003,7 @@ NG5_EXPORT(const struct archive_object *)archive_column_entry_object_iter_next_o
         if (iter) {
                 if (iter->next_obj_off != 0) {
                         memfile_seek(&iter->memfile, iter->next_obj_off);
-                        if (init_object_from_memfile(&iter->obj, &iter->memfile)) {
+                        if (init_object_from_memfile(&iter->obj, &iter->memfile, iter->entry_state.archive)) {
                                 iter->next_obj_off = iter->obj.next_obj_off;
                                 return &iter->obj;
                         } else {
@@ -776,39 +1070,44 @@ static void value_vector_init_fixed_length_types_basic(struct archive_value_vect
 {
         assert(!value->is_array);
 
+        const void *values = int_decode_cache_get(&value->prop_iter->object.archive->decode_cache,
+                NG5_MEMFILE_PEEK(&value->record_table_memfile, void),
+                value->prop_iter->mode_object.prop_group_header.header->encoding, value->prop_type,
+                value->value_max_idx);
+
         switch (value->prop_type) {
         case FIELD_INT8:
-                value->data.basic.values.int8s = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_i8_t);
+                value->data.basic.values.int8s = values;
                 break;
         case FIELD_INT16:
-                value->data.basic.values.int16s = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_i16_t);
+                value->data.basic.values.int16s = values;
                 break;
         case FIELD_INT32:
-                value->data.basic.values.int32s = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_i32_t);
+                value->data.basic.values.int32s = values;
                 break;
         case FIELD_INT64:
-                value->data.basic.values.int64s = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_i64_t);
+                value->data.basic.values.int64s = values;
                 break;
         case FIELD_UINT8:
-                value->data.basic.values.uint8s = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_u8_t);
+                value->data.basic.values.uint8s = values;
                 break;
         case FIELD_UINT16:
-                value->data.basic.values.uint16s = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_u16_t);
+                value->data.basic.values.uint16s = values;
                 break;
         case FIELD_UINT32:
-                value->data.basic.values.uint32s = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_u32_t);
+                value->data.basic.values.uint32s = values;
                 break;
         case FIELD_UINT64:
-                value->data.basic.values.uint64s = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_u64_t);
+                value->data.basic.values.uint64s = values;
                 break;
         case FIELD_FLOAT:
-                value->data.basic.values.numbers = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_number_t);
+                value->data.basic.values.numbers = values;
                 break;
         case FIELD_STRING:
-                value->data.basic.values.strings = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_sid_t);
+                value->data.basic.values.strings = values;
                 break;
         case FIELD_BOOLEAN:
-                value->data.basic.values.booleans = NG5_MEMFILE_PEEK(&value->record_table_memfile, FIELD_BOOLEANean_t);
+                value->data.basic.values.booleans = values;
                 break;
         default: print_error_and_die(NG5_ERR_INTERNALERR);
         }
@@ -818,51 +1117,58 @@ static void value_vector_init_fixed_length_types_null_arrays(struct archive_valu
 {
         assert(value->is_array);
         assert(value->prop_type == FIELD_NULL);
-        value->data.arrays.meta.num_nulls_contained =
-                NG5_MEMFILE_READ_TYPE_LIST(&value->record_table_memfile, u32, value->value_max_idx);
+        value->data.arrays.meta.num_nulls_contained = int_read_lengths(
+                &value->prop_iter->object.archive->decode_cache, &value->record_table_memfile, value->value_max_idx);
 }
 
 static void value_vector_init_fixed_length_types_non_null_arrays(struct archive_value_vector *value)
 {
         assert (value->is_array);
 
-        value->data.arrays.meta.array_lengths =
-                NG5_MEMFILE_READ_TYPE_LIST(&value->record_table_memfile, u32, value->value_max_idx);
+        value->data.arrays.meta.array_lengths = int_read_lengths(&value->prop_iter->object.archive->decode_cache,
+                &value->record_table_memfile, value->value_max_idx);
+
+        u32 num_values = 0;
+        for (u32 i = 0; i < value->value_max_idx; i++) {
+                num_values += value->data.arrays.meta.array_lengths[i];
+        }
+        const void *values = int_decode_cache_get(&value->prop_iter->object.archive->decode_cache,
+                NG5_MEMFILE_PEEK(&value->record_table_memfile, void),
+                value->prop_iter->mode_object.prop_group_header.header->encoding, value->prop_type, num_values);
 
         switch (value->prop_type) {
         case FIELD_INT8:
-                value->data.arrays.values.int8s_base = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_i8_t);
+                value->data.arrays.values.int8s_base = values;
                 break;
         case FIELD_INT16:
-                value->data.arrays.values.int16s_base = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_i16_t);
+                value->data.arrays.values.int16s_base = values;
                 break;
         case FIELD_INT32:
-                value->data.arrays.values.int32s_base = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_i32_t);
+                value->data.arrays.values.int32s_base = values;
                 break;
         case FIELD_INT64:
-                value->data.arrays.values.int64s_base = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_i64_t);
+                value->data.arrays.values.int64s_base = values;
                 break;
         case FIELD_UINT8:
-                value->data.arrays.values.uint8s_base = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_u8_t);
+                value->data.arrays.values.uint8s_base = values;
                 break;
         case FIELD_UINT16:
-                value->data.arrays.values.uint16s_base = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_u16_t);
+                value->data.arrays.values.uint16s_base = values;
                 break;
         case FIELD_UINT32:
-                value->data.arrays.values.uint32s_base = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_u32_t);
+                value->data.arrays.values.uint32s_base = values;
                 break;
         case FIELD_UINT64:
-                value->data.arrays.values.uint64s_base = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_u64_t);
+                value->data.arrays.values.uint64s_base = values;
                 break;
         case FIELD_FLOAT:
-                value->data.arrays.values.numbers_base = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_number_t);
+                value->data.arrays.values.numbers_base = values;
                 break;
         case FIELD_STRING:
-                value->data.arrays.values.strings_base = NG5_MEMFILE_PEEK(&value->record_table_memfile, field_sid_t);
+                value->data.arrays.values.strings_base = values;
                 break;
         case FIELD_BOOLEAN:
-                value->data.arrays.values.booleans_base =
-                        NG5_MEMFILE_PEEK(&value->record_table_memfile, FIELD_BOOLEANean_t);
+                value->data.arrays.values.booleans_base = values;
                 break;
         default: print_error_and_die(NG5_ERR_INTERNALERR);
         }
@@ -995,7 +1301,8 @@ NG5_EXPORT(bool) archive_value_vector_get_object_at(struct archive_object *objec
 
         if (is_object) {
                 memfile_seek(&value->record_table_memfile, value->data.object.offsets[idx]);
-                init_object_from_memfile(&value->data.object.object, &value->record_table_memfile);
+                init_object_from_memfile(&value->data.object.object, &value->record_table_memfile,
+                        value->prop_iter->object.archive);
                 *object = value->data.object.object;
                 return true;
         } else {
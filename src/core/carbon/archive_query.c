@@ -42,7 +42,7 @@ struct sid_to_offset {
         assert(obj->props.offset_name != 0);                                                                           \
         memfile_seek(&obj->file, obj->props.offset_name);                                                       \
         struct fixed_prop prop;                                                                                      \
-        int_embedded_fixed_props_read(&prop, &obj->file);                                                       \
+        int_embedded_fixed_props_read(&prop, &obj->file, &obj->archive->decode_cache);                              \
         int_reset_cabin_object_mem_file(obj);                                                                   \
         ng5_optional_set(num_pairs, prop.header->num_entries);                                                      \
         return prop.keys;                                                                                              \
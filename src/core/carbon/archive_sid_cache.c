@@ -15,9 +15,10 @@
  * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
-#include "hash/bern.h"
+#include "hash/wyhash.h"
 #include "shared/error.h"
 #include "core/carbon/archive_sid_cache.h"
+#include "core/alloc/prof.h"
 
 struct cache_entry {
         struct cache_entry *prev, *next;
@@ -69,8 +70,11 @@ NG5_EXPORT(bool) string_id_cache_create_LRU_ex(struct string_cache **cache, stru
         query_create(&result->query, archive);
         result->capacity = capacity;
 
+        struct allocator alloc;
+        prof_alloc_wrap(&alloc, NULL, "sid_cache");
+
         size_t num_buckets = ng5_max(1, capacity);
-        vec_create(&result->list_entries, NULL, sizeof(struct lru_list), num_buckets);
+        vec_create(&result->list_entries, &alloc, sizeof(struct lru_list), num_buckets);
         for (size_t i = 0; i < num_buckets; i++) {
                 struct lru_list *list = vec_new_and_get(&result->list_entries, struct lru_list);
                 ng5_zero_memory(list, sizeof(struct lru_list));
@@ -122,12 +126,13 @@ static void make_most_recent(struct lru_list *list, struct cache_entry *entry)
 NG5_EXPORT(char *)string_id_cache_get(struct string_cache *cache, field_sid_t id)
 {
         error_if_null(cache)
-        hash32_t id_hash = NG5_HASH_BERNSTEIN(sizeof(field_sid_t), &id);
+        hash32_t id_hash = NG5_HASH_WYHASH_SID(id);
         size_t bucket_pos = id_hash % cache->list_entries.num_elems;
         struct lru_list *list = vec_get(&cache->list_entries, bucket_pos, struct lru_list);
         struct cache_entry *cursor = list->most_recent;
         while (cursor != NULL) {
-                if (id == cursor->id) {
+                /** entries that were not used yet have no string, and a zeroed (i.e., valid) id */
+                if (id == cursor->id && cursor->string != NULL) {
                         make_most_recent(list, cursor);
                         cache->statistics.num_hits++;
                         return strdup(cursor->string);
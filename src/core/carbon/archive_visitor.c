@@ -381,11 +381,15 @@ static void iterate_props(struct archive *archive, struct prop_iter *prop_iter,
                                                         capture);
                                         }
 
-                                        u32 current_column_group_obj_idx = 0;
+                                        /** 'skip_objects' is indexed by object, i.e., by the position of a column entry */
+                                        bool skip_all_objects = true;
+                                        for (u32 i = 0; i < num_column_group_objs; i++) {
+                                                skip_all_objects &= skip_objects[i];
+                                        }
 
                                         while (archive_column_group_next_column(&column_iter, &group_iter)) {
 
-                                                if (!skip_objects[current_column_group_obj_idx]) {
+                                                if (!skip_all_objects) {
                                                         field_sid_t current_column_name;
                                                         enum field_type current_column_entry_type;
 
@@ -462,6 +466,11 @@ static void iterate_props(struct archive *archive, struct prop_iter *prop_iter,
                                                                 while (archive_column_next_entry(&entry_iter,
                                                                         &column_iter)) {
 
+                                                                        if (skip_objects[entry_positions[current_entry_idx]]) {
+                                                                                current_entry_idx++;
+                                                                                continue;
+                                                                        }
+
                                                                         object_id_t current_nested_object_id =
                                                                                 entry_object_containments[current_entry_idx];
                                                                         u32 entry_length;
@@ -610,7 +619,6 @@ static void iterate_props(struct archive *archive, struct prop_iter *prop_iter,
                                                         }
                                                         vec_pop(path_stack);
                                                 }
-                                                current_column_group_obj_idx++;
 
                                         }
 
@@ -15,6 +15,8 @@
  * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <stdatomic.h>
+
 #include "core/alloc/alloc.h"
 #include "std/vec.h"
 #include "core/encode/encode_sync.h"
@@ -67,6 +67,8 @@ static int create_extra(struct strdic *self, size_t capacity, size_t num_index_b
         size_t num_threads);
 static struct sync_extra *this_extra(struct strdic *self);
 
+static char *this_strdup(struct strdic *self, const char *string);
+
 static int freelist_pop(field_sid_t *out, struct strdic *self);
 static int freelist_push(struct strdic *self, field_sid_t idx);
 
@@ -124,11 +126,7 @@ static int create_extra(struct strdic *self, size_t capacity, size_t num_index_b
         ng5_unused(num_threads);
 
         struct allocator hashtable_alloc;
-#if defined(NG5_CONFIG_TRACE_STRING_DIC_ALLOC) && !defined(NDEBUG)
-        CHECK_SUCCESS(allocatorTrace(&hashtable_alloc));
-#else
         ng5_check_success(alloc_this_or_std(&hashtable_alloc, &self->alloc));
-#endif
 
         ng5_check_success(strhash_create_inmemory(&extra->index,
                 &hashtable_alloc,
@@ -210,11 +208,7 @@ static bool this_insert(struct strdic *self, field_sid_t **out, char *const *str
         struct sync_extra *extra = this_extra(self);
 
         struct allocator hashtable_alloc;
-#if defined(NG5_CONFIG_TRACE_STRING_DIC_ALLOC) && !defined(NDEBUG)
-        CHECK_SUCCESS(allocatorTrace(&hashtable_alloc));
-#else
         ng5_check_success(alloc_this_or_std(&hashtable_alloc, &self->alloc));
-#endif
 
         field_sid_t *ids_out = alloc_malloc(&hashtable_alloc, num_strings * sizeof(field_sid_t));
         bool *found_mask;
@@ -281,7 +275,7 @@ static bool this_insert(struct strdic *self, field_sid_t **out, char *const *str
                                 struct entry *entry = entries + string_id;
                                 assert (!entry->in_use);
                                 entry->in_use = true;
-                                entry->str = strdup(strings[i]);
+                                entry->str = this_strdup(self, strings[i]);
                                 ids_out[i] = string_id;
 
                                 /** add for not yet registered pairs to buffer for fast import */
@@ -342,7 +336,7 @@ static bool this_remove(struct strdic *self, field_sid_t *strings, size_t num_st
 
         /** free up resources for strings that should be removed */
         for (size_t i = 0; i < num_strings_to_delete; i++) {
-                free(string_to_delete[i]);
+                alloc_free(&self->alloc, string_to_delete[i]);
         }
 
         /** cleanup */
@@ -405,11 +399,7 @@ static char **this_extract(struct strdic *self, const field_sid_t *ids, size_t n
         lock(self);
 
         struct allocator hashtable_alloc;
-#if defined(NG5_CONFIG_TRACE_STRING_DIC_ALLOC) && !defined(NDEBUG)
-        allocatorTrace(&hashtable_alloc);
-#else
         alloc_this_or_std(&hashtable_alloc, &self->alloc);
-#endif
 
         struct sync_extra *extra = this_extra(self);
         char **result = alloc_malloc(&hashtable_alloc, num_ids * sizeof(char *));
@@ -434,11 +424,7 @@ static bool this_free(struct strdic *self, void *ptr)
         ng5_unused(self);
 
         struct allocator hashtable_alloc;
-#if defined(NG5_CONFIG_TRACE_STRING_DIC_ALLOC) && !defined(NDEBUG)
-        CHECK_SUCCESS(allocatorTrace(&hashtable_alloc));
-#else
         ng5_check_success(alloc_this_or_std(&hashtable_alloc, &self->alloc));
-#endif
 
         return alloc_free(&hashtable_alloc, ptr);
 }
@@ -481,4 +467,11 @@ static bool this_get_contents(struct strdic *self, struct vector ofType (char *)
                 }
         }
         return true;
-}
\ No newline at end of file
+}
+
+static char *this_strdup(struct strdic *self, const char *string)
+{
+        size_t length = strlen(string) + 1;
+        char *result = alloc_malloc(&self->alloc, length);
+        return memcpy(result, string, length);
+}
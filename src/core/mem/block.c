@@ -41,9 +41,15 @@ bool memblock_create(struct memblock **block, size_t size)
         return true;
 }
 
+/** alignment of blocks that are read from files, such that aligned data in the file is aligned in memory, too */
+#define MEMBLOCK_FILE_ALIGNMENT 64
+
 bool memblock_from_file(struct memblock **block, FILE *file, size_t nbytes)
 {
         memblock_create(block, nbytes);
+        free((*block)->base);
+        size_t num_lines = (ng5_max(nbytes, 1u) + MEMBLOCK_FILE_ALIGNMENT - 1) / MEMBLOCK_FILE_ALIGNMENT;
+        (*block)->base = aligned_alloc(MEMBLOCK_FILE_ALIGNMENT, num_lines * MEMBLOCK_FILE_ALIGNMENT);
         size_t numRead = fread((*block)->base, 1, nbytes, file);
         return numRead == nbytes ? true : false;
 }
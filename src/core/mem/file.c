@@ -281,4 +281,43 @@ void *memfile_current_pos(struct memfile *file, offset_t nbytes)
         } else {
                 return NULL;
         }
-}
\ No newline at end of file
+}
+
+bool memfile_bit_writer_begin(struct memfile_bit_writer *writer, struct memfile *file)
+{
+        error_if_null(writer)
+        error_if_null(file)
+        writer->file = file;
+        writer->bits = 0;
+        writer->num_bits = 0;
+        writer->num_bytes = 0;
+        return true;
+}
+
+bool memfile_write_bits(struct memfile_bit_writer *writer, u32 bits, unsigned nbits)
+{
+        assert(nbits <= 32 && writer->num_bits < 32);
+        writer->bits = (writer->bits << nbits) | bits;
+        writer->num_bits += nbits;
+        if (writer->num_bits >= 32) {
+                writer->num_bits -= 32;
+                u32 word = __builtin_bswap32((u32) (writer->bits >> writer->num_bits));
+                writer->num_bytes += sizeof(u32);
+                return memfile_write(writer->file, &word, sizeof(u32));
+        }
+        return true;
+}
+
+bool memfile_bit_writer_end(size_t *num_bytes_written, struct memfile_bit_writer *writer)
+{
+        error_if_null(writer)
+        while (writer->num_bits > 0) {
+                unsigned shift = ng5_min(writer->num_bits, 8);
+                writer->num_bits -= shift;
+                u8 byte = (u8) ((writer->bits >> writer->num_bits) << (8 - shift));
+                memfile_write(writer->file, &byte, sizeof(u8));
+                writer->num_bytes++;
+        }
+        ng5_optional_set(num_bytes_written, writer->num_bytes);
+        return true;
+}
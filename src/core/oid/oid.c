@@ -73,36 +73,40 @@ union object_id {
         u64 value;
 };
 
-NG5_EXPORT(bool) object_id_create(object_id_t *out)
-{
-        assert(out);
+static u64 process_local_id;
+static u8 process_magic;
+static u64 process_counter;
 
-        static bool process_init;
-        static u64 process_local_id;
-        static u8 process_magic;
-        static u64 process_counter;
+static u8 global_build_date_bit;
+static u8 global_build_path_bit;
 
-        static u8 global_build_date_bit;
-        static u8 global_build_path_bit;
+static pthread_once_t process_once = PTHREAD_ONCE_INIT;
 
-        if (!process_init) {
-                srand(time(NULL));
-                process_magic = rand();
-                process_init = true;
-                process_counter = rand();
+static void process_init_once(void)
+{
+        srand(time(NULL));
+        process_magic = rand();
+        process_local_id = getpid();
+        process_counter = rand();
 
-                const char *file = __FILE__;
-                const char *time = __TIME__;
+        const char *file = __FILE__;
+        const char *time = __TIME__;
 
-                global_build_path_bit = NG5_HASH_BERNSTEIN(strlen(file), file) % 2;
-                global_build_date_bit = NG5_HASH_BERNSTEIN(strlen(time), time) % 2;
-        }
+        global_build_path_bit = NG5_HASH_BERNSTEIN(strlen(file), file) % 2;
+        global_build_date_bit = NG5_HASH_BERNSTEIN(strlen(time), time) % 2;
+}
+
+NG5_EXPORT(bool) object_id_create(object_id_t *out)
+{
+        assert(out);
+
+        /** object ids are created by several threads when an archive is written, see archive.c */
+        pthread_once(&process_once, process_init_once);
 
         if (!thread_local_init) {
                 thread_local_counter = rand();
                 thread_local_counter_limit = thread_local_counter++;
                 thread_local_id = (u64) pthread_self();
-                process_local_id = getpid();
                 thread_local_magic = rand();
                 thread_local_init = true;
         }
@@ -111,7 +115,7 @@ NG5_EXPORT(bool) object_id_create(object_id_t *out)
         error_print_if(!capacity_left, NG5_ERR_THREADOOOBJIDS)
         if (likely(capacity_left)) {
                 union object_id internal =
-                        {.global_wallclock  = time_now_wallclock(), .global_build_date = global_build_date_bit, .global_build_path = global_build_path_bit, .process_id        = process_local_id, .process_magic     = process_magic, .process_counter   = process_counter++, .thread_id         = (u64) thread_local_id, .thread_magic      = thread_local_magic, .thread_counter    = thread_local_counter++, .call_random       = rand()};
+                        {.global_wallclock  = time_now_wallclock(), .global_build_date = global_build_date_bit, .global_build_path = global_build_path_bit, .process_id        = process_local_id, .process_magic     = process_magic, .process_counter   = __atomic_fetch_add(&process_counter, 1, __ATOMIC_RELAXED), .thread_id         = (u64) thread_local_id, .thread_magic      = thread_local_magic, .thread_counter    = thread_local_counter++, .call_random       = rand()};
                 *out = internal.value;
         } else {
                 *out = 0;
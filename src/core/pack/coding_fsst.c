@@ -0,0 +1,190 @@
+/**
+ * Copyright 2019 Marcus Pinnecke
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <assert.h>
+#include <inttypes.h>
+
+#include "core/pack/pack.h"
+#include "coding/coding_fsst.h"
+
+#define  MARKER_SYMBOL_FSST_DIC_ENTRY      's'
+
+/** encoded strings up to this size are decoded from the stack */
+#define  NG5_FSST_STACK_BUFFER_SIZE        256
+
+NG5_EXPORT(bool) pack_fsst_init(struct packer *self)
+{
+        self->extra = malloc(sizeof(struct coding_fsst));
+        if (self->extra != NULL) {
+                struct coding_fsst *encoder = (struct coding_fsst *) self->extra;
+                coding_fsst_create(encoder);
+                return true;
+        } else {
+                return false;
+        }
+}
+
+NG5_EXPORT(bool) pack_coding_fsst_cpy(const struct packer *self, struct packer *dst)
+{
+        ng5_check_tag(self->tag, PACK_FSST);
+
+        *dst = *self;
+        dst->extra = malloc(sizeof(struct coding_fsst));
+        if (dst->extra != NULL) {
+                struct coding_fsst *self_encoder = (struct coding_fsst *) self->extra;
+                struct coding_fsst *dst_encoder = (struct coding_fsst *) dst->extra;
+                return coding_fsst_cpy(dst_encoder, self_encoder);
+        } else {
+                return false;
+        }
+}
+
+NG5_EXPORT(bool) pack_coding_fsst_drop(struct packer *self)
+{
+        ng5_check_tag(self->tag, PACK_FSST);
+
+        struct coding_fsst *encoder = (struct coding_fsst *) self->extra;
+        coding_fsst_drop(encoder);
+        free(encoder);
+
+        return true;
+}
+
+static bool fsst_dump_dictionary(FILE *file, struct memfile *memfile)
+{
+        struct pack_fsst_symbol_info info;
+        offset_t offset;
+
+        u8 num_symbols = *NG5_MEMFILE_READ_TYPE(memfile, u8);
+        for (u8 code = 0; code < num_symbols; code++) {
+                memfile_get_offset(&offset, memfile);
+                if (!coding_fsst_read_symbol(&info, memfile, MARKER_SYMBOL_FSST_DIC_ENTRY)) {
+                        return false;
+                }
+                fprintf(file, "0x%04x ", (unsigned) offset);
+                fprintf(file, "[marker: %c] [code: %d] [symbol: '%.*s']\n", MARKER_SYMBOL_FSST_DIC_ENTRY, code,
+                        (int) info.length, info.bytes);
+        }
+        return true;
+}
+
+static bool fsst_dump_string_table_entry(FILE *file, struct coding_fsst *dic, struct memfile *memfile,
+        u32 decompressed_strlen)
+{
+        struct pack_fsst_str_info info;
+
+        coding_fsst_read_string(&info, memfile);
+
+        fprintf(file, "[[nbytes_encoded: %d] [codes: ", info.nbytes_encoded);
+        for (size_t i = 0; i < info.nbytes_encoded; i++) {
+                fprintf(file, "%d%s", (unsigned char) info.encoded_bytes[i], i + 1 < info.nbytes_encoded ? "," : "");
+        }
+        fprintf(file, "]");
+
+        char *string = malloc(decompressed_strlen + 1);
+        if (coding_fsst_decode(string, decompressed_strlen, dic, info.encoded_bytes, info.nbytes_encoded)) {
+                string[decompressed_strlen] = '\0';
+                fprintf(file, " [string: %s]", string);
+        }
+        free(string);
+        fprintf(file, "]\n");
+
+        return true;
+}
+
+NG5_EXPORT(bool) pack_fsst_write_extra(struct packer *self, struct memfile *dst,
+        const struct vector ofType (const char *) *strings)
+{
+        ng5_check_tag(self->tag, PACK_FSST);
+
+        struct coding_fsst *encoder = (struct coding_fsst *) self->extra;
+
+        return coding_fsst_build(encoder, strings)
+                && coding_fsst_serialize(dst, encoder, MARKER_SYMBOL_FSST_DIC_ENTRY);
+}
+
+NG5_EXPORT(bool) pack_fsst_read_extra(struct packer *self, FILE *src, size_t nbytes)
+{
+        ng5_check_tag(self->tag, PACK_FSST);
+
+        struct coding_fsst *encoder = (struct coding_fsst *) self->extra;
+        struct memblock *block;
+        struct memfile memfile;
+
+        if (!memblock_from_file(&block, src, nbytes)) {
+                error(&encoder->err, NG5_ERR_IO);
+                return false;
+        }
+        memfile_open(&memfile, block, READ_ONLY);
+        bool status = coding_fsst_deserialize(encoder, &memfile, MARKER_SYMBOL_FSST_DIC_ENTRY);
+        memblock_drop(block);
+
+        return status;
+}
+
+NG5_EXPORT(bool) pack_fsst_print_extra(struct packer *self, FILE *file, struct memfile *src)
+{
+        ng5_check_tag(self->tag, PACK_FSST);
+
+        /** the symbol table is read for printing the encoded strings afterwards */
+        struct coding_fsst *encoder = (struct coding_fsst *) self->extra;
+        offset_t begin = memfile_tell(src);
+        coding_fsst_deserialize(encoder, src, MARKER_SYMBOL_FSST_DIC_ENTRY);
+        memfile_seek(src, begin);
+
+        return fsst_dump_dictionary(file, src);
+}
+
+NG5_EXPORT(bool) pack_fsst_print_encoded(struct packer *self, FILE *file, struct memfile *src,
+        u32 decompressed_strlen)
+{
+        ng5_check_tag(self->tag, PACK_FSST);
+
+        return fsst_dump_string_table_entry(file, (struct coding_fsst *) self->extra, src, decompressed_strlen);
+}
+
+NG5_EXPORT(bool) pack_fsst_encode_string(struct packer *self, struct memfile *dst, struct err *err,
+        const char *string)
+{
+        ng5_check_tag(self->tag, PACK_FSST);
+
+        struct coding_fsst *encoder = (struct coding_fsst *) self->extra;
+        bool status = coding_fsst_encode(dst, encoder, string);
+        error_cpy(err, &encoder->err);
+
+        return status;
+}
+
+NG5_EXPORT(bool) pack_fsst_decode_string(struct packer *self, char *dst, size_t strlen, FILE *src)
+{
+        ng5_check_tag(self->tag, PACK_FSST);
+
+        struct coding_fsst *encoder = (struct coding_fsst *) self->extra;
+        char stack_buffer[NG5_FSST_STACK_BUFFER_SIZE];
+        u32 nbytes_encoded;
+
+        if (fread(&nbytes_encoded, sizeof(u32), 1, src) != 1) {
+                return false;
+        }
+        char *encoded = nbytes_encoded <= sizeof(stack_buffer) ? stack_buffer : malloc(nbytes_encoded);
+        bool status = fread(encoded, 1, nbytes_encoded, src) == nbytes_encoded
+                && coding_fsst_decode(dst, strlen, encoder, encoded, nbytes_encoded);
+        if (encoded != stack_buffer) {
+                free(encoded);
+        }
+        return status;
+}
@@ -18,12 +18,14 @@
 #include <assert.h>
 #include <inttypes.h>
 
-#include "std/bitmap.h"
 #include "core/pack/pack.h"
 #include "coding/coding_huffman.h"
 
 #define  MARKER_SYMBOL_HUFFMAN_DIC_ENTRY   'd'
 
+/** encoded strings up to this size are decoded from the stack */
+#define  NG5_HUFFMAN_STACK_BUFFER_SIZE     256
+
 NG5_EXPORT(bool) pack_huffman_init(struct packer *self)
 {
         self->extra = malloc(sizeof(struct coding_huffman));
@@ -72,40 +74,33 @@ bool huffman_dump_dictionary(FILE *file, struct memfile *memfile)
 
                 fprintf(file, "0x%04x ", (unsigned) offset);
                 fprintf(file,
-                        "[marker: %c] [letter: '%c'] [nbytes_prefix: %d] [code: ",
+                        "[marker: %c] [letter: '%c'] [code_length: %d]\n",
                         MARKER_SYMBOL_HUFFMAN_DIC_ENTRY,
                         entry_info.letter,
-                        entry_info.nbytes_prefix);
-
-                if (entry_info.nbytes_prefix > 0) {
-                        for (u16 i = 0; i < entry_info.nbytes_prefix; i++) {
-                                bitmap_print_bits_in_char(file, entry_info.prefix_code[i]);
-                                fprintf(file, "%s", i + 1 < entry_info.nbytes_prefix ? ", " : "");
-                        }
-                } else {
-                        fprintf(file, "0b00000000");
-                }
-
-                fprintf(file, "]\n");
+                        entry_info.code_length);
         }
         return true;
 }
 
-bool huffman_dump_string_table_entry(FILE *file, struct memfile *memfile)
+bool huffman_dump_string_table_entry(FILE *file, struct coding_huffman *dic, struct memfile *memfile,
+        u32 decompressed_strlen)
 {
-        ng5_unused(file);
-        ng5_unused(memfile);
-
         struct pack_huffman_str_info info;
 
         coding_huffman_read_string(&info, memfile);
 
         fprintf(file, "[[nbytes_encoded: %d] [bytes: ", info.nbytes_encoded);
         for (size_t i = 0; i < info.nbytes_encoded; i++) {
-                char byte = info.encoded_bytes[i];
-                bitmap_print_bits_in_char(file, byte);
-                fprintf(file, "%s", i + 1 < info.nbytes_encoded ? "," : "");
+                fprintf(file, "0x%02x%s", (unsigned char) info.encoded_bytes[i], i + 1 < info.nbytes_encoded ? "," : "");
         }
+        fprintf(file, "]");
+
+        char *string = malloc(decompressed_strlen + 1);
+        if (coding_huffman_decode(string, decompressed_strlen, dic, info.encoded_bytes, info.nbytes_encoded)) {
+                string[decompressed_strlen] = '\0';
+                fprintf(file, " [string: %s]", string);
+        }
+        free(string);
         fprintf(file, "]\n");
 
         return true;
@@ -128,17 +123,30 @@ NG5_EXPORT(bool) pack_huffman_read_extra(struct packer *self, FILE *src, size_t
 {
         ng5_check_tag(self->tag, PACK_HUFFMAN);
 
-        ng5_unused(self);
-        ng5_unused(src);
-        ng5_unused(nbytes);
+        struct coding_huffman *encoder = (struct coding_huffman *) self->extra;
+        struct memblock *block;
+        struct memfile memfile;
+
+        if (!memblock_from_file(&block, src, nbytes)) {
+                error(&encoder->err, NG5_ERR_IO);
+                return false;
+        }
+        memfile_open(&memfile, block, READ_ONLY);
+        bool status = coding_huffman_deserialize(encoder, &memfile, MARKER_SYMBOL_HUFFMAN_DIC_ENTRY);
+        memblock_drop(block);
 
-        abort(); /* not implemented */
-        return false;
+        return status;
 }
 
 NG5_EXPORT(bool) pack_huffman_print_extra(struct packer *self, FILE *file, struct memfile *src)
 {
-        ng5_unused(self);
+        ng5_check_tag(self->tag, PACK_HUFFMAN);
+
+        /** the code table is read for printing the encoded strings afterwards */
+        struct coding_huffman *encoder = (struct coding_huffman *) self->extra;
+        offset_t begin = memfile_tell(src);
+        coding_huffman_deserialize(encoder, src, MARKER_SYMBOL_HUFFMAN_DIC_ENTRY);
+        memfile_seek(src, begin);
 
         huffman_dump_dictionary(file, src);
 
@@ -148,12 +156,9 @@ NG5_EXPORT(bool) pack_huffman_print_extra(struct packer *self, FILE *file, struc
 NG5_EXPORT(bool) pack_huffman_print_encoded(struct packer *self, FILE *file, struct memfile *src,
         u32 decompressed_strlen)
 {
-        ng5_unused(self);
-        ng5_unused(file);
-        ng5_unused(src);
-        ng5_unused(decompressed_strlen);
+        ng5_check_tag(self->tag, PACK_HUFFMAN);
 
-        huffman_dump_string_table_entry(file, src);
+        huffman_dump_string_table_entry(file, (struct coding_huffman *) self->extra, src, decompressed_strlen);
 
         return true;
 }
@@ -171,10 +176,20 @@ bool pack_huffman_encode_string(struct packer *self, struct memfile *dst, struct
 
 NG5_EXPORT(bool) pack_huffman_decode_string(struct packer *self, char *dst, size_t strlen, FILE *src)
 {
-        ng5_unused(self);
-        ng5_unused(dst);
-        ng5_unused(strlen);
-        ng5_unused(src);
-        abort(); /* not implemented */
-        return false;
-}
\ No newline at end of file
+        ng5_check_tag(self->tag, PACK_HUFFMAN);
+
+        struct coding_huffman *encoder = (struct coding_huffman *) self->extra;
+        char stack_buffer[NG5_HUFFMAN_STACK_BUFFER_SIZE];
+        u32 nbytes_encoded;
+
+        if (fread(&nbytes_encoded, sizeof(u32), 1, src) != 1) {
+                return false;
+        }
+        char *encoded = nbytes_encoded <= sizeof(stack_buffer) ? stack_buffer : malloc(nbytes_encoded);
+        bool status = fread(encoded, 1, nbytes_encoded, src) == nbytes_encoded
+                && coding_huffman_decode(dst, strlen, encoder, encoded, nbytes_encoded);
+        if (encoded != stack_buffer) {
+                free(encoded);
+        }
+        return status;
+}
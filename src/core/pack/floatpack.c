@@ -0,0 +1,220 @@
+/**
+ * Copyright 2019 Marcus Pinnecke
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <assert.h>
+
+#include "core/pack/floatpack.h"
+#include "core/pack/intpack.h"
+
+#define ALP_HEADER_SIZE                 (2 * sizeof(u8) + sizeof(u32))
+
+/** integers beyond this magnitude are not exactly representable as 'double', and values that yield them are kept */
+#define ALP_MAX_INTEGER                 (1ll << 52)
+
+static const double alp_powers[NG5_FLOATPACK_MAX_EXPONENT + 1] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10
+};
+
+static const double alp_fractions[NG5_FLOATPACK_MAX_EXPONENT + 1] = {
+        1e0, 1e-1, 1e-2, 1e-3, 1e-4, 1e-5, 1e-6, 1e-7, 1e-8, 1e-9, 1e-10
+};
+
+static inline field_number_t alp_decode_one(i64 number, unsigned exponent)
+{
+        return (field_number_t) ((double) number * alp_fractions[exponent]);
+}
+
+/** returns true if 'value' is restored exactly from the integer that is returned in 'number' */
+static inline bool alp_encode_one(i64 *number, field_number_t value, unsigned exponent)
+{
+        double scaled = (double) value * alp_powers[exponent];
+        /** also false for 'NAN' */
+        if (!(scaled > -ALP_MAX_INTEGER && scaled < ALP_MAX_INTEGER)) {
+                return false;
+        }
+        *number = (i64) (scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+        field_number_t restored = alp_decode_one(*number, exponent);
+        /** bitwise, such that negative zero is an exception */
+        return memcmp(&restored, &value, sizeof(field_number_t)) == 0;
+}
+
+static inline unsigned bits_of(u64 x)
+{
+        return x ? 64 - __builtin_clzll(x) : 0;
+}
+
+/** chooses the exponent with the fewest bytes for the integers and exceptions of evenly spread sample values */
+static unsigned alp_exponent(const field_number_t *values, size_t num_values)
+{
+        size_t num_samples = ng5_min(num_values, (size_t) NG5_FLOATPACK_SAMPLE_SIZE);
+        size_t step = num_samples ? num_values / num_samples : 1;
+        unsigned best = 0;
+        size_t best_bits = SIZE_MAX;
+        for (unsigned exponent = 0; exponent <= NG5_FLOATPACK_MAX_EXPONENT; exponent++) {
+                i64 min = INT64_MAX, max = INT64_MIN, number;
+                size_t num_exceptions = 0;
+                for (size_t i = 0; i < num_samples; i++) {
+                        if (alp_encode_one(&number, values[i * step], exponent)) {
+                                min = ng5_min(min, number);
+                                max = ng5_max(max, number);
+                        } else {
+                                num_exceptions++;
+                        }
+                }
+                size_t bits = (num_samples - num_exceptions) * (min <= max ? bits_of((u64) max - (u64) min) : 0)
+                        + num_exceptions * 8 * (sizeof(u32) + sizeof(field_number_t));
+                if (bits < best_bits) {
+                        best_bits = bits;
+                        best = exponent;
+                }
+        }
+        return best;
+}
+
+/**
+ * returns the integers of all values for 'exponent' (which the caller must free), and the positions of the exceptions
+ * in 'exceptions' (which the caller must free, too)
+ */
+static i64 *alp_numbers(u32 **exceptions, u32 *num_exceptions, const field_number_t *values, size_t num_values,
+        unsigned exponent)
+{
+        i64 *numbers = malloc(ng5_max(num_values, 1u) * sizeof(i64)), filler = 0;
+        bool has_filler = false;
+        *exceptions = malloc(ng5_max(num_values, 1u) * sizeof(u32));
+        *num_exceptions = 0;
+        for (size_t i = 0; i < num_values; i++) {
+                if (alp_encode_one(numbers + i, values[i], exponent)) {
+                        filler = has_filler ? filler : numbers[i];
+                        has_filler = true;
+                } else {
+                        (*exceptions)[(*num_exceptions)++] = (u32) i;
+                }
+        }
+        for (u32 i = 0; i < *num_exceptions; i++) {
+                numbers[(*exceptions)[i]] = filler;
+        }
+        return numbers;
+}
+
+void floatpack_estimate(size_t sizes[NG5_FLOATPACK_NUM_TYPES], const field_number_t *values, size_t num_values)
+{
+        u32 *exceptions, num_exceptions;
+        size_t int_sizes[NG5_INTPACK_NUM_TYPES] = {0};
+        i64 *numbers = alp_numbers(&exceptions, &num_exceptions, values, num_values,
+                alp_exponent(values, num_values));
+        intpack_estimate(int_sizes, numbers, num_values, sizeof(i64), true);
+
+        sizes[FLOATPACK_PLAIN] += num_values * sizeof(field_number_t);
+        sizes[FLOATPACK_ALP] += ALP_HEADER_SIZE + int_sizes[intpack_choose(int_sizes)]
+                + num_exceptions * (sizeof(u32) + sizeof(field_number_t));
+        free(numbers);
+        free(exceptions);
+}
+
+enum floatpack_type floatpack_choose(const size_t sizes[NG5_FLOATPACK_NUM_TYPES])
+{
+        return sizes[FLOATPACK_ALP] < sizes[FLOATPACK_PLAIN] ? FLOATPACK_ALP : FLOATPACK_PLAIN;
+}
+
+bool floatpack_encode(struct memfile *dst, enum floatpack_type type, const field_number_t *values, size_t num_values)
+{
+        error_if_null(dst)
+        assert(values || num_values == 0);
+
+        switch (type) {
+        case FLOATPACK_PLAIN:
+                return num_values == 0 || memfile_write(dst, values, num_values * sizeof(field_number_t));
+        case FLOATPACK_ALP: {
+                u32 *exceptions, num_exceptions;
+                size_t int_sizes[NG5_INTPACK_NUM_TYPES] = {0};
+                u8 exponent = (u8) alp_exponent(values, num_values);
+                i64 *numbers = alp_numbers(&exceptions, &num_exceptions, values, num_values, exponent);
+                intpack_estimate(int_sizes, numbers, num_values, sizeof(i64), true);
+                u8 int_type = (u8) intpack_choose(int_sizes);
+
+                memfile_write(dst, &exponent, sizeof(u8));
+                memfile_write(dst, &int_type, sizeof(u8));
+                memfile_write(dst, &num_exceptions, sizeof(u32));
+                intpack_encode(dst, int_type, numbers, num_values, sizeof(i64), true);
+                memfile_write(dst, exceptions, num_exceptions * sizeof(u32));
+                for (u32 i = 0; i < num_exceptions; i++) {
+                        memfile_write(dst, values + exceptions[i], sizeof(field_number_t));
+                }
+                free(numbers);
+                free(exceptions);
+                return true;
+        }
+        default:
+                error(&dst->err, NG5_ERR_NOTYPE)
+                return false;
+        }
+}
+
+size_t floatpack_encoded_size(const void *src, enum floatpack_type type, size_t num_values)
+{
+        const u8 *in = src;
+        u32 num_exceptions;
+        switch (type) {
+        case FLOATPACK_ALP:
+                memcpy(&num_exceptions, in + 2, sizeof(u32));
+                return ALP_HEADER_SIZE + intpack_encoded_size(in + ALP_HEADER_SIZE, in[1], num_values, sizeof(i64))
+                        + num_exceptions * (sizeof(u32) + sizeof(field_number_t));
+        default:
+                return num_values * sizeof(field_number_t);
+        }
+}
+
+size_t floatpack_decode(field_number_t *dst, const void *src, enum floatpack_type type, size_t num_values)
+{
+        const u8 *in = src;
+        if (type != FLOATPACK_ALP) {
+                memcpy(dst, src, num_values * sizeof(field_number_t));
+                return num_values * sizeof(field_number_t);
+        }
+
+        unsigned exponent = in[0];
+        u32 num_exceptions;
+        memcpy(&num_exceptions, in + 2, sizeof(u32));
+        i64 *numbers = malloc(ng5_max(num_values, 1u) * sizeof(i64));
+        size_t size = ALP_HEADER_SIZE + intpack_decode(numbers, in + ALP_HEADER_SIZE, in[1], num_values, sizeof(i64),
+                true);
+        const double fraction = alp_fractions[exponent];
+        for (size_t i = 0; i < num_values; i++) {
+                dst[i] = (field_number_t) ((double) numbers[i] * fraction);
+        }
+        free(numbers);
+
+        const u8 *positions = in + size, *exceptions = positions + num_exceptions * sizeof(u32);
+        for (u32 i = 0; i < num_exceptions; i++) {
+                u32 position;
+                memcpy(&position, positions + i * sizeof(u32), sizeof(u32));
+                memcpy(dst + position, exceptions + i * sizeof(field_number_t), sizeof(field_number_t));
+        }
+        return size + num_exceptions * (sizeof(u32) + sizeof(field_number_t));
+}
+
+const char *floatpack_type_str(enum floatpack_type type)
+{
+        switch (type) {
+        case FLOATPACK_PLAIN:
+                return "plain";
+        case FLOATPACK_ALP:
+                return "alp";
+        default:
+                return "unknown";
+        }
+}
@@ -0,0 +1,663 @@
+/**
+ * Copyright 2018 Marcus Pinnecke
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <assert.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "core/pack/intpack.h"
+
+/** numbers that are unpacked at once into a buffer on the stack while decoding */
+#define NG5_INTPACK_CHUNK               256
+
+static inline u64 zigzag(u64 x)
+{
+        return (x << 1) ^ (u64) ((i64) x >> 63);
+}
+
+static inline u64 unzigzag(u64 x)
+{
+        return (x >> 1) ^ (0 - (x & 1));
+}
+
+static inline unsigned bits_of(u64 x)
+{
+        return x ? 64 - __builtin_clzll(x) : 0;
+}
+
+static inline size_t packed_size(size_t num_numbers, unsigned bits)
+{
+        return (num_numbers * bits + 7) / 8;
+}
+
+static inline size_t header_size(enum intpack_type type, size_t width)
+{
+        switch (type) {
+        case INTPACK_FOR:
+        case INTPACK_DELTA:
+                return width + 1;
+        case INTPACK_BITPACK:
+                return 1;
+        case INTPACK_RLE:
+                return sizeof(u32);
+        default:
+                return 0;
+        }
+}
+
+static inline size_t rle_size(size_t num_runs, size_t width)
+{
+        return header_size(INTPACK_RLE, width) + num_runs * (width + sizeof(u32));
+}
+
+static inline size_t bitmap_size(size_t num_values, bool has_nulls)
+{
+        return sizeof(u8) + (has_nulls ? 2 : 1) * packed_size(num_values, 1);
+}
+
+/** returns true if the 'num_values' values are 1-byte booleans, and whether any of them is null in 'has_nulls' */
+static bool bitmap_applies(bool *has_nulls, const void *values, size_t num_values, size_t width)
+{
+        const u8 *in = values;
+        *has_nulls = false;
+        if (width != 1) {
+                return false;
+        }
+        for (size_t i = 0; i < num_values; i++) {
+                if (in[i] == NG5_NULL_BOOLEAN) {
+                        *has_nulls = true;
+                } else if (in[i] > 1) {
+                        return false;
+                }
+        }
+        return true;
+}
+
+static inline u64 load(const void *values, size_t i, size_t width, bool is_signed)
+{
+        const char *value = (const char *) values + i * width;
+        switch (width) {
+        case 1: {
+                u8 x;
+                memcpy(&x, value, 1);
+                return is_signed ? (u64) (i64) (i8) x : x;
+        }
+        case 2: {
+                u16 x;
+                memcpy(&x, value, 2);
+                return is_signed ? (u64) (i64) (i16) x : x;
+        }
+        case 4: {
+                u32 x;
+                memcpy(&x, value, 4);
+                return is_signed ? (u64) (i64) (i32) x : x;
+        }
+        default: {
+                u64 x;
+                memcpy(&x, value, 8);
+                return x;
+        }
+        }
+}
+
+#define STORE_NUMBERS(dst, numbers, num_numbers, type)                                                                 \
+{                                                                                                                      \
+        for (size_t k = 0; k < num_numbers; k++) {                                                                     \
+                type x = (type) numbers[k];                                                                            \
+                memcpy((char *) dst + k * sizeof(type), &x, sizeof(type));                                             \
+        }                                                                                                              \
+}
+
+/** stores 'num_numbers' numbers truncated to 'width' bytes each */
+static inline void store(void *dst, const u64 *numbers, size_t num_numbers, size_t width)
+{
+        switch (width) {
+        case 1: STORE_NUMBERS(dst, numbers, num_numbers, u8)
+                break;
+        case 2: STORE_NUMBERS(dst, numbers, num_numbers, u16)
+                break;
+        case 4: STORE_NUMBERS(dst, numbers, num_numbers, u32)
+                break;
+        default: STORE_NUMBERS(dst, numbers, num_numbers, u64)
+                break;
+        }
+}
+
+static inline bool less(u64 a, u64 b, bool is_signed)
+{
+        return is_signed ? (i64) a < (i64) b : a < b;
+}
+
+void intpack_estimate(size_t sizes[NG5_INTPACK_NUM_TYPES], const void *values, size_t num_values, size_t width,
+        bool is_signed)
+{
+        size_t window = num_values, num_windows = 1, stride = 0;
+        if (num_values > NG5_INTPACK_SAMPLE_SIZE) {
+                window = NG5_INTPACK_SAMPLE_SIZE / NG5_INTPACK_SAMPLE_WINDOWS;
+                num_windows = NG5_INTPACK_SAMPLE_WINDOWS;
+                stride = (num_values - window) / (num_windows - 1);
+        }
+
+        u64 min = num_values ? load(values, 0, width, is_signed) : 0, max = min;
+        u64 max_delta = 0, max_number = 0;
+        size_t num_runs = 0;
+        for (size_t w = 0; w < num_windows; w++) {
+                size_t begin = w * stride;
+                u64 prev = 0;
+                for (size_t i = begin; i < begin + window; i++) {
+                        u64 value = load(values, i, width, is_signed);
+                        min = less(value, min, is_signed) ? value : min;
+                        max = less(max, value, is_signed) ? value : max;
+                        max_number |= is_signed ? zigzag(value) : value;
+                        if (i > begin) {
+                                max_delta |= zigzag(value - prev);
+                        }
+                        num_runs += i == begin || value != prev;
+                        prev = value;
+                }
+        }
+
+        /** or-ing the numbers above yields the same bit width as taking their maximum */
+        sizes[INTPACK_PLAIN] += num_values * width;
+        sizes[INTPACK_FOR] += header_size(INTPACK_FOR, width) + packed_size(num_values, bits_of(max - min));
+        sizes[INTPACK_DELTA] += header_size(INTPACK_DELTA, width)
+                + packed_size(num_values ? num_values - 1 : 0, bits_of(max_delta));
+        sizes[INTPACK_BITPACK] += header_size(INTPACK_BITPACK, width) + packed_size(num_values, bits_of(max_number));
+        /** runs that span window borders are counted once per window; scaling overestimates the number of runs */
+        sizes[INTPACK_RLE] += rle_size(num_windows > 1 ? num_runs * num_values / (window * num_windows) : num_runs,
+                width);
+        /** a single value that is not a boolean rules out bitmaps, hence all values are inspected */
+        bool has_nulls = false;
+        sizes[INTPACK_BITMAP] = sizes[INTPACK_BITMAP] == SIZE_MAX || !bitmap_applies(&has_nulls, values, num_values,
+                width) ? SIZE_MAX : sizes[INTPACK_BITMAP] + bitmap_size(num_values, has_nulls);
+}
+
+enum intpack_type intpack_choose(const size_t sizes[NG5_INTPACK_NUM_TYPES])
+{
+        enum intpack_type best = INTPACK_PLAIN;
+        for (int type = INTPACK_FOR; type < NG5_INTPACK_NUM_TYPES; type++) {
+                /** bitmaps are counted without decoding them, which outweighs other encodings of the same size */
+                if (sizes[type] < sizes[best] || (type == INTPACK_BITMAP && sizes[type] == sizes[best])) {
+                        best = (enum intpack_type) type;
+                }
+        }
+        return best;
+}
+
+static bool rle_encode(struct memfile *dst, const void *values, size_t num_values, size_t width)
+{
+        u32 num_runs = 0;
+        char *run_values = malloc(ng5_max(num_values * width, 1u));
+        u32 *run_ends = malloc(ng5_max(num_values, 1u) * sizeof(u32));
+        for (size_t i = 0; i < num_values; i++) {
+                if (i == 0 || memcmp((const char *) values + i * width, (const char *) values + (i - 1) * width,
+                        width) != 0) {
+                        memcpy(run_values + num_runs++ * width, (const char *) values + i * width, width);
+                }
+                run_ends[num_runs - 1] = (u32) i + 1;
+        }
+        memfile_write(dst, &num_runs, sizeof(u32));
+        memfile_write(dst, run_values, num_runs * width);
+        bool status = memfile_write(dst, run_ends, num_runs * sizeof(u32));
+        free(run_values);
+        free(run_ends);
+        return status;
+}
+
+static bool bitmap_encode(struct memfile *dst, const void *values, size_t num_values, size_t width)
+{
+        bool has_nulls;
+        if (!bitmap_applies(&has_nulls, values, num_values, width)) {
+                error(&dst->err, NG5_ERR_ILLEGALARG)
+                return false;
+        }
+        const u8 *in = values;
+        size_t size = packed_size(num_values, 1);
+        u8 flags = has_nulls, *bits = calloc(2 * size + 1, 1), *valid = bits + size;
+        for (size_t i = 0; i < num_values; i++) {
+                bits[i >> 3] |= (u8) ((in[i] == 1) << (i & 7));
+                valid[i >> 3] |= (u8) ((in[i] != NG5_NULL_BOOLEAN) << (i & 7));
+        }
+        memfile_write(dst, &flags, sizeof(u8));
+        bool status = memfile_write(dst, bits, (has_nulls ? 2 : 1) * size);
+        free(bits);
+        return status;
+}
+
+static size_t bitmap_decode(void *dst, const void *src, size_t num_values)
+{
+        const u8 *in = src, *bits = in + 1, *valid = bits + packed_size(num_values, 1);
+        u8 *out = dst;
+        for (size_t i = 0; i < num_values; i++) {
+                out[i] = (bits[i >> 3] >> (i & 7)) & 1;
+        }
+        if (in[0]) {
+                for (size_t i = 0; i < num_values; i++) {
+                        out[i] = (valid[i >> 3] >> (i & 7)) & 1 ? out[i] : NG5_NULL_BOOLEAN;
+                }
+        }
+        return bitmap_size(num_values, in[0]);
+}
+
+static size_t rle_decode(void *dst, const void *src, size_t width)
+{
+        const void *values;
+        const u32 *ends;
+        u32 num_runs = intpack_rle_runs(&values, &ends, src, width);
+        u32 begin = 0;
+        for (u32 run = 0; run < num_runs; run++) {
+                u32 end;
+                memcpy(&end, ends + run, sizeof(u32));
+                for (u32 i = begin; i < end; i++) {
+                        memcpy((char *) dst + i * width, (const char *) values + run * width, width);
+                }
+                begin = end;
+        }
+        return rle_size(num_runs, width);
+}
+
+/** or's the lowest 'bits' bits of 'number' into 'out' (of 'size' bytes) at bit position 'pos' */
+static inline void pack_one(u8 *out, size_t size, size_t pos, u64 number, unsigned bits)
+{
+        size_t byte = pos >> 3;
+        unsigned shift = pos & 7;
+        u64 lo = number << shift;
+        for (size_t k = 0; k < 8 && byte + k < size; k++) {
+                out[byte + k] |= (u8) (lo >> (8 * k));
+        }
+        if (shift + bits > 64) {
+                out[byte + 8] |= (u8) (number >> (64 - shift));
+        }
+}
+
+bool intpack_encode(struct memfile *dst, enum intpack_type type, const void *values, size_t num_values, size_t width,
+        bool is_signed)
+{
+        error_if_null(dst)
+        assert(values || num_values == 0);
+
+        if (type == INTPACK_PLAIN) {
+                return num_values == 0 || memfile_write(dst, values, num_values * width);
+        } else if (type == INTPACK_RLE) {
+                return rle_encode(dst, values, num_values, width);
+        } else if (type == INTPACK_BITMAP) {
+                return bitmap_encode(dst, values, num_values, width);
+        }
+
+        u64 *numbers = malloc(ng5_max(num_values, 1u) * sizeof(u64));
+        u64 ref = num_values ? load(values, 0, width, is_signed) : 0;
+        size_t num_numbers = num_values;
+        u64 max_number = 0;
+
+        switch (type) {
+        case INTPACK_FOR:
+                for (size_t i = 1; i < num_values; i++) {
+                        u64 value = load(values, i, width, is_signed);
+                        ref = less(value, ref, is_signed) ? value : ref;
+                }
+                for (size_t i = 0; i < num_values; i++) {
+                        numbers[i] = load(values, i, width, is_signed) - ref;
+                        max_number |= numbers[i];
+                }
+                break;
+        case INTPACK_DELTA:
+                num_numbers = num_values ? num_values - 1 : 0;
+                for (size_t i = 0; i < num_numbers; i++) {
+                        numbers[i] = zigzag(load(values, i + 1, width, is_signed) - load(values, i, width, is_signed));
+                        max_number |= numbers[i];
+                }
+                break;
+        case INTPACK_BITPACK:
+                for (size_t i = 0; i < num_values; i++) {
+                        u64 value = load(values, i, width, is_signed);
+                        numbers[i] = is_signed ? zigzag(value) : value;
+                        max_number |= numbers[i];
+                }
+                break;
+        default:
+                free(numbers);
+                error(&dst->err, NG5_ERR_NOTYPE)
+                return false;
+        }
+
+        u8 bits = (u8) bits_of(max_number);
+        size_t size = packed_size(num_numbers, bits);
+        u8 *packed = calloc(size + 1, 1);
+        for (size_t i = 0; i < num_numbers && bits > 0; i++) {
+                pack_one(packed, size, i * bits, numbers[i], bits);
+        }
+
+        if (type != INTPACK_BITPACK) {
+                memfile_write(dst, &ref, width);
+        }
+        memfile_write(dst, &bits, sizeof(u8));
+        memfile_write(dst, packed, size);
+
+        free(packed);
+        free(numbers);
+        return true;
+}
+
+size_t intpack_encoded_size(const void *src, enum intpack_type type, size_t num_values, size_t width)
+{
+        const u8 *in = src;
+        u32 num_runs;
+        switch (type) {
+        case INTPACK_FOR:
+                return header_size(type, width) + packed_size(num_values, in[width]);
+        case INTPACK_DELTA:
+                return header_size(type, width) + packed_size(num_values ? num_values - 1 : 0, in[width]);
+        case INTPACK_BITPACK:
+                return header_size(type, width) + packed_size(num_values, in[0]);
+        case INTPACK_RLE:
+                memcpy(&num_runs, in, sizeof(u32));
+                return rle_size(num_runs, width);
+        case INTPACK_BITMAP:
+                return bitmap_size(num_values, in[0]);
+        default:
+                return num_values * width;
+        }
+}
+
+/** unpacks the number at bit position 'pos' of 'in' (of 'size' bytes) */
+static inline u64 unpack_one(const u8 *in, size_t size, size_t pos, unsigned bits)
+{
+        size_t byte = pos >> 3;
+        unsigned shift = pos & 7;
+        u64 word = 0;
+        if (likely(byte + sizeof(u64) <= size)) {
+                memcpy(&word, in + byte, sizeof(u64));
+        } else {
+                memcpy(&word, in + byte, size - byte);
+        }
+        u64 number = word >> shift;
+        if (shift + bits > 64) {
+                number |= (u64) in[byte + 8] << (64 - shift);
+        }
+        return bits == 64 ? number : number & ((1ull << bits) - 1);
+}
+
+#if defined(__AVX2__)
+/** unpacks numbers 'first' to 'first + num_numbers' of 'in' eight (32bit lanes) or four (64bit lanes) at a time as
+ * long as all lanes can be gathered within 'size' bytes, and returns how many numbers are unpacked */
+static size_t unpack_avx2(u64 *out, const u8 *in, size_t size, size_t first, size_t num_numbers, unsigned bits)
+{
+        size_t i = 0;
+        if (bits > 0 && bits <= 25) {
+                const __m256i lanes = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                        _mm256_set1_epi32((int) bits));
+                const __m256i mask = _mm256_set1_epi32((int) ((1u << bits) - 1));
+                const __m256i seven = _mm256_set1_epi32(7);
+                for (; i + 8 <= num_numbers; i += 8) {
+                        size_t pos = (first + i) * bits;
+                        size_t byte = pos >> 3;
+                        if (byte + ((pos & 7) + 7 * bits) / 8 + sizeof(u32) > size) {
+                                break;
+                        }
+                        __m256i rel = _mm256_add_epi32(lanes, _mm256_set1_epi32((int) (pos & 7)));
+                        __m256i words = _mm256_i32gather_epi32((const int *) (in + byte), _mm256_srli_epi32(rel, 3), 1);
+                        __m256i numbers = _mm256_and_si256(_mm256_srlv_epi32(words, _mm256_and_si256(rel, seven)),
+                                mask);
+                        _mm256_storeu_si256((__m256i *) (out + i),
+                                _mm256_cvtepu32_epi64(_mm256_castsi256_si128(numbers)));
+                        _mm256_storeu_si256((__m256i *) (out + i + 4),
+                                _mm256_cvtepu32_epi64(_mm256_extracti128_si256(numbers, 1)));
+                }
+        } else if (bits > 25 && bits <= 57) {
+                const __m256i lanes = _mm256_setr_epi64x(0, bits, 2 * bits, 3 * bits);
+                const __m256i mask = _mm256_set1_epi64x((long long) ((1ull << bits) - 1));
+                const __m256i seven = _mm256_set1_epi64x(7);
+                for (; i + 4 <= num_numbers; i += 4) {
+                        size_t pos = (first + i) * bits;
+                        size_t byte = pos >> 3;
+                        if (byte + ((pos & 7) + 3 * bits) / 8 + sizeof(u64) > size) {
+                                break;
+                        }
+                        __m256i rel = _mm256_add_epi64(lanes, _mm256_set1_epi64x((long long) (pos & 7)));
+                        __m256i words = _mm256_i64gather_epi64((const long long *) (in + byte),
+                                _mm256_srli_epi64(rel, 3), 1);
+                        __m256i numbers = _mm256_and_si256(_mm256_srlv_epi64(words, _mm256_and_si256(rel, seven)),
+                                mask);
+                        _mm256_storeu_si256((__m256i *) (out + i), numbers);
+                }
+        }
+        return i;
+}
+#endif
+
+static void unpack(u64 *out, const u8 *in, size_t size, size_t first, size_t num_numbers, unsigned bits)
+{
+        size_t i = 0;
+        if (bits == 0) {
+                memset(out, 0, num_numbers * sizeof(u64));
+                return;
+        }
+#if defined(__AVX2__)
+        i = unpack_avx2(out, in, size, first, num_numbers, bits);
+#endif
+        for (; i < num_numbers; i++) {
+                out[i] = unpack_one(in, size, (first + i) * bits, bits);
+        }
+}
+
+size_t intpack_decode(void *dst, const void *src, enum intpack_type type, size_t num_values, size_t width,
+        bool is_signed)
+{
+        const u8 *in = src;
+        u64 ref = 0;
+        unsigned bits;
+        size_t num_numbers = num_values;
+        char *out = dst;
+
+        switch (type) {
+        case INTPACK_FOR:
+                ref = load(in, 0, width, is_signed);
+                bits = in[width];
+                break;
+        case INTPACK_DELTA:
+                ref = load(in, 0, width, is_signed);
+                bits = in[width];
+                if (num_values > 0) {
+                        store(out, &ref, 1, width);
+                        out += width;
+                        num_numbers--;
+                }
+                break;
+        case INTPACK_BITPACK:
+                bits = in[0];
+                break;
+        case INTPACK_RLE:
+                return rle_decode(dst, src, width);
+        case INTPACK_BITMAP:
+                return bitmap_decode(dst, src, num_values);
+        default:
+                memcpy(dst, src, num_values * width);
+                return num_values * width;
+        }
+
+        in += header_size(type, width);
+        size_t size = packed_size(num_numbers, bits);
+        u64 numbers[NG5_INTPACK_CHUNK];
+
+        for (size_t i = 0; i < num_numbers; i += NG5_INTPACK_CHUNK) {
+                size_t n = ng5_min(num_numbers - i, (size_t) NG5_INTPACK_CHUNK);
+                unpack(numbers, in, size, i, n, bits);
+                switch (type) {
+                case INTPACK_FOR:
+                        for (size_t k = 0; k < n; k++) {
+                                numbers[k] += ref;
+                        }
+                        break;
+                case INTPACK_DELTA:
+                        for (size_t k = 0; k < n; k++) {
+                                ref += unzigzag(numbers[k]);
+                                numbers[k] = ref;
+                        }
+                        break;
+                default:
+                        if (is_signed) {
+                                for (size_t k = 0; k < n; k++) {
+                                        numbers[k] = unzigzag(numbers[k]);
+                                }
+                        }
+                        break;
+                }
+                store(out + i * width, numbers, n, width);
+        }
+
+        return header_size(type, width) + size;
+}
+
+u32 intpack_rle_runs(const void **values, const u32 **ends, const void *src, size_t width)
+{
+        u32 num_runs;
+        memcpy(&num_runs, src, sizeof(u32));
+        *values = (const char *) src + header_size(INTPACK_RLE, width);
+        *ends = (const u32 *) ((const char *) *values + num_runs * width);
+        return num_runs;
+}
+
+u64 intpack_value_at(const void *values, size_t idx, size_t width, bool is_signed)
+{
+        return load(values, idx, width, is_signed);
+}
+
+static inline bool in_range(u64 value, u64 lo, u64 hi, bool is_signed)
+{
+        return !less(value, lo, is_signed) && !less(hi, value, is_signed);
+}
+
+#define COUNT_ALIGNED(count, values, num_values, type, bound_type, lo, hi)                                            \
+{                                                                                                                      \
+        const type *typed = __builtin_assume_aligned(values, sizeof(type));                                            \
+        for (size_t i = 0; i < num_values; i++) {                                                                      \
+                count += (bound_type) typed[i] >= (bound_type) lo && (bound_type) typed[i] <= (bound_type) hi;         \
+        }                                                                                                              \
+}
+
+/** counts the values in [lo, hi] with typed loads, given that 'values' is aligned to 'width' */
+static size_t count_range_aligned(const void *values, size_t num_values, size_t width, bool is_signed, u64 lo, u64 hi)
+{
+        size_t count = 0;
+        switch (width) {
+        case 1: if (is_signed) COUNT_ALIGNED(count, values, num_values, i8, i64, lo, hi)
+                else COUNT_ALIGNED(count, values, num_values, u8, u64, lo, hi)
+                break;
+        case 2: if (is_signed) COUNT_ALIGNED(count, values, num_values, i16, i64, lo, hi)
+                else COUNT_ALIGNED(count, values, num_values, u16, u64, lo, hi)
+                break;
+        case 4: if (is_signed) COUNT_ALIGNED(count, values, num_values, i32, i64, lo, hi)
+                else COUNT_ALIGNED(count, values, num_values, u32, u64, lo, hi)
+                break;
+        default: if (is_signed) COUNT_ALIGNED(count, values, num_values, i64, i64, lo, hi)
+                else COUNT_ALIGNED(count, values, num_values, u64, u64, lo, hi)
+                break;
+        }
+        return count;
+}
+
+size_t intpack_count_range(const void *src, enum intpack_type type, size_t num_values, size_t width, bool is_signed,
+        u64 lo, u64 hi)
+{
+        size_t count = 0;
+        if (type == INTPACK_RLE) {
+                const void *values;
+                const u32 *ends;
+                u32 num_runs = intpack_rle_runs(&values, &ends, src, width), begin = 0, end;
+                for (u32 run = 0; run < num_runs; run++) {
+                        memcpy(&end, ends + run, sizeof(u32));
+                        if (in_range(load(values, run, width, is_signed), lo, hi, is_signed)) {
+                                count += end - begin;
+                        }
+                        begin = end;
+                }
+        } else if (type == INTPACK_BITMAP) {
+                size_t num_null, num_true = intpack_bitmap_count(&num_null, src, num_values);
+                count += in_range(0, lo, hi, is_signed) ? num_values - num_true - num_null : 0;
+                count += in_range(1, lo, hi, is_signed) ? num_true : 0;
+                count += in_range(NG5_NULL_BOOLEAN, lo, hi, is_signed) ? num_null : 0;
+        } else {
+                const void *values = src;
+                void *decoded = NULL;
+                if (type != INTPACK_PLAIN) {
+                        values = decoded = malloc(ng5_max(num_values * width, 1u));
+                        intpack_decode(decoded, src, type, num_values, width, is_signed);
+                }
+                if (((uintptr_t) values & (width - 1)) == 0) {
+                        /** decoded values, and plain values of aligned record tables */
+                        count = count_range_aligned(values, num_values, width, is_signed, lo, hi);
+                } else {
+                        for (size_t i = 0; i < num_values; i++) {
+                                count += in_range(load(values, i, width, is_signed), lo, hi, is_signed);
+                        }
+                }
+                free(decoded);
+        }
+        return count;
+}
+
+size_t intpack_bitmap_count(size_t *num_null, const void *src, size_t num_values)
+{
+        const u8 *in = src;
+        size_t size = packed_size(num_values, 1);
+        ng5_optional_set(num_null, in[0] ? num_values - intpack_popcount(in + 1 + size, 0, num_values) : 0)
+        return intpack_popcount(in + 1, 0, num_values);
+}
+
+size_t intpack_popcount(const void *bits, size_t begin, size_t end)
+{
+        const u8 *in = bits;
+        size_t count = 0, i = begin;
+        /** single bits up to the next byte border, then whole words and bytes, then single bits again */
+        for (; i < end && (i & 7); i++) {
+                count += (in[i >> 3] >> (i & 7)) & 1;
+        }
+        for (; i + 64 <= end; i += 64) {
+                u64 word;
+                memcpy(&word, in + (i >> 3), sizeof(u64));
+                count += __builtin_popcountll(word);
+        }
+        for (; i + 8 <= end; i += 8) {
+                count += __builtin_popcount(in[i >> 3]);
+        }
+        for (; i < end; i++) {
+                count += (in[i >> 3] >> (i & 7)) & 1;
+        }
+        return count;
+}
+
+const char *intpack_type_str(enum intpack_type type)
+{
+        switch (type) {
+        case INTPACK_PLAIN:
+                return "plain";
+        case INTPACK_FOR:
+                return "for";
+        case INTPACK_DELTA:
+                return "delta";
+        case INTPACK_BITPACK:
+                return "bitpack";
+        case INTPACK_RLE:
+                return "rle";
+        case INTPACK_BITMAP:
+                return "bitmap";
+        default:
+                return "unknown";
+        }
+}
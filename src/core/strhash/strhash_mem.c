@@ -18,7 +18,6 @@
 #include "core/strhash/strhash_mem.h"
 #include "core/async/spin.h"
 #include "std/sort.h"
-#include "core/alloc/trace.h"
 #include "utils/time.h"
 #include "std/bloom.h"
 #include "stdx/slicelist.h"
@@ -227,11 +226,7 @@ static int this_get_safe(struct strhash *self, field_sid_t **out, bool **found_m
         ng5_trace(SMART_MAP_TAG, "'get_safe' function invoked for %zu strings", num_keys)
 
         struct allocator hashtable_alloc;
-#if defined(NG5_CONFIG_TRACE_STRING_DIC_ALLOC) && !defined(NDEBUG)
-        CHECK_SUCCESS(allocator_TRACE(&hashtable_alloc));
-#else
         ng5_check_success(alloc_this_or_std(&hashtable_alloc, &self->allocator));
-#endif
 
         struct mem_extra *extra = this_get_exta(self);
         size_t *bucket_idxs = alloc_malloc(&self->allocator, num_keys * sizeof(size_t));
@@ -281,11 +276,7 @@ static int this_get_safe_exact(struct strhash *self, field_sid_t *out, bool *fou
         assert(self->tag == MEMORY_RESIDENT);
 
         struct allocator hashtable_alloc;
-#if defined(NG5_CONFIG_TRACE_STRING_DIC_ALLOC) && !defined(NDEBUG)
-        CHECK_SUCCESS(allocator_TRACE(&hashtable_alloc));
-#else
         ng5_check_success(alloc_this_or_std(&hashtable_alloc, &self->allocator));
-#endif
 
         struct mem_extra *extra = this_get_exta(self);
 
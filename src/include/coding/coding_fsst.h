@@ -0,0 +1,123 @@
+/**
+ * Copyright 2018 Marcus Pinnecke
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NG5_FSST_H
+#define NG5_FSST_H
+
+#include <limits.h>
+
+#include "shared/common.h"
+#include "std/vec.h"
+#include "core/mem/file.h"
+#include "shared/types.h"
+
+NG5_BEGIN_DECL
+
+/** maximum number of symbols of a symbol table; the code NG5_FSST_ESCAPE is reserved for escaping single bytes */
+#define NG5_FSST_MAX_SYMBOLS            255
+
+/** code that is followed by a byte which is not encoded by any symbol */
+#define NG5_FSST_ESCAPE                 255
+
+/** maximum number of bytes of a symbol */
+#define NG5_FSST_MAX_SYMBOL_LENGTH      8
+
+/** number of bytes of strings that are sampled from the string dictionary for learning the symbol table */
+#define NG5_FSST_SAMPLE_SIZE            (16 * 1024)
+
+/** number of rounds in which the symbol table is refined on the sample */
+#define NG5_FSST_GENERATIONS            5
+
+/**
+ * Static symbol table compression (FSST) for strings. A symbol table holds up to NG5_FSST_MAX_SYMBOLS symbols of 1 to
+ * NG5_FSST_MAX_SYMBOL_LENGTH bytes each that are learned from a sample of the strings to compress. A string is
+ * encoded by replacing its longest prefix that is a symbol by the one-byte code of that symbol, repeatedly. Bytes
+ * that do not start any symbol are escaped, i.e., are stored as NG5_FSST_ESCAPE followed by the byte itself.
+ *
+ * Each string is encoded on its own, such that strings are decoded independently of each other (one symbol lookup
+ * per code). Since the encoding of a string is determined by the symbol table only, two strings are equal if and only
+ * if their encodings are equal, see <code>coding_fsst_equals</code>.
+ *
+ * Symbols are sorted by their first byte and descending length, such that the symbols starting with a byte
+ * <code>b</code> have the codes <code>first[b]</code> to <code>first[b + 1] - 1</code>.
+ */
+struct coding_fsst {
+        u8 num_symbols;
+        u8 lengths[NG5_FSST_MAX_SYMBOLS];
+        unsigned char symbols[NG5_FSST_MAX_SYMBOLS][NG5_FSST_MAX_SYMBOL_LENGTH];
+        u16 first[UCHAR_MAX + 2];
+        struct err err;
+};
+
+struct pack_fsst_symbol_info {
+        u8 code;
+        u8 length;
+        const char *bytes;
+};
+
+struct pack_fsst_str_info {
+        u32 nbytes_encoded;
+        const char *encoded_bytes;
+};
+
+NG5_EXPORT(bool) coding_fsst_create(struct coding_fsst *dic);
+
+NG5_EXPORT(bool) coding_fsst_cpy(struct coding_fsst *dst, const struct coding_fsst *src);
+
+NG5_EXPORT(bool) coding_fsst_drop(struct coding_fsst *dic);
+
+/** learns the symbol table from a sample of up to NG5_FSST_SAMPLE_SIZE bytes of <code>strings</code> */
+NG5_EXPORT(bool) coding_fsst_build(struct coding_fsst *dic, const string_vector_t *strings);
+
+NG5_EXPORT(bool) coding_fsst_get_error(struct err *err, const struct coding_fsst *dic);
+
+/**
+ * Encodes the <code>strlen</code> bytes of <code>string</code> into <code>dst</code> which must hold at least
+ * <code>2 * strlen</code> bytes, and returns the number of bytes of the encoded string
+ */
+NG5_EXPORT(size_t) coding_fsst_compress(void *dst, const struct coding_fsst *dic, const char *string, size_t strlen);
+
+/** writes the number of encoded bytes (u32), followed by the encoded bytes of <code>string</code> to <code>file</code> */
+NG5_EXPORT(bool) coding_fsst_encode(struct memfile *file, struct coding_fsst *dic, const char *string);
+
+NG5_EXPORT(bool) coding_fsst_read_string(struct pack_fsst_str_info *info, struct memfile *src);
+
+/**
+ * Decodes the <code>strlen</code> bytes of the string that is encoded in the <code>nbytes</code> bytes at
+ * <code>src</code> into <code>dst</code> (which is not null-terminated)
+ */
+NG5_EXPORT(bool) coding_fsst_decode(char *dst, size_t strlen, struct coding_fsst *dic, const void *src,
+        size_t nbytes);
+
+/**
+ * Returns <code>true</code> if the strings that are encoded in <code>lhs</code> and <code>rhs</code> with the same
+ * symbol table are equal, without decoding them. A string literal is compared to encoded strings after encoding it
+ * with <code>coding_fsst_compress</code>.
+ */
+NG5_EXPORT(bool) coding_fsst_equals(const void *lhs, size_t lhs_nbytes, const void *rhs, size_t rhs_nbytes);
+
+/** writes the number of symbols (u8), followed by each symbol (marker, length and bytes) to <code>file</code> */
+NG5_EXPORT(bool) coding_fsst_serialize(struct memfile *file, const struct coding_fsst *dic, char marker_symbol);
+
+/** reads the symbol table that is serialized at the cursor of 'file' by 'coding_fsst_serialize' */
+NG5_EXPORT(bool) coding_fsst_deserialize(struct coding_fsst *dic, struct memfile *file, char marker_symbol);
+
+NG5_EXPORT(bool) coding_fsst_read_symbol(struct pack_fsst_symbol_info *info, struct memfile *file, char marker_symbol);
+
+NG5_END_DECL
+
+#endif
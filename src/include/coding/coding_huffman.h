@@ -18,6 +18,8 @@
 #ifndef NG5_HUFFMAN_H
 #define NG5_HUFFMAN_H
 
+#include <limits.h>
+
 #include "shared/common.h"
 #include "std/vec.h"
 #include "core/mem/file.h"
@@ -25,21 +27,47 @@
 
 NG5_BEGIN_DECL
 
-struct coding_huffman {
-        struct vector ofType(struct pack_huffman_entry) table;
-        struct err err;
+/** codes are limited in length such that each probe of the decode table yields at least one letter */
+#define NG5_HUFFMAN_MAX_CODE_LENGTH     12
+
+/** number of bits looked up per probe of the decode table, i.e., the table has 2^NG5_HUFFMAN_TABLE_BITS entries */
+#define NG5_HUFFMAN_TABLE_BITS          NG5_HUFFMAN_MAX_CODE_LENGTH
+
+/** maximum number of letters that are decoded by one probe of the decode table */
+#define NG5_HUFFMAN_TABLE_MAX_LETTERS   6
+
+/** dictionaries with at least this many strings are scanned for letter frequencies concurrently */
+#define NG5_HUFFMAN_PARALLEL_MIN        (1 << 14)
+
+/** the canonical prefix code of a letter, stored in the 'length' least significant bits of 'code' */
+struct pack_huffman_code {
+        u16 code;
+        u8 length;      /* 0 if the letter does not occur */
 };
 
-struct pack_huffman_entry {
-        unsigned char letter;
-        u32 *blocks;
-        u16 nblocks;
+/** the letters encoded by the leading bits of NG5_HUFFMAN_TABLE_BITS bits */
+struct pack_huffman_decode_entry {
+        u8 num_letters;  /* 0 if the bits do not start with a code */
+        u8 num_bits;     /* number of bits of the codes of all letters */
+        unsigned char letters[NG5_HUFFMAN_TABLE_MAX_LETTERS];
+};
+
+/**
+ * Canonical, length-limited Huffman codes for the letters of strings. The code of a letter is determined by the code
+ * lengths of all letters only, such that the code table is serialized as the code length of each letter. Letters are
+ * encoded by a lookup in 'codes', and decoded by probing 'table' with the next NG5_HUFFMAN_TABLE_BITS bits of the
+ * encoded string, which yields up to NG5_HUFFMAN_TABLE_MAX_LETTERS letters at once. Codes are written most
+ * significant bit first.
+ */
+struct coding_huffman {
+        struct pack_huffman_code codes[UCHAR_MAX + 1];
+        struct pack_huffman_decode_entry *table;
+        struct err err;
 };
 
 struct pack_huffman_info {
         unsigned char letter;
-        u8 nbytes_prefix;
-        char *prefix_code;
+        u8 code_length;
 };
 
 struct pack_huffman_str_info {
@@ -59,10 +87,20 @@ NG5_EXPORT(bool) coding_huffman_encode(struct memfile *file, struct coding_huffm
 
 NG5_EXPORT(bool) coding_huffman_read_string(struct pack_huffman_str_info *info, struct memfile *src);
 
+/**
+ * Decodes the <code>strlen</code> letters of the string that is encoded in the <code>nbytes</code> bytes at
+ * <code>src</code> into <code>dst</code> (which is not null-terminated)
+ */
+NG5_EXPORT(bool) coding_huffman_decode(char *dst, size_t strlen, struct coding_huffman *dic, const void *src,
+        size_t nbytes);
+
 NG5_EXPORT(bool) coding_huffman_drop(struct coding_huffman *dic);
 
 NG5_EXPORT(bool) coding_huffman_serialize(struct memfile *file, const struct coding_huffman *dic, char marker_symbol);
 
+/** reads the code table that is serialized at the cursor of 'file' by 'coding_huffman_serialize' */
+NG5_EXPORT(bool) coding_huffman_deserialize(struct coding_huffman *dic, struct memfile *file, char marker_symbol);
+
 NG5_EXPORT(bool) coding_huffman_read_entry(struct pack_huffman_info *info, struct memfile *file, char marker_symbol);
 
 NG5_END_DECL
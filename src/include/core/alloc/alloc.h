@@ -18,6 +18,8 @@
 #ifndef NG5_ALLOC_H
 #define NG5_ALLOC_H
 
+#include <assert.h>
+
 #include "shared/common.h"
 #include "shared/error.h"
 
@@ -104,11 +106,17 @@ NG5_EXPORT (bool) alloc_clone(struct allocator *dst, const struct allocator *src
  *
  * If allocation fails, the system may panic.
  *
+ * Inlined, such that implementations see the caller's code as return address (see prof.h).
+ *
  * @param alloc non-null pointer to allocator implementation
  * @param size number of bytes requested
  * @return non-null pointer to memory allocated with 'alloc'
  */
-NG5_EXPORT (void *) alloc_malloc(struct allocator *alloc, size_t size);
+static inline void *alloc_malloc(struct allocator *alloc, size_t size)
+{
+        assert(alloc);
+        return alloc->malloc(alloc, size);
+}
 
 /**
  * Invokes memory re-allocation for pointer 'ptr' (that is managed by 'alloc') to size 'size' in bytes.
@@ -118,7 +126,10 @@ NG5_EXPORT (void *) alloc_malloc(struct allocator *alloc, size_t size);
  * @param size new number of bytes for 'ptr'
  * @return non-null pointer that points to reallocated memory for 'ptr'
  */
-NG5_EXPORT (void *) alloc_realloc(struct allocator *alloc, void *ptr, size_t size);
+static inline void *alloc_realloc(struct allocator *alloc, void *ptr, size_t size)
+{
+        return alloc->realloc(alloc, ptr, size);
+}
 
 /**
  * Invokes memory freeing for pointer 'ptr' (that is managed by 'alloc').
@@ -0,0 +1,69 @@
+/**
+ * Copyright 2018 Marcus Pinnecke
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NG5_ALLOC_ARENA_H
+#define NG5_ALLOC_ARENA_H
+
+#include "alloc.h"
+
+NG5_BEGIN_DECL
+
+/** default number of bytes of a chunk from which small blocks are handed out */
+#define NG5_ARENA_CHUNK_SIZE            (1024 * 1024)
+
+/** alignment of all blocks handed out by an arena allocator */
+#define NG5_ARENA_ALIGNMENT             8
+
+/**
+ * Returns an arena (bump pointer) allocator that hands out blocks from chunks of <code>chunk_size</code> bytes
+ * (<code>NG5_ARENA_CHUNK_SIZE</code> if zero). Blocks larger than a quarter of a chunk get a chunk of their own, which
+ * is resized in place by <code>realloc</code>, such that growing vectors do not leave copies behind. Freeing a block
+ * gives its memory back only if it is the most recently allocated block or a block with a chunk of its own; all
+ * other memory is released at once with <code>arena_alloc_drop</code> or <code>arena_alloc_reset</code>. Hence,
+ * structures that live in an arena do not have to be freed node by node (see <code>arena_alloc_is</code>).
+ *
+ * Clones of an arena allocator (e.g., the ones stored in each <code>struct vector</code>) share the same arena.
+ * An arena is not thread-safe; use one arena per thread.
+ *
+ * @param alloc must be non-null
+ * @param chunk_size number of bytes per chunk, or 0 for the default size
+ * @return true on success, false otherwise
+ */
+NG5_EXPORT(bool) arena_alloc_create(struct allocator *alloc, size_t chunk_size);
+
+/**
+ * Releases all memory handed out by the arena <code>alloc</code> and the arena itself. All clones of
+ * <code>alloc</code> become invalid.
+ */
+NG5_EXPORT(bool) arena_alloc_drop(struct allocator *alloc);
+
+/**
+ * Releases all memory handed out by the arena <code>alloc</code>, but keeps its first chunk for subsequent
+ * allocations (unless it only holds a single large block), e.g., to reuse one arena for consecutive batches of
+ * documents.
+ */
+NG5_EXPORT(bool) arena_alloc_reset(struct allocator *alloc);
+
+/** Returns the number of bytes currently reserved by the arena <code>alloc</code> from the system */
+NG5_EXPORT(bool) arena_alloc_size(size_t *num_bytes, const struct allocator *alloc);
+
+/** Returns true if <code>alloc</code> is an arena allocator (or a clone of one), i.e., frees are (mostly) no-ops */
+NG5_EXPORT(bool) arena_alloc_is(const struct allocator *alloc);
+
+NG5_END_DECL
+
+#endif
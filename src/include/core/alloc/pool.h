@@ -0,0 +1,63 @@
+/**
+ * Copyright 2018 Marcus Pinnecke
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NG5_ALLOC_POOL_H
+#define NG5_ALLOC_POOL_H
+
+#include "alloc.h"
+
+NG5_BEGIN_DECL
+
+/** number of bytes of a slab, i.e., the unit in which blocks of one size class are handed to a thread */
+#define NG5_POOL_SLAB_SIZE              (256 * 1024)
+
+/** number of slabs that are mapped from the system at once */
+#define NG5_POOL_SLABS_PER_CHUNK        16
+
+/** blocks larger than this get a mapping of their own */
+#define NG5_POOL_MAX_BLOCK_SIZE         (16 * 1024)
+
+/** alignment of all blocks handed out by a pool allocator */
+#define NG5_POOL_ALIGNMENT              16
+
+/**
+ * Returns a pool allocator, i.e., an allocator that rounds each request up to one of a fixed set of size classes
+ * (four classes per power of two) and hands out blocks of that class from slabs of
+ * <code>NG5_POOL_SLAB_SIZE</code> bytes. Slabs are carved out of larger chunks mapped from the system with
+ * <code>mmap</code>, and each slab belongs to exactly one thread that allocates from it and frees into it without
+ * synchronization. A block that is freed by another thread is pushed on a lock-free list of its slab, from which the
+ * owning thread collects it once it runs out of free blocks. Slabs that become empty are given back to a process-wide
+ * list from which any thread (and any size class) takes them. When a thread exits, its slabs are handed over to the
+ * next thread that starts allocating. Blocks larger than <code>NG5_POOL_MAX_BLOCK_SIZE</code> are mapped one by one.
+ *
+ * All pool allocators share the same process-wide pool, hence it is safe to free a block with another pool
+ * allocator (or a clone) than the one that allocated it, and in another thread.
+ *
+ * @param alloc must be non-null
+ * @return true on success, false otherwise
+ */
+NG5_EXPORT(bool) pool_alloc_create(struct allocator *alloc);
+
+/** Returns the number of bytes currently mapped from the system by the process-wide pool */
+NG5_EXPORT(bool) pool_alloc_size(size_t *num_bytes);
+
+/** Returns true if <code>alloc</code> is a pool allocator (or a clone of one) */
+NG5_EXPORT(bool) pool_alloc_is(const struct allocator *alloc);
+
+NG5_END_DECL
+
+#endif
@@ -0,0 +1,87 @@
+/**
+ * Copyright 2018 Marcus Pinnecke
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NG5_ALLOC_PROF_H
+#define NG5_ALLOC_PROF_H
+
+#include <stdio.h>
+
+#include "alloc.h"
+
+NG5_BEGIN_DECL
+
+/** default sampling rate, i.e., on average one of this many allocations is sampled with its call site */
+#define NG5_PROF_SAMPLE_RATE            1024
+
+/** maximum number of distinct (tag, backend) pairs of profiling allocators */
+#define NG5_PROF_MAX_TAGS               32
+
+/** maximum number of distinct sampled call sites over all tags */
+#define NG5_PROF_MAX_SITES              4096
+
+/**
+ * Returns an allocation-profiling allocator that forwards to <code>backend</code> (the standard allocator if
+ * <b>NULL</b>) and accounts all memory it hands out to the subsystem <code>tag</code> (e.g., "strdic"), i.e., the
+ * number of allocations and frees, the bytes currently in use, and their high-water mark. Each block is preceded
+ * by a 16-byte header that stores its size and tag.
+ *
+ * Counters are kept per thread and flushed to the (atomic) counters of the tag every few hundred KiB, such that the
+ * common path takes neither a lock nor an atomic operation; live bytes and high-water marks are exact up to the
+ * unflushed bytes of other threads. On average one of <code>NG5_PROF_SAMPLE_RATE</code> allocations (see
+ * <code>prof_alloc_enable</code>) is sampled: its call site, i.e., the return address of the code that called
+ * <code>alloc_malloc</code> resp. <code>alloc_realloc</code>, is recorded in a lock-free table together with the
+ * requested bytes. Use <code>prof_alloc_dump</code> to print all counters and the top call sites per tag.
+ *
+ * Blocks of a profiling allocator must be freed by a profiling allocator (e.g., a clone).
+ *
+ * @param alloc must be non-null
+ * @param backend allocator that actually provides memory, or <b>NULL</b>
+ * @param tag name of the subsystem (copied, at most 31 characters are used)
+ * @return true on success, false if there are <code>NG5_PROF_MAX_TAGS</code> (tag, backend) pairs already
+ */
+NG5_EXPORT(bool) prof_alloc_create(struct allocator *alloc, const struct allocator *backend, const char *tag);
+
+/**
+ * Same as <code>prof_alloc_create</code> if profiling is switched on with <code>prof_alloc_enable</code>,
+ * otherwise <code>alloc</code> becomes a clone of <code>backend</code> (the standard allocator if <b>NULL</b>).
+ * Intended for subsystems that should be profiled in production only on demand. If there are
+ * <code>NG5_PROF_MAX_TAGS</code> (tag, backend) pairs already, <code>alloc</code> becomes a clone of
+ * <code>backend</code> as well, and the allocator is reported as not profiled by <code>prof_alloc_dump</code>.
+ */
+NG5_EXPORT(bool) prof_alloc_wrap(struct allocator *alloc, const struct allocator *backend, const char *tag);
+
+/**
+ * Switches profiling on for subsequent calls to <code>prof_alloc_wrap</code>, sampling on average one of
+ * <code>sample_rate</code> allocations (<code>NG5_PROF_SAMPLE_RATE</code> if zero, every allocation if 1).
+ */
+NG5_EXPORT(bool) prof_alloc_enable(size_t sample_rate);
+
+NG5_EXPORT(bool) prof_alloc_enabled(void);
+
+/** Returns true if <code>alloc</code> is an allocation-profiling allocator (or a clone of one) */
+NG5_EXPORT(bool) prof_alloc_is(const struct allocator *alloc);
+
+/**
+ * Writes the counters of all tags and, per tag, the call sites with the most sampled bytes to <code>file</code>.
+ * Byte counts of call sites are estimates, i.e., the sampled bytes scaled by the sampling rate. Call sites are code
+ * addresses that can be resolved with, e.g., <code>addr2line</code>. Can be called at any time from any thread.
+ */
+NG5_EXPORT(bool) prof_alloc_dump(FILE *file);
+
+NG5_END_DECL
+
+#endif
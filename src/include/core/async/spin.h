@@ -18,16 +18,46 @@
 #ifndef NG5_SPINLOCK_H
 #define NG5_SPINLOCK_H
 
-#include <stdatomic.h>
-
 #include "shared/common.h"
-#include "std/vec.h"
+#include "shared/types.h"
 
 NG5_BEGIN_DECL
 
+/** upper bound of pause instructions between two polls of a waiting thread (exponential backoff) */
+#define NG5_SPIN_MAX_BACKOFF            128
+
+/**
+ * pause instructions the next thread in the queue spins until it falls asleep (futex on Linux, yield otherwise);
+ * threads further back in the queue spin proportionally less, and on a single processor, no thread spins at all
+ */
+#define NG5_SPIN_MAX_SPINS              (1u << 14)
+
+/** contention counters of a spinlock, see <code>spin_stats</code> */
+struct spin_stats {
+        u64 acquisitions;               /* number of times the lock was taken */
+        u64 contended;                  /* number of acquisitions that had to wait */
+        u64 spins;                      /* pause instructions issued while waiting */
+        u64 sleeps;                     /* number of times a waiting thread fell asleep */
+        u64 wait_ns;                    /* total time spent waiting in contended acquisitions */
+};
+
+/**
+ * Fair (FIFO) ticket lock. Waiting threads poll with exponential backoff and fall asleep after a while (see
+ * <code>NG5_SPIN_MAX_SPINS</code>); a release wakes up the next thread in the queue only. The lock is recursive, i.e.,
+ * the holder may acquire it again and must release it as often as it acquired it. Releasing a lock that the calling
+ * thread does not hold has no effect and returns false.
+ *
+ * All fields are accessed atomically in spin.c only (with compiler builtins, such that this header can be used from
+ * C++, too). The counters are written by the holder of the lock only; the clock is read on contended acquisitions
+ * only.
+ */
 struct spinlock {
-        atomic_flag lock;
-        pthread_t owner;
+        u32 next;                       /* ticket handed out to the next thread that acquires the lock */
+        u32 serving;                    /* ticket of the thread that holds the lock */
+        u32 sleepers;                   /* number of threads asleep on 'serving' */
+        uintptr_t owner;                /* token of the thread that holds the lock, 0 if none */
+        u32 depth;                      /* number of nested acquisitions by the holder */
+        struct spin_stats stats;
 };
 
 NG5_EXPORT(bool) spin_init(struct spinlock *spinlock);
@@ -36,6 +66,12 @@ NG5_EXPORT(bool) spin_acquire(struct spinlock *spinlock);
 
 NG5_EXPORT(bool) spin_release(struct spinlock *spinlock);
 
+/**
+ * Copies the contention counters of <code>spinlock</code> to <code>stats</code>. This can be called any time,
+ * concurrently to threads that acquire or release the lock.
+ */
+NG5_EXPORT(bool) spin_stats(struct spin_stats *stats, const struct spinlock *spinlock);
+
 NG5_END_DECL
 
 #endif
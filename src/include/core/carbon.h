@@ -57,7 +57,7 @@ extern "C" {
 #include "shared/types.h"
 #include "core/carbon/archive_query.h"
 #include "std/vec.h"
-#include "core/alloc/trace.h"
+#include "core/alloc/prof.h"
 #include "encode/encode_async.h"
 #include "core/encode/encode_sync.h"
 #include "core/strhash/strhash_mem.h"
@@ -39,6 +39,8 @@ struct archive {
         struct sid_to_offset *query_index_string_id_to_offset;
         struct string_cache *string_id_cache;
         struct archive_query *default_query;
+        struct decode_cache decode_cache;
+        struct row_group_directory row_groups;
 };
 
 struct archive_callback {
@@ -56,8 +58,8 @@ struct archive_callback {
         void (*end_setup_string_dictionary)();
         void (*begin_parse_json)();
         void (*end_parse_json)();
-        void (*begin_test_json)();
-        void (*end_test_json)();
+        void (*begin_test_json)();     /* unused: restrictions are tested during parsing */
+        void (*end_test_json)();       /* unused: restrictions are tested during parsing */
         void (*begin_import_json)();
         void (*end_import_json)();
         void (*begin_cleanup)();
@@ -79,8 +81,63 @@ NG5_EXPORT(bool) archive_stream_from_json(struct memblock **stream, struct err *
         enum packer_type compressor, enum strdic_tag dictionary, size_t num_async_dic_threads, bool read_optimized,
         bool bake_id_index, struct archive_callback *callback);
 
+/**
+ * Creates an archive from <code>json_string</code> as <code>archive_from_json</code> does, but parses and imports
+ * the records of a top-level array with <code>num_import_threads</code> threads. For this, the array is split into
+ * ranges of consecutive records, each of which is imported into a partition of its own; all partitions share one
+ * string dictionary, and are merged in input order into one partition from which the archive is built. If the
+ * input is a single object, it is imported by the calling thread only.
+ *
+ * If <code>aligned</code> is set, the record table starts at a cache line, and its key, value, offset and position
+ * arrays are padded to their natural alignment (large arrays and the positions of columns to a cache line), such
+ * that plain values can be loaded aligned. Aligned archives are marked in the flags of their record header.
+ *
+ * If <code>row_group_size</code> is not 0, arrays of more than <code>row_group_size</code> objects that are not nested
+ * in arrays of objects (e.g., the records of a top-level array) are cut into row groups of
+ * <code>row_group_size</code> objects, which are listed with statistics on their values in a row-group directory
+ * after the record table. Scans over such arrays can be split by row group, skip row groups by their statistics, or
+ * start at a row group (see <code>archive_column_count_range_in_row_groups</code> and
+ * <code>archive_column_seek_row_group</code>).
+ */
+NG5_EXPORT(bool) archive_from_json_parallel(struct archive *out, const char *file, struct err *err,
+        const char *json_string, size_t num_import_threads, enum packer_type compressor, enum strdic_tag dictionary,
+        size_t num_async_dic_threads, bool read_optimized, bool aligned, u64 row_group_size, bool bake_string_id_index,
+        struct archive_callback *callback);
+
+NG5_EXPORT(bool) archive_stream_from_json_parallel(struct memblock **stream, struct err *err,
+        const char *json_string, size_t num_import_threads, enum packer_type compressor, enum strdic_tag dictionary,
+        size_t num_async_dic_threads, bool read_optimized, bool aligned, u64 row_group_size, bool bake_id_index,
+        struct archive_callback *callback);
+
+/** size of the chunks in which newline-delimited JSON input is read */
+#define NG5_NDJSON_CHUNK_SIZE           (4 * 1024 * 1024)
+
+/** default number of records after which strings are inserted into the string dictionary */
+#define NG5_NDJSON_BATCH_SIZE           10000
+
+/**
+ * Creates an archive from newline-delimited JSON (JSON lines) read from <code>ndjson</code>, i.e., each non-empty
+ * line of the input is exactly one JSON object that is imported as one record. In contrast to
+ * <code>archive_from_json</code>, the input is read chunk-wise and never held in memory entirely. The strings of each
+ * <code>batch_size</code> records are inserted into the string dictionary as one batch.
+ */
+NG5_EXPORT(bool) archive_from_ndjson(struct archive *out, const char *file, struct err *err, FILE *ndjson,
+        size_t batch_size, enum packer_type compressor, enum strdic_tag dictionary, size_t num_async_dic_threads,
+        bool read_optimized, bool aligned, u64 row_group_size, bool bake_string_id_index,
+        struct archive_callback *callback);
+
+NG5_EXPORT(bool) archive_stream_from_ndjson(struct memblock **stream, struct err *err, FILE *ndjson,
+        size_t batch_size, enum packer_type compressor, enum strdic_tag dictionary, size_t num_async_dic_threads,
+        bool read_optimized, bool aligned, u64 row_group_size, bool bake_id_index, struct archive_callback *callback);
+
+/**
+ * writes 'model' to 'stream'; the string ids in 'model' are replaced by the compact ids of the archive. The record
+ * table is aligned if 'aligned' is set, and top-level arrays of objects are cut into row groups if 'row_group_size' is
+ * not 0 (see <code>archive_from_json_parallel</code>).
+ */
 NG5_EXPORT(bool) archive_from_model(struct memblock **stream, struct err *err, struct columndoc *model,
-        enum packer_type compressor, bool bake_string_id_index, struct archive_callback *callback);
+        enum packer_type compressor, bool aligned, u64 row_group_size, bool bake_string_id_index,
+        struct archive_callback *callback);
 
 NG5_EXPORT(bool) archive_write(FILE *file, const struct memblock *stream);
 
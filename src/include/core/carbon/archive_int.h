@@ -23,15 +23,25 @@
 #include "shared/types.h"
 #include "core/oid/oid.h"
 #include "core/pack/pack.h"
+#include "core/pack/intpack.h"
+#include "core/pack/floatpack.h"
+#include "core/async/spin.h"
+#include "std/hash_map.h"
 
 NG5_BEGIN_DECL
 
+/** alignment of the record table and of large arrays in aligned record tables (see 'record_flags') */
+#define NG5_ARCHIVE_CACHE_LINE          64
+
+/** arrays of at least this number of bytes are aligned to NG5_ARCHIVE_CACHE_LINE in aligned record tables */
+#define NG5_ARCHIVE_ALIGN_LARGE         256
 
 struct __attribute__((packed)) archive_header {
         char magic[9];
         u8 version;
         offset_t root_object_header_offset;
         offset_t string_id_to_offset_index_offset;
+        offset_t row_group_directory_offset;    /* see 'row_group_directory_header', or 0 if there are no row groups */
 };
 
 struct __attribute__((packed)) record_header {
@@ -46,9 +56,16 @@ struct __attribute__((packed)) object_header {
         u32 flags;
 };
 
+/**
+ * Counts of the headers of the record table and the string table are 64-bit where a collection grows with the
+ * dataset, i.e., the objects of an array of objects (column groups), the entries of a column, and the strings of the
+ * string table. Counts that are bounded by the number of distinct keys (the properties of an object, the arrays of
+ * objects of an object, and the columns of a column group) are 32-bit, since keys are stored as 32-bit string ids.
+ */
 struct __attribute__((packed)) prop_header {
         char marker;
         u32 num_entries;
+        u8 encoding;            /* 'enum intpack_type' of the values of integer and string (array) properties */
 };
 
 union __attribute__((packed)) string_tab_flags {
@@ -57,13 +74,15 @@ union __attribute__((packed)) string_tab_flags {
                         : 1;
                 u8 compressed_huffman
                         : 1;
+                u8 compressed_fsst
+                        : 1;
         } bits;
         u8 value;
 };
 
 struct __attribute__((packed)) string_table_header {
         char marker;
-        u32 num_entries;
+        u64 num_entries;
         u8 flags;
         offset_t first_entry;
         offset_t compressor_extra_size;
@@ -71,20 +90,82 @@ struct __attribute__((packed)) string_table_header {
 
 struct __attribute__((packed)) object_array_header {
         char marker;
-        u8 num_entries;
+        u32 num_entries;
 };
 
 struct __attribute__((packed)) column_group_header {
         char marker;
         u32 num_columns;
-        u32 num_objects;
+        u64 num_objects;
+};
+
+/**
+ * Flags of a column in a column group. A column whose entries are not held by every object of its column group
+ * stores a validity bitmap of one bit per object of the column group after the positions of its entries, in which the
+ * i-th bit is set if the i-th object holds an entry ('has_validity').
+ */
+union __attribute__((packed)) column_flags {
+        struct {
+                u8 has_validity
+                        : 1;
+        } bits;
+        u8 value;
 };
 
+/**
+ * The offsets of the entries of a column are relative to the header of the column, and are stored after its entries
+ * (at 'entry_offsets' from the header) as an 'enum intpack_type' (1 byte), followed by the offsets encoded with that
+ * type. Since entries are written one after another, these offsets are ascending and mostly delta encoded with a few
+ * bits each. The iterators decode them into the decode cache on first access (see 'int_read_entry_offsets').
+ */
 struct __attribute__((packed)) column_header {
         char marker;
         field_sid_t column_name;
         char value_type;
-        u32 num_entries;
+        u64 num_entries;
+        u8 encoding;            /* 'enum intpack_type' of the values of each entry of integer and string columns */
+        u8 flags;               /* 'union column_flags' */
+        offset_t entry_offsets; /* position of the offsets of the entries, relative to this header */
+};
+
+/**
+ * Large arrays of objects that are not nested in a column ("top-level collections") are cut into row groups of
+ * 'row_group_size' consecutive objects each (the last row group may hold fewer), if requested on import. A row group
+ * is not stored separately, but is a range of the entries (and of the values) of each column of the column group of
+ * each key of the array. Hence, arrays are cut only if the entries of all their columns are ordered by position.
+ *
+ * The row-group directory follows the record table, and is referenced by 'row_group_directory_offset' of the file
+ * header: a 'row_group_directory_header', followed by a 'row_group_collection' per column group that is cut into row
+ * groups. Each collection is followed by a byte per column that is set if the column has a zone map (i.e., if 'min' and
+ * 'max' of its zones are set), and by 'num_row_groups' zones per column.
+ */
+struct __attribute__((packed)) row_group_directory_header {
+        char marker;
+        u64 size;               /* size of the directory in bytes, including this header */
+        u64 row_group_size;
+        u32 num_collections;
+};
+
+struct __attribute__((packed)) row_group_collection {
+        offset_t column_group;  /* offset of the column group header in the record table */
+        u64 num_objects;
+        u32 num_columns;
+        u32 num_row_groups;
+};
+
+/**
+ * The entries of a column at the positions of the objects of a row group, and their values. Values are counted as
+ * positions in the run of a column that is stored as a run (see 'int_column_is_run'). Zone maps are stored for
+ * integer, boolean and string columns: the smallest and largest value of the row group, sign-extended for signed
+ * types, which include null values such that a range that does not overlap them holds no value of the row group.
+ */
+struct __attribute__((packed)) row_group_zone {
+        u64 first_entry;
+        u64 num_entries;
+        u64 first_value;
+        u64 num_values;
+        u64 min;
+        u64 max;
 };
 
 union object_flags {
@@ -252,6 +333,7 @@ enum marker_type {
         MARKER_TYPE_COLUMN = 31,
         MARKER_TYPE_HUFFMAN_DIC_ENTRY = 32,
         MARKER_TYPE_RECORD_HEADER = 33,
+        MARKER_TYPE_ROW_GROUP_DIRECTORY = 34,
 };
 
 #pragma GCC diagnostic push
@@ -288,7 +370,8 @@ static struct {
          {MARKER_TYPE_EMBEDDED_UNCOMP_STR, MARKER_SYMBOL_EMBEDDED_STR},
          {MARKER_TYPE_COLUMN_GROUP, MARKER_SYMBOL_COLUMN_GROUP}, {MARKER_TYPE_COLUMN, MARKER_SYMBOL_COLUMN},
          {MARKER_TYPE_HUFFMAN_DIC_ENTRY, MARKER_SYMBOL_HUFFMAN_DIC_ENTRY},
-         {MARKER_TYPE_RECORD_HEADER, MARKER_SYMBOL_RECORD_HEADER}};
+         {MARKER_TYPE_RECORD_HEADER, MARKER_SYMBOL_RECORD_HEADER},
+         {MARKER_TYPE_ROW_GROUP_DIRECTORY, MARKER_SYMBOL_ROW_GROUP_DIRECTORY}};
 
 static struct {
         field_e value_type;
@@ -311,13 +394,26 @@ static struct {
 
 #pragma GCC diagnostic pop
 
-struct record_flags {
+/**
+ * Flags of the record table. If 'sid32' is set, string ids in the record table are compact, i.e., the position of
+ * their string in the string table, and key columns (of properties and of arrays of objects) store them as u32.
+ * Readers widen these keys to 'field_sid_t' (see 'int_read_keys').
+ *
+ * If 'aligned' is set, the record table starts at a multiple of NG5_ARCHIVE_CACHE_LINE bytes in the file, and arrays
+ * in the record table are preceded by zero bytes up to their alignment (see 'int_array_alignment'), such that their
+ * elements can be loaded aligned: key columns are padded to 4 bytes before and to 8 bytes after the keys (hence, the
+ * values, offsets or lengths that follow keys are aligned to 8 bytes), the lengths of array properties are padded to 8
+ * bytes after the lengths, object ids of column groups are aligned to 8 bytes, positions of columns are aligned to
+ * NG5_ARCHIVE_CACHE_LINE bytes, and the values of column entries that are stored plain are aligned by padding that
+ * precedes the entry (i.e., its length). Offsets to headers and entries point past the padding that precedes them.
+ */
+union record_flags {
         struct {
                 u8 is_sorted
                         : 1;
-                u8 RESERVED_2
+                u8 sid32
                         : 1;
-                u8 RESERVED_3
+                u8 aligned
                         : 1;
                 u8 RESERVED_4
                         : 1;
@@ -336,19 +432,27 @@ struct record_flags {
 struct string_table {
         struct packer compressor;
         offset_t first_entry_off;
-        u32 num_embeddded_strings;
+        u64 num_embeddded_strings;
 };
 
 struct record_table {
-        struct record_flags flags;
+        union record_flags flags;
         struct memblock *recordDataBase;
 };
 
+/** row-group directory of an archive (see 'row_group_directory_header'), which is loaded by 'archive_open' */
+struct row_group_directory {
+        void *data;             /* the directory, or NULL if the archive has no row groups */
+        u64 row_group_size;
+        u32 num_collections;
+        const struct row_group_collection **collections;
+};
+
 struct archive_info {
         size_t string_table_size;
         size_t record_table_size;
         size_t string_id_index_size;
-        u32 num_embeddded_strings;
+        u64 num_embeddded_strings;
 };
 
 struct __attribute__((packed)) string_entry_header {
@@ -358,23 +462,112 @@ struct __attribute__((packed)) string_entry_header {
         u32 string_len;
 };
 
+/** decoded values of runs that are not stored plain, keyed by the address of the encoded run in the record table */
+NG5_DEFINE_HASHMAP_NAMED(decoded_runs, u64, void *)
+
+struct decode_cache {
+        struct hashmap_decoded_runs runs;
+        struct spinlock lock;
+        bool sid32;                     /* key columns store u32 string ids (see 'record_flags') */
+        bool aligned;                   /* arrays are padded to their alignment (see 'record_flags') */
+};
+
 void int_read_prop_offsets(struct archive_prop_offs *prop_offsets, struct memfile *memfile,
         const union object_flags *flags);
 
-void int_embedded_fixed_props_read(struct fixed_prop *prop, struct memfile *memfile);
+void int_embedded_fixed_props_read(struct fixed_prop *prop, struct memfile *memfile, struct decode_cache *cache);
 
-void int_embedded_var_props_read(struct var_prop *prop, struct memfile *memfile);
+void int_embedded_var_props_read(struct var_prop *prop, struct memfile *memfile, struct decode_cache *cache);
 
-void int_embedded_null_props_read(struct null_prop *prop, struct memfile *memfile);
+void int_embedded_null_props_read(struct null_prop *prop, struct memfile *memfile, struct decode_cache *cache);
 
-void int_embedded_array_props_read(struct array_prop *prop, struct memfile *memfile);
+void int_embedded_array_props_read(struct array_prop *prop, struct memfile *memfile, struct decode_cache *cache);
 
-void int_embedded_table_props_read(struct table_prop *prop, struct memfile *memfile);
+void int_embedded_table_props_read(struct table_prop *prop, struct memfile *memfile, struct decode_cache *cache);
 
 field_e int_get_value_type_of_char(char c);
 
+/** returns false if values of 'type' are always stored plain, and otherwise their width and signedness for encoding */
+bool int_get_intpack_params(size_t *width, bool *is_signed, field_e type);
+
+/** returns the name of 'encoding', which is an 'enum floatpack_type' for floating-point values of 'type' */
+const char *int_encoding_str(u8 encoding, field_e type);
+
+/**
+ * returns true if the values of all entries of a column of 'type' that is stored with 'encoding' are stored as a run
+ * after the positions of its entries, and the entries store their lengths only
+ */
+bool int_column_is_run(u8 encoding, field_e type);
+
+bool int_decode_cache_create(struct decode_cache *cache, union record_flags flags);
+
+bool int_decode_cache_drop(struct decode_cache *cache);
+
+/**
+ * Returns the 'num_values' values of 'type' that are stored at 'src' with 'encoding'. Encoded values are decoded into
+ * 'cache' on the first access, and later accesses return the same decoded values.
+ */
+const void *int_decode_cache_get(struct decode_cache *cache, const void *src, u8 encoding, field_e type,
+        u32 num_values);
+
+/**
+ * Reads the 'num_values' values of 'type' (of 'value_size' bytes each) that are stored with 'encoding' at the current
+ * position in 'memfile'. If these are not stored plain, they are decoded into a buffer that is returned in 'decoded'
+ * and must be freed by the caller (or NULL otherwise).
+ */
+const void *int_read_values(void **decoded, struct memfile *memfile, u8 encoding, field_e type, size_t value_size,
+        u32 num_values);
+
+/**
+ * Reads the key column of 'num_keys' string ids at the current position in 'memfile'. Keys that are stored as u32
+ * (see 'record_flags') are widened into 'cache' on the first access, and are returned in place otherwise.
+ */
+const field_sid_t *int_read_keys(struct decode_cache *cache, struct memfile *memfile, u32 num_keys);
+
+/**
+ * Reads the 'num_lengths' lengths (u32) of array properties at the current position in 'memfile', and skips the
+ * padding that follows them in aligned record tables
+ */
+const u32 *int_read_lengths(struct decode_cache *cache, struct memfile *memfile, u32 num_lengths);
+
+/**
+ * Returns the alignment of an array of 'num_bytes' bytes of elements of 'width' bytes in aligned record tables, i.e.,
+ * NG5_ARCHIVE_CACHE_LINE for arrays of at least NG5_ARCHIVE_ALIGN_LARGE bytes, and 'width' otherwise
+ */
+size_t int_array_alignment(size_t width, size_t num_bytes);
+
+/** returns the smallest position at or after 'pos' that is a multiple of 'alignment' (a power of two) */
+offset_t int_align_offset(offset_t pos, size_t alignment);
+
+/** skips the padding up to the next multiple of 'alignment' in 'memfile' if the record table is aligned */
+void int_align(struct decode_cache *cache, struct memfile *memfile, size_t alignment);
+
+/**
+ * Returns the offsets of the 'num_entries' entries of the column whose header is at 'column_off' in the record table,
+ * which are stored encoded at 'src' (see 'column_header'). The offsets are decoded and rebased to 'column_off' into
+ * 'cache' on the first access.
+ */
+const offset_t *int_read_entry_offsets(struct decode_cache *cache, const void *src, u32 num_entries,
+        offset_t column_off);
+
 field_e int_marker_to_field_type(char symbol);
 
+/** takes ownership of the row-group directory 'data' (allocated with malloc), and indexes its collections in 'dir' */
+bool int_row_groups_create(struct row_group_directory *dir, void *data);
+
+void int_row_groups_drop(struct row_group_directory *dir);
+
+/** returns the row groups of the column group at 'column_group' in the record table, or NULL if it has none */
+const struct row_group_collection *int_row_groups_find(const struct row_group_directory *dir,
+        offset_t column_group);
+
+/**
+ * returns the 'num_row_groups' zones of the column at 'column_idx' of 'collection', and sets 'zone_map' if their
+ * 'min' and 'max' are set
+ */
+const struct row_group_zone *int_row_groups_zones(bool *zone_map, const struct row_group_collection *collection,
+        u32 column_idx);
+
 NG5_END_DECL
 
 #endif
@@ -20,6 +20,7 @@
 
 #include "shared/common.h"
 #include "shared/error.h"
+#include "std/hash_map.h"
 #include "archive.h"
 
 NG5_BEGIN_DECL
@@ -61,6 +62,7 @@ struct archive_object {
         struct archive_prop_offs prop_offsets;  /* per-property type offset in the record table byte stream */
         offset_t next_obj_off;                  /* offset to next object in list, or NULL if no such exists */
         struct memfile memfile;
+        struct archive *archive;                /* archive that contains this object */
         struct err err;
 };
 
@@ -80,6 +82,7 @@ struct object_iter_state {
 };
 
 struct collection_iter_state {
+        struct archive *archive;                /* archive that contains this collection */
         offset_t collection_start_off;
         u32 num_column_groups;
         u32 current_column_group_idx;
@@ -91,13 +94,21 @@ struct collection_iter_state {
                 u32 num_objects;
                 const object_id_t *object_ids;
                 const offset_t *column_offs;
+                const struct row_group_collection *row_groups;  /* row groups of this column group, or NULL */
                 struct {
                         u32 idx;
                         field_sid_t name;
                         enum field_type type;
+                        u8 encoding;    /* 'enum intpack_type' (or 'enum floatpack_type') of each entry, or of 'run' */
                         u32 num_elem;
+                        u32 num_values; /* number of values in 'run' */
+                        const void *run;        /* values of all entries if stored as a run, or NULL */
+                        u32 run_pos;            /* position in 'run' of the first value of the current entry */
                         const offset_t *elem_offsets;
                         const u32 *elem_positions;
+                        const u8 *validity;     /* bit per object of the group that holds an entry, or NULL if all do */
+                        const struct row_group_zone *zones;     /* zone per row group, or NULL if there are none */
+                        bool zone_map;          /* whether 'min' and 'max' of 'zones' are set */
                         struct {
                                 u32 idx;
                                 u32 array_length;
@@ -273,6 +284,61 @@ NG5_EXPORT(bool) archive_column_get_name(field_sid_t *name, enum field_type *typ
 
 NG5_EXPORT(const u32 *)archive_column_get_entry_positions(u32 *num_entry, archive_column_iter_t *column_iter);
 
+/**
+ * Sets <code>count</code> to the number of values <code>v</code> with <code>lo <= v <= hi</code> in all entries of
+ * the integer, boolean or string column of <code>column_iter</code>. Values of signed types and the bounds are compared
+ * as <code>i64</code>. Run-length encoded columns are evaluated once per run, without decoding their values.
+ */
+NG5_EXPORT(bool) archive_column_count_range(u64 *count, u64 lo, u64 hi, archive_column_iter_t *column_iter);
+
+/**
+ * Sets <code>num_row_groups</code> to the number of row groups of the column group of <code>iter</code>, and
+ * <code>row_group_size</code> (optional) to the number of objects per row group, of which the last row group may hold
+ * fewer. A column group that is not cut into row groups (see <code>archive_from_json_parallel</code>) is a single row
+ * group of all its objects.
+ */
+NG5_EXPORT(bool) archive_column_group_get_row_groups(u32 *num_row_groups, u64 *row_group_size,
+        archive_column_group_iter_t *iter);
+
+/**
+ * Sets <code>count</code> to the number of values <code>v</code> with <code>lo <= v <= hi</code> (as in
+ * <code>archive_column_count_range</code>) in the entries of the <code>num_row_groups</code> row groups that start at
+ * <code>first_row_group</code>. Row groups whose smallest and largest value do not overlap the range are skipped, and
+ * row groups whose values are all within the range are counted without reading their values. Since
+ * <code>column_iter</code> is not modified, scans can be split by row group over several threads, each of which calls
+ * this function with a copy of <code>column_iter</code>.
+ */
+NG5_EXPORT(bool) archive_column_count_range_in_row_groups(u64 *count, u32 first_row_group, u32 num_row_groups,
+        u64 lo, u64 hi, archive_column_iter_t *column_iter);
+
+/**
+ * Moves <code>column_iter</code> to the first entry of its column in <code>row_group</code>, such that
+ * <code>archive_column_next_entry</code> continues with the entries of the objects of that row group and the row
+ * groups that follow it (e.g., to page through a large collection).
+ */
+NG5_EXPORT(bool) archive_column_seek_row_group(u32 row_group, archive_column_iter_t *column_iter);
+
+/**
+ * Adds to <code>counts</code> the number of occurrences of each value (sign-extended to 64 bits) in all entries of the
+ * integer, boolean or string column of <code>column_iter</code>. Run-length encoded columns are counted once per run.
+ */
+NG5_EXPORT(bool) archive_column_count_values(struct hashmap_u64_u32 *counts, archive_column_iter_t *column_iter);
+
+/**
+ * Sets <code>num_true</code>, <code>num_false</code> and <code>num_null</code> (each optional) to the number of values
+ * that are true, false or <code>NG5_NULL_BOOLEAN</code> in all entries of the boolean column of
+ * <code>column_iter</code>. Entries that are encoded with <code>INTPACK_BITMAP</code> are counted by popcounts.
+ */
+NG5_EXPORT(bool) archive_column_count_booleans(u64 *num_true, u64 *num_false, u64 *num_null,
+        archive_column_iter_t *column_iter);
+
+/**
+ * Sets <code>count</code> to the number of objects at the positions <code>begin</code> to <code>end - 1</code> of the
+ * column group of <code>column_iter</code> that hold an entry in its column, which is a popcount of the validity
+ * bitmap of the column.
+ */
+NG5_EXPORT(bool) archive_column_count_present(u32 *count, u32 begin, u32 end, archive_column_iter_t *column_iter);
+
 NG5_EXPORT(bool) archive_column_next_entry(archive_column_entry_iter_t *entry_iter, archive_column_iter_t *iter);
 
 NG5_EXPORT(bool) archive_column_entry_get_type(enum field_type *type, archive_column_entry_iter_t *entry);
@@ -32,6 +32,18 @@ struct memfile {
         struct err err;
 };
 
+/**
+ * Writes bit strings of up to 32 bits most significant bit first into consecutive bytes of a memfile. Unlike bit mode
+ * (see <code>memfile_begin_bit_mode</code>), which reads and writes back one byte per bit, bits are collected in a
+ * 64-bit buffer and written 32 bits at a time.
+ */
+struct memfile_bit_writer {
+        struct memfile *file;
+        u64 bits;
+        unsigned num_bits;
+        size_t num_bytes;
+};
+
 #define NG5_MEMFILE_PEEK(file, type)                                                                                   \
 ({                                                                                                                     \
     assert (memfile_remain_size(file) >= sizeof(type));                                                                \
@@ -92,6 +104,14 @@ NG5_EXPORT(bool) memfile_end_bit_mode(size_t *num_bytes_written, struct memfile
 
 NG5_EXPORT(void *) memfile_current_pos(struct memfile *file, offset_t nbytes);
 
+NG5_EXPORT(bool) memfile_bit_writer_begin(struct memfile_bit_writer *writer, struct memfile *file);
+
+/** appends the <code>nbits</code> least significant bits of <code>bits</code> (all other bits must be zero) */
+NG5_EXPORT(bool) memfile_write_bits(struct memfile_bit_writer *writer, u32 bits, unsigned nbits);
+
+/** writes the remaining bits padded with zeros to a full byte, and returns the number of bytes written in total */
+NG5_EXPORT(bool) memfile_bit_writer_end(size_t *num_bytes_written, struct memfile_bit_writer *writer);
+
 NG5_END_DECL
 
 #endif
\ No newline at end of file
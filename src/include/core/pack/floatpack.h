@@ -0,0 +1,91 @@
+/**
+ * Copyright 2019 Marcus Pinnecke
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NG5_FLOATPACK_H
+#define NG5_FLOATPACK_H
+
+#include "shared/common.h"
+#include "shared/types.h"
+#include "core/mem/file.h"
+
+NG5_BEGIN_DECL
+
+/**
+ * Lightweight encodings for runs of floating-point numbers (<code>field_number_t</code>) as they are stored in the
+ * value columns of a CARBON archive. As for <code>intpack.h</code>, the number of values of a run is not part of its
+ * encoding.
+ *
+ * <ul>
+ *  <li><code>FLOATPACK_PLAIN</code>: the values as they are (no header)</li>
+ *  <li><code>FLOATPACK_ALP</code>: adaptive lossless floating-point compression for numbers that were decimals with
+ *      few digits after the decimal point (prices, measurements, percentages), i.e., the exponent <code>e</code>
+ *      (1 byte), the <code>enum intpack_type</code> of the integers (1 byte) and the number of exceptions (4 bytes),
+ *      followed by the integer <code>round(v * 10^e)</code> (<code>i64</code>) of each value <code>v</code>,
+ *      encoded with <code>intpack_encode</code>, followed by the position (4 bytes each) and the value (as is) of
+ *      each exception. A value is an exception if it is not restored exactly from its integer (e.g., null, i.e.,
+ *      <code>NAN</code>, negative zero, or numbers with more digits); its integer is a filler that does not widen
+ *      the bit width of the integers. The exponent is the one of <code>0</code> to
+ *      <code>NG5_FLOATPACK_MAX_EXPONENT</code> that yields the smallest encoding on a sample of the values.</li>
+ * </ul>
+ *
+ * The value of each <code>enum floatpack_type</code> is stored as is in archives, in place of an
+ * <code>enum intpack_type</code> for values of floating-point properties and columns.
+ */
+enum floatpack_type {
+        FLOATPACK_PLAIN = 0,
+        FLOATPACK_ALP = 1
+};
+
+#define NG5_FLOATPACK_NUM_TYPES         2
+
+/** largest exponent of ten by which values are multiplied to become integers */
+#define NG5_FLOATPACK_MAX_EXPONENT      10
+
+/** number of values from which the exponent of a run is chosen */
+#define NG5_FLOATPACK_SAMPLE_SIZE       256
+
+/**
+ * Adds to <code>sizes[t]</code> the number of bytes of the <code>num_values</code> values in <code>values</code> when
+ * encoded with <code>t</code>, for each <code>enum floatpack_type t</code>. The integers of <code>FLOATPACK_ALP</code>
+ * are estimated with <code>intpack_estimate</code>, such that the estimate is exact for short runs.
+ */
+NG5_EXPORT(void) floatpack_estimate(size_t sizes[NG5_FLOATPACK_NUM_TYPES], const field_number_t *values,
+        size_t num_values);
+
+/** returns the encoding with the smallest (estimated) size in <code>sizes</code>; plain on ties */
+NG5_EXPORT(enum floatpack_type) floatpack_choose(const size_t sizes[NG5_FLOATPACK_NUM_TYPES]);
+
+/** encodes the <code>num_values</code> values in <code>values</code> with <code>type</code> into <code>dst</code> */
+NG5_EXPORT(bool) floatpack_encode(struct memfile *dst, enum floatpack_type type, const field_number_t *values,
+        size_t num_values);
+
+/** returns the number of bytes of <code>num_values</code> values encoded with <code>type</code> at <code>src</code> */
+NG5_EXPORT(size_t) floatpack_encoded_size(const void *src, enum floatpack_type type, size_t num_values);
+
+/**
+ * Decodes <code>num_values</code> values that are encoded with <code>type</code> at <code>src</code> into the
+ * caller buffer <code>dst</code>, and returns the number of bytes read from <code>src</code>. The integers are
+ * unpacked by <code>intpack_decode</code> and scaled back in a branch-free loop; exceptions are patched afterwards.
+ */
+NG5_EXPORT(size_t) floatpack_decode(field_number_t *dst, const void *src, enum floatpack_type type,
+        size_t num_values);
+
+NG5_EXPORT(const char *) floatpack_type_str(enum floatpack_type type);
+
+NG5_END_DECL
+
+#endif
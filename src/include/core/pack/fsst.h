@@ -1,5 +1,5 @@
 /**
- * Copyright 2018 Marcus Pinnecke
+ * Copyright 2019 Marcus Pinnecke
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
  * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
@@ -15,22 +15,35 @@
  * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
-#ifndef NG5_ALLOC_TRACER_H
-#define NG5_ALLOC_TRACER_H
+#ifndef NG5_COMPRESSOR_FSST_H
+#define NG5_COMPRESSOR_FSST_H
 
-#include "alloc.h"
+#include "shared/common.h"
+#include "std/vec.h"
+#include "core/mem/file.h"
 
 NG5_BEGIN_DECL
 
-/**
- * Returns standard c-lib allocator (malloc, realloc, free) that collects some statistics
- * for inspection purposes. Generally, this implementation is slow and should not be used
- * in productive mode
- *
- * @param alloc must be non-null
- * @return STATUS_OK in case of non-null parameter alloc, STATUS_NULLPTR otherwise
- */
-NG5_EXPORT (int) trace_alloc_create(struct allocator *alloc);
+NG5_EXPORT(bool) pack_fsst_init(struct packer *self);
+
+NG5_EXPORT(bool) pack_coding_fsst_cpy(const struct packer *self, struct packer *dst);
+
+NG5_EXPORT(bool) pack_coding_fsst_drop(struct packer *self);
+
+NG5_EXPORT(bool) pack_fsst_write_extra(struct packer *self, struct memfile *dst,
+        const struct vector ofType (const char *) *strings);
+
+NG5_EXPORT(bool) pack_fsst_read_extra(struct packer *self, FILE *src, size_t nbytes);
+
+NG5_EXPORT(bool) pack_fsst_print_extra(struct packer *self, FILE *file, struct memfile *src);
+
+NG5_EXPORT(bool) pack_fsst_print_encoded(struct packer *self, FILE *file, struct memfile *src,
+        u32 decompressed_strlen);
+
+NG5_EXPORT(bool) pack_fsst_encode_string(struct packer *self, struct memfile *dst, struct err *err,
+        const char *string);
+
+NG5_EXPORT(bool) pack_fsst_decode_string(struct packer *self, char *dst, size_t strlen, FILE *src);
 
 NG5_END_DECL
 
@@ -0,0 +1,141 @@
+/**
+ * Copyright 2018 Marcus Pinnecke
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NG5_INTPACK_H
+#define NG5_INTPACK_H
+
+#include "shared/common.h"
+#include "shared/types.h"
+#include "core/mem/file.h"
+
+NG5_BEGIN_DECL
+
+/**
+ * Lightweight encodings for runs of fixed-width integers (1, 2, 4 or 8 bytes per value, signed or unsigned) as they
+ * are stored in the value columns of a CARBON archive. The number of values of a run is not part of its encoding;
+ * it is known from the context in which the run is stored.
+ *
+ * Frame of reference, delta and bit-packing pack a sequence of unsigned numbers with the minimal number of bits (least
+ * significant bit first, no padding between numbers) into a byte stream that is prefixed by the encoding-specific
+ * header below:
+ *
+ * <ul>
+ *  <li><code>INTPACK_PLAIN</code>: the values as they are (no header)</li>
+ *  <li><code>INTPACK_FOR</code>: frame of reference, i.e., the minimum value (<code>width</code> bytes) and the bit
+ *      width (1 byte), followed by the differences of each value to the minimum</li>
+ *  <li><code>INTPACK_DELTA</code>: the first value (<code>width</code> bytes) and the bit width (1 byte), followed by
+ *      the zig-zag encoded differences of each further value to its predecessor</li>
+ *  <li><code>INTPACK_BITPACK</code>: the bit width (1 byte), followed by the values (zig-zag encoded if signed)</li>
+ *  <li><code>INTPACK_RLE</code>: run-length encoding, i.e., the number of runs (4 bytes), followed by the value of
+ *      each run (<code>width</code> bytes each), followed by the (exclusive) end position of each run in the
+ *      sequence of values (4 bytes each). Runs are not bit-packed, such that they can be searched and aggregated
+ *      without decoding them (see <code>intpack_rle_runs</code>).</li>
+ *  <li><code>INTPACK_BITMAP</code>: for 1-byte values that are 0, 1 or <code>NG5_NULL_BOOLEAN</code> only (i.e.,
+ *      booleans), a flag (1 byte) that is 1 if any value is null, followed by a bitmap in which the i-th bit is set
+ *      if the i-th value is 1, followed by a bitmap in which the i-th bit is set if the i-th value is not null (only
+ *      if the flag is 1). Each bitmap is padded with zero bits to full bytes. Values are counted by popcounts of the
+ *      bitmaps without decoding them (see <code>intpack_bitmap_count</code>).</li>
+ * </ul>
+ *
+ * The value of each <code>enum intpack_type</code> is stored as is in archives. Decoding unpacks eight (four) numbers
+ * of up to 25 (57) bits at once with AVX2 gathers and per-lane shifts when the library is compiled with
+ * <code>-DUSE_AVX2=on</code>, and one number at a time otherwise.
+ */
+enum intpack_type {
+        INTPACK_PLAIN = 0,
+        INTPACK_FOR = 1,
+        INTPACK_DELTA = 2,
+        INTPACK_BITPACK = 3,
+        INTPACK_RLE = 4,
+        INTPACK_BITMAP = 5
+};
+
+#define NG5_INTPACK_NUM_TYPES           6
+
+/** runs longer than this are not inspected entirely to estimate their encoded size, but sampled in windows */
+#define NG5_INTPACK_SAMPLE_SIZE         1024
+
+/** number of windows of consecutive values in a sampled run */
+#define NG5_INTPACK_SAMPLE_WINDOWS      8
+
+/**
+ * Adds to <code>sizes[t]</code> the (estimated) number of bytes of the <code>num_values</code> values in
+ * <code>values</code> of <code>width</code> bytes each when encoded with <code>t</code>, for each
+ * <code>enum intpack_type t</code>. The estimate is exact for runs up to <code>NG5_INTPACK_SAMPLE_SIZE</code> values,
+ * and for <code>INTPACK_BITMAP</code>, whose size is <code>SIZE_MAX</code> if any value cannot be encoded with it.
+ */
+NG5_EXPORT(void) intpack_estimate(size_t sizes[NG5_INTPACK_NUM_TYPES], const void *values, size_t num_values,
+        size_t width, bool is_signed);
+
+/**
+ * Returns the encoding with the smallest (estimated) size in <code>sizes</code>; plain on ties, unless bitmaps are
+ * among the smallest
+ */
+NG5_EXPORT(enum intpack_type) intpack_choose(const size_t sizes[NG5_INTPACK_NUM_TYPES]);
+
+/** encodes the <code>num_values</code> values in <code>values</code> with <code>type</code> into <code>dst</code> */
+NG5_EXPORT(bool) intpack_encode(struct memfile *dst, enum intpack_type type, const void *values, size_t num_values,
+        size_t width, bool is_signed);
+
+/** returns the number of bytes of <code>num_values</code> values encoded with <code>type</code> at <code>src</code> */
+NG5_EXPORT(size_t) intpack_encoded_size(const void *src, enum intpack_type type, size_t num_values, size_t width);
+
+/**
+ * Decodes <code>num_values</code> values that are encoded with <code>type</code> at <code>src</code> into the
+ * caller buffer <code>dst</code> of at least <code>num_values * width</code> bytes, and returns the number of bytes
+ * read from <code>src</code>.
+ */
+NG5_EXPORT(size_t) intpack_decode(void *dst, const void *src, enum intpack_type type, size_t num_values, size_t width,
+        bool is_signed);
+
+/**
+ * Returns the number of runs of the values that are encoded with <code>INTPACK_RLE</code> at <code>src</code>, and
+ * the value (<code>width</code> bytes each) and the (exclusive) end position of each run in <code>values</code> and
+ * <code>ends</code>. Neither array is aligned.
+ */
+NG5_EXPORT(u32) intpack_rle_runs(const void **values, const u32 **ends, const void *src, size_t width);
+
+/** returns the <code>idx</code>-th value in <code>values</code>, sign-extended if <code>is_signed</code> */
+NG5_EXPORT(u64) intpack_value_at(const void *values, size_t idx, size_t width, bool is_signed);
+
+/**
+ * Returns the number of values <code>v</code> with <code>lo <= v <= hi</code> of the <code>num_values</code> values
+ * that are encoded with <code>type</code> at <code>src</code>. Signed values (and bounds) are compared as
+ * <code>i64</code>. Values that are encoded with <code>INTPACK_RLE</code> are evaluated once per run, values that are
+ * encoded with <code>INTPACK_BITMAP</code> are counted by popcounts, and values that are encoded otherwise are
+ * evaluated after decoding them. Values that are aligned to <code>width</code> (i.e., decoded values, and plain values
+ * of record tables with an aligned layout) are compared with aligned loads in a loop that is vectorized.
+ */
+NG5_EXPORT(size_t) intpack_count_range(const void *src, enum intpack_type type, size_t num_values, size_t width,
+        bool is_signed, u64 lo, u64 hi);
+
+/**
+ * Returns the number of values that are 1 of the <code>num_values</code> values that are encoded with
+ * <code>INTPACK_BITMAP</code> at <code>src</code>, and the number of values that are <code>NG5_NULL_BOOLEAN</code> in
+ * <code>num_null</code> (if non-null). Both are counted a word of 64 values at a time with <code>popcount</code>,
+ * which is a single instruction when the library is compiled with <code>-DUSE_AVX2=on</code>.
+ */
+NG5_EXPORT(size_t) intpack_bitmap_count(size_t *num_null, const void *src, size_t num_values);
+
+/** returns the number of set bits at the positions <code>begin</code> to <code>end - 1</code> of <code>bits</code> */
+NG5_EXPORT(size_t) intpack_popcount(const void *bits, size_t begin, size_t end);
+
+NG5_EXPORT(const char *) intpack_type_str(enum intpack_type type);
+
+NG5_END_DECL
+
+#endif
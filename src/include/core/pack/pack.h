@@ -20,7 +20,9 @@
 
 #include "core/pack/pack_none.h"
 #include "core/pack/huffman.h"
+#include "core/pack/fsst.h"
 #include "coding/coding_huffman.h"
+#include "coding/coding_fsst.h"
 #include "shared/common.h"
 #include "shared/types.h"
 
@@ -31,7 +33,7 @@ NG5_BEGIN_DECL
  * string table.
  */
 enum packer_type {
-        PACK_NONE, PACK_HUFFMAN
+        PACK_NONE, PACK_HUFFMAN, PACK_FSST
 };
 
 /**
@@ -208,6 +210,20 @@ static void pack_huffman_create(struct packer *strategy)
         strategy->print_encoded = pack_huffman_print_encoded;
 }
 
+static void pack_fsst_create(struct packer *strategy)
+{
+        strategy->tag = PACK_FSST;
+        strategy->create = pack_fsst_init;
+        strategy->cpy = pack_coding_fsst_cpy;
+        strategy->drop = pack_coding_fsst_drop;
+        strategy->write_extra = pack_fsst_write_extra;
+        strategy->read_extra = pack_fsst_read_extra;
+        strategy->encode_string = pack_fsst_encode_string;
+        strategy->decode_string = pack_fsst_decode_string;
+        strategy->print_extra = pack_fsst_print_extra;
+        strategy->print_encoded = pack_fsst_print_encoded;
+}
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-variable"
 
@@ -221,7 +237,8 @@ static struct {
         u8 flag_bit;
 } compressor_strategy_register[] =
         {{.type = PACK_NONE, .name = "none", .create = pack_none_create, .flag_bit = 1 << 0},
-         {.type = PACK_HUFFMAN, .name = "huffman", .create = pack_huffman_create, .flag_bit = 1 << 1}};
+         {.type = PACK_HUFFMAN, .name = "huffman", .create = pack_huffman_create, .flag_bit = 1 << 1},
+         {.type = PACK_FSST, .name = "fsst", .create = pack_fsst_create, .flag_bit = 1 << 2}};
 
 #pragma GCC diagnostic pop
 
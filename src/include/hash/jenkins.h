@@ -52,7 +52,7 @@ NG5_BEGIN_DECL
         a += (k[0] + ((unsigned)k[1] << 8) + ((unsigned)k[2] << 16) + ((unsigned)k[3] << 24));                         \
         b += (k[4] + ((unsigned)k[5] << 8) + ((unsigned)k[6] << 16) + ((unsigned)k[7] << 24));                         \
         c += (k[8] + ((unsigned)k[9] << 8) + ((unsigned)k[10] << 16) + ((unsigned)k[11] << 24));                       \
-        JENKINS_MIX(a, b, c);                                                                                          \
+        NG5_JENKINS_MIX(a, b, c);                                                                                      \
         k += 12;                                                                                                       \
         key_size -= 12;                                                                                                \
     }                                                                                                                  \
@@ -60,19 +60,19 @@ NG5_BEGIN_DECL
     c += key_size;                                                                                                     \
                                                                                                                        \
     switch (key_size) {                                                                                                \
-        case 11: c += ((unsigned)k[10] << 24); break;                                                                  \
-        case 10: c += ((unsigned)k[9] << 16); break;                                                                   \
-        case 9: c += ((unsigned)k[8] << 8); break;                                                                     \
-        case 8: b += ((unsigned)k[7] << 24); break;                                                                    \
-        case 7: b += ((unsigned)k[6] << 16); break;                                                                    \
-        case 6: b += ((unsigned)k[5] << 8); break;                                                                     \
-        case 5: b += k[4]; break;                                                                                      \
-        case 4: a += ((unsigned)k[3] << 24); break;                                                                    \
-        case 3: a += ((unsigned)k[2] << 16); break;                                                                    \
-        case 2: a += ((unsigned)k[1] << 8); break;                                                                     \
-        case 1: a += k[0]; break;                                                                                      \
+        case 11: c += ((unsigned)k[10] << 24); /* fallthrough */                                                       \
+        case 10: c += ((unsigned)k[9] << 16); /* fallthrough */                                                        \
+        case 9: c += ((unsigned)k[8] << 8); /* fallthrough */                                                          \
+        case 8: b += ((unsigned)k[7] << 24); /* fallthrough */                                                         \
+        case 7: b += ((unsigned)k[6] << 16); /* fallthrough */                                                         \
+        case 6: b += ((unsigned)k[5] << 8); /* fallthrough */                                                          \
+        case 5: b += k[4]; /* fallthrough */                                                                           \
+        case 4: a += ((unsigned)k[3] << 24); /* fallthrough */                                                         \
+        case 3: a += ((unsigned)k[2] << 16); /* fallthrough */                                                         \
+        case 2: a += ((unsigned)k[1] << 8); /* fallthrough */                                                          \
+        case 1: a += k[0];                                                                                             \
     }                                                                                                                  \
-    JENKINS_MIX(a, b, c);                                                                                              \
+    NG5_JENKINS_MIX(a, b, c);                                                                                          \
     c;                                                                                                                 \
 })
 
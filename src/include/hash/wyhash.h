@@ -0,0 +1,155 @@
+/**
+ * Copyright 2018 Marcus Pinnecke
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NG5_WYHASH_H
+#define NG5_WYHASH_H
+
+#include <string.h>
+#include "hash.h"
+
+NG5_BEGIN_DECL
+
+/**
+ * Word-at-a-time 64bit hash function in the spirit of wyhash. In contrast to the other hash functions in this
+ * directory, which consume the key byte by byte, this function consumes the key in 64bit words (48 bytes per round
+ * for long keys) and mixes using a 64x64->128 bit multiplication. For fixed-width keys (e.g., field_sid_t or
+ * object_id_t), use the *_SID/U64 variants that skip the length dispatch entirely.
+ */
+
+#define NG5_WYHASH_SEED         0xa0761d6478bd642full
+
+#define NG5_WYHASH_SECRET_0     0x2d358dccaa6c78a5ull
+#define NG5_WYHASH_SECRET_1     0x8bb84b93962eacc9ull
+#define NG5_WYHASH_SECRET_2     0x4b33a62ed433d4a3ull
+#define NG5_WYHASH_SECRET_3     0x4d5a2da51de1aa47ull
+
+/** implements: hash64_t hash_wyhash(size_t key_size, const void *key) */
+#define NG5_HASH64_WYHASH(key_size, key)                                                                               \
+({                                                                                                                     \
+    assert ((key != NULL) && (key_size > 0));                                                                          \
+    wyhash_bytes((const void *) (key), (key_size), NG5_WYHASH_SEED);                                                   \
+})
+
+/** implements: hash32_t hash_wyhash(size_t key_size, const void *key) */
+#define NG5_HASH_WYHASH(key_size, key)                                                                                 \
+({                                                                                                                     \
+    hash64_t hash = NG5_HASH64_WYHASH(key_size, key);                                                                  \
+    (hash32_t) (hash ^ (hash >> 32));                                                                                  \
+})
+
+/** implements: hash64_t hash_wyhash_u64(u64 key); fast path for field_sid_t and object_id_t keys */
+#define NG5_HASH64_WYHASH_U64(key)              wyhash_u64((u64) (key))
+#define NG5_HASH_WYHASH_U64(key)                                                                                       \
+({                                                                                                                     \
+    hash64_t hash = wyhash_u64((u64) (key));                                                                           \
+    (hash32_t) (hash ^ (hash >> 32));                                                                                  \
+})
+
+#define NG5_HASH64_WYHASH_SID(sid)              NG5_HASH64_WYHASH_U64(sid)
+#define NG5_HASH_WYHASH_SID(sid)                NG5_HASH_WYHASH_U64(sid)
+
+static inline void wyhash_mum(u64 *a, u64 *b)
+{
+        __uint128_t r = (__uint128_t) *a * *b;
+        *a = (u64) r;
+        *b = (u64) (r >> 64);
+}
+
+static inline u64 wyhash_mix(u64 a, u64 b)
+{
+        wyhash_mum(&a, &b);
+        return a ^ b;
+}
+
+static inline u64 wyhash_read64(const u8 *p)
+{
+        u64 v;
+        memcpy(&v, p, sizeof(u64));
+        return v;
+}
+
+static inline u64 wyhash_read32(const u8 *p)
+{
+        u32 v;
+        memcpy(&v, p, sizeof(u32));
+        return v;
+}
+
+static inline u64 wyhash_read_small(const u8 *p, size_t k)
+{
+        return (((u64) p[0]) << 16) | (((u64) p[k >> 1]) << 8) | p[k - 1];
+}
+
+static inline hash64_t wyhash_bytes(const void *key, size_t len, u64 seed)
+{
+        const u8 *p = (const u8 *) key;
+        u64 a, b;
+
+        seed ^= wyhash_mix(seed ^ NG5_WYHASH_SECRET_0, NG5_WYHASH_SECRET_1);
+
+        if (likely(len <= 16)) {
+                if (likely(len >= 4)) {
+                        a = (wyhash_read32(p) << 32) | wyhash_read32(p + ((len >> 3) << 2));
+                        b = (wyhash_read32(p + len - 4) << 32) | wyhash_read32(p + len - 4 - ((len >> 3) << 2));
+                } else if (likely(len > 0)) {
+                        a = wyhash_read_small(p, len);
+                        b = 0;
+                } else {
+                        a = b = 0;
+                }
+        } else {
+                size_t i = len;
+                if (unlikely(i > 48)) {
+                        u64 see1 = seed, see2 = seed;
+                        do {
+                                seed = wyhash_mix(wyhash_read64(p) ^ NG5_WYHASH_SECRET_1,
+                                                  wyhash_read64(p + 8) ^ seed);
+                                see1 = wyhash_mix(wyhash_read64(p + 16) ^ NG5_WYHASH_SECRET_2,
+                                                  wyhash_read64(p + 24) ^ see1);
+                                see2 = wyhash_mix(wyhash_read64(p + 32) ^ NG5_WYHASH_SECRET_3,
+                                                  wyhash_read64(p + 40) ^ see2);
+                                p += 48;
+                                i -= 48;
+                        } while (likely(i > 48));
+                        seed ^= see1 ^ see2;
+                }
+                while (unlikely(i > 16)) {
+                        seed = wyhash_mix(wyhash_read64(p) ^ NG5_WYHASH_SECRET_1, wyhash_read64(p + 8) ^ seed);
+                        i -= 16;
+                        p += 16;
+                }
+                a = wyhash_read64(p + i - 16);
+                b = wyhash_read64(p + i - 8);
+        }
+
+        a ^= NG5_WYHASH_SECRET_1;
+        b ^= seed;
+        wyhash_mum(&a, &b);
+        return wyhash_mix(a ^ NG5_WYHASH_SECRET_0 ^ len, b ^ NG5_WYHASH_SECRET_1);
+}
+
+static inline hash64_t wyhash_u64(u64 key)
+{
+        u64 a = key ^ NG5_WYHASH_SECRET_0;
+        u64 b = NG5_WYHASH_SEED ^ NG5_WYHASH_SECRET_1;
+        wyhash_mum(&a, &b);
+        return wyhash_mix(a ^ NG5_WYHASH_SECRET_0, b ^ NG5_WYHASH_SECRET_1);
+}
+
+NG5_END_DECL
+
+#endif
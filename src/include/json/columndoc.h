@@ -57,6 +57,11 @@ struct columndoc_group {
 
 };
 
+/**
+ * Columnar decomposition of a single object. An object typically holds only a few of the possible key/value types.
+ * Hence, all vectors below are referenced rather than embedded, and are created on the first insertion of a property
+ * of their type. Until then, they point to a shared empty (read-only) vector such that readers need no special case.
+ */
 struct columndoc_obj {
         /** Parent document meta doc */
         struct columndoc *parent;
@@ -66,156 +71,110 @@ struct columndoc_obj {
         size_t index;
 
         /** Inverted index of keys mapping to primitive boolean types (sorted by key) */
-        struct vector ofType(field_sid_t) bool_prop_keys;
+        struct vector ofType(field_sid_t) *bool_prop_keys;
         /** Inverted index of keys mapping to primitive int8 number types (sorted by key) */
-        struct vector ofType(field_sid_t) int8_prop_keys;
+        struct vector ofType(field_sid_t) *int8_prop_keys;
         /** Inverted index of keys mapping to primitive int16 number types (sorted by key) */
-        struct vector ofType(field_sid_t) int16_prop_keys;
+        struct vector ofType(field_sid_t) *int16_prop_keys;
         /** Inverted index of keys mapping to primitive int32 number types (sorted by key) */
-        struct vector ofType(field_sid_t) int32_prop_keys;
+        struct vector ofType(field_sid_t) *int32_prop_keys;
         /** Inverted index of keys mapping to primitive int64 number types (sorted by key) */
-        struct vector ofType(field_sid_t) int64_prop_keys;
+        struct vector ofType(field_sid_t) *int64_prop_keys;
         /** Inverted index of keys mapping to primitive uint8 number types (sorted by key) */
-        struct vector ofType(field_sid_t) uint8_prop_keys;
+        struct vector ofType(field_sid_t) *uint8_prop_keys;
         /** Inverted index of keys mapping to primitive uint16 number types (sorted by key) */
-        struct vector ofType(field_sid_t) uint16_prop_keys;
+        struct vector ofType(field_sid_t) *uint16_prop_keys;
         /** Inverted index of keys mapping to primitive uint32 number types (sorted by key) */
-        struct vector ofType(field_sid_t) uin32_prop_keys;
+        struct vector ofType(field_sid_t) *uin32_prop_keys;
         /** Inverted index of keys mapping to primitive uint64 number types (sorted by key) */
-        struct vector ofType(field_sid_t) uint64_prop_keys;
+        struct vector ofType(field_sid_t) *uint64_prop_keys;
         /** Inverted index of keys mapping to primitive string types (sorted by key) */
-        struct vector ofType(field_sid_t) string_prop_keys;
+        struct vector ofType(field_sid_t) *string_prop_keys;
         /** Inverted index of keys mapping to primitive real types (sorted by key) */
-        struct vector ofType(field_sid_t) float_prop_keys;
+        struct vector ofType(field_sid_t) *float_prop_keys;
         /** Inverted index of keys mapping to primitive null values (sorted by key) */
-        struct vector ofType(field_sid_t) null_prop_keys;
+        struct vector ofType(field_sid_t) *null_prop_keys;
         /** Inverted index of keys mapping to exactly one nested object value (sorted by key) */
-        struct vector ofType(field_sid_t) obj_prop_keys;
+        struct vector ofType(field_sid_t) *obj_prop_keys;
 
         /** Inverted index of keys mapping to array of boolean types (sorted by key)*/
-        struct vector ofType(field_sid_t) bool_array_prop_keys;
+        struct vector ofType(field_sid_t) *bool_array_prop_keys;
         /** Inverted index of keys mapping to array of int8 number types (sorted by key)*/
-        struct vector ofType(field_sid_t) int8_array_prop_keys;
+        struct vector ofType(field_sid_t) *int8_array_prop_keys;
         /** Inverted index of keys mapping to array of int16 number types (sorted by key) */
-        struct vector ofType(field_sid_t) int16_array_prop_keys;
+        struct vector ofType(field_sid_t) *int16_array_prop_keys;
         /** Inverted index of keys mapping to array of int32 number types (sorted by key) */
-        struct vector ofType(field_sid_t) int32_array_prop_keys;
+        struct vector ofType(field_sid_t) *int32_array_prop_keys;
         /** Inverted index of keys mapping to array of int64 number types (sorted by key) */
-        struct vector ofType(field_sid_t) int64_array_prop_keys;
+        struct vector ofType(field_sid_t) *int64_array_prop_keys;
         /** Inverted index of keys mapping to array of uint8 number types (sorted by key) */
-        struct vector ofType(field_sid_t) uint8_array_prop_keys;
+        struct vector ofType(field_sid_t) *uint8_array_prop_keys;
         /** Inverted index of keys mapping to array of uint16 number types (sorted by key) */
-        struct vector ofType(field_sid_t) uint16_array_prop_keys;
+        struct vector ofType(field_sid_t) *uint16_array_prop_keys;
         /** Inverted index of keys mapping to array of uint32 number types (sorted by key) */
-        struct vector ofType(field_sid_t) uint32_array_prop_keys;
+        struct vector ofType(field_sid_t) *uint32_array_prop_keys;
         /** Inverted index of keys mapping to array of uint64 number types (sorted by key) */
-        struct vector ofType(field_sid_t) uint64_array_prop_keys;
+        struct vector ofType(field_sid_t) *uint64_array_prop_keys;
         /** Inverted index of keys mapping array of string types (sorted by key) */
-        struct vector ofType(field_sid_t) string_array_prop_keys;
+        struct vector ofType(field_sid_t) *string_array_prop_keys;
         /** Inverted index of keys mapping array of real types (sorted by key) */
-        struct vector ofType(field_sid_t) float_array_prop_keys;
+        struct vector ofType(field_sid_t) *float_array_prop_keys;
         /** Inverted index of keys mapping array of null value (sorted by key)s */
-        struct vector ofType(field_sid_t) null_array_prop_keys;
+        struct vector ofType(field_sid_t) *null_array_prop_keys;
 
         /** Primitive boolean values associated to keys stored above (sorted by key) */
-        struct vector ofType(FIELD_BOOLEANean_t) bool_prop_vals;
+        struct vector ofType(FIELD_BOOLEANean_t) *bool_prop_vals;
         /** Primitive int8 number values associated to keys stored above (sorted by key) */
-        struct vector ofType(field_i8_t) int8_prop_vals;
+        struct vector ofType(field_i8_t) *int8_prop_vals;
         /** Primitive int16 number values associated to keys stored above (sorted by key) */
-        struct vector ofType(field_i16_t) int16_prop_vals;
+        struct vector ofType(field_i16_t) *int16_prop_vals;
         /** Primitive int32 number values associated to keys stored above (sorted by key) */
-        struct vector ofType(field_i32_t) int32_prop_vals;
+        struct vector ofType(field_i32_t) *int32_prop_vals;
         /** Primitive int64 number values associated to keys stored above (sorted by key) */
-        struct vector ofType(field_i64_t) int64_prop_vals;
+        struct vector ofType(field_i64_t) *int64_prop_vals;
         /** Primitive uint8 number values associated to keys stored above (sorted by key) */
-        struct vector ofType(field_u8_t) uint8_prop_vals;
+        struct vector ofType(field_u8_t) *uint8_prop_vals;
         /** Primitive uint16 number values associated to keys stored above (sorted by key) */
-        struct vector ofType(field_u16_t) uint16_prop_vals;
+        struct vector ofType(field_u16_t) *uint16_prop_vals;
         /** Primitive uint32 number values associated to keys stored above (sorted by key) */
-        struct vector ofType(field_u32_t) uint32_prop_vals;
+        struct vector ofType(field_u32_t) *uint32_prop_vals;
         /** Primitive uint64 number values associated to keys stored above (sorted by key) */
-        struct vector ofType(field_u64_t) uint64_prop_vals;
+        struct vector ofType(field_u64_t) *uint64_prop_vals;
         /** Primitive real number values associated to keys stored above (sorted by key) */
-        struct vector ofType(field_number_t) float_prop_vals;
+        struct vector ofType(field_number_t) *float_prop_vals;
         /** Primitive string number values associated to keys stored above (sorted by key) */
-        struct vector ofType(field_sid_t) string_prop_vals;
+        struct vector ofType(field_sid_t) *string_prop_vals;
 
         /** Array of boolean values associated to keys stored above (sorted by key) */
-        struct vector ofType(Vector) bool_array_prop_vals;
+        struct vector ofType(Vector) *bool_array_prop_vals;
         /** Array of int8 number values associated to keys stored above (sorted by key) */
-        struct vector ofType(Vector) int8_array_prop_vals;
+        struct vector ofType(Vector) *int8_array_prop_vals;
         /** Array of int16 number values associated to keys stored above (sorted by key) */
-        struct vector ofType(Vector) int16_array_prop_vals;
+        struct vector ofType(Vector) *int16_array_prop_vals;
         /** Array of int32 number values associated to keys stored above (sorted by key) */
-        struct vector ofType(Vector) int32_array_prop_vals;
+        struct vector ofType(Vector) *int32_array_prop_vals;
         /** Array of int64 number values associated to keys stored above (sorted by key) */
-        struct vector ofType(Vector) int64_array_prop_vals;
+        struct vector ofType(Vector) *int64_array_prop_vals;
         /** Array of uint8 number values associated to keys stored above (sorted by key) */
-        struct vector ofType(Vector) uint8_array_prop_vals;
+        struct vector ofType(Vector) *uint8_array_prop_vals;
         /** Array of uint16 number values associated to keys stored above (sorted by key) */
-        struct vector ofType(Vector) uint16_array_prop_vals;
+        struct vector ofType(Vector) *uint16_array_prop_vals;
         /** Array of uint32 number values associated to keys stored above (sorted by key) */
-        struct vector ofType(Vector) uint32_array_prop_vals;
+        struct vector ofType(Vector) *uint32_array_prop_vals;
         /** Array of uint64 number values associated to keys stored above (sorted by key) */
-        struct vector ofType(Vector) ui64_array_prop_vals;
+        struct vector ofType(Vector) *ui64_array_prop_vals;
         /** Array of real number values associated to keys stored above (sorted by key) */
-        struct vector ofType(Vector) float_array_prop_vals;
+        struct vector ofType(Vector) *float_array_prop_vals;
         /** Array of string number values associated to keys stored above (sorted by key) */
-        struct vector ofType(Vector) string_array_prop_vals;
+        struct vector ofType(Vector) *string_array_prop_vals;
         /** Array of null values associated to keys stored above (sorted by key). The number represents the
          * multiplicity of nulls for the associated key. */
-        struct vector ofType(u16) null_array_prop_vals;
+        struct vector ofType(u16) *null_array_prop_vals;
         /** Primitive objects associated to keys stored above (sorted by key) */
-        struct vector ofType(struct columndoc_obj) obj_prop_vals;
-
-        /** Index of primitive boolean values associated to keys stored above (sorted by value) */
-        struct vector ofType(u32) bool_val_idxs;
-        /** Index of primitive int8 number values associated to keys stored above (sorted by value) */
-        struct vector ofType(u32) int8_val_idxs;
-        /** Index of primitive int16 number values associated to keys stored above (sorted by value) */
-        struct vector ofType(u32) int16_val_idxs;
-        /** Index of primitive int32 number values associated to keys stored above (sorted by value) */
-        struct vector ofType(u32) int32_val_idxs;
-        /** Index of primitive int64 number values associated to keys stored above (sorted by value) */
-        struct vector ofType(u32) int64_val_idxs;
-        /** Index of primitive uint8 number values associated to keys stored above (sorted by value) */
-        struct vector ofType(u32) uint8_val_idxs;
-        /** Index of primitive uint16 number values associated to keys stored above (sorted by value) */
-        struct vector ofType(u32) uint16_val_idxs;
-        /** Index of primitive uint32 number values associated to keys stored above (sorted by value) */
-        struct vector ofType(u32) uint32_val_idxs;
-        /** Index of primitive uint64 number values associated to keys stored above (sorted by value) */
-        struct vector ofType(u32) uint64_val_idxs;
-        /** Index of primitive real number values associated to keys stored above (sorted by value) */
-        struct vector ofType(u32) float_val_idxs;
-        /** Index of primitive string number values associated to keys stored above (sorted by value) */
-        struct vector ofType(u32) string_val_idxs;
-
-        /** Index of array of boolean values associated to keys stored above (sorted by value) */
-        struct vector ofType(Vector) bool_array_idxs;
-        /** Index of array of int8 number values associated to keys stored above (sorted by value) */
-        struct vector ofType(Vector) int8_array_idxs;
-        /** Index of array of int16 number values associated to keys stored above (sorted by value) */
-        struct vector ofType(Vector) int16_array_idxs;
-        /** Index of array of int32 number values associated to keys stored above (sorted by value) */
-        struct vector ofType(Vector) int32_array_idxs;
-        /** Index of array of int64 number values associated to keys stored above (sorted by value) */
-        struct vector ofType(Vector) int64_array_idxs;
-        /** Index of array of uint8 number values associated to keys stored above (sorted by value) */
-        struct vector ofType(Vector) uint8_array_idxs;
-        /** Index of array of uint16 number values associated to keys stored above (sorted by value) */
-        struct vector ofType(Vector) uint16_array_idxs;
-        /** Index of array of uint32 number values associated to keys stored above (sorted by value) */
-        struct vector ofType(Vector) uint32_array_idxs;
-        /** Index of array of uint64 number values associated to keys stored above (sorted by value) */
-        struct vector ofType(Vector) uint64_array_idxs;
-        /** Index of array of real number values associated to keys stored above (sorted by value) */
-        struct vector ofType(Vector) float_array_idxs;
-        /** Index of array of string number values associated to keys stored above (sorted by value) */
-        struct vector ofType(Vector) string_array_idxs;
+        struct vector ofType(struct columndoc_obj) *obj_prop_vals;
 
         /** Array of objects associated to keys stored above (sorted by key) */
-        struct vector ofType(struct columndoc_group) obj_array_props;
+        struct vector ofType(struct columndoc_group) *obj_array_props;
 
 };
 
@@ -225,11 +184,17 @@ struct columndoc {
         struct columndoc_obj columndoc;
         const struct doc_bulk *bulk;
         bool read_optimized;
+        struct allocator alloc;         /* allocator of all vectors of all (nested) objects */
         struct err err;
 };
 
+/**
+ * Builds the columnar representation of the records in <code>entries</code>. All vectors of the columnar
+ * representation are created with <code>alloc</code> (the standard allocator if <b>NULL</b>).
+ */
 NG5_EXPORT(bool) columndoc_create(struct columndoc *columndoc, struct err *err, const struct doc *doc,
-        const struct doc_bulk *bulk, const struct doc_entries *entries, struct strdic *dic);
+        const struct doc_bulk *bulk, const struct doc_entries *entries, struct strdic *dic,
+        const struct allocator *alloc);
 
 NG5_DEFINE_GET_ERROR_FUNCTION(columndoc, struct columndoc, doc)
 
@@ -38,8 +38,10 @@ struct doc_entries {
 
 struct doc_bulk {
         struct strdic *dic;
+        struct allocator alloc;
         struct vector ofType(char *) keys, values;
         struct vector ofType(struct doc) models;
+        size_t num_encoded_keys, num_encoded_values;
 };
 
 struct doc {
@@ -53,12 +55,25 @@ struct doc_obj {
         struct doc *doc;
 };
 
-NG5_EXPORT(bool) doc_bulk_create(struct doc_bulk *bulk, struct strdic *dic);
+/**
+ * Creates an empty bulk whose strings, objects and entry vectors are allocated with <code>alloc</code> (the
+ * standard allocator if <b>NULL</b>), as are ASTs parsed by a <code>json_parser</code> for this bulk. If
+ * <code>alloc</code> is an arena (see arena.h), <code>doc_bulk_Drop</code> does not visit the objects one by one,
+ * and the memory is released by dropping the arena after the bulk.
+ */
+NG5_EXPORT(bool) doc_bulk_create(struct doc_bulk *bulk, struct strdic *dic, const struct allocator *alloc);
 
 NG5_EXPORT(bool) doc_bulk_Drop(struct doc_bulk *bulk);
 
 NG5_EXPORT(bool) doc_bulk_shrink(struct doc_bulk *bulk);
 
+/**
+ * Inserts all key and value strings that were added to <code>bulk</code> since the last call into the bulk's string
+ * dictionary. Calling this function between batches of imported documents feeds the dictionary incrementally;
+ * strings that are not encoded when <code>doc_entries_columndoc</code> is called are inserted there.
+ */
+NG5_EXPORT(bool) doc_bulk_encode_strings(struct doc_bulk *bulk);
+
 NG5_EXPORT(bool) doc_bulk_print(FILE *file, struct doc_bulk *bulk);
 
 NG5_EXPORT(struct doc *)doc_bulk_new_doc(struct doc_bulk *context, field_e type);
@@ -89,8 +104,13 @@ NG5_EXPORT(struct doc_obj *)doc_bulk_add_json(struct doc_entries *partition, str
 
 NG5_EXPORT(struct doc_obj *)doc_entries_get_root(const struct doc_entries *partition);
 
+/**
+ * Returns the columnar representation of <code>partition</code>, whose vectors are created with <code>alloc</code>
+ * (the standard allocator if <b>NULL</b>). The columnar representation may outlive <code>bulk</code>, hence
+ * <code>alloc</code> should not be the bulk's arena.
+ */
 NG5_EXPORT(struct columndoc *)doc_entries_columndoc(const struct doc_bulk *bulk, const struct doc_entries *partition,
-        bool read_optimized);
+        bool read_optimized, const struct allocator *alloc);
 
 NG5_EXPORT(bool) doc_entries_drop(struct doc_entries *partition);
 
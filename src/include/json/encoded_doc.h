@@ -19,7 +19,7 @@
 #define NG5_ENCODED_DOC_H
 
 #include "shared/common.h"
-#include "std/hash_table.h"
+#include "std/hash_map.h"
 #include "core/oid/oid.h"
 #include "shared/types.h"
 #include "core/carbon/archive.h"
@@ -83,14 +83,14 @@ struct encoded_doc {
         object_id_t object_id;
         struct vector ofType(struct encoded_doc_prop) props;
         struct vector ofType(struct encoded_doc_prop_array) props_arrays;
-        struct hashtable ofMapping(field_sid_t, u32) prop_array_index; /* maps key to index in prop arrays */
+        struct hashmap_u64_u32 ofMapping(field_sid_t, u32) prop_array_index; /* maps key to index in prop arrays */
         struct err err;
 };
 
 struct encoded_doc_list {
         struct archive *archive;
         struct vector ofType(struct encoded_doc) flat_object_collection;   /* list of objects; also nested ones */
-        struct hashtable ofMapping(object_id_t, u32) index;   /* maps oid to index in collection */
+        struct hashmap_u64_u32 ofMapping(object_id_t, u32) index;   /* maps oid to index in collection */
         struct err err;
 };
 
@@ -20,6 +20,7 @@
 
 #include "shared/common.h"
 #include "std/vec.h"
+#include "json/json_scan.h"
 
 NG5_BEGIN_DECL
 
@@ -43,6 +44,10 @@ struct json_prop;
 
 struct json_elements;
 
+struct doc_entries;
+
+struct doc_obj;
+
 enum json_token_type {
         OBJECT_OPEN,
         OBJECT_CLOSE,
@@ -77,11 +82,23 @@ struct json_tokenizer {
         const char *cursor;
         struct json_token token;
         struct err err;
+
+        /* structural index of the current block (stage one, see json_scan.h) */
+        const char *input;
+        size_t input_len;
+        size_t block_begin;
+        u64 block_index;
+        u64 block_newlines;
+        struct json_scan_carry carry;
+        unsigned line;
+        size_t line_cursor;
+        size_t line_begin;
 };
 
 struct json_parser {
         struct json_tokenizer tokenizer;
         struct doc_bulk *partition;
+        struct allocator alloc;         /* allocator of the partition, used for the nodes of ASTs */
         struct err err;
 };
 
@@ -101,6 +118,7 @@ enum json_value_type {
 
 struct json {
         struct json_element *element;
+        struct allocator alloc;
         struct err err;
 };
 
@@ -178,6 +196,11 @@ struct json_number {
         } value;
 };
 
+/**
+ * Prepares <code>tokenizer</code> to read tokens from the null-terminated string <code>input</code>. Tokens are
+ * produced by jumping between the positions of a structural index that is built lazily per 64-byte block while
+ * the tokenizer advances (see json_scan.h), i.e., whitespace and string contents are never looked at byte by byte.
+ */
 NG5_EXPORT(bool) json_tokenizer_init(struct json_tokenizer *tokenizer, const char *input);
 
 NG5_EXPORT(const struct json_token *)json_tokenizer_next(struct json_tokenizer *tokenizer);
@@ -191,6 +214,39 @@ NG5_EXPORT(bool) json_parser_create(struct json_parser *parser, struct doc_bulk
 NG5_EXPORT(bool) json_parse(struct json *json, struct json_err *error_desc, struct json_parser *parser,
         const char *input);
 
+/**
+ * Parses the JSON document <code>input</code> and imports it into <code>partition</code> in a single pass, i.e.,
+ * without materializing a token stream or an AST. The document restrictions checked by <code>json_test</code> are
+ * validated during parsing. On success, <code>out</code> (optional) points to the imported root object.
+ */
+NG5_EXPORT(bool) json_parse_to_doc(struct doc_obj **out, struct json_err *error_desc, struct json_parser *parser,
+        struct doc_entries *partition, const char *input);
+
+/** consecutive records of a top-level array, see <code>json_split_records</code> */
+struct json_record_range {
+        const char *begin;      /* first byte after the '[' or ',' that precedes the first record */
+        const char *end;        /* the ',' or ']' that follows the last record */
+};
+
+/**
+ * Splits the top-level array of objects in <code>input</code> into at most <code>max_ranges</code> ranges of
+ * consecutive records of roughly the same size in bytes, walking the structural index (see json_scan.h) to find
+ * the array's element boundaries. Returns the number of ranges, or 0 if <code>input</code> is not a non-empty
+ * top-level array, or its brackets are unbalanced. In the latter cases, <code>json_parse_to_doc</code> must be used
+ * on the entire input.
+ */
+NG5_EXPORT(size_t) json_split_records(struct json_record_range *ranges, size_t max_ranges, const char *input);
+
+/**
+ * Parses the records in <code>range</code> of the top-level array of <code>input</code> (see
+ * <code>json_split_records</code>) and imports each record as a sibling object into <code>partition</code>, i.e.,
+ * in the same way <code>json_parse_to_doc</code> imports the entire array. Line numbers in
+ * <code>error_desc</code> are relative to <code>input</code>. Ranges of one input can be parsed concurrently, given
+ * that each thread uses its own <code>parser</code> and its own <code>doc_bulk</code>.
+ */
+NG5_EXPORT(bool) json_parse_records_to_doc(struct json_err *error_desc, struct json_parser *parser,
+        struct doc_entries *partition, const char *input, const struct json_record_range *range);
+
 NG5_EXPORT(bool) json_test(struct err *err, struct json *json);
 
 NG5_EXPORT(bool) json_drop(struct json *json);
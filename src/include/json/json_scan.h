@@ -0,0 +1,193 @@
+/**
+ * Copyright 2018 Marcus Pinnecke
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NG5_JSON_SCAN_H
+#define NG5_JSON_SCAN_H
+
+#include "shared/common.h"
+#include "shared/types.h"
+
+#if defined(__AVX2__) || defined(__PCLMUL__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+NG5_BEGIN_DECL
+
+/**
+ * Stage one of the JSON tokenizer: classification of the input in blocks of 64 bytes into bitmasks (one bit per
+ * input byte, lowest bit is the first byte of the block) in the spirit of simdjson. Per block, the input is loaded
+ * into vector registers (2x AVX2, 4x SSE2, or a table-driven scalar fallback if neither is available) and compared
+ * against the characters of interest. Escaped quotes and string contents are then removed with plain 64bit
+ * arithmetic, such that the remaining structural index can be walked with count-trailing-zeros, jumping from token
+ * to token without looking at the bytes in between.
+ *
+ * AVX2 and carry-less multiplication (for the prefix-xor) are used when the library is compiled with
+ * <code>-DUSE_AVX2=on</code>; otherwise SSE2 is used on x86-64.
+ */
+
+#define NG5_JSON_SCAN_BLOCK_SIZE        64
+
+struct json_scan_block {
+        u64 quote;              /* '"' */
+        u64 backslash;          /* '\\' */
+        u64 structural;         /* '{', '}', '[', ']', ':', ',' */
+        u64 whitespace;         /* ' ', '\t', '\n', '\r' */
+        u64 newline;            /* '\n' */
+};
+
+/** carry state between two consecutive blocks */
+struct json_scan_carry {
+        u64 escaped;            /* 1 if the previous block ends with an odd-length backslash sequence */
+        u64 in_string;          /* all-ones if the previous block ends inside a string literal */
+        u64 scalar_pred;        /* 1 if the last byte of the previous block may precede a scalar start */
+};
+
+#define NG5_JSON_SCAN_EVEN_BITS         0x5555555555555555ull
+#define NG5_JSON_SCAN_ODD_BITS          (~NG5_JSON_SCAN_EVEN_BITS)
+
+#if !defined(__SSE2__)
+enum json_scan_class {
+        JSON_SCAN_NONE = 0,
+        JSON_SCAN_QUOTE = 1,
+        JSON_SCAN_BACKSLASH = 2,
+        JSON_SCAN_STRUCTURAL = 4,
+        JSON_SCAN_WHITESPACE = 8,
+        JSON_SCAN_NEWLINE = 16
+};
+
+static const u8 JSON_SCAN_CLASS[256] = {
+        ['"'] = JSON_SCAN_QUOTE, ['\\'] = JSON_SCAN_BACKSLASH, ['{'] = JSON_SCAN_STRUCTURAL,
+        ['}'] = JSON_SCAN_STRUCTURAL, ['['] = JSON_SCAN_STRUCTURAL, [']'] = JSON_SCAN_STRUCTURAL,
+        [':'] = JSON_SCAN_STRUCTURAL, [','] = JSON_SCAN_STRUCTURAL, [' '] = JSON_SCAN_WHITESPACE,
+        ['\t'] = JSON_SCAN_WHITESPACE, ['\r'] = JSON_SCAN_WHITESPACE,
+        ['\n'] = JSON_SCAN_WHITESPACE | JSON_SCAN_NEWLINE
+};
+#endif
+
+#if defined(__AVX2__)
+#define json_scan_eq(in, c)             _mm256_cmpeq_epi8(in, _mm256_set1_epi8(c))
+#define json_scan_or(a, b)              _mm256_or_si256(a, b)
+#define json_scan_movemask(x)           ((u64) (u32) _mm256_movemask_epi8(x))
+#define NG5_JSON_SCAN_LANES             2
+#define NG5_JSON_SCAN_LANE_WIDTH        32
+typedef __m256i json_scan_lane_t;
+#define json_scan_load(ptr)             _mm256_loadu_si256((const __m256i *) (ptr))
+#elif defined(__SSE2__)
+#define json_scan_eq(in, c)             _mm_cmpeq_epi8(in, _mm_set1_epi8(c))
+#define json_scan_or(a, b)              _mm_or_si128(a, b)
+#define json_scan_movemask(x)           ((u64) (u16) _mm_movemask_epi8(x))
+#define NG5_JSON_SCAN_LANES             4
+#define NG5_JSON_SCAN_LANE_WIDTH        16
+typedef __m128i json_scan_lane_t;
+#define json_scan_load(ptr)             _mm_loadu_si128((const __m128i *) (ptr))
+#endif
+
+/** classifies the 64 bytes starting at <code>block</code> (no alignment required) */
+static inline void json_scan_classify(struct json_scan_block *out, const char *block)
+{
+#if defined(__AVX2__) || defined(__SSE2__)
+        *out = (struct json_scan_block) {0};
+        for (int i = 0; i < NG5_JSON_SCAN_LANES; i++) {
+                json_scan_lane_t in = json_scan_load(block + i * NG5_JSON_SCAN_LANE_WIDTH);
+                json_scan_lane_t newline = json_scan_eq(in, '\n');
+                json_scan_lane_t structural = json_scan_or(json_scan_or(json_scan_eq(in, '{'), json_scan_eq(in, '}')),
+                        json_scan_or(json_scan_or(json_scan_eq(in, '['), json_scan_eq(in, ']')),
+                                json_scan_or(json_scan_eq(in, ':'), json_scan_eq(in, ','))));
+                json_scan_lane_t whitespace = json_scan_or(json_scan_or(json_scan_eq(in, ' '), json_scan_eq(in, '\t')),
+                        json_scan_or(json_scan_eq(in, '\r'), newline));
+                unsigned shift = i * NG5_JSON_SCAN_LANE_WIDTH;
+                out->quote |= json_scan_movemask(json_scan_eq(in, '"')) << shift;
+                out->backslash |= json_scan_movemask(json_scan_eq(in, '\\')) << shift;
+                out->newline |= json_scan_movemask(newline) << shift;
+                out->structural |= json_scan_movemask(structural) << shift;
+                out->whitespace |= json_scan_movemask(whitespace) << shift;
+        }
+#else
+        *out = (struct json_scan_block) {0};
+        for (int i = 0; i < NG5_JSON_SCAN_BLOCK_SIZE; i++) {
+                u8 class = JSON_SCAN_CLASS[(u8) block[i]];
+                u64 bit = 1ull << i;
+                out->quote |= (class & JSON_SCAN_QUOTE) ? bit : 0;
+                out->backslash |= (class & JSON_SCAN_BACKSLASH) ? bit : 0;
+                out->structural |= (class & JSON_SCAN_STRUCTURAL) ? bit : 0;
+                out->whitespace |= (class & JSON_SCAN_WHITESPACE) ? bit : 0;
+                out->newline |= (class & JSON_SCAN_NEWLINE) ? bit : 0;
+        }
+#endif
+}
+
+/** returns a mask of all bytes that are escaped by an odd-length sequence of backslashes */
+static inline u64 json_scan_escaped(u64 backslash, struct json_scan_carry *carry)
+{
+        u64 start_edges = backslash & ~(backslash << 1);
+        u64 even_start_mask = NG5_JSON_SCAN_EVEN_BITS ^ carry->escaped;
+        u64 even_starts = start_edges & even_start_mask;
+        u64 odd_starts = start_edges & ~even_start_mask;
+        u64 even_carries = backslash + even_starts;
+        u64 odd_carries = backslash + odd_starts;
+        u64 odd_overflow = odd_carries < backslash;
+
+        odd_carries |= carry->escaped;
+        carry->escaped = odd_overflow;
+
+        u64 even_carry_ends = even_carries & ~backslash;
+        u64 odd_carry_ends = odd_carries & ~backslash;
+        return (even_carry_ends & NG5_JSON_SCAN_ODD_BITS) | (odd_carry_ends & NG5_JSON_SCAN_EVEN_BITS);
+}
+
+/** bit i of the result is the xor of bits 0..i of the input */
+static inline u64 json_scan_prefix_xor(u64 bits)
+{
+#if defined(__PCLMUL__)
+        __m128i product = _mm_clmulepi64_si128(_mm_set_epi64x(0, (long long) bits), _mm_set1_epi8((char) 0xFF), 0);
+        return (u64) _mm_cvtsi128_si64(product);
+#else
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+#endif
+}
+
+/**
+ * Computes the structural index of a classified block: structural characters outside of string literals, all
+ * unescaped quotes (i.e., both the opening and the closing quote of each string literal), and the first byte of
+ * each scalar (number, <code>true</code>, <code>false</code>, <code>null</code>, or garbage) outside of strings.
+ * Everything else (whitespace, string contents, non-first bytes of scalars) is skipped.
+ */
+static inline u64 json_scan_index(const struct json_scan_block *block, struct json_scan_carry *carry)
+{
+        u64 quote = block->quote & ~json_scan_escaped(block->backslash, carry);
+        u64 in_string = json_scan_prefix_xor(quote) ^ carry->in_string;
+        carry->in_string = (u64) ((i64) in_string >> 63);
+
+        u64 scalar_pred = block->structural | block->whitespace | quote;
+        u64 scalar = ~(block->structural | block->whitespace | quote | in_string);
+        u64 scalar_start = scalar & ((scalar_pred << 1) | carry->scalar_pred);
+        carry->scalar_pred = scalar_pred >> 63;
+
+        return (block->structural & ~in_string) | quote | scalar_start;
+}
+
+NG5_END_DECL
+
+#endif
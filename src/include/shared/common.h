@@ -215,7 +215,7 @@ ng5_func_unused static const char *basic_type_to_system_type_str(enum field_type
 #endif
 
 #define CARBON_ARCHIVE_MAGIC                "MP/CARBON"
-#define CARBON_ARCHIVE_VERSION               1
+#define CARBON_ARCHIVE_VERSION               2
 
 #define  MARKER_SYMBOL_OBJECT_BEGIN        '{'
 #define  MARKER_SYMBOL_OBJECT_END          '}'
@@ -251,6 +251,7 @@ ng5_func_unused static const char *basic_type_to_system_type_str(enum field_type
 #define  MARKER_SYMBOL_COLUMN              'x'
 #define  MARKER_SYMBOL_HUFFMAN_DIC_ENTRY   'd'
 #define  MARKER_SYMBOL_RECORD_HEADER       'r'
+#define  MARKER_SYMBOL_ROW_GROUP_DIRECTORY 'Z'
 #define  MARKER_SYMBOL_HASHTABLE_HEADER    '#'
 #define  MARKER_SYMBOL_VECTOR_HEADER       '|'
 
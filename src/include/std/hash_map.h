@@ -0,0 +1,285 @@
+/**
+ * Copyright 2018 Marcus Pinnecke
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NG5_HASH_MAP_H
+#define NG5_HASH_MAP_H
+
+#include "shared/common.h"
+#include "shared/error.h"
+#include "core/alloc/alloc.h"
+#include "hash/wyhash.h"
+
+NG5_BEGIN_DECL
+
+/**
+ * Type-specialized hash maps for fixed-width integer keys (e.g., field_sid_t or object_id_t) and plain-old-data
+ * values, generated at compile time. Use <code>NG5_DEFINE_HASHMAP(key_type, value_type)</code> to generate a map
+ * <code>struct hashmap_key_type_value_type</code> along with its functions <code>hashmap_key_type_value_type_*</code>.
+ *
+ * Example: <code>NG5_DEFINE_HASHMAP(u64, u32)</code> generates <code>struct hashmap_u64_u32</code>, and
+ * <code>hashmap_u64_u32_create</code>, <code>hashmap_u64_u32_get</code>, etc.
+ *
+ * In contrast to <code>struct hashtable</code> (see hash_table.h), hashing and key comparison are inlined, keys,
+ * values and slot states are stored in separate flat arrays (linear probing over a power-of-two table), and no lock is
+ * taken. Concurrent access must be synchronized by the caller. Pointers to values returned by
+ * <code>get</code>/<code>upsert</code> are invalidated by the next insertion or removal.
+ */
+
+#define NG5_HASHMAP_DEFAULT_CAPACITY       16
+#define NG5_HASHMAP_BATCH_SIZE             16
+
+#define NG5_HASHMAP_SLOT_FREE              0
+#define NG5_HASHMAP_SLOT_IN_USE            1
+
+#define NG5_DEFINE_HASHMAP(key_type, value_type)                                                                       \
+        NG5_DEFINE_HASHMAP_NAMED(key_type##_##value_type, key_type, value_type)
+
+#define NG5_DEFINE_HASHMAP_NAMED(name, key_type, value_type)                                                           \
+struct hashmap_##name {                                                                                                \
+        struct allocator alloc;                                                                                        \
+        key_type *keys;                                                                                                \
+        value_type *values;                                                                                            \
+        u8 *slots;                                                                                                     \
+        u32 mask;                                                                                                      \
+        u32 num_elems;                                                                                                 \
+        struct err err;                                                                                                \
+};                                                                                                                     \
+                                                                                                                       \
+ng5_func_unused static inline u32 hashmap_##name##_pos_of(const struct hashmap_##name *map, key_type key)              \
+{                                                                                                                      \
+        return (u32) NG5_HASH64_WYHASH_U64(key) & map->mask;                                                           \
+}                                                                                                                      \
+                                                                                                                       \
+/** allocates an empty table for at least 'capacity' elements; the table of 'map' is left untouched on failure */      \
+ng5_func_unused static inline bool hashmap_##name##_alloc_table(struct hashmap_##name *map, size_t capacity)           \
+{                                                                                                                      \
+        size_t cap = NG5_HASHMAP_DEFAULT_CAPACITY;                                                                     \
+        while (cap < capacity) {                                                                                       \
+                cap <<= 1;                                                                                             \
+        }                                                                                                              \
+        key_type *keys = (key_type *) alloc_malloc(&map->alloc, cap * sizeof(key_type));                               \
+        value_type *values = (value_type *) alloc_malloc(&map->alloc, cap * sizeof(value_type));                       \
+        u8 *slots = (u8 *) alloc_malloc(&map->alloc, cap * sizeof(u8));                                                \
+        if (unlikely(!keys || !values || !slots)) {                                                                    \
+                if (keys) {                                                                                            \
+                        alloc_free(&map->alloc, keys);                                                                 \
+                }                                                                                                      \
+                if (values) {                                                                                          \
+                        alloc_free(&map->alloc, values);                                                               \
+                }                                                                                                      \
+                if (slots) {                                                                                           \
+                        alloc_free(&map->alloc, slots);                                                                \
+                }                                                                                                      \
+                error(&map->err, NG5_ERR_MALLOCERR);                                                                   \
+                return false;                                                                                          \
+        }                                                                                                              \
+        memset(slots, NG5_HASHMAP_SLOT_FREE, cap * sizeof(u8));                                                        \
+        map->keys = keys;                                                                                              \
+        map->values = values;                                                                                          \
+        map->slots = slots;                                                                                            \
+        map->mask = cap - 1;                                                                                           \
+        map->num_elems = 0;                                                                                            \
+        return true;                                                                                                   \
+}                                                                                                                      \
+                                                                                                                       \
+ng5_func_unused static inline void hashmap_##name##_free_table(struct hashmap_##name *map)                             \
+{                                                                                                                      \
+        alloc_free(&map->alloc, map->keys);                                                                            \
+        alloc_free(&map->alloc, map->values);                                                                          \
+        alloc_free(&map->alloc, map->slots);                                                                           \
+}                                                                                                                      \
+                                                                                                                       \
+ng5_func_unused static inline bool hashmap_##name##_create(struct hashmap_##name *map, const struct allocator *alloc,  \
+        size_t capacity)                                                                                               \
+{                                                                                                                      \
+        error_if_null(map)                                                                                             \
+        error_init(&map->err);                                                                                         \
+        ng5_check_success(alloc_this_or_std(&map->alloc, alloc));                                                      \
+        /* reserve space such that 'capacity' elements fit without exceeding the load factor */                        \
+        return hashmap_##name##_alloc_table(map, capacity + capacity / 3);                                             \
+}                                                                                                                      \
+                                                                                                                       \
+ng5_func_unused static inline bool hashmap_##name##_drop(struct hashmap_##name *map)                                   \
+{                                                                                                                      \
+        error_if_null(map)                                                                                             \
+        hashmap_##name##_free_table(map);                                                                              \
+        return true;                                                                                                   \
+}                                                                                                                      \
+                                                                                                                       \
+ng5_func_unused static inline bool hashmap_##name##_clear(struct hashmap_##name *map)                                  \
+{                                                                                                                      \
+        error_if_null(map)                                                                                             \
+        memset(map->slots, NG5_HASHMAP_SLOT_FREE, (map->mask + 1) * sizeof(u8));                                       \
+        map->num_elems = 0;                                                                                            \
+        return true;                                                                                                   \
+}                                                                                                                      \
+                                                                                                                       \
+ng5_func_unused static inline size_t hashmap_##name##_size(const struct hashmap_##name *map)                           \
+{                                                                                                                      \
+        return map->num_elems;                                                                                         \
+}                                                                                                                      \
+                                                                                                                       \
+ng5_func_unused static inline value_type *hashmap_##name##_get(struct hashmap_##name *map, key_type key)               \
+{                                                                                                                      \
+        u32 pos = hashmap_##name##_pos_of(map, key);                                                                   \
+        while (map->slots[pos] == NG5_HASHMAP_SLOT_IN_USE) {                                                           \
+                if (map->keys[pos] == key) {                                                                           \
+                        return map->values + pos;                                                                      \
+                }                                                                                                      \
+                pos = (pos + 1) & map->mask;                                                                           \
+        }                                                                                                              \
+        return NULL;                                                                                                   \
+}                                                                                                                      \
+                                                                                                                       \
+ng5_func_unused static inline bool hashmap_##name##_contains(struct hashmap_##name *map, key_type key)                 \
+{                                                                                                                      \
+        return hashmap_##name##_get(map, key) != NULL;                                                                 \
+}                                                                                                                      \
+                                                                                                                       \
+ng5_func_unused static inline bool hashmap_##name##_rehash(struct hashmap_##name *map, size_t capacity)                \
+{                                                                                                                      \
+        /* on failure, the map keeps its table (and its contents) */                                                   \
+        struct hashmap_##name old = *map;                                                                              \
+        ng5_check_success(hashmap_##name##_alloc_table(map, capacity));                                                \
+        for (u32 i = 0; i <= old.mask; i++) {                                                                          \
+                if (old.slots[i] == NG5_HASHMAP_SLOT_IN_USE) {                                                         \
+                        u32 pos = hashmap_##name##_pos_of(map, old.keys[i]);                                           \
+                        while (map->slots[pos] == NG5_HASHMAP_SLOT_IN_USE) {                                           \
+                                pos = (pos + 1) & map->mask;                                                           \
+                        }                                                                                              \
+                        map->slots[pos] = NG5_HASHMAP_SLOT_IN_USE;                                                     \
+                        map->keys[pos] = old.keys[i];                                                                  \
+                        map->values[pos] = old.values[i];                                                              \
+                        map->num_elems++;                                                                              \
+                }                                                                                                      \
+        }                                                                                                              \
+        hashmap_##name##_free_table(&old);                                                                             \
+        return true;                                                                                                   \
+}                                                                                                                      \
+                                                                                                                       \
+/**                                                                                                                    \
+ * returns the value for 'key', inserting a zero-initialized value if 'key' is not contained; 'found' is optional.     \
+ * Returns NULL (and leaves the map unchanged) if the table must grow, but allocating the larger table fails.          \
+ */                                                                                                                    \
+ng5_func_unused static inline value_type *hashmap_##name##_upsert(struct hashmap_##name *map, key_type key,            \
+        bool *found)                                                                                                   \
+{                                                                                                                      \
+        /* grow at load factor 0.75 */                                                                                 \
+        if (unlikely((map->num_elems + 1) * 4 > (map->mask + 1) * 3)) {                                                \
+                if (unlikely(!hashmap_##name##_rehash(map, (map->mask + 1) * 2))) {                                    \
+                        return NULL;                                                                                   \
+                }                                                                                                      \
+        }                                                                                                              \
+        u32 pos = hashmap_##name##_pos_of(map, key);                                                                   \
+        while (map->slots[pos] == NG5_HASHMAP_SLOT_IN_USE) {                                                           \
+                if (map->keys[pos] == key) {                                                                           \
+                        ng5_optional_set(found, true);                                                                 \
+                        return map->values + pos;                                                                      \
+                }                                                                                                      \
+                pos = (pos + 1) & map->mask;                                                                           \
+        }                                                                                                              \
+        ng5_optional_set(found, false);                                                                                \
+        map->slots[pos] = NG5_HASHMAP_SLOT_IN_USE;                                                                     \
+        map->keys[pos] = key;                                                                                          \
+        memset(map->values + pos, 0, sizeof(value_type));                                                              \
+        map->num_elems++;                                                                                              \
+        return map->values + pos;                                                                                      \
+}                                                                                                                      \
+                                                                                                                       \
+ng5_func_unused static inline bool hashmap_##name##_put(struct hashmap_##name *map, key_type key, value_type value)    \
+{                                                                                                                      \
+        value_type *slot = hashmap_##name##_upsert(map, key, NULL);                                                    \
+        if (likely(slot != NULL)) {                                                                                    \
+                *slot = value;                                                                                         \
+                return true;                                                                                           \
+        }                                                                                                              \
+        return false;                                                                                                  \
+}                                                                                                                      \
+                                                                                                                       \
+ng5_func_unused static inline bool hashmap_##name##_remove(struct hashmap_##name *map, key_type key)                   \
+{                                                                                                                      \
+        u32 pos = hashmap_##name##_pos_of(map, key);                                                                   \
+        while (map->slots[pos] == NG5_HASHMAP_SLOT_IN_USE && map->keys[pos] != key) {                                  \
+                pos = (pos + 1) & map->mask;                                                                           \
+        }                                                                                                              \
+        if (map->slots[pos] != NG5_HASHMAP_SLOT_IN_USE) {                                                              \
+                return false;                                                                                          \
+        }                                                                                                              \
+        /* backward shift deletion: move successors of the cluster into the gap if their home slot permits */          \
+        u32 gap = pos;                                                                                                 \
+        u32 next = (pos + 1) & map->mask;                                                                              \
+        while (map->slots[next] == NG5_HASHMAP_SLOT_IN_USE) {                                                          \
+                u32 home = hashmap_##name##_pos_of(map, map->keys[next]);                                              \
+                if (((next - home) & map->mask) >= ((next - gap) & map->mask)) {                                       \
+                        map->keys[gap] = map->keys[next];                                                              \
+                        map->values[gap] = map->values[next];                                                          \
+                        gap = next;                                                                                    \
+                }                                                                                                      \
+                next = (next + 1) & map->mask;                                                                         \
+        }                                                                                                              \
+        map->slots[gap] = NG5_HASHMAP_SLOT_FREE;                                                                       \
+        map->num_elems--;                                                                                              \
+        return true;                                                                                                   \
+}                                                                                                                      \
+                                                                                                                       \
+/** looks up 'num_keys' keys at once, storing a pointer to each value (or NULL if not contained) in 'values' */        \
+ng5_func_unused static inline void hashmap_##name##_get_batch(value_type **values, struct hashmap_##name *map,         \
+        const key_type *keys, size_t num_keys)                                                                         \
+{                                                                                                                      \
+        u32 positions[NG5_HASHMAP_BATCH_SIZE];                                                                         \
+        for (size_t offset = 0; offset < num_keys; offset += NG5_HASHMAP_BATCH_SIZE) {                                 \
+                size_t batch_size = ng5_min(NG5_HASHMAP_BATCH_SIZE, num_keys - offset);                                \
+                for (size_t i = 0; i < batch_size; i++) {                                                              \
+                        positions[i] = hashmap_##name##_pos_of(map, keys[offset + i]);                                 \
+                        prefetch_read(map->slots + positions[i]);                                                      \
+                        prefetch_read(map->keys + positions[i]);                                                       \
+                }                                                                                                      \
+                for (size_t i = 0; i < batch_size; i++) {                                                              \
+                        u32 pos = positions[i];                                                                        \
+                        key_type key = keys[offset + i];                                                               \
+                        values[offset + i] = NULL;                                                                     \
+                        while (map->slots[pos] == NG5_HASHMAP_SLOT_IN_USE) {                                           \
+                                if (map->keys[pos] == key) {                                                           \
+                                        values[offset + i] = map->values + pos;                                        \
+                                        break;                                                                         \
+                                }                                                                                      \
+                                pos = (pos + 1) & map->mask;                                                           \
+                        }                                                                                              \
+                }                                                                                                      \
+        }                                                                                                              \
+}                                                                                                                      \
+                                                                                                                       \
+/** iterates over contained pairs; set '*it' to 0 before the first call; returns false if there are no more pairs */   \
+ng5_func_unused static inline bool hashmap_##name##_next(key_type *key, value_type **value, u32 *it,                   \
+        struct hashmap_##name *map)                                                                                    \
+{                                                                                                                      \
+        while (*it <= map->mask) {                                                                                     \
+                u32 pos = (*it)++;                                                                                     \
+                if (map->slots[pos] == NG5_HASHMAP_SLOT_IN_USE) {                                                      \
+                        *key = map->keys[pos];                                                                         \
+                        *value = map->values + pos;                                                                    \
+                        return true;                                                                                   \
+                }                                                                                                      \
+        }                                                                                                              \
+        return false;                                                                                                  \
+}
+
+NG5_DEFINE_HASHMAP(u64, u32)
+
+NG5_END_DECL
+
+#endif
@@ -83,6 +83,56 @@ NG5_EXPORT(bool) sort_qsort_indicies(size_t *indices, const void *base, size_t w
 NG5_EXPORT(int) sort_qsort_indicies_wargs(size_t *indices, const void *base, size_t width, less_eq_wargs_func_t comp,
         size_t nelemens, struct allocator *alloc, void *args);
 
+/** fixed-width key types of <code>sort_argsort</code> */
+enum sort_key_type {
+        SORT_KEY_U8,
+        SORT_KEY_U16,
+        SORT_KEY_U32,
+        SORT_KEY_U64,
+        SORT_KEY_I8,
+        SORT_KEY_I16,
+        SORT_KEY_I32,
+        SORT_KEY_I64,
+        SORT_KEY_FLOAT,
+        SORT_KEY_SID            /* field_sid_t, ordered by identifier (not by string) */
+};
+
+/** below this number of elements, <code>sort_argsort_parallel</code> sorts on the calling thread only */
+#define NG5_SORT_PARALLEL_MIN           (1 << 16)
+
+/**
+ * Computes the permutation <code>indices</code> that sorts the <code>nelemens</code> keys in <code>keys</code>
+ * ascending, i.e., <code>indices[0]</code> is the position of the smallest key. The sort is stable and uses a LSD
+ * radix sort on one byte per pass, skipping bytes that are equal for all keys. The content of <code>indices</code>
+ * is ignored.
+ */
+NG5_EXPORT(bool) sort_argsort(size_t *indices, const void *keys, enum sort_key_type key_type, size_t nelemens,
+        struct allocator *alloc);
+
+/**
+ * Same as <code>sort_argsort</code> but splits the keys into buckets by splitters taken from a sample of the keys,
+ * and sorts the buckets with <code>num_threads</code> threads (sample sort). The result is the same as for
+ * <code>sort_argsort</code>.
+ */
+NG5_EXPORT(bool) sort_argsort_parallel(size_t *indices, const void *keys, enum sort_key_type key_type,
+        size_t nelemens, struct allocator *alloc, uint_fast16_t num_threads);
+
+/**
+ * Computes the permutation <code>indices</code> that sorts the <code>nelemens</code> null-terminated strings in
+ * <code>strings</code> by <code>strcmp</code> (stable merge sort). <b>NULL</b> is ordered before any string.
+ */
+NG5_EXPORT(bool) sort_argsort_strings(size_t *indices, const char *const *strings, size_t nelemens,
+        struct allocator *alloc);
+
+/**
+ * Computes the permutation <code>indices</code> that sorts <code>nelemens</code> arrays of keys lexicographically
+ * (stable merge sort). Array <code>i</code> holds the keys <code>offsets[i]</code> up to (but excluding)
+ * <code>offsets[i + 1]</code> in <code>keys</code>, which are of type <code>key_type</code>. An array that is a
+ * prefix of another one is ordered first.
+ */
+NG5_EXPORT(bool) sort_argsort_arrays(size_t *indices, const void *keys, enum sort_key_type key_type,
+        const size_t *offsets, size_t nelemens, struct allocator *alloc);
+
 NG5_EXPORT(size_t) sort_bsearch_indicies(const size_t *indicies, const void *base, size_t width, size_t nelemens,
         const void *neelde, eq_func_t compEq, less_func_t compLess);
 
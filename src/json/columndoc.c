@@ -32,8 +32,6 @@ static bool print_object(FILE *file, struct err *err, const struct columndoc_obj
 
 static const char *get_type_name(struct err *err, field_e type);
 
-static void object_array_key_columns_create(struct vector ofType(struct columndoc_group) *columns);
-
 static struct columndoc_column *object_array_key_columns_find_or_new(
         struct vector ofType(struct columndoc_group) *columns, field_sid_t array_key,
         field_sid_t nested_object_entry_key, field_e nested_object_entry_type);
@@ -41,8 +39,28 @@ static struct columndoc_column *object_array_key_columns_find_or_new(
 static bool object_array_key_column_push(struct columndoc_column *col, struct err *err, const struct doc_entries *entry,
         u32 array_idx, struct strdic *dic, struct columndoc_obj *model);
 
+/** placeholder for vectors of a columndoc_obj that are not created yet, must never be written */
+static struct vector empty_vector;
+
+static struct vector *object_vec(struct columndoc_obj *model, struct vector **vec, size_t elem_size)
+{
+        if (*vec == &empty_vector) {
+                *vec = alloc_malloc(&model->parent->alloc, sizeof(struct vector));
+                vec_create(*vec, &model->parent->alloc, elem_size, 4);
+        }
+        return *vec;
+}
+
+static void object_vec_drop(struct columndoc_obj *model, struct vector *vec)
+{
+        if (vec != &empty_vector) {
+                vec_drop(vec);
+                alloc_free(&model->parent->alloc, vec);
+        }
+}
+
 bool columndoc_create(struct columndoc *columndoc, struct err *err, const struct doc *doc, const struct doc_bulk *bulk,
-        const struct doc_entries *entries, struct strdic *dic)
+        const struct doc_entries *entries, struct strdic *dic, const struct allocator *alloc)
 {
         error_if_null(columndoc)
         error_if_null(doc)
@@ -52,6 +70,7 @@ bool columndoc_create(struct columndoc *columndoc, struct err *err, const struct
         columndoc->dic = dic;
         columndoc->doc = doc;
         columndoc->bulk = bulk;
+        alloc_this_or_std(&columndoc->alloc, alloc);
         error_init(&columndoc->err);
 
         const char *root_string = "/";
@@ -73,200 +92,77 @@ bool columndoc_create(struct columndoc *columndoc, struct err *err, const struct
 
 static void object_array_key_columns_drop(struct vector ofType(struct columndoc_group) *columns);
 
-static void object_meta_model_free(struct columndoc_obj *columndoc)
+static void object_array_vals_drop(struct columndoc_obj *model, struct vector ofType(Vector) *values)
 {
-        vec_drop(&columndoc->bool_prop_keys);
-        vec_drop(&columndoc->int8_prop_keys);
-        vec_drop(&columndoc->int16_prop_keys);
-        vec_drop(&columndoc->int32_prop_keys);
-        vec_drop(&columndoc->int64_prop_keys);
-        vec_drop(&columndoc->uint8_prop_keys);
-        vec_drop(&columndoc->uint16_prop_keys);
-        vec_drop(&columndoc->uin32_prop_keys);
-        vec_drop(&columndoc->uint64_prop_keys);
-        vec_drop(&columndoc->string_prop_keys);
-        vec_drop(&columndoc->float_prop_keys);
-        vec_drop(&columndoc->null_prop_keys);
-        vec_drop(&columndoc->obj_prop_keys);
-
-        vec_drop(&columndoc->bool_array_prop_keys);
-        vec_drop(&columndoc->int8_array_prop_keys);
-        vec_drop(&columndoc->int16_array_prop_keys);
-        vec_drop(&columndoc->int32_array_prop_keys);
-        vec_drop(&columndoc->int64_array_prop_keys);
-        vec_drop(&columndoc->uint8_array_prop_keys);
-        vec_drop(&columndoc->uint16_array_prop_keys);
-        vec_drop(&columndoc->uint32_array_prop_keys);
-        vec_drop(&columndoc->uint64_array_prop_keys);
-        vec_drop(&columndoc->string_array_prop_keys);
-        vec_drop(&columndoc->float_array_prop_keys);
-        vec_drop(&columndoc->null_array_prop_keys);
-
-        vec_drop(&columndoc->bool_prop_vals);
-        vec_drop(&columndoc->int8_prop_vals);
-        vec_drop(&columndoc->int16_prop_vals);
-        vec_drop(&columndoc->int32_prop_vals);
-        vec_drop(&columndoc->int64_prop_vals);
-        vec_drop(&columndoc->uint8_prop_vals);
-        vec_drop(&columndoc->uint16_prop_vals);
-        vec_drop(&columndoc->uint32_prop_vals);
-        vec_drop(&columndoc->uint64_prop_vals);
-        vec_drop(&columndoc->float_prop_vals);
-        vec_drop(&columndoc->string_prop_vals);
-
-        for (size_t i = 0; i < columndoc->bool_array_prop_vals.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->bool_array_prop_vals, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->bool_array_prop_vals);
-
-        for (size_t i = 0; i < columndoc->int8_array_prop_vals.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->int8_array_prop_vals, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->int8_array_prop_vals);
-
-        for (size_t i = 0; i < columndoc->int16_array_prop_vals.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->int16_array_prop_vals, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->int16_array_prop_vals);
-
-        for (size_t i = 0; i < columndoc->int32_array_prop_vals.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->int32_array_prop_vals, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->int32_array_prop_vals);
-
-        for (size_t i = 0; i < columndoc->int64_array_prop_vals.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->int64_array_prop_vals, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->int64_array_prop_vals);
-
-        for (size_t i = 0; i < columndoc->uint8_array_prop_vals.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->uint8_array_prop_vals, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->uint8_array_prop_vals);
-
-        for (size_t i = 0; i < columndoc->uint16_array_prop_vals.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->uint16_array_prop_vals, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->uint16_array_prop_vals);
-
-        for (size_t i = 0; i < columndoc->uint32_array_prop_vals.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->uint32_array_prop_vals, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->uint32_array_prop_vals);
-
-        for (size_t i = 0; i < columndoc->ui64_array_prop_vals.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->ui64_array_prop_vals, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->ui64_array_prop_vals);
-
-        for (size_t i = 0; i < columndoc->float_array_prop_vals.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->float_array_prop_vals, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->float_array_prop_vals);
-
-        for (size_t i = 0; i < columndoc->string_array_prop_vals.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->string_array_prop_vals, i, struct vector);
+        for (size_t i = 0; i < values->num_elems; i++) {
+                struct vector *vec = vec_get(values, i, struct vector);
                 vec_drop(vec);
         }
-        vec_drop(&columndoc->string_array_prop_vals);
-
-        vec_drop(&columndoc->null_array_prop_vals);
-
-        vec_drop(&columndoc->bool_val_idxs);
-        vec_drop(&columndoc->int8_val_idxs);
-        vec_drop(&columndoc->int16_val_idxs);
-        vec_drop(&columndoc->int32_val_idxs);
-        vec_drop(&columndoc->int64_val_idxs);
-        vec_drop(&columndoc->uint8_val_idxs);
-        vec_drop(&columndoc->uint16_val_idxs);
-        vec_drop(&columndoc->uint32_val_idxs);
-        vec_drop(&columndoc->uint64_val_idxs);
-        vec_drop(&columndoc->float_val_idxs);
-        vec_drop(&columndoc->string_val_idxs);
-
-        for (size_t i = 0; i < columndoc->bool_array_idxs.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->bool_array_idxs, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->bool_array_idxs);
-
-        for (size_t i = 0; i < columndoc->int8_array_idxs.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->int8_array_idxs, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->int8_array_idxs);
-
-        for (size_t i = 0; i < columndoc->int16_array_idxs.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->int16_array_idxs, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->int16_array_idxs);
-
-        for (size_t i = 0; i < columndoc->int32_array_idxs.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->int32_array_idxs, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->int32_array_idxs);
-
-        for (size_t i = 0; i < columndoc->int64_array_idxs.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->int64_array_idxs, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->int64_array_idxs);
-
-        for (size_t i = 0; i < columndoc->uint8_array_idxs.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->uint8_array_idxs, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->uint8_array_idxs);
-
-        for (size_t i = 0; i < columndoc->uint16_array_idxs.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->uint16_array_idxs, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->uint16_array_idxs);
-
-        for (size_t i = 0; i < columndoc->uint32_array_idxs.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->uint32_array_idxs, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->uint32_array_idxs);
-
-        for (size_t i = 0; i < columndoc->uint64_array_idxs.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->uint64_array_idxs, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->uint64_array_idxs);
-
-        for (size_t i = 0; i < columndoc->float_array_idxs.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->float_array_idxs, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->float_array_idxs);
-
-        for (size_t i = 0; i < columndoc->string_array_idxs.num_elems; i++) {
-                struct vector *vec = vec_get(&columndoc->string_array_idxs, i, struct vector);
-                vec_drop(vec);
-        }
-        vec_drop(&columndoc->string_array_idxs);
+        object_vec_drop(model, values);
+}
 
-        for (size_t i = 0; i < columndoc->obj_prop_vals.num_elems; i++) {
-                struct columndoc_obj *object = vec_get(&columndoc->obj_prop_vals, i, struct columndoc_obj);
+static void object_meta_model_free(struct columndoc_obj *columndoc)
+{
+        object_vec_drop(columndoc, columndoc->bool_prop_keys);
+        object_vec_drop(columndoc, columndoc->int8_prop_keys);
+        object_vec_drop(columndoc, columndoc->int16_prop_keys);
+        object_vec_drop(columndoc, columndoc->int32_prop_keys);
+        object_vec_drop(columndoc, columndoc->int64_prop_keys);
+        object_vec_drop(columndoc, columndoc->uint8_prop_keys);
+        object_vec_drop(columndoc, columndoc->uint16_prop_keys);
+        object_vec_drop(columndoc, columndoc->uin32_prop_keys);
+        object_vec_drop(columndoc, columndoc->uint64_prop_keys);
+        object_vec_drop(columndoc, columndoc->string_prop_keys);
+        object_vec_drop(columndoc, columndoc->float_prop_keys);
+        object_vec_drop(columndoc, columndoc->null_prop_keys);
+        object_vec_drop(columndoc, columndoc->obj_prop_keys);
+
+        object_vec_drop(columndoc, columndoc->bool_array_prop_keys);
+        object_vec_drop(columndoc, columndoc->int8_array_prop_keys);
+        object_vec_drop(columndoc, columndoc->int16_array_prop_keys);
+        object_vec_drop(columndoc, columndoc->int32_array_prop_keys);
+        object_vec_drop(columndoc, columndoc->int64_array_prop_keys);
+        object_vec_drop(columndoc, columndoc->uint8_array_prop_keys);
+        object_vec_drop(columndoc, columndoc->uint16_array_prop_keys);
+        object_vec_drop(columndoc, columndoc->uint32_array_prop_keys);
+        object_vec_drop(columndoc, columndoc->uint64_array_prop_keys);
+        object_vec_drop(columndoc, columndoc->string_array_prop_keys);
+        object_vec_drop(columndoc, columndoc->float_array_prop_keys);
+        object_vec_drop(columndoc, columndoc->null_array_prop_keys);
+
+        object_vec_drop(columndoc, columndoc->bool_prop_vals);
+        object_vec_drop(columndoc, columndoc->int8_prop_vals);
+        object_vec_drop(columndoc, columndoc->int16_prop_vals);
+        object_vec_drop(columndoc, columndoc->int32_prop_vals);
+        object_vec_drop(columndoc, columndoc->int64_prop_vals);
+        object_vec_drop(columndoc, columndoc->uint8_prop_vals);
+        object_vec_drop(columndoc, columndoc->uint16_prop_vals);
+        object_vec_drop(columndoc, columndoc->uint32_prop_vals);
+        object_vec_drop(columndoc, columndoc->uint64_prop_vals);
+        object_vec_drop(columndoc, columndoc->float_prop_vals);
+        object_vec_drop(columndoc, columndoc->string_prop_vals);
+
+        object_array_vals_drop(columndoc, columndoc->bool_array_prop_vals);
+        object_array_vals_drop(columndoc, columndoc->int8_array_prop_vals);
+        object_array_vals_drop(columndoc, columndoc->int16_array_prop_vals);
+        object_array_vals_drop(columndoc, columndoc->int32_array_prop_vals);
+        object_array_vals_drop(columndoc, columndoc->int64_array_prop_vals);
+        object_array_vals_drop(columndoc, columndoc->uint8_array_prop_vals);
+        object_array_vals_drop(columndoc, columndoc->uint16_array_prop_vals);
+        object_array_vals_drop(columndoc, columndoc->uint32_array_prop_vals);
+        object_array_vals_drop(columndoc, columndoc->ui64_array_prop_vals);
+        object_array_vals_drop(columndoc, columndoc->float_array_prop_vals);
+        object_array_vals_drop(columndoc, columndoc->string_array_prop_vals);
+        object_vec_drop(columndoc, columndoc->null_array_prop_vals);
+
+        for (size_t i = 0; i < columndoc->obj_prop_vals->num_elems; i++) {
+                struct columndoc_obj *object = vec_get(columndoc->obj_prop_vals, i, struct columndoc_obj);
                 object_meta_model_free(object);
         }
-        vec_drop(&columndoc->obj_prop_vals);
+        object_vec_drop(columndoc, columndoc->obj_prop_vals);
 
-        object_array_key_columns_drop(&columndoc->obj_array_props);
+        object_array_key_columns_drop(columndoc->obj_array_props);
+        object_vec_drop(columndoc, columndoc->obj_array_props);
 }
 
 bool columndoc_free(struct columndoc *doc)
@@ -297,7 +193,7 @@ bool columndoc_free(struct columndoc *doc)
     }                                                                                                                  \
 }                                                                                                                      \
 
-#define PRINT_PRIMITIVE_COLUMN(file, type_name, key_vector, value_vector, keyIndicesVector, dic, TYPE, FORMAT_STR)     \
+#define PRINT_PRIMITIVE_COLUMN(file, type_name, key_vector, value_vector, dic, TYPE, FORMAT_STR)                       \
 {                                                                                                                      \
     PRINT_PRIMITIVE_KEY_PART(file, type_name, key_vector, dic, ", ")                                                   \
     if(!vec_is_empty((key_vector))) {                                                                           \
@@ -355,24 +251,24 @@ static bool print_primitive_objects(FILE *file, struct err *err, const char *typ
 #define PRINT_ARRAY(file, type_name, key_vector, value_vector, TYPE, TYPE_FORMAT, nonnull_expr)                        \
 {                                                                                                                      \
     fprintf(file, "\"%s\": { ", type_name);                                                                            \
-    if(!vec_is_empty((&key_vector))) {                                                                          \
+    if(!vec_is_empty((key_vector))) {                                                                          \
         fprintf(file, "\"Keys\": [ ");                                                                                 \
-        for (size_t i = 0; i < (&key_vector)->num_elems; i++) {                                                        \
-            field_sid_t string_id = *vec_get((&key_vector), i, field_sid_t);                   \
-            fprintf(file, "%"PRIu64"%s", string_id, i + 1 < (&key_vector)->num_elems ? ", " : "");                     \
+        for (size_t i = 0; i < (key_vector)->num_elems; i++) {                                                        \
+            field_sid_t string_id = *vec_get((key_vector), i, field_sid_t);                   \
+            fprintf(file, "%"PRIu64"%s", string_id, i + 1 < (key_vector)->num_elems ? ", " : "");                     \
         }                                                                                                              \
         fprintf(file, "], ");                                                                                          \
         fprintf(file, "\"Keys Decoded\": [ ");                                                                         \
-        for (size_t i = 0; i < (&key_vector)->num_elems; i++) {                                                        \
-            field_sid_t string_id = *vec_get((&key_vector), i, field_sid_t);                   \
+        for (size_t i = 0; i < (key_vector)->num_elems; i++) {                                                        \
+            field_sid_t string_id = *vec_get((key_vector), i, field_sid_t);                   \
             char **encString = strdic_extract(dic, &string_id, 1);                                              \
-            fprintf(file, "\"%s\"%s", encString[0], i + 1 < (&key_vector)->num_elems ? ", " : "");                     \
+            fprintf(file, "\"%s\"%s", encString[0], i + 1 < (key_vector)->num_elems ? ", " : "");                     \
             strdic_free(dic, encString);                                                                        \
         }                                                                                                              \
         fprintf(file, "],");                                                                                           \
         fprintf(file, "\"Values\": [ ");                                                                               \
-        for (size_t i = 0; i < (&value_vector)->num_elems; i++) {                                                      \
-            const struct vector ofType(TYPE) *values = vec_get(&value_vector, i, struct vector);               \
+        for (size_t i = 0; i < (value_vector)->num_elems; i++) {                                                      \
+            const struct vector ofType(TYPE) *values = vec_get(value_vector, i, struct vector);               \
             fprintf(file, "[ ");                                                                                       \
             for (size_t j = 0; j < values->num_elems; j++) {                                                           \
                 TYPE value = *vec_get(values, j, TYPE);                                                      \
@@ -382,7 +278,7 @@ static bool print_primitive_objects(FILE *file, struct err *err, const char *typ
                     fprintf(file, NG5_NULL_TEXT "%s", j + 1 < values->num_elems ? ", " : "");                       \
                 }                                                                                                      \
             }                                                                                                          \
-            fprintf(file, "]%s ", i + 1 < (&value_vector)->num_elems ? "," : "");                                      \
+            fprintf(file, "]%s ", i + 1 < (value_vector)->num_elems ? "," : "");                                      \
         }                                                                                                              \
         fprintf(file, "]");                                                                                            \
     }                                                                                                                  \
@@ -392,30 +288,30 @@ static bool print_primitive_objects(FILE *file, struct err *err, const char *typ
 #define PRINT_BOOLEAN_ARRAY(file, type_name, key_vector, value_vector)                                                 \
 {                                                                                                                      \
     fprintf(file, "\"%s\": { ", "Boolean");                                                                            \
-    if(!vec_is_empty((&key_vector))) {                                                                          \
+    if(!vec_is_empty((key_vector))) {                                                                          \
         fprintf(file, "\"Keys\": [ ");                                                                                 \
-        for (size_t i = 0; i < (&key_vector)->num_elems; i++) {                                                        \
-            field_sid_t string_id = *vec_get((&key_vector), i, field_sid_t);                   \
-            fprintf(file, "%"PRIu64"%s", string_id, i + 1 < (&key_vector)->num_elems ? ", " : "");                     \
+        for (size_t i = 0; i < (key_vector)->num_elems; i++) {                                                        \
+            field_sid_t string_id = *vec_get((key_vector), i, field_sid_t);                   \
+            fprintf(file, "%"PRIu64"%s", string_id, i + 1 < (key_vector)->num_elems ? ", " : "");                     \
         }                                                                                                              \
         fprintf(file, "], ");                                                                                          \
         fprintf(file, "\"Keys Decoded\": [ ");                                                                         \
-        for (size_t i = 0; i < (&key_vector)->num_elems; i++) {                                                        \
-            field_sid_t string_id = *vec_get((&key_vector), i, field_sid_t);                   \
+        for (size_t i = 0; i < (key_vector)->num_elems; i++) {                                                        \
+            field_sid_t string_id = *vec_get((key_vector), i, field_sid_t);                   \
             char **encString = strdic_extract(dic, &string_id, 1);                                              \
-            fprintf(file, "\"%s\"%s", encString[0], i + 1 < (&key_vector)->num_elems ? ", " : "");                     \
+            fprintf(file, "\"%s\"%s", encString[0], i + 1 < (key_vector)->num_elems ? ", " : "");                     \
             strdic_free(dic, encString);                                                                        \
         }                                                                                                              \
         fprintf(file, "],");                                                                                           \
         fprintf(file, "\"Values\": [ ");                                                                               \
-        for (size_t i = 0; i < (&value_vector)->num_elems; i++) {                                                      \
-            const struct vector ofType(FIELD_BOOLEANean_t) *values = vec_get(&value_vector, i, struct vector);      \
+        for (size_t i = 0; i < (value_vector)->num_elems; i++) {                                                      \
+            const struct vector ofType(FIELD_BOOLEANean_t) *values = vec_get(value_vector, i, struct vector);      \
             fprintf(file, "[ ");                                                                                       \
             for (size_t j = 0; j < values->num_elems; j++) {                                                           \
                 FIELD_BOOLEANean_t value = *vec_get(values, j, FIELD_BOOLEANean_t);                                    \
                 fprintf(file, "%s%s", value == 0 ? "false" : "true", j + 1 < values->num_elems ? ", " : "");           \
             }                                                                                                          \
-            fprintf(file, "]%s ", i + 1 < (&value_vector)->num_elems ? "," : "");                                      \
+            fprintf(file, "]%s ", i + 1 < (value_vector)->num_elems ? "," : "");                                      \
         }                                                                                                              \
         fprintf(file, "]");                                                                                            \
     }                                                                                                                  \
@@ -698,84 +594,75 @@ static bool print_object(FILE *file, struct err *err, const struct columndoc_obj
                 object->index);
         fprintf(file, "\"Pairs\": { ");
         fprintf(file, "\"Primitives\": { ");
-        PRINT_PRIMITIVE_BOOLEAN_COLUMN(file, "Boolean", &object->bool_prop_keys, &object->bool_prop_vals, dic)
+        PRINT_PRIMITIVE_BOOLEAN_COLUMN(file, "Boolean", object->bool_prop_keys, object->bool_prop_vals, dic)
         PRINT_PRIMITIVE_COLUMN(file,
                 "UInt8",
-                &object->uint8_prop_keys,
-                &object->uint8_prop_vals,
-                &object->uint8_val_idxs,
+                object->uint8_prop_keys,
+                object->uint8_prop_vals,
                 dic,
                 field_u8_t,
                 "%d")
         PRINT_PRIMITIVE_COLUMN(file,
                 "UInt16",
-                &object->uint16_prop_keys,
-                &object->uint16_prop_vals,
-                &object->uint16_val_idxs,
+                object->uint16_prop_keys,
+                object->uint16_prop_vals,
                 dic,
                 field_u16_t,
                 "%d")
         PRINT_PRIMITIVE_COLUMN(file,
                 "UInt32",
-                &object->uin32_prop_keys,
-                &object->uint32_prop_vals,
-                &object->uint32_val_idxs,
+                object->uin32_prop_keys,
+                object->uint32_prop_vals,
                 dic,
                 field_u32_t,
                 "%d")
         PRINT_PRIMITIVE_COLUMN(file,
                 "UInt64",
-                &object->uint64_prop_keys,
-                &object->uint64_prop_vals,
-                &object->uint64_val_idxs,
+                object->uint64_prop_keys,
+                object->uint64_prop_vals,
                 dic,
                 field_u64_t,
                 "%"
                 PRIu64)
         PRINT_PRIMITIVE_COLUMN(file,
                 "Int8",
-                &object->int8_prop_keys,
-                &object->int8_prop_vals,
-                &object->int8_val_idxs,
+                object->int8_prop_keys,
+                object->int8_prop_vals,
                 dic,
                 field_i8_t,
                 "%d")
         PRINT_PRIMITIVE_COLUMN(file,
                 "Int16",
-                &object->int16_prop_keys,
-                &object->int16_prop_vals,
-                &object->int16_val_idxs,
+                object->int16_prop_keys,
+                object->int16_prop_vals,
                 dic,
                 field_i16_t,
                 "%d")
         PRINT_PRIMITIVE_COLUMN(file,
                 "Int32",
-                &object->int32_prop_keys,
-                &object->int32_prop_vals,
-                &object->int32_val_idxs,
+                object->int32_prop_keys,
+                object->int32_prop_vals,
                 dic,
                 field_i32_t,
                 "%d")
         PRINT_PRIMITIVE_COLUMN(file,
                 "Int64",
-                &object->int64_prop_keys,
-                &object->int64_prop_vals,
-                &object->int64_val_idxs,
+                object->int64_prop_keys,
+                object->int64_prop_vals,
                 dic,
                 field_i64_t,
                 "%"
                 PRIi64)
         PRINT_PRIMITIVE_COLUMN(file,
                 "Real",
-                &object->float_prop_keys,
-                &object->float_prop_vals,
-                &object->float_val_idxs,
+                object->float_prop_keys,
+                object->float_prop_vals,
                 dic,
                 field_number_t,
                 "%f")
-        print_primitive_strings(file, "Strings", &object->string_prop_keys, &object->string_prop_vals, dic);
-        print_primitive_null(file, "Null", &object->null_prop_keys, dic);
-        if (print_primitive_objects(file, err, "Objects", &object->obj_prop_keys, &object->obj_prop_vals, dic)) {
+        print_primitive_strings(file, "Strings", object->string_prop_keys, object->string_prop_vals, dic);
+        print_primitive_null(file, "Null", object->null_prop_keys, dic);
+        if (print_primitive_objects(file, err, "Objects", object->obj_prop_keys, object->obj_prop_vals, dic)) {
                 return false;
         }
         fprintf(file, "}, ");
@@ -834,9 +721,9 @@ static bool print_object(FILE *file, struct err *err, const struct columndoc_obj
                 field_number_t,
                 "%f",
                 (!isnan(value)));
-        print_array_strings(file, "Strings", &object->string_array_prop_keys, &object->string_array_prop_vals, dic);
-        print_array_null(file, "Null", &object->null_array_prop_keys, &object->null_array_prop_vals, dic);
-        if (!print_array_objects(file, err, "Objects", &object->obj_array_props, dic)) {
+        print_array_strings(file, "Strings", object->string_array_prop_keys, object->string_array_prop_vals, dic);
+        print_array_null(file, "Null", object->null_array_prop_keys, object->null_array_prop_vals, dic);
+        if (!print_array_objects(file, err, "Objects", object->obj_array_props, dic)) {
                 return false;
         }
         fprintf(file, "} ");
@@ -859,11 +746,6 @@ bool columndoc_drop(struct columndoc *doc)
         NG5_NOT_IMPLEMENTED
 }
 
-static void object_array_key_columns_create(struct vector ofType(struct columndoc_group) *columns)
-{
-        vec_create(columns, NULL, sizeof(struct columndoc_group), 20000);
-}
-
 static void object_array_key_columns_drop(struct vector ofType(struct columndoc_group) *columns)
 {
         for (size_t i = 0; i < columns->num_elems; i++) {
@@ -896,7 +778,6 @@ static void object_array_key_columns_drop(struct vector ofType(struct columndoc_
                 }
                 vec_drop(&array_columns->columns);
         }
-        vec_drop(columns);
 }
 
 static const char *get_type_name(struct err *err, field_e type)
@@ -963,14 +844,14 @@ static struct columndoc_column *object_array_key_columns_find_or_new(
          * return that newly created column */
         key_columns = vec_new_and_get(columns, struct columndoc_group);
         key_columns->key = array_key;
-        vec_create(&key_columns->columns, NULL, sizeof(struct columndoc_column), 10);
+        vec_create(&key_columns->columns, columns->allocator, sizeof(struct columndoc_column), 10);
 
         objectArrayKeyColumnsNewColumn:
         new_column = vec_new_and_get(&key_columns->columns, struct columndoc_column);
         new_column->key_name = nested_object_entry_key;
         new_column->type = nested_object_entry_type;
-        vec_create(&new_column->values, NULL, sizeof(struct vector), 10);
-        vec_create(&new_column->array_positions, NULL, sizeof(u32), 10);
+        vec_create(&new_column->values, columns->allocator, sizeof(struct vector), 10);
+        vec_create(&new_column->array_positions, columns->allocator, sizeof(u32), 10);
 
         return new_column;
 }
@@ -984,7 +865,7 @@ static bool object_array_key_column_push(struct columndoc_column *col, struct er
         *entry_array_idx = array_idx;
 
         struct vector ofType(<T>) *values_for_entry = vec_new_and_get(&col->values, struct vector);
-        vec_create(values_for_entry, NULL, GET_TYPE_SIZE(entry->type), entry->values.num_elems);
+        vec_create(values_for_entry, col->values.allocator, GET_TYPE_SIZE(entry->type), entry->values.num_elems);
 
         bool is_null_by_def = entry->values.num_elems == 0;
         u32 num_elements = (u32) entry->values.num_elems;
@@ -1051,85 +932,66 @@ static void setup_object(struct columndoc_obj *model, struct columndoc *parent,
         model->parent_key = key;
         model->index = idx;
 
-        vec_create(&model->bool_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->int8_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->int16_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->int32_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->int64_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->uint8_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->uint16_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->uin32_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->uint64_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->string_prop_keys, NULL, sizeof(field_sid_t), 50);
-        vec_create(&model->float_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->null_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->obj_prop_keys, NULL, sizeof(field_sid_t), 10);
-
-        vec_create(&model->bool_array_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->int8_array_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->int16_array_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->int32_array_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->int64_array_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->uint8_array_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->uint16_array_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->uint32_array_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->uint64_array_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->string_array_prop_keys, NULL, sizeof(field_sid_t), 50);
-        vec_create(&model->float_array_prop_keys, NULL, sizeof(field_sid_t), 10);
-        vec_create(&model->null_array_prop_keys, NULL, sizeof(field_sid_t), 10);
-
-        vec_create(&model->bool_prop_vals, NULL, sizeof(FIELD_BOOLEANean_t), 10);
-        vec_create(&model->int8_prop_vals, NULL, sizeof(field_i8_t), 10);
-        vec_create(&model->int16_prop_vals, NULL, sizeof(field_i16_t), 10);
-        vec_create(&model->int32_prop_vals, NULL, sizeof(field_i32_t), 10);
-        vec_create(&model->int64_prop_vals, NULL, sizeof(field_i64_t), 10);
-        vec_create(&model->uint8_prop_vals, NULL, sizeof(field_u8_t), 10);
-        vec_create(&model->uint16_prop_vals, NULL, sizeof(field_u16_t), 10);
-        vec_create(&model->uint32_prop_vals, NULL, sizeof(field_u32_t), 10);
-        vec_create(&model->uint64_prop_vals, NULL, sizeof(field_u64_t), 10);
-        vec_create(&model->float_prop_vals, NULL, sizeof(field_number_t), 10);
-        vec_create(&model->string_prop_vals, NULL, sizeof(field_sid_t), 50);
-
-        vec_create(&model->bool_array_prop_vals, NULL, sizeof(struct vector), 10);
-        vec_create(&model->int8_array_prop_vals, NULL, sizeof(struct vector), 10);
-        vec_create(&model->int16_array_prop_vals, NULL, sizeof(struct vector), 10);
-        vec_create(&model->int32_array_prop_vals, NULL, sizeof(struct vector), 10);
-        vec_create(&model->int64_array_prop_vals, NULL, sizeof(struct vector), 10);
-        vec_create(&model->uint8_array_prop_vals, NULL, sizeof(struct vector), 10);
-        vec_create(&model->uint16_array_prop_vals, NULL, sizeof(struct vector), 10);
-        vec_create(&model->uint32_array_prop_vals, NULL, sizeof(struct vector), 10);
-        vec_create(&model->ui64_array_prop_vals, NULL, sizeof(struct vector), 10);
-        vec_create(&model->float_array_prop_vals, NULL, sizeof(struct vector), 10);
-        vec_create(&model->string_array_prop_vals, NULL, sizeof(struct vector), 50);
-        vec_create(&model->null_array_prop_vals, NULL, sizeof(u16), 10);
-
-        vec_create(&model->bool_val_idxs, NULL, sizeof(u32), 10);
-        vec_create(&model->int8_val_idxs, NULL, sizeof(u32), 10);
-        vec_create(&model->int16_val_idxs, NULL, sizeof(u32), 10);
-        vec_create(&model->int32_val_idxs, NULL, sizeof(u32), 10);
-        vec_create(&model->int64_val_idxs, NULL, sizeof(u32), 10);
-        vec_create(&model->uint8_val_idxs, NULL, sizeof(u32), 10);
-        vec_create(&model->uint16_val_idxs, NULL, sizeof(u32), 10);
-        vec_create(&model->uint32_val_idxs, NULL, sizeof(u32), 10);
-        vec_create(&model->uint64_val_idxs, NULL, sizeof(u32), 10);
-        vec_create(&model->float_val_idxs, NULL, sizeof(u32), 10);
-        vec_create(&model->string_val_idxs, NULL, sizeof(u32), 50);
-
-        vec_create(&model->bool_array_idxs, NULL, sizeof(struct vector), 10);
-        vec_create(&model->int8_array_idxs, NULL, sizeof(struct vector), 10);
-        vec_create(&model->int16_array_idxs, NULL, sizeof(struct vector), 10);
-        vec_create(&model->int32_array_idxs, NULL, sizeof(struct vector), 10);
-        vec_create(&model->int64_array_idxs, NULL, sizeof(struct vector), 10);
-        vec_create(&model->uint8_array_idxs, NULL, sizeof(struct vector), 10);
-        vec_create(&model->uint16_array_idxs, NULL, sizeof(struct vector), 10);
-        vec_create(&model->uint32_array_idxs, NULL, sizeof(struct vector), 10);
-        vec_create(&model->uint64_array_idxs, NULL, sizeof(struct vector), 10);
-        vec_create(&model->float_array_idxs, NULL, sizeof(struct vector), 10);
-        vec_create(&model->string_array_idxs, NULL, sizeof(struct vector), 50);
-
-        vec_create(&model->obj_prop_vals, NULL, sizeof(struct columndoc_obj), 10);
-
-        object_array_key_columns_create(&model->obj_array_props);
+        model->bool_prop_keys = &empty_vector;
+        model->int8_prop_keys = &empty_vector;
+        model->int16_prop_keys = &empty_vector;
+        model->int32_prop_keys = &empty_vector;
+        model->int64_prop_keys = &empty_vector;
+        model->uint8_prop_keys = &empty_vector;
+        model->uint16_prop_keys = &empty_vector;
+        model->uin32_prop_keys = &empty_vector;
+        model->uint64_prop_keys = &empty_vector;
+        model->string_prop_keys = &empty_vector;
+        model->float_prop_keys = &empty_vector;
+        model->null_prop_keys = &empty_vector;
+        model->obj_prop_keys = &empty_vector;
+
+        model->bool_array_prop_keys = &empty_vector;
+        model->int8_array_prop_keys = &empty_vector;
+        model->int16_array_prop_keys = &empty_vector;
+        model->int32_array_prop_keys = &empty_vector;
+        model->int64_array_prop_keys = &empty_vector;
+        model->uint8_array_prop_keys = &empty_vector;
+        model->uint16_array_prop_keys = &empty_vector;
+        model->uint32_array_prop_keys = &empty_vector;
+        model->uint64_array_prop_keys = &empty_vector;
+        model->string_array_prop_keys = &empty_vector;
+        model->float_array_prop_keys = &empty_vector;
+        model->null_array_prop_keys = &empty_vector;
+
+        model->bool_prop_vals = &empty_vector;
+        model->int8_prop_vals = &empty_vector;
+        model->int16_prop_vals = &empty_vector;
+        model->int32_prop_vals = &empty_vector;
+        model->int64_prop_vals = &empty_vector;
+        model->uint8_prop_vals = &empty_vector;
+        model->uint16_prop_vals = &empty_vector;
+        model->uint32_prop_vals = &empty_vector;
+        model->uint64_prop_vals = &empty_vector;
+        model->float_prop_vals = &empty_vector;
+        model->string_prop_vals = &empty_vector;
+
+        model->bool_array_prop_vals = &empty_vector;
+        model->int8_array_prop_vals = &empty_vector;
+        model->int16_array_prop_vals = &empty_vector;
+        model->int32_array_prop_vals = &empty_vector;
+        model->int64_array_prop_vals = &empty_vector;
+        model->uint8_array_prop_vals = &empty_vector;
+        model->uint16_array_prop_vals = &empty_vector;
+        model->uint32_array_prop_vals = &empty_vector;
+        model->ui64_array_prop_vals = &empty_vector;
+        model->float_array_prop_vals = &empty_vector;
+        model->string_array_prop_vals = &empty_vector;
+        model->null_array_prop_vals = &empty_vector;
+        model->obj_prop_vals = &empty_vector;
+        model->obj_array_props = &empty_vector;
+}
+
+static void object_push_primitive(struct columndoc_obj *model, struct vector ofType(field_sid_t) **keys,
+        struct vector ofType(<T>) **values, const field_sid_t *key_id, const void *value, size_t value_size)
+{
+        vec_push(object_vec(model, keys, sizeof(field_sid_t)), key_id, 1);
+        vec_push(object_vec(model, values, value_size), value, 1);
 }
 
 static bool object_put_primitive(struct columndoc_obj *columndoc, struct err *err, const struct doc_entries *entry,
@@ -1137,62 +999,62 @@ static bool object_put_primitive(struct columndoc_obj *columndoc, struct err *er
 {
         switch (entry->type) {
         case FIELD_NULL:
-                vec_push(&columndoc->null_prop_keys, key_id, 1);
+                vec_push(object_vec(columndoc, &columndoc->null_prop_keys, sizeof(field_sid_t)), key_id, 1);
                 break;
         case FIELD_BOOLEAN:
-                vec_push(&columndoc->bool_prop_keys, key_id, 1);
-                vec_push(&columndoc->bool_prop_vals, entry->values.base, 1);
+                object_push_primitive(columndoc, &columndoc->bool_prop_keys, &columndoc->bool_prop_vals, key_id,
+                        entry->values.base, sizeof(FIELD_BOOLEANean_t));
                 break;
         case FIELD_INT8:
-                vec_push(&columndoc->int8_prop_keys, key_id, 1);
-                vec_push(&columndoc->int8_prop_vals, entry->values.base, 1);
+                object_push_primitive(columndoc, &columndoc->int8_prop_keys, &columndoc->int8_prop_vals, key_id,
+                        entry->values.base, sizeof(field_i8_t));
                 break;
         case FIELD_INT16:
-                vec_push(&columndoc->int16_prop_keys, key_id, 1);
-                vec_push(&columndoc->int16_prop_vals, entry->values.base, 1);
+                object_push_primitive(columndoc, &columndoc->int16_prop_keys, &columndoc->int16_prop_vals, key_id,
+                        entry->values.base, sizeof(field_i16_t));
                 break;
         case FIELD_INT32:
-                vec_push(&columndoc->int32_prop_keys, key_id, 1);
-                vec_push(&columndoc->int32_prop_vals, entry->values.base, 1);
+                object_push_primitive(columndoc, &columndoc->int32_prop_keys, &columndoc->int32_prop_vals, key_id,
+                        entry->values.base, sizeof(field_i32_t));
                 break;
         case FIELD_INT64:
-                vec_push(&columndoc->int64_prop_keys, key_id, 1);
-                vec_push(&columndoc->int64_prop_vals, entry->values.base, 1);
+                object_push_primitive(columndoc, &columndoc->int64_prop_keys, &columndoc->int64_prop_vals, key_id,
+                        entry->values.base, sizeof(field_i64_t));
                 break;
         case FIELD_UINT8:
-                vec_push(&columndoc->uint8_prop_keys, key_id, 1);
-                vec_push(&columndoc->uint8_prop_vals, entry->values.base, 1);
+                object_push_primitive(columndoc, &columndoc->uint8_prop_keys, &columndoc->uint8_prop_vals, key_id,
+                        entry->values.base, sizeof(field_u8_t));
                 break;
         case FIELD_UINT16:
-                vec_push(&columndoc->uint16_prop_keys, key_id, 1);
-                vec_push(&columndoc->uint16_prop_vals, entry->values.base, 1);
+                object_push_primitive(columndoc, &columndoc->uint16_prop_keys, &columndoc->uint16_prop_vals, key_id,
+                        entry->values.base, sizeof(field_u16_t));
                 break;
         case FIELD_UINT32:
-                vec_push(&columndoc->uin32_prop_keys, key_id, 1);
-                vec_push(&columndoc->uint32_prop_vals, entry->values.base, 1);
+                object_push_primitive(columndoc, &columndoc->uin32_prop_keys, &columndoc->uint32_prop_vals, key_id,
+                        entry->values.base, sizeof(field_u32_t));
                 break;
         case FIELD_UINT64:
-                vec_push(&columndoc->uint64_prop_keys, key_id, 1);
-                vec_push(&columndoc->uint64_prop_vals, entry->values.base, 1);
+                object_push_primitive(columndoc, &columndoc->uint64_prop_keys, &columndoc->uint64_prop_vals, key_id,
+                        entry->values.base, sizeof(field_u64_t));
                 break;
         case FIELD_FLOAT:
-                vec_push(&columndoc->float_prop_keys, key_id, 1);
-                vec_push(&columndoc->float_prop_vals, entry->values.base, 1);
+                object_push_primitive(columndoc, &columndoc->float_prop_keys, &columndoc->float_prop_vals, key_id,
+                        entry->values.base, sizeof(field_number_t));
                 break;
         case FIELD_STRING: {
                 field_sid_t *value;
                 strdic_locate_fast(&value, dic, (char *const *) entry->values.base, 1);
-                vec_push(&columndoc->string_prop_keys, key_id, 1);
-                vec_push(&columndoc->string_prop_vals, value, 1);
+                object_push_primitive(columndoc, &columndoc->string_prop_keys, &columndoc->string_prop_vals, key_id,
+                        value, sizeof(field_sid_t));
                 strdic_free(dic, value);
         }
                 break;
         case FIELD_OBJECT: {
                 struct columndoc_obj template, *nested_object;
-                size_t position = vec_length(&columndoc->obj_prop_keys);
-                vec_push(&columndoc->obj_prop_keys, key_id, 1);
-                vec_push(&columndoc->obj_prop_vals, &template, 1);
-                nested_object = vec_get(&columndoc->obj_prop_vals, position, struct columndoc_obj);
+                size_t position = vec_length(columndoc->obj_prop_keys);
+                object_push_primitive(columndoc, &columndoc->obj_prop_keys, &columndoc->obj_prop_vals, key_id,
+                        &template, sizeof(struct columndoc_obj));
+                nested_object = vec_get(columndoc->obj_prop_vals, position, struct columndoc_obj);
                 setup_object(nested_object, columndoc->parent, *key_id, 0);
                 if (!import_object(nested_object, err, vec_get(&entry->values, 0, struct doc_obj), dic)) {
                         return false;
@@ -1205,17 +1067,18 @@ static bool object_put_primitive(struct columndoc_obj *columndoc, struct err *er
         return true;
 }
 
-static void object_push_array(struct vector ofType(Vector
-        ofType( < T >)) *values, size_t TSize, u32 num_elements, const void *data, field_sid_t key_id,
-        struct vector ofType(field_sid_t) *key_vector)
+static void object_push_array(struct columndoc_obj *model, struct vector ofType(Vector
+        ofType( < T >)) **values, size_t TSize, u32 num_elements, const void *data, field_sid_t key_id,
+        struct vector ofType(field_sid_t) **key_vector)
 {
         struct vector ofType(<T>) template, *vector;
-        size_t idx = vec_length(values);
-        vec_push(values, &template, 1);
-        vector = vec_get(values, idx, struct vector);
-        vec_create(vector, NULL, TSize, num_elements);
+        struct vector *arrays = object_vec(model, values, sizeof(struct vector));
+        size_t idx = vec_length(arrays);
+        vec_push(arrays, &template, 1);
+        vector = vec_get(arrays, idx, struct vector);
+        vec_create(vector, arrays->allocator, TSize, num_elements);
         vec_push(vector, data, num_elements);
-        vec_push(key_vector, &key_id, 1);
+        vec_push(object_vec(model, key_vector, sizeof(field_sid_t)), &key_id, 1);
 }
 
 static bool object_put_array(struct columndoc_obj *model, struct err *err, const struct doc_entries *entry,
@@ -1227,12 +1090,12 @@ static bool object_put_array(struct columndoc_obj *model, struct err *err, const
 
         switch (entry->type) {
         case FIELD_NULL: {
-                vec_push(&model->null_array_prop_vals, &num_elements, 1);
-                vec_push(&model->null_array_prop_keys, key_id, 1);
+                vec_push(object_vec(model, &model->null_array_prop_vals, sizeof(u16)), &num_elements, 1);
+                vec_push(object_vec(model, &model->null_array_prop_keys, sizeof(field_sid_t)), key_id, 1);
         }
                 break;
         case FIELD_BOOLEAN:
-                object_push_array(&model->bool_array_prop_vals,
+                object_push_array(model, &model->bool_array_prop_vals,
                         sizeof(FIELD_BOOLEANean_t),
                         num_elements,
                         entry->values.base,
@@ -1240,7 +1103,7 @@ static bool object_put_array(struct columndoc_obj *model, struct err *err, const
                         &model->bool_array_prop_keys);
                 break;
         case FIELD_INT8:
-                object_push_array(&model->int8_array_prop_vals,
+                object_push_array(model, &model->int8_array_prop_vals,
                         sizeof(field_i8_t),
                         num_elements,
                         entry->values.base,
@@ -1248,7 +1111,7 @@ static bool object_put_array(struct columndoc_obj *model, struct err *err, const
                         &model->int8_array_prop_keys);
                 break;
         case FIELD_INT16:
-                object_push_array(&model->int16_array_prop_vals,
+                object_push_array(model, &model->int16_array_prop_vals,
                         sizeof(field_i16_t),
                         num_elements,
                         entry->values.base,
@@ -1256,7 +1119,7 @@ static bool object_put_array(struct columndoc_obj *model, struct err *err, const
                         &model->int16_array_prop_keys);
                 break;
         case FIELD_INT32:
-                object_push_array(&model->int32_array_prop_vals,
+                object_push_array(model, &model->int32_array_prop_vals,
                         sizeof(field_i32_t),
                         num_elements,
                         entry->values.base,
@@ -1264,7 +1127,7 @@ static bool object_put_array(struct columndoc_obj *model, struct err *err, const
                         &model->int32_array_prop_keys);
                 break;
         case FIELD_INT64:
-                object_push_array(&model->int64_array_prop_vals,
+                object_push_array(model, &model->int64_array_prop_vals,
                         sizeof(field_i64_t),
                         num_elements,
                         entry->values.base,
@@ -1272,7 +1135,7 @@ static bool object_put_array(struct columndoc_obj *model, struct err *err, const
                         &model->int64_array_prop_keys);
                 break;
         case FIELD_UINT8:
-                object_push_array(&model->uint8_array_prop_vals,
+                object_push_array(model, &model->uint8_array_prop_vals,
                         sizeof(field_u8_t),
                         num_elements,
                         entry->values.base,
@@ -1280,7 +1143,7 @@ static bool object_put_array(struct columndoc_obj *model, struct err *err, const
                         &model->uint8_array_prop_keys);
                 break;
         case FIELD_UINT16:
-                object_push_array(&model->uint16_array_prop_vals,
+                object_push_array(model, &model->uint16_array_prop_vals,
                         sizeof(field_u16_t),
                         num_elements,
                         entry->values.base,
@@ -1288,7 +1151,7 @@ static bool object_put_array(struct columndoc_obj *model, struct err *err, const
                         &model->uint16_array_prop_keys);
                 break;
         case FIELD_UINT32:
-                object_push_array(&model->uint32_array_prop_vals,
+                object_push_array(model, &model->uint32_array_prop_vals,
                         sizeof(field_u32_t),
                         num_elements,
                         entry->values.base,
@@ -1296,7 +1159,7 @@ static bool object_put_array(struct columndoc_obj *model, struct err *err, const
                         &model->uint32_array_prop_keys);
                 break;
         case FIELD_UINT64:
-                object_push_array(&model->ui64_array_prop_vals,
+                object_push_array(model, &model->ui64_array_prop_vals,
                         sizeof(field_u64_t),
                         num_elements,
                         entry->values.base,
@@ -1304,7 +1167,7 @@ static bool object_put_array(struct columndoc_obj *model, struct err *err, const
                         &model->uint64_array_prop_keys);
                 break;
         case FIELD_FLOAT:
-                object_push_array(&model->float_array_prop_vals,
+                object_push_array(model, &model->float_array_prop_vals,
                         sizeof(field_number_t),
                         num_elements,
                         entry->values.base,
@@ -1315,7 +1178,7 @@ static bool object_put_array(struct columndoc_obj *model, struct err *err, const
                 const char **strings = vec_all(&entry->values, const char *);
                 field_sid_t *string_ids;
                 strdic_locate_fast(&string_ids, dic, (char *const *) strings, num_elements);
-                object_push_array(&model->string_array_prop_vals,
+                object_push_array(model, &model->string_array_prop_vals,
                         sizeof(field_sid_t),
                         num_elements,
                         string_ids,
@@ -1333,7 +1196,9 @@ static bool object_put_array(struct columndoc_obj *model, struct err *err, const
                                         *pair = vec_get(&object->entries, pair_idx, struct doc_entries);
                                 strdic_locate_fast(&nested_object_key_name, dic, (char *const *) &pair->key, 1);
                                 struct columndoc_column *key_column =
-                                        object_array_key_columns_find_or_new(&model->obj_array_props,
+                                        object_array_key_columns_find_or_new(
+                                                object_vec(model, &model->obj_array_props,
+                                                        sizeof(struct columndoc_group)),
                                                 *key_id,
                                                 *nested_object_key_name,
                                                 pair->type);
@@ -1368,7 +1233,7 @@ static bool object_put(struct columndoc_obj *model, struct err *err, const struc
         switch (entryType) {
         case ENTRY_TYPE_NULL:
                 /** For a key which does not parallel_map_exec to any value, the value is defined as 'null'  */
-                vec_push(&model->null_prop_keys, key_id, 1);
+                vec_push(object_vec(model, &model->null_prop_keys, sizeof(field_sid_t)), key_id, 1);
                 break;
         case ENTRY_TYPE_PRIMITIVE:
                 if (!object_put_primitive(model, err, entry, dic, key_id)) {
@@ -22,6 +22,7 @@
 #include "json/columndoc.h"
 #include "json/json.h"
 #include "std/sort.h"
+#include "core/alloc/arena.h"
 
 char VALUE_NULL = '\0';
 
@@ -39,14 +40,18 @@ static bool import_json_object(struct doc_obj *target, struct err *err, const st
 
 static void sort_columndoc_entries(struct columndoc_obj *columndoc);
 
-NG5_EXPORT(bool) doc_bulk_create(struct doc_bulk *bulk, struct strdic *dic)
+static char *bulk_strdup(struct doc_bulk *bulk, const char *string);
+
+NG5_EXPORT(bool) doc_bulk_create(struct doc_bulk *bulk, struct strdic *dic, const struct allocator *alloc)
 {
         error_if_null(bulk)
         error_if_null(dic)
         bulk->dic = dic;
-        vec_create(&bulk->keys, NULL, sizeof(char *), 500);
-        vec_create(&bulk->values, NULL, sizeof(char *), 1000);
-        vec_create(&bulk->models, NULL, sizeof(struct doc), 50);
+        alloc_this_or_std(&bulk->alloc, alloc);
+        vec_create(&bulk->keys, &bulk->alloc, sizeof(char *), 500);
+        vec_create(&bulk->values, &bulk->alloc, sizeof(char *), 1000);
+        vec_create(&bulk->models, &bulk->alloc, sizeof(struct doc), 50);
+        bulk->num_encoded_keys = bulk->num_encoded_values = 0;
         return true;
 }
 
@@ -94,7 +99,7 @@ struct doc *doc_bulk_new_doc(struct doc_bulk *context, field_e type)
         model->context = context;
         model->type = type;
 
-        vec_create(&model->obj_model, NULL, sizeof(struct doc_obj), 500);
+        vec_create(&model->obj_model, &context->alloc, sizeof(struct doc_obj), 500);
 
         return model;
 }
@@ -102,13 +107,19 @@ struct doc *doc_bulk_new_doc(struct doc_bulk *context, field_e type)
 NG5_EXPORT(bool) doc_bulk_Drop(struct doc_bulk *bulk)
 {
         error_if_null(bulk)
+        if (arena_alloc_is(&bulk->alloc)) {
+                /** strings, objects and vectors live in the arena, which is released by its owner */
+                return true;
+        }
         for (size_t i = 0; i < bulk->keys.num_elems; i++) {
                 char *string = *vec_get(&bulk->keys, i, char *);
-                free(string);
+                alloc_free(&bulk->alloc, string);
         }
         for (size_t i = 0; i < bulk->values.num_elems; i++) {
                 char *string = *vec_get(&bulk->values, i, char *);
-                free(string);
+                if (string) {
+                        alloc_free(&bulk->alloc, string);
+                }
         }
         for (size_t i = 0; i < bulk->models.num_elems; i++) {
                 struct doc *model = vec_get(&bulk->models, i, struct doc);
@@ -133,6 +144,23 @@ NG5_EXPORT(bool) doc_bulk_shrink(struct doc_bulk *bulk)
         return true;
 }
 
+NG5_EXPORT(bool) doc_bulk_encode_strings(struct doc_bulk *bulk)
+{
+        error_if_null(bulk)
+        size_t num_keys = vec_length(&bulk->keys) - bulk->num_encoded_keys;
+        size_t num_values = vec_length(&bulk->values) - bulk->num_encoded_values;
+        if (num_keys > 0) {
+                strdic_insert(bulk->dic, NULL, vec_all(&bulk->keys, char *) + bulk->num_encoded_keys, num_keys, 0);
+        }
+        if (num_values > 0) {
+                strdic_insert(bulk->dic, NULL, vec_all(&bulk->values, char *) + bulk->num_encoded_values,
+                        num_values, 0);
+        }
+        bulk->num_encoded_keys += num_keys;
+        bulk->num_encoded_values += num_values;
+        return true;
+}
+
 NG5_EXPORT(bool) doc_bulk_print(FILE *file, struct doc_bulk *bulk)
 {
         error_if_null(file)
@@ -208,7 +236,7 @@ bool doc_obj_add_key(struct doc_entries **out, struct doc_obj *obj, const char *
         error_if_null(key)
 
         size_t entry_idx;
-        char *key_dup = strdup(key);
+        char *key_dup = bulk_strdup(obj->doc->context, key);
 
         struct doc_entries entry_model = {.type = type, .key = key_dup, .context = obj};
 
@@ -233,7 +261,7 @@ bool doc_obj_push_primtive(struct doc_entries *entry, const void *value)
                 vec_push(&entry->values, &VALUE_NULL, 1);
                 break;
         case FIELD_STRING: {
-                char *string = value ? strdup((char *) value) : NULL;
+                char *string = value ? bulk_strdup(entry->context->doc->context, value) : NULL;
                 vec_push(&entry->context->doc->context->values, &string, 1);
                 vec_push(&entry->values, &string, 1);
         }
@@ -724,120 +752,22 @@ struct doc_entries *doc_bulk_new_entries(struct doc_bulk *dst)
         return partition;
 }
 
-#define DEFINE_NG5_TYPE_LQ_FUNC(type)                                                                               \
-static bool compare_##type##_leq(const void *lhs, const void *rhs)                                                \
-{                                                                                                                      \
-    type a = *(type *) lhs;                                                                                            \
-    type b = *(type *) rhs;                                                                                            \
-    return (a <= b);                                                                                                   \
-}
-
-DEFINE_NG5_TYPE_LQ_FUNC(FIELD_BOOLEANean_t)
-
-DEFINE_NG5_TYPE_LQ_FUNC(field_number_t)
-
-DEFINE_NG5_TYPE_LQ_FUNC(field_i8_t)
-
-DEFINE_NG5_TYPE_LQ_FUNC(field_i16_t)
-
-DEFINE_NG5_TYPE_LQ_FUNC(field_i32_t)
-
-DEFINE_NG5_TYPE_LQ_FUNC(field_i64_t)
-
-DEFINE_NG5_TYPE_LQ_FUNC(field_u8_t)
-
-DEFINE_NG5_TYPE_LQ_FUNC(field_u16_t)
-
-DEFINE_NG5_TYPE_LQ_FUNC(field_u32_t)
-
-DEFINE_NG5_TYPE_LQ_FUNC(field_u64_t)
-
-static bool compare_encoded_string_less_eq_func(const void *lhs, const void *rhs, void *args)
-{
-        struct strdic *dic = (struct strdic *) args;
-        field_sid_t *a = (field_sid_t *) lhs;
-        field_sid_t *b = (field_sid_t *) rhs;
-        char **a_string = strdic_extract(dic, a, 1);
-        char **b_string = strdic_extract(dic, b, 1);
-        bool lq = strcmp(*a_string, *b_string) <= 0;
-        strdic_free(dic, a_string);
-        strdic_free(dic, b_string);
-        return lq;
-}
-
 static void sort_nested_primitive_object(struct columndoc_obj *columndoc)
 {
         if (columndoc->parent->read_optimized) {
-                for (size_t i = 0; i < columndoc->obj_prop_vals.num_elems; i++) {
-                        struct columndoc_obj *nestedModel = vec_get(&columndoc->obj_prop_vals, i, struct columndoc_obj);
+                for (size_t i = 0; i < columndoc->obj_prop_vals->num_elems; i++) {
+                        struct columndoc_obj *nestedModel = vec_get(columndoc->obj_prop_vals, i, struct columndoc_obj);
                         sort_columndoc_entries(nestedModel);
                 }
         }
 }
 
-#define DEFINE_NG5_ARRAY_TYPE_LQ_FUNC(type)                                                                         \
-static bool compare_##type##_array_leq(const void *lhs, const void *rhs)                                           \
-{                                                                                                                      \
-    struct vector ofType(type) *a = (struct vector *) lhs;                                                               \
-    struct vector ofType(type) *b = (struct vector *) rhs;                                                               \
-    const type *aValues = vec_all(a, type);                                                                  \
-    const type *bValues = vec_all(b, type);                                                                  \
-    size_t max_compare_idx = a->num_elems < b->num_elems ? a->num_elems : b->num_elems;                                \
-    for (size_t i = 0; i < max_compare_idx; i++) {                                                                     \
-        if (aValues[i] > bValues[i]) {                                                                                 \
-            return false;                                                                                              \
-        }                                                                                                              \
-    }                                                                                                                  \
-    return true;                                                                                                       \
-}
-
-DEFINE_NG5_ARRAY_TYPE_LQ_FUNC(FIELD_BOOLEANean_t)
-
-DEFINE_NG5_ARRAY_TYPE_LQ_FUNC(field_i8_t)
-
-DEFINE_NG5_ARRAY_TYPE_LQ_FUNC(field_i16_t)
-
-DEFINE_NG5_ARRAY_TYPE_LQ_FUNC(field_i32_t)
-
-DEFINE_NG5_ARRAY_TYPE_LQ_FUNC(field_i64_t)
-
-DEFINE_NG5_ARRAY_TYPE_LQ_FUNC(field_u8_t)
-
-DEFINE_NG5_ARRAY_TYPE_LQ_FUNC(field_u16_t)
-
-DEFINE_NG5_ARRAY_TYPE_LQ_FUNC(field_u32_t)
-
-DEFINE_NG5_ARRAY_TYPE_LQ_FUNC(field_u64_t)
-
-DEFINE_NG5_ARRAY_TYPE_LQ_FUNC(field_number_t)
-
-static bool compare_encoded_string_array_less_eq_func(const void *lhs, const void *rhs, void *args)
-{
-        struct strdic *dic = (struct strdic *) args;
-        struct vector ofType(field_sid_t) *a = (struct vector *) lhs;
-        struct vector ofType(field_sid_t) *b = (struct vector *) rhs;
-        const field_sid_t *aValues = vec_all(a, field_sid_t);
-        const field_sid_t *bValues = vec_all(b, field_sid_t);
-        size_t max_compare_idx = a->num_elems < b->num_elems ? a->num_elems : b->num_elems;
-        for (size_t i = 0; i < max_compare_idx; i++) {
-                char **aString = strdic_extract(dic, aValues + i, 1);
-                char **bString = strdic_extract(dic, bValues + i, 1);
-                bool greater = strcmp(*aString, *bString) > 0;
-                strdic_free(dic, aString);
-                strdic_free(dic, bString);
-                if (greater) {
-                        return false;
-                }
-        }
-        return true;
-}
-
 static void sorted_nested_array_objects(struct columndoc_obj *columndoc)
 {
         if (columndoc->parent->read_optimized) {
-                for (size_t i = 0; i < columndoc->obj_array_props.num_elems; i++) {
+                for (size_t i = 0; i < columndoc->obj_array_props->num_elems; i++) {
                         struct columndoc_group
-                                *array_columns = vec_get(&columndoc->obj_array_props, i, struct columndoc_group);
+                                *array_columns = vec_get(columndoc->obj_array_props, i, struct columndoc_group);
                         for (size_t j = 0; j < array_columns->columns.num_elems; j++) {
                                 struct columndoc_column
                                         *column = vec_get(&array_columns->columns, j, struct columndoc_column);
@@ -861,30 +791,26 @@ static void sorted_nested_array_objects(struct columndoc_obj *columndoc)
         }
 }
 
-#define SORT_META_MODEL_VALUES(key_vector, value_vector, value_type, compareValueFunc)                                 \
+#define SORT_META_MODEL_VALUES(key_vector, value_vector, value_type, key_type)                                         \
 {                                                                                                                      \
-    size_t num_elements = vec_length(&key_vector);                                                              \
+    size_t num_elements = vec_length(key_vector);                                                              \
                                                                                                                        \
     if (num_elements > 0) {                                                                                            \
         size_t *value_indicies = malloc(sizeof(size_t) * num_elements);                                                \
-        for (size_t i = 0; i < num_elements; i++) {                                                                    \
-            value_indicies[i] = i;                                                                                     \
-        }                                                                                                              \
                                                                                                                        \
         struct vector ofType(field_sid_t) key_cpy;                                                               \
         struct vector ofType(value_type) value_cpy;                                                                     \
                                                                                                                        \
-        vec_cpy(&key_cpy, &key_vector);                                                                         \
-        vec_cpy(&value_cpy, &value_vector);                                                                     \
+        vec_cpy(&key_cpy, key_vector);                                                                         \
+        vec_cpy(&value_cpy, value_vector);                                                                     \
                                                                                                                        \
         value_type *values = vec_all(&value_cpy, value_type);                                                \
                                                                                                                        \
-        sort_qsort_indicies(value_indicies, values, sizeof(value_type), compareValueFunc, num_elements,         \
-                      key_vector.allocator);                                                                           \
+        sort_argsort(value_indicies, values, key_type, num_elements, key_vector->allocator);                            \
                                                                                                                        \
         for (size_t i = 0; i < num_elements; i++) {                                                                    \
-            vec_set(&key_vector, i, vec_get(&key_cpy, value_indicies[i], field_sid_t));        \
-            vec_set(&value_vector, i, vec_get(&value_cpy, value_indicies[i], value_type));            \
+            vec_set(key_vector, i, vec_get(&key_cpy, value_indicies[i], field_sid_t));        \
+            vec_set(value_vector, i, vec_get(&value_cpy, value_indicies[i], value_type));            \
         }                                                                                                              \
                                                                                                                        \
                                                                                                                        \
@@ -894,6 +820,15 @@ static void sorted_nested_array_objects(struct columndoc_obj *columndoc)
     }                                                                                                                  \
 }
 
+/** sorts string ids by their strings, extracting all strings from the dictionary at once */
+static void argsort_strings_by_id(size_t *indices, const field_sid_t *ids, size_t num_ids, struct strdic *dic,
+        struct allocator *alloc)
+{
+        char **strings = strdic_extract(dic, ids, num_ids);
+        sort_argsort_strings(indices, (const char *const *) strings, num_ids, alloc);
+        strdic_free(dic, strings);
+}
+
 static void sort_meta_model_string_values(struct vector ofType(field_sid_t) *key_vector,
         struct vector ofType(field_sid_t) *value_vector, struct strdic *dic)
 {
@@ -901,9 +836,6 @@ static void sort_meta_model_string_values(struct vector ofType(field_sid_t) *key
 
         if (num_elements > 0) {
                 size_t *value_indicies = malloc(sizeof(size_t) * num_elements);
-                for (size_t i = 0; i < num_elements; i++) {
-                        value_indicies[i] = i;
-                }
 
                 struct vector ofType(field_sid_t) key_cpy;
                 struct vector ofType(field_sid_t) value_cpy;
@@ -913,13 +845,7 @@ static void sort_meta_model_string_values(struct vector ofType(field_sid_t) *key
 
                 field_sid_t *values = vec_all(&value_cpy, field_sid_t);
 
-                sort_qsort_indicies_wargs(value_indicies,
-                        values,
-                        sizeof(field_sid_t),
-                        compare_encoded_string_less_eq_func,
-                        num_elements,
-                        key_vector->allocator,
-                        dic);
+                argsort_strings_by_id(value_indicies, values, num_elements, dic, key_vector->allocator);
 
                 for (size_t i = 0; i < num_elements; i++) {
                         vec_set(key_vector, i, vec_get(&key_cpy, value_indicies[i], field_sid_t));
@@ -932,48 +858,108 @@ static void sort_meta_model_string_values(struct vector ofType(field_sid_t) *key
         }
 }
 
-#define SORT_META_MODEL_ARRAYS(key_vector, value_array_vector, compare_func)                                           \
-{                                                                                                                      \
-    size_t num_elements = vec_length(&key_vector);                                                              \
-                                                                                                                       \
-    if (num_elements > 0) {                                                                                            \
-        size_t *value_indicies = malloc(sizeof(size_t) * num_elements);                                                \
-        for (size_t i = 0; i < num_elements; i++) {                                                                    \
-            value_indicies[i] = i;                                                                                     \
-        }                                                                                                              \
-                                                                                                                       \
-        struct vector ofType(field_sid_t) key_cpy;                                                               \
-        struct vector ofType(struct vector) value_cpy;                                                                   \
-                                                                                                                       \
-        vec_cpy(&key_cpy, &key_vector);                                                                         \
-        vec_cpy(&value_cpy, &value_array_vector);                                                               \
-                                                                                                                       \
-        const struct vector *values = vec_all(&value_array_vector, struct vector);                             \
-                                                                                                                       \
-        sort_qsort_indicies(value_indicies, values, sizeof(struct vector), compare_func, num_elements,           \
-                      key_vector.allocator);                                                                           \
-                                                                                                                       \
-        for (size_t i = 0; i < num_elements; i++) {                                                                    \
-            vec_set(&key_vector, i, vec_get(&key_cpy, value_indicies[i], field_sid_t));        \
-            vec_set(&value_array_vector, i, vec_get(&value_cpy, value_indicies[i], struct vector));    \
-        }                                                                                                              \
-                                                                                                                       \
-        free(value_indicies);                                                                                          \
-        vec_drop(&key_cpy);                                                                                     \
-        vec_drop(&value_cpy);                                                                                   \
-    }                                                                                                                  \
+static bool sort_key_type_of(enum sort_key_type *key_type, field_e type)
+{
+        switch (type) {
+        case FIELD_BOOLEAN:
+        case FIELD_INT8:
+                *key_type = SORT_KEY_I8;
+                return true;
+        case FIELD_INT16:
+                *key_type = SORT_KEY_I16;
+                return true;
+        case FIELD_INT32:
+                *key_type = SORT_KEY_I32;
+                return true;
+        case FIELD_INT64:
+                *key_type = SORT_KEY_I64;
+                return true;
+        case FIELD_UINT8:
+                *key_type = SORT_KEY_U8;
+                return true;
+        case FIELD_UINT16:
+                *key_type = SORT_KEY_U16;
+                return true;
+        case FIELD_UINT32:
+                *key_type = SORT_KEY_U32;
+                return true;
+        case FIELD_UINT64:
+                *key_type = SORT_KEY_U64;
+                return true;
+        case FIELD_FLOAT:
+                *key_type = SORT_KEY_FLOAT;
+                return true;
+        default:
+                return false;
+        }
+}
+
+/** ranks string ids by their strings, such that equal strings get the same rank */
+static void rank_strings_by_id(u64 *ranks, const field_sid_t *ids, size_t num_ids, struct strdic *dic,
+        struct allocator *alloc)
+{
+        char **strings = strdic_extract(dic, ids, num_ids);
+        size_t *indices = malloc(num_ids * sizeof(size_t));
+        sort_argsort_strings(indices, (const char *const *) strings, num_ids, alloc);
+        u64 rank = 0;
+        for (size_t i = 0; i < num_ids; i++) {
+                if (i > 0 && strcmp(strings[indices[i]], strings[indices[i - 1]]) != 0) {
+                        rank++;
+                }
+                ranks[indices[i]] = rank;
+        }
+        free(indices);
+        strdic_free(dic, strings);
 }
 
-static void sort_columndoc_strings_arrays(struct vector ofType(field_sid_t) *key_vector,
-        struct vector ofType(field_sid_t) *value_array_vector, struct strdic *dic)
+/**
+ * Sorts arrays of values of <code>type</code> lexicographically (stable merge sort). String ids of all arrays are
+ * resolved with a single dictionary lookup and compared by their rank afterwards.
+ */
+static void argsort_arrays(size_t *indices, const struct vector *arrays, size_t num_arrays, field_e type,
+        struct strdic *dic, struct allocator *alloc)
+{
+        enum sort_key_type key_type = SORT_KEY_U64;
+        if (type != FIELD_STRING && !sort_key_type_of(&key_type, type)) {
+                /** objects are not ordered among each other */
+                for (size_t i = 0; i < num_arrays; i++) {
+                        indices[i] = i;
+                }
+                return;
+        }
+
+        size_t *offsets = malloc((num_arrays + 1) * sizeof(size_t));
+        offsets[0] = 0;
+        for (size_t i = 0; i < num_arrays; i++) {
+                offsets[i + 1] = offsets[i] + arrays[i].num_elems;
+        }
+        size_t num_values = offsets[num_arrays];
+        size_t elem_size = num_arrays > 0 ? arrays[0].elem_size : 1;
+        void *values = malloc(ng5_max(1, num_values) * elem_size);
+        for (size_t i = 0; i < num_arrays; i++) {
+                memcpy(values + offsets[i] * elem_size, arrays[i].base, arrays[i].num_elems * elem_size);
+        }
+
+        if (type == FIELD_STRING && num_values > 0) {
+                u64 *ranks = malloc(num_values * sizeof(u64));
+                rank_strings_by_id(ranks, values, num_values, dic, alloc);
+                free(values);
+                values = ranks;
+        }
+        sort_argsort_arrays(indices, values, key_type, offsets, num_arrays, alloc);
+
+        free(values);
+        free(offsets);
+}
+
+/** sorts properties whose values are arrays of <code>type</code> by their values */
+static void sort_meta_model_arrays(struct vector ofType(field_sid_t) *key_vector,
+        struct vector ofType(struct vector) *value_array_vector, field_e type, struct strdic *dic)
 {
         size_t num_elements = vec_length(key_vector);
 
         if (num_elements > 0) {
                 size_t *value_indicies = malloc(sizeof(size_t) * num_elements);
-                for (size_t i = 0; i < num_elements; i++) {
-                        value_indicies[i] = i;
-                }
 
                 struct vector ofType(field_sid_t) key_cpy;
                 struct vector ofType(struct vector) value_cpy;
@@ -981,15 +967,8 @@ static void sort_columndoc_strings_arrays(struct vector ofType(field_sid_t) *key
                 vec_cpy(&key_cpy, key_vector);
                 vec_cpy(&value_cpy, value_array_vector);
 
-                const struct vector *values = vec_all(value_array_vector, struct vector);
-
-                sort_qsort_indicies_wargs(value_indicies,
-                        values,
-                        sizeof(struct vector),
-                        compare_encoded_string_array_less_eq_func,
-                        num_elements,
-                        key_vector->allocator,
-                        dic);
+                argsort_arrays(value_indicies, vec_all(&value_cpy, struct vector), num_elements, type, dic,
+                        key_vector->allocator);
 
                 for (size_t i = 0; i < num_elements; i++) {
                         vec_set(key_vector, i, vec_get(&key_cpy, value_indicies[i], field_sid_t));
@@ -1002,102 +981,38 @@ static void sort_columndoc_strings_arrays(struct vector ofType(field_sid_t) *key
         }
 }
 
-static bool compare_object_array_key_columns_less_eq_func(const void *lhs, const void *rhs, void *args)
-{
-        struct strdic *dic = (struct strdic *) args;
-        struct columndoc_group *a = (struct columndoc_group *) lhs;
-        struct columndoc_group *b = (struct columndoc_group *) rhs;
-        char **a_column_name = strdic_extract(dic, &a->key, 1);
-        char **b_column_name = strdic_extract(dic, &b->key, 1);
-        bool column_name_leq = strcmp(*a_column_name, *b_column_name) <= 0;
-        strdic_free(dic, a_column_name);
-        strdic_free(dic, b_column_name);
-        return column_name_leq;
-}
-
-static bool compare_object_array_key_column_less_eq_func(const void *lhs, const void *rhs, void *args)
-{
-        struct strdic *dic = (struct strdic *) args;
-        struct columndoc_column *a = (struct columndoc_column *) lhs;
-        struct columndoc_column *b = (struct columndoc_column *) rhs;
-        char **a_column_name = strdic_extract(dic, &a->key_name, 1);
-        char **b_column_name = strdic_extract(dic, &b->key_name, 1);
-        int cmpResult = strcmp(*a_column_name, *b_column_name);
-        bool column_name_leq = cmpResult < 0 ? true : (cmpResult == 0 ? (a->type <= b->type) : false);
-        strdic_free(dic, a_column_name);
-        strdic_free(dic, b_column_name);
-        return column_name_leq;
-}
-
-struct com_column_leq_arg {
-        struct strdic *dic;
-        field_e value_type;
-};
-
-#define ARRAY_LEQ_PRIMITIVE_FUNC(max_num_elem, type, valueVectorAPtr, valueVectorBPtr)                                 \
-{                                                                                                                      \
-    for (size_t i = 0; i < max_num_elem; i++) {                                                                        \
-        type o1 = *vec_get(valueVectorAPtr, i, type);                                                        \
-        type o2 = *vec_get(valueVectorBPtr, i, type);                                                        \
-        if (o1 > o2) {                                                                                                 \
-            return false;                                                                                              \
-        }                                                                                                              \
-    }                                                                                                                  \
-    return true;                                                                                                       \
-}
-
-static bool compare_column_less_eq_func(const void *lhs, const void *rhs, void *args)
+/**
+ * Sorts a column that holds exactly one value per object by key (radix sort, in parallel for large columns) instead
+ * of by comparing value vectors. Returns false if the column holds arrays, or values that are not keys.
+ */
+static bool argsort_single_value_column(size_t *indices, const struct columndoc_column *column, struct strdic *dic)
 {
-        struct vector ofType(<T>) *a = (struct vector *) lhs;
-        struct vector ofType(<T>) *b = (struct vector *) rhs;
-        struct com_column_leq_arg *func_arg = (struct com_column_leq_arg *) args;
+        const struct vector *values = vec_all(&column->values, struct vector);
+        size_t num_values = column->values.num_elems;
+        enum sort_key_type key_type = SORT_KEY_SID;
 
-        size_t max_num_elem = ng5_min(a->num_elems, b->num_elems);
-
-        switch (func_arg->value_type) {
-        case FIELD_NULL:
-                return (a->num_elems <= b->num_elems);
-                break;
-        case FIELD_BOOLEAN: ARRAY_LEQ_PRIMITIVE_FUNC(max_num_elem, FIELD_BOOLEANean_t, a, b);
-                break;
-        case FIELD_INT8: ARRAY_LEQ_PRIMITIVE_FUNC(max_num_elem, field_i8_t, a, b);
-                break;
-        case FIELD_INT16: ARRAY_LEQ_PRIMITIVE_FUNC(max_num_elem, field_i16_t, a, b);
-                break;
-        case FIELD_INT32: ARRAY_LEQ_PRIMITIVE_FUNC(max_num_elem, field_i32_t, a, b);
-                break;
-        case FIELD_INT64: ARRAY_LEQ_PRIMITIVE_FUNC(max_num_elem, field_i64_t, a, b);
-                break;
-        case FIELD_UINT8: ARRAY_LEQ_PRIMITIVE_FUNC(max_num_elem, field_u8_t, a, b);
-                break;
-        case FIELD_UINT16: ARRAY_LEQ_PRIMITIVE_FUNC(max_num_elem, field_u16_t, a, b);
-                break;
-        case FIELD_UINT32: ARRAY_LEQ_PRIMITIVE_FUNC(max_num_elem, field_u32_t, a, b);
-                break;
-        case FIELD_UINT64: ARRAY_LEQ_PRIMITIVE_FUNC(max_num_elem, field_u64_t, a, b);
-                break;
-        case FIELD_FLOAT: ARRAY_LEQ_PRIMITIVE_FUNC(max_num_elem, field_number_t, a, b);
-                break;
-        case FIELD_STRING:
-                for (size_t i = 0; i < max_num_elem; i++) {
-                        field_sid_t o1 = *vec_get(a, i, field_sid_t);
-                        field_sid_t o2 = *vec_get(b, i, field_sid_t);
-                        char **o1_string = strdic_extract(func_arg->dic, &o1, 1);
-                        char **o2_string = strdic_extract(func_arg->dic, &o2, 1);
-                        bool greater = strcmp(*o1_string, *o2_string) > 0;
-                        strdic_free(func_arg->dic, o1_string);
-                        strdic_free(func_arg->dic, o2_string);
-                        if (greater) {
-                                return false;
-                        }
-                }
-                return true;
-        case FIELD_OBJECT:
-                return true;
-                break;
-        default: print_error_and_die(NG5_ERR_NOTYPE)
+        if (column->type != FIELD_STRING && !sort_key_type_of(&key_type, column->type)) {
                 return false;
         }
+        for (size_t i = 0; i < num_values; i++) {
+                if (values[i].num_elems != 1) {
+                        return false;
+                }
+        }
+
+        size_t elem_size = values[0].elem_size;
+        void *keys = malloc(num_values * elem_size);
+        for (size_t i = 0; i < num_values; i++) {
+                memcpy(keys + i * elem_size, values[i].base, elem_size);
+        }
+        if (column->type == FIELD_STRING) {
+                argsort_strings_by_id(indices, keys, num_values, dic, column->values.allocator);
+        } else {
+                sort_argsort_parallel(indices, keys, key_type, num_values, column->values.allocator,
+                        sysconf(_SC_NPROCESSORS_ONLN));
+        }
+        free(keys);
+        return true;
 }
 
 static void sort_columndoc_column(struct columndoc_column *column, struct strdic *dic)
@@ -1114,19 +1029,18 @@ static void sort_columndoc_column(struct columndoc_column *column, struct strdic
         assert(values_cpy.num_elems == column->array_positions.num_elems);
 
         size_t *indices = malloc(values_cpy.num_elems * sizeof(size_t));
-        for (size_t i = 0; i < values_cpy.num_elems; i++) {
-                indices[i] = i;
-        }
 
-        struct com_column_leq_arg func_arg = {.dic = dic, .value_type = column->type};
-
-        sort_qsort_indicies_wargs(indices,
-                values_cpy.base,
-                values_cpy.elem_size,
-                compare_column_less_eq_func,
-                values_cpy.num_elems,
-                values_cpy.allocator,
-                &func_arg);
+        if (values_cpy.num_elems == 0) {
+                /** nothing to sort */
+        } else if (column->type == FIELD_NULL) {
+                /** all values are equal */
+                for (size_t i = 0; i < values_cpy.num_elems; i++) {
+                        indices[i] = i;
+                }
+        } else if (!argsort_single_value_column(indices, column, dic)) {
+                argsort_arrays(indices, values_cpy.base, values_cpy.num_elems, column->type, dic,
+                        values_cpy.allocator);
+        }
 
         for (size_t i = 0; i < values_cpy.num_elems; i++) {
                 vec_set(&column->values, i, vec_at(&values_cpy, indices[i]));
@@ -1140,51 +1054,56 @@ static void sort_columndoc_column(struct columndoc_column *column, struct strdic
 
 static void sort_columndoc_column_arrays(struct columndoc_obj *columndoc)
 {
+        struct strdic *dic = columndoc->parent->dic;
         struct vector ofType(struct columndoc_group) cpy;
-        vec_cpy(&cpy, &columndoc->obj_array_props);
+        vec_cpy(&cpy, columndoc->obj_array_props);
         size_t *indices = malloc(cpy.num_elems * sizeof(size_t));
+        field_sid_t *names = malloc(cpy.num_elems * sizeof(field_sid_t));
+        const struct columndoc_group *groups = vec_all(&cpy, struct columndoc_group);
         for (size_t i = 0; i < cpy.num_elems; i++) {
-                indices[i] = i;
-        }
-        sort_qsort_indicies_wargs(indices,
-                cpy.base,
-                sizeof(struct columndoc_group),
-                compare_object_array_key_columns_less_eq_func,
-                cpy.num_elems,
-                cpy.allocator,
-                columndoc->parent->dic);
+                names[i] = groups[i].key;
+        }
+        argsort_strings_by_id(indices, names, cpy.num_elems, dic, cpy.allocator);
         for (size_t i = 0; i < cpy.num_elems; i++) {
-                vec_set(&columndoc->obj_array_props, i, vec_get(&cpy, indices[i], struct columndoc_group));
+                vec_set(columndoc->obj_array_props, i, vec_get(&cpy, indices[i], struct columndoc_group));
         }
+        free(names);
         free(indices);
 
         for (size_t i = 0; i < cpy.num_elems; i++) {
-                struct columndoc_group *key_columns = vec_get(&columndoc->obj_array_props, i, struct columndoc_group);
-                size_t *columnIndices = malloc(key_columns->columns.num_elems * sizeof(size_t));
+                struct columndoc_group *key_columns = vec_get(columndoc->obj_array_props, i, struct columndoc_group);
+                size_t num_columns = key_columns->columns.num_elems;
+                size_t *type_indices = malloc(num_columns * sizeof(size_t));
+                size_t *name_indices = malloc(num_columns * sizeof(size_t));
+                u32 *column_types = malloc(num_columns * sizeof(u32));
+                field_sid_t *column_names = malloc(num_columns * sizeof(field_sid_t));
                 struct vector ofType(struct columndoc_column) columnCpy;
                 vec_cpy(&columnCpy, &key_columns->columns);
-                for (size_t i = 0; i < key_columns->columns.num_elems; i++) {
-                        columnIndices[i] = i;
+                const struct columndoc_column *columns = vec_all(&columnCpy, struct columndoc_column);
+
+                /** First, sort by type; Then, sort by name such that columns with same name stay sorted by type */
+                for (size_t j = 0; j < num_columns; j++) {
+                        column_types[j] = columns[j].type;
+                }
+                sort_argsort(type_indices, column_types, SORT_KEY_U32, num_columns, key_columns->columns.allocator);
+                for (size_t j = 0; j < num_columns; j++) {
+                        column_names[j] = columns[type_indices[j]].key_name;
                 }
+                argsort_strings_by_id(name_indices, column_names, num_columns, dic, key_columns->columns.allocator);
 
-                /** First, sort by column name; Then, sort by columns with same name by type */
-                sort_qsort_indicies_wargs(columnIndices,
-                        columnCpy.base,
-                        sizeof(struct columndoc_column),
-                        compare_object_array_key_column_less_eq_func,
-                        key_columns->columns.num_elems,
-                        key_columns->columns.allocator,
-                        columndoc->parent->dic);
-                for (size_t i = 0; i < key_columns->columns.num_elems; i++) {
+                for (size_t j = 0; j < num_columns; j++) {
                         vec_set(&key_columns->columns,
-                                i,
-                                vec_get(&columnCpy, columnIndices[i], struct columndoc_column));
-                        struct columndoc_column *column = vec_get(&key_columns->columns, i, struct columndoc_column);
-                        sort_columndoc_column(column, columndoc->parent->dic);
+                                j,
+                                vec_get(&columnCpy, type_indices[name_indices[j]], struct columndoc_column));
+                        struct columndoc_column *column = vec_get(&key_columns->columns, j, struct columndoc_column);
+                        sort_columndoc_column(column, dic);
                 }
 
                 vec_drop(&columnCpy);
-                free(columnIndices);
+                free(column_names);
+                free(column_types);
+                free(name_indices);
+                free(type_indices);
         }
         vec_drop(&cpy);
 }
@@ -1195,79 +1114,90 @@ static void sort_columndoc_values(struct columndoc_obj *columndoc)
                 SORT_META_MODEL_VALUES(columndoc->bool_prop_keys,
                         columndoc->bool_prop_vals,
                         FIELD_BOOLEANean_t,
-                        compare_FIELD_BOOLEANean_t_leq);
+                        SORT_KEY_I8);
                 SORT_META_MODEL_VALUES(columndoc->int8_prop_keys,
                         columndoc->int8_prop_vals,
                         field_i8_t,
-                        compare_field_i8_t_leq);
+                        SORT_KEY_I8);
                 SORT_META_MODEL_VALUES(columndoc->int16_prop_keys,
                         columndoc->int16_prop_vals,
                         field_i16_t,
-                        compare_field_i16_t_leq);
+                        SORT_KEY_I16);
                 SORT_META_MODEL_VALUES(columndoc->int32_prop_keys,
                         columndoc->int32_prop_vals,
                         field_i32_t,
-                        compare_field_i32_t_leq);
+                        SORT_KEY_I32);
                 SORT_META_MODEL_VALUES(columndoc->int64_prop_keys,
                         columndoc->int64_prop_vals,
                         field_i64_t,
-                        compare_field_i64_t_leq);
+                        SORT_KEY_I64);
                 SORT_META_MODEL_VALUES(columndoc->uint8_prop_keys,
                         columndoc->uint8_prop_vals,
                         field_u8_t,
-                        compare_field_u8_t_leq);
+                        SORT_KEY_U8);
                 SORT_META_MODEL_VALUES(columndoc->uint16_prop_keys,
                         columndoc->uint16_prop_vals,
                         field_u16_t,
-                        compare_field_u16_t_leq);
+                        SORT_KEY_U16);
                 SORT_META_MODEL_VALUES(columndoc->uin32_prop_keys,
                         columndoc->uint32_prop_vals,
                         field_u32_t,
-                        compare_field_u32_t_leq);
+                        SORT_KEY_U32);
                 SORT_META_MODEL_VALUES(columndoc->uint64_prop_keys,
                         columndoc->uint64_prop_vals,
                         field_u64_t,
-                        compare_field_u64_t_leq);
+                        SORT_KEY_U64);
                 SORT_META_MODEL_VALUES(columndoc->float_prop_keys,
                         columndoc->float_prop_vals,
                         field_number_t,
-                        compare_field_number_t_leq);
-                sort_meta_model_string_values(&columndoc->string_prop_keys,
-                        &columndoc->string_prop_vals,
+                        SORT_KEY_FLOAT);
+                sort_meta_model_string_values(columndoc->string_prop_keys,
+                        columndoc->string_prop_vals,
                         columndoc->parent->dic);
 
-                SORT_META_MODEL_ARRAYS(columndoc->bool_array_prop_keys,
+                sort_meta_model_arrays(columndoc->bool_array_prop_keys,
                         columndoc->bool_array_prop_vals,
-                        compare_FIELD_BOOLEANean_t_array_leq);
-                SORT_META_MODEL_ARRAYS(columndoc->int8_array_prop_keys,
+                        FIELD_BOOLEAN,
+                        columndoc->parent->dic);
+                sort_meta_model_arrays(columndoc->int8_array_prop_keys,
                         columndoc->int8_array_prop_vals,
-                        compare_field_i8_t_array_leq);
-                SORT_META_MODEL_ARRAYS(columndoc->int16_array_prop_keys,
+                        FIELD_INT8,
+                        columndoc->parent->dic);
+                sort_meta_model_arrays(columndoc->int16_array_prop_keys,
                         columndoc->int16_array_prop_vals,
-                        compare_field_i16_t_array_leq);
-                SORT_META_MODEL_ARRAYS(columndoc->int32_array_prop_keys,
+                        FIELD_INT16,
+                        columndoc->parent->dic);
+                sort_meta_model_arrays(columndoc->int32_array_prop_keys,
                         columndoc->int32_array_prop_vals,
-                        compare_field_i32_t_array_leq);
-                SORT_META_MODEL_ARRAYS(columndoc->int64_array_prop_keys,
+                        FIELD_INT32,
+                        columndoc->parent->dic);
+                sort_meta_model_arrays(columndoc->int64_array_prop_keys,
                         columndoc->int64_array_prop_vals,
-                        compare_field_i64_t_array_leq);
-                SORT_META_MODEL_ARRAYS(columndoc->uint8_array_prop_keys,
+                        FIELD_INT64,
+                        columndoc->parent->dic);
+                sort_meta_model_arrays(columndoc->uint8_array_prop_keys,
                         columndoc->uint8_array_prop_vals,
-                        compare_field_u8_t_array_leq);
-                SORT_META_MODEL_ARRAYS(columndoc->uint16_array_prop_keys,
+                        FIELD_UINT8,
+                        columndoc->parent->dic);
+                sort_meta_model_arrays(columndoc->uint16_array_prop_keys,
                         columndoc->uint16_array_prop_vals,
-                        compare_field_u16_t_array_leq);
-                SORT_META_MODEL_ARRAYS(columndoc->uint32_array_prop_keys,
+                        FIELD_UINT16,
+                        columndoc->parent->dic);
+                sort_meta_model_arrays(columndoc->uint32_array_prop_keys,
                         columndoc->uint32_array_prop_vals,
-                        compare_field_u32_t_array_leq);
-                SORT_META_MODEL_ARRAYS(columndoc->uint64_array_prop_keys,
+                        FIELD_UINT32,
+                        columndoc->parent->dic);
+                sort_meta_model_arrays(columndoc->uint64_array_prop_keys,
                         columndoc->ui64_array_prop_vals,
-                        compare_field_u64_t_array_leq);
-                SORT_META_MODEL_ARRAYS(columndoc->float_array_prop_keys,
+                        FIELD_UINT64,
+                        columndoc->parent->dic);
+                sort_meta_model_arrays(columndoc->float_array_prop_keys,
                         columndoc->float_array_prop_vals,
-                        compare_field_number_t_array_leq);
-                sort_columndoc_strings_arrays(&columndoc->string_array_prop_keys,
-                        &columndoc->string_array_prop_vals,
+                        FIELD_FLOAT,
+                        columndoc->parent->dic);
+                sort_meta_model_arrays(columndoc->string_array_prop_keys,
+                        columndoc->string_array_prop_vals,
+                        FIELD_STRING,
                         columndoc->parent->dic);
 
                 sort_columndoc_column_arrays(columndoc);
@@ -1284,17 +1214,17 @@ static void sort_columndoc_entries(struct columndoc_obj *columndoc)
 }
 
 struct columndoc *doc_entries_columndoc(const struct doc_bulk *bulk, const struct doc_entries *partition,
-        bool read_optimized)
+        bool read_optimized, const struct allocator *alloc)
 {
         if (!bulk || !partition) {
                 return NULL;
         }
 
-        // Step 1: encode all strings at once in a bulk
-        char *const *key_strings = vec_all(&bulk->keys, char *);
-        char *const *valueStrings = vec_all(&bulk->values, char *);
-        strdic_insert(bulk->dic, NULL, key_strings, vec_length(&bulk->keys), 0);
-        strdic_insert(bulk->dic, NULL, valueStrings, vec_length(&bulk->values), 0);
+        // Step 1: encode all strings at once in a bulk (except those already encoded via 'doc_bulk_encode_strings')
+        char *const *key_strings = vec_all(&bulk->keys, char *) + bulk->num_encoded_keys;
+        char *const *valueStrings = vec_all(&bulk->values, char *) + bulk->num_encoded_values;
+        strdic_insert(bulk->dic, NULL, key_strings, vec_length(&bulk->keys) - bulk->num_encoded_keys, 0);
+        strdic_insert(bulk->dic, NULL, valueStrings, vec_length(&bulk->values) - bulk->num_encoded_values, 0);
 
         // Step 2: for each document doc, create a meta doc, and construct a binary compressed document
         const struct doc *models = vec_all(&bulk->models, struct doc);
@@ -1309,7 +1239,7 @@ struct columndoc *doc_entries_columndoc(const struct doc_bulk *bulk, const struc
         struct columndoc *columndoc = malloc(sizeof(struct columndoc));
         columndoc->read_optimized = read_optimized;
         struct err err;
-        if (!columndoc_create(columndoc, &err, model, bulk, partition, bulk->dic)) {
+        if (!columndoc_create(columndoc, &err, model, bulk, partition, bulk->dic, alloc)) {
                 error_print_and_abort(&err);
         }
 
@@ -1330,9 +1260,16 @@ NG5_EXPORT(bool) doc_entries_drop(struct doc_entries *partition)
         return true;
 }
 
+static char *bulk_strdup(struct doc_bulk *bulk, const char *string)
+{
+        size_t length = strlen(string) + 1;
+        char *result = alloc_malloc(&bulk->alloc, length);
+        return memcpy(result, string, length);
+}
+
 static void create_doc(struct doc_obj *model, struct doc *doc)
 {
-        vec_create(&model->entries, NULL, sizeof(struct doc_entries), 50);
+        vec_create(&model->entries, &doc->context->alloc, sizeof(struct doc_entries), 50);
         model->doc = doc;
 }
 
@@ -1382,7 +1319,7 @@ static void create_typed_vector(struct doc_entries *entry)
         default: print_error_and_die(NG5_ERR_INTERNALERR) /** unknown type */
                 return;
         }
-        vec_create(&entry->values, NULL, size, 50);
+        vec_create(&entry->values, &entry->context->doc->context->alloc, size, 50);
 }
 
 static void entries_drop(struct doc_entries *entry)
@@ -27,7 +27,7 @@ NG5_EXPORT(bool) encoded_doc_collection_create(struct encoded_doc_list *collecti
         ng5_unused(archive);
 
         vec_create(&collection->flat_object_collection, NULL, sizeof(struct encoded_doc), 5000000);
-        hashtable_create(&collection->index, err, sizeof(object_id_t), sizeof(u32), 5000000);
+        hashmap_u64_u32_create(&collection->index, NULL, 5000000);
         error_init(&collection->err);
         collection->archive = archive;
 
@@ -38,7 +38,7 @@ NG5_EXPORT(bool) encoded_doc_collection_drop(struct encoded_doc_list *collection
 {
         ng5_unused(collection);
 
-        hashtable_drop(&collection->index);
+        hashmap_u64_u32_drop(&collection->index);
         for (u32 i = 0; i < collection->flat_object_collection.num_elems; i++) {
                 struct encoded_doc *doc = vec_get(&collection->flat_object_collection, i, struct encoded_doc);
                 encoded_doc_drop(doc);
@@ -57,9 +57,14 @@ static struct encoded_doc *doc_create(struct err *err, object_id_t object_id, st
                 new_doc->object_id = object_id;
                 vec_create(&new_doc->props, NULL, sizeof(struct encoded_doc_prop), 20);
                 vec_create(&new_doc->props_arrays, NULL, sizeof(struct encoded_doc_prop_array), 20);
-                hashtable_create(&new_doc->prop_array_index, err, sizeof(field_sid_t), sizeof(u32), 20);
+                hashmap_u64_u32_create(&new_doc->prop_array_index, NULL, 20);
                 error_init(&new_doc->err);
-                hashtable_insert_or_update(&collection->index, &object_id, &doc_position, 1);
+                if (unlikely(!hashmap_u64_u32_put(&collection->index, object_id, doc_position))) {
+                        encoded_doc_drop(new_doc);
+                        vec_pop(&collection->flat_object_collection);
+                        error(err, NG5_ERR_MALLOCERR);
+                        return NULL;
+                }
                 return new_doc;
         } else {
                 error(err, NG5_ERR_ILLEGALARG);
@@ -71,17 +76,13 @@ NG5_EXPORT(struct encoded_doc *)encoded_doc_collection_get_or_append(struct enco
         object_id_t id)
 {
         error_if_null(collection);
-        const u32 *doc_pos = hashtable_get_value(&collection->index, &id);
+        const u32 *doc_pos = hashmap_u64_u32_get(&collection->index, id);
         if (doc_pos) {
                 struct encoded_doc *result = vec_get(&collection->flat_object_collection, *doc_pos, struct encoded_doc);
                 error_if(result == NULL, &collection->err, NG5_ERR_INTERNALERR);
                 return result;
         } else {
-                struct encoded_doc *result = doc_create(&collection->err, id, collection);
-                if (!result) {
-                        error(&collection->err, NG5_ERR_INTERNALERR);
-                }
-                return result;
+                return doc_create(&collection->err, id, collection);
         }
 }
 
@@ -113,7 +114,7 @@ NG5_EXPORT(bool) encoded_doc_drop(struct encoded_doc *doc)
         }
         vec_drop(&doc->props);
         vec_drop(&doc->props_arrays);
-        hashtable_drop(&doc->prop_array_index);
+        hashmap_u64_u32_drop(&doc->prop_array_index);
         return false;
 }
 
@@ -274,7 +275,12 @@ encoded_doc_add_prop_array_##name(struct encoded_doc *doc,
     array->header.type = basic_type;                                                                                   \
     array->header.context = doc;                                                                                       \
     vec_create(&array->values, NULL, sizeof(union encoded_doc_value), 10);                                   \
-    hashtable_insert_or_update(&doc->prop_array_index, &key, &new_array_pos, 1);                                \
+    if (unlikely(!hashmap_u64_u32_put(&doc->prop_array_index, key, new_array_pos))) {                               \
+        vec_drop(&array->values);                                                                                      \
+        vec_pop(&doc->props_arrays);                                                                                   \
+        error(&doc->err, NG5_ERR_MALLOCERR);                                                                           \
+        return false;                                                                                                  \
+    }                                                                                                                  \
     return true;                                                                                                       \
 }
 
@@ -351,7 +357,7 @@ encoded_doc_array_push_##name(struct encoded_doc *doc, field_sid_t key,
                                      const built_in_type *values, u32 values_length)                              \
 {                                                                                                                      \
     error_if_null(doc)                                                                                      \
-    const u32 *prop_pos = hashtable_get_value(&doc->prop_array_index, &key);                               \
+    const u32 *prop_pos = hashmap_u64_u32_get(&doc->prop_array_index, key);                                \
     error_if(prop_pos == NULL, &doc->err, NG5_ERR_NOTFOUND);                                                 \
     struct encoded_doc_prop_array *array = vec_get(&doc->props_arrays, *prop_pos,                          \
                                                                struct encoded_doc_prop_array);                       \
@@ -448,7 +454,7 @@ DECLARE_NG5_ENCODED_DOC_ARRAY_PUSH_TYPE_DECODED(null, field_u32_t, FIELD_NULL)
 //encoded_doc_array_push_null(struct encoded_doc *doc, field_sid_t key, u32 how_many)
 //{
 //    error_if_null(doc)
-//    const u32 *prop_pos = hashtable_get_value(&doc->prop_array_index, &key);
+//    const u32 *prop_pos = hashmap_u64_u32_get(&doc->prop_array_index, key);
 //    error_if(prop_pos == NULL, &doc->err, NG5_ERR_NOTFOUND);
 //    struct encoded_doc_prop_array *array = vec_get(&doc->props_arrays, *prop_pos,
 //                                                               struct encoded_doc_prop_array);
@@ -470,7 +476,7 @@ NG5_EXPORT(bool) encoded_doc_array_push_object(struct encoded_doc *doc, field_si
         ng5_unused(id);
 
         error_if_null(doc)
-        const u32 *prop_pos = hashtable_get_value(&doc->prop_array_index, &key);
+        const u32 *prop_pos = hashmap_u64_u32_get(&doc->prop_array_index, key);
         error_if(prop_pos == NULL, &doc->err, NG5_ERR_NOTFOUND);
         struct encoded_doc_prop_array *array = vec_get(&doc->props_arrays, *prop_pos, struct encoded_doc_prop_array);
         error_if(array == NULL, &doc->err, NG5_ERR_INTERNALERR);
@@ -18,8 +18,11 @@
 #include <inttypes.h>
 #include <ctype.h>
 #include <locale.h>
+#include <math.h>
 #include "json/json.h"
+#include "json/json_scan.h"
 #include "json/doc.h"
+#include "core/alloc/arena.h"
 #include "utils/convert.h"
 
 static struct {
@@ -45,123 +48,197 @@ static int process_token(struct err *err, struct json_err *error_desc, const str
 
 static int set_error(struct json_err *error_desc, const struct json_token *token, const char *msg);
 
-NG5_EXPORT(bool) json_tokenizer_init(struct json_tokenizer *tokenizer, const char *input)
+static void tokenizer_load_block(struct json_tokenizer *tokenizer)
+{
+        struct json_scan_block block;
+        size_t remain = tokenizer->input_len - tokenizer->block_begin;
+
+        if (likely(remain >= NG5_JSON_SCAN_BLOCK_SIZE)) {
+                json_scan_classify(&block, tokenizer->input + tokenizer->block_begin);
+        } else {
+                /* pad the last block with whitespaces, which are not part of the structural index */
+                char tail[NG5_JSON_SCAN_BLOCK_SIZE];
+                memset(tail, ' ', sizeof(tail));
+                memcpy(tail, tokenizer->input + tokenizer->block_begin, remain);
+                json_scan_classify(&block, tail);
+        }
+        tokenizer->block_index = json_scan_index(&block, &tokenizer->carry);
+        tokenizer->block_newlines = block.newline;
+}
+
+/* counts the line breaks between the last tracked position and 'pos', which must be in the current block */
+static inline void tokenizer_track_lines(struct json_tokenizer *tokenizer, size_t pos)
+{
+        size_t from = tokenizer->line_cursor - tokenizer->block_begin;
+        size_t to = pos - tokenizer->block_begin;
+        if (from < to) {
+                u64 newlines = tokenizer->block_newlines >> from;
+                newlines &= (to - from == NG5_JSON_SCAN_BLOCK_SIZE) ? ~0ull : ((1ull << (to - from)) - 1);
+                if (unlikely(newlines != 0)) {
+                        tokenizer->line += __builtin_popcountll(newlines);
+                        tokenizer->line_begin = tokenizer->block_begin + from + (64 - __builtin_clzll(newlines));
+                }
+                tokenizer->line_cursor = pos;
+        }
+}
+
+/*
+ * returns the offset of the next position in the structural index, or 'input_len' if there is none; line numbers
+ * are only tracked if 'track_lines' is set
+ */
+static inline size_t tokenizer_next_position(struct json_tokenizer *tokenizer, bool track_lines)
+{
+        while (unlikely(tokenizer->block_index == 0)) {
+                if (track_lines) {
+                        tokenizer_track_lines(tokenizer, tokenizer->block_begin + NG5_JSON_SCAN_BLOCK_SIZE);
+                }
+                tokenizer->block_begin += NG5_JSON_SCAN_BLOCK_SIZE;
+                if (unlikely(tokenizer->block_begin >= tokenizer->input_len)) {
+                        tokenizer->block_begin = tokenizer->line_cursor = tokenizer->input_len;
+                        return tokenizer->input_len;
+                }
+                tokenizer_load_block(tokenizer);
+        }
+        size_t pos = tokenizer->block_begin + __builtin_ctzll(tokenizer->block_index);
+        tokenizer->block_index &= tokenizer->block_index - 1;
+        if (track_lines) {
+                tokenizer_track_lines(tokenizer, pos);
+        }
+        return pos;
+}
+
+static inline bool tokenizer_is_digit(char c)
+{
+        return (unsigned char) (c - '0') < 10;
+}
+
+static inline bool tokenizer_is_delimiter(char c)
+{
+        return c == '\0' || c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == ',' || c == ':' || c == '}'
+                || c == ']' || c == '{' || c == '[';
+}
+
+/* starts the structural index of the 'input_len' bytes at 'input' */
+static void tokenizer_init_index(struct json_tokenizer *tokenizer, const char *input, size_t input_len)
 {
-        error_if_null(tokenizer)
-        error_if_null(input)
         tokenizer->cursor = input;
         tokenizer->token =
                 (struct json_token) {.type = JSON_UNKNOWN, .length = 0, .column = 0, .line = 1, .string = NULL};
         error_init(&tokenizer->err);
+
+        tokenizer->input = input;
+        tokenizer->input_len = input_len;
+        tokenizer->block_begin = 0;
+        tokenizer->block_index = tokenizer->block_newlines = 0;
+        tokenizer->carry = (struct json_scan_carry) {.escaped = 0, .in_string = 0, .scalar_pred = 1};
+        tokenizer->line = 1;
+        tokenizer->line_cursor = tokenizer->line_begin = 0;
+        if (tokenizer->input_len > 0) {
+                tokenizer_load_block(tokenizer);
+        }
+}
+
+NG5_EXPORT(bool) json_tokenizer_init(struct json_tokenizer *tokenizer, const char *input)
+{
+        error_if_null(tokenizer)
+        error_if_null(input)
+        tokenizer_init_index(tokenizer, input, strlen(input));
         return true;
 }
 
 const struct json_token *json_tokenizer_next(struct json_tokenizer *tokenizer)
 {
-        if (likely(*tokenizer->cursor != '\0')) {
-                char c = *tokenizer->cursor;
-                tokenizer->token.string = tokenizer->cursor;
-                tokenizer->token.column += tokenizer->token.length;
-                tokenizer->token.length = 0;
-                if (c == '\n' || c == '\r') {
-                        tokenizer->token.line += c == '\n' ? 1 : 0;
-                        tokenizer->token.column = c == '\n' ? 0 : tokenizer->token.column;
-                        tokenizer->cursor++;
-                        return json_tokenizer_next(tokenizer);
-                } else if (isspace(c)) {
-                        do {
-                                tokenizer->cursor++;
-                                tokenizer->token.column++;
-                        }
-                        while (isspace(c = *tokenizer->cursor) && c != '\n');
-                        return json_tokenizer_next(tokenizer);
-                } else if (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',') {
-                        tokenizer->token.type =
-                                c == '{' ? OBJECT_OPEN : c == '}' ? OBJECT_CLOSE : c == '[' ? ARRAY_OPEN : c == ']'
-                                                                                                           ? ARRAY_CLOSE
-                                                                                                           : c == ':'
-                                                                                                             ? ASSIGN
-                                                                                                             : COMMA;
-                        tokenizer->token.column++;
-                        tokenizer->token.length = 1;
-                        tokenizer->cursor++;
-                } else if (c == '"') {
-                        bool escapeQuote = false;
-                        tokenizer->token.type = LITERAL_STRING;
-                        tokenizer->token.string++;
-                        tokenizer->token.column++;
-                        char last_1_c = '\0', last_2_c = '\0', last_3_c = '\0', last_4_c = '\0';
-                        c = *(++tokenizer->cursor);
-                        while ((escapeQuote || c != '"') && c != '\r' && c != '\n') {
-                                next_char:
-                                tokenizer->token.length++;
-                                last_4_c = last_3_c;
-                                last_3_c = last_2_c;
-                                last_2_c = last_1_c;
-                                last_1_c = c;
-                                c = *(++tokenizer->cursor);
-                                if (unlikely(c == '\\' && last_1_c == '\\')) {
-                                        goto next_char;
-                                }
-                                escapeQuote = c == '"' && last_1_c == '\\'
-                                        && ((last_2_c == '\\' && last_3_c == '\\' && last_4_c != '\\')
-                                                || (last_2_c != '\\' && last_3_c == '\\')
-                                                || (last_2_c != '\\' && last_3_c != '\\'));
-                        }
-                        tokenizer->cursor++;
-                        tokenizer->cursor += (c == '\r' || c == '\n') ? 1 : 0;
-                } else if (c == 't' || c == 'f' || c == 'n') {
-                        const unsigned lenTrueNull = 4;
-                        const unsigned lenFalse = 5;
-                        const unsigned cursorLen = strlen(tokenizer->cursor);
-                        if (cursorLen > lenTrueNull && strncmp(tokenizer->cursor, "true", lenTrueNull) == 0) {
-                                tokenizer->token.type = LITERAL_TRUE;
-                                tokenizer->token.length = lenTrueNull;
-                        } else if (cursorLen > lenFalse && strncmp(tokenizer->cursor, "false", lenFalse) == 0) {
-                                tokenizer->token.type = LITERAL_FALSE;
-                                tokenizer->token.length = lenFalse;
-                        } else if (cursorLen > lenTrueNull && strncmp(tokenizer->cursor, "null", lenTrueNull) == 0) {
-                                tokenizer->token.type = LITERAL_NULL;
-                                tokenizer->token.length = lenTrueNull;
-                        } else {
-                                goto caseTokenUnknown;
-                        }
-                        tokenizer->token.column++;
-                        tokenizer->cursor += tokenizer->token.length;
-                } else if (c == '-' || isdigit(c)) {
+        const char *end = tokenizer->input + tokenizer->input_len;
+        if (unlikely(tokenizer->cursor == end)) {
+                return NULL;
+        }
+
+        size_t pos = tokenizer_next_position(tokenizer, true);
+        if (unlikely(pos == tokenizer->input_len)) {
+                tokenizer->cursor = end;
+                return NULL;
+        }
+
+        const char *begin = tokenizer->input + pos;
+        char c = *begin;
+        tokenizer->token.string = begin;
+        tokenizer->token.line = tokenizer->line;
+        tokenizer->token.column = pos - tokenizer->line_begin + 1;
+
+        switch (c) {
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+        case ':':
+        case ',':
+                tokenizer->token.type = c == '{' ? OBJECT_OPEN : c == '}' ? OBJECT_CLOSE : c == '[' ? ARRAY_OPEN :
+                                        c == ']' ? ARRAY_CLOSE : c == ':' ? ASSIGN : COMMA;
+                tokenizer->token.length = 1;
+                tokenizer->cursor = begin + 1;
+                break;
+        case '"': {
+                /* inside string literals, the index contains nothing but the closing quote */
+                size_t close = tokenizer_next_position(tokenizer, true);
+                tokenizer->token.type = LITERAL_STRING;
+                tokenizer->token.string = begin + 1;
+                tokenizer->token.length = close - pos - 1;
+                tokenizer->cursor = close == tokenizer->input_len ? end : tokenizer->input + close + 1;
+        }
+                break;
+        case 't':
+        case 'f':
+        case 'n':
+                if (strncmp(begin, "true", 4) == 0) {
+                        tokenizer->token.type = LITERAL_TRUE;
+                        tokenizer->token.length = 4;
+                } else if (strncmp(begin, "false", 5) == 0) {
+                        tokenizer->token.type = LITERAL_FALSE;
+                        tokenizer->token.length = 5;
+                } else if (strncmp(begin, "null", 4) == 0) {
+                        tokenizer->token.type = LITERAL_NULL;
+                        tokenizer->token.length = 4;
+                } else {
+                        goto caseTokenUnknown;
+                }
+                if (unlikely(!tokenizer_is_delimiter(begin[tokenizer->token.length]))) {
+                        goto caseTokenUnknown;
+                }
+                tokenizer->cursor = begin + tokenizer->token.length;
+                break;
+        default:
+                if (c == '-' || tokenizer_is_digit(c)) {
+                        const char *cursor = begin;
                         unsigned fracFound = 0, expFound = 0, plusMinusFound = 0;
                         bool plusMinusAllowed = false;
                         bool onlyDigitsAllowed = false;
                         do {
                                 onlyDigitsAllowed |= plusMinusAllowed;
                                 plusMinusAllowed = (expFound == 1);
-                                c = *(++tokenizer->cursor);
+                                c = *(++cursor);
                                 fracFound += c == '.';
                                 expFound += (c == 'e') || (c == 'E');
                                 plusMinusFound += plusMinusAllowed && ((c == '+') || (c == '-')) ? 1 : 0;
-                                tokenizer->token.length++;
                         }
-                        while ((((isdigit(c)) || (c == '.' && fracFound <= 1)
+                        while ((tokenizer_is_digit(c) || (c == '.' && fracFound <= 1)
                                 || (plusMinusAllowed && (plusMinusFound <= 1) && ((c == '+') || (c == '-')))
-                                || ((c == 'e' || c == 'E') && expFound <= 1))) && c != '\n' && c != '\r');
+                                || ((c == 'e' || c == 'E') && expFound <= 1)));
 
-                        if (!isdigit(*(tokenizer->cursor - 1))) {
-                                tokenizer->token.column -= tokenizer->token.length;
+                        if (!tokenizer_is_digit(*(cursor - 1)) || !tokenizer_is_delimiter(c)) {
                                 goto caseTokenUnknown;
                         }
-                        tokenizer->cursor += (c == '\r' || c == '\n') ? 1 : 0;
                         tokenizer->token.type = fracFound ? LITERAL_FLOAT : LITERAL_INT;
+                        tokenizer->token.length = cursor - begin;
+                        tokenizer->cursor = cursor;
                 } else {
                         caseTokenUnknown:
+                        /* the remaining input is returned as one unknown token */
                         tokenizer->token.type = JSON_UNKNOWN;
-                        tokenizer->token.column++;
-                        tokenizer->token.length = strlen(tokenizer->cursor);
-                        tokenizer->cursor += tokenizer->token.length;
+                        tokenizer->token.length = end - begin;
+                        tokenizer->cursor = end;
                 }
-                return &tokenizer->token;
-        } else {
-                return NULL;
         }
+        return &tokenizer->token;
 }
 
 void json_token_dup(struct json_token *dst, const struct json_token *src)
@@ -186,19 +263,19 @@ void json_token_print(FILE *file, const struct json_token *token)
         free(string);
 }
 
-static bool parse_object(struct json_object_t *object, struct err *err,
+static bool parse_object(struct json_object_t *object, struct err *err, struct allocator *alloc,
         struct vector ofType(struct json_token) *token_stream, size_t *token_idx);
-static bool parse_array(struct json_array *array, struct err *err,
+static bool parse_array(struct json_array *array, struct err *err, struct allocator *alloc,
+        struct vector ofType(struct json_token) *token_stream, size_t *token_idx);
+static void parse_string(struct json_string *string, struct allocator *alloc,
         struct vector ofType(struct json_token) *token_stream, size_t *token_idx);
-static void parse_string(struct json_string *string, struct vector ofType(struct json_token) *token_stream,
-        size_t *token_idx);
 static void parse_number(struct json_number *number, struct vector ofType(struct json_token) *token_stream,
         size_t *token_idx);
-static bool parse_element(struct json_element *element, struct err *err,
+static bool parse_element(struct json_element *element, struct err *err, struct allocator *alloc,
         struct vector ofType(struct json_token) *token_stream, size_t *token_idx);
-static bool parse_elements(struct json_elements *elements, struct err *err,
+static bool parse_elements(struct json_elements *elements, struct err *err, struct allocator *alloc,
         struct vector ofType(struct json_token) *token_stream, size_t *token_idx);
-static bool parse_token_stream(struct json *json, struct err *err,
+static bool parse_token_stream(struct json *json, struct err *err, struct allocator *alloc,
         struct vector ofType(struct json_token) *token_stream);
 static struct json_token get_token(struct vector ofType(struct json_token) *token_stream, size_t token_idx);
 static void connect_child_and_parents_member(struct json_prop *member);
@@ -224,6 +301,7 @@ NG5_EXPORT(bool) json_parser_create(struct json_parser *parser, struct doc_bulk
         error_if_null(partition)
 
         parser->partition = partition;
+        alloc_clone(&parser->alloc, &partition->alloc);
         error_init(&parser->err);
 
         return true;
@@ -237,7 +315,9 @@ bool json_parse(struct json *json, struct json_err *error_desc, struct json_pars
         struct vector ofType(enum json_token_type) brackets;
         struct vector ofType(struct json_token) token_stream;
 
-        struct json retval = {.element = malloc(sizeof(struct json_element))};
+        struct json retval;
+        alloc_clone(&retval.alloc, &parser->alloc);
+        retval.element = alloc_malloc(&retval.alloc, sizeof(struct json_element));
         error_init(&retval.err);
         const struct json_token *token;
         int status;
@@ -268,11 +348,11 @@ bool json_parse(struct json *json, struct json_err *error_desc, struct json_pars
                 goto cleanup;
         }
 
-        if (!parse_token_stream(&retval, &parser->err, &token_stream)) {
+        if (!parse_token_stream(&retval, &parser->err, &retval.alloc, &token_stream)) {
                 return false;
         }
 
-        ng5_optional_set_or_else(json, retval, json_drop(json));
+        ng5_optional_set_or_else(json, retval, json_drop(&retval));
         status = true;
 
         cleanup:
@@ -281,6 +361,698 @@ bool json_parse(struct json *json, struct json_err *error_desc, struct json_pars
         return status;
 }
 
+/**
+ * Single-pass import of a JSON document into a document partition.
+ *
+ * The input is validated and imported on the fly by recursive descent that walks the structural index of the
+ * parser's tokenizer (see json_scan.h): the parser jumps from one structural character, quote or scalar start to the
+ * next, and skips whitespaces and string contents without looking at them. Only scalars are read byte by byte. Neither
+ * a token stream nor an AST is materialized: keys and values are pushed into the document model via 'doc_obj_add_key',
+ * 'doc_obj_push_primtive' and 'doc_obj_push_object' as soon as they are read. The only exception are arrays of
+ * primitive values, whose elements must be seen entirely to determine the (smallest fitting) array type; these
+ * elements are buffered in a reused vector that points into the input (arrays of arrays are not supported, so that
+ * one such buffer is sufficient).
+ */
+
+enum sax_value_kind {
+        SAX_VALUE_NULL, SAX_VALUE_STRING, SAX_VALUE_NUMBER, SAX_VALUE_BOOLEAN, SAX_VALUE_OBJECT
+};
+
+struct sax_value {
+        enum sax_value_kind kind;
+        const char *string;
+        u32 string_len;
+        FIELD_BOOLEANean_t boolean;
+        struct json_number number;
+};
+
+struct sax_parser {
+        const char *input;
+        const char *end;
+        const char *cursor;             /* last position taken from the structural index */
+        struct json_tokenizer *index;
+        struct json_parser *parser;
+        struct json_err *error_desc;
+        struct vector ofType(char) key_buffer;
+        struct vector ofType(char) value_buffer;
+        struct vector ofType(struct sax_value) array_values;
+};
+
+static bool sax_parse_object(struct sax_parser *sax, struct doc_obj *target);
+
+static bool sax_error(struct sax_parser *sax, int code, const char *msg)
+{
+        struct json_tokenizer *tokenizer = &sax->parser->tokenizer;
+        const struct json_token *token;
+        unsigned line = 1, column = 0;
+
+        for (const char *it = sax->input; it < sax->cursor; it++) {
+                line += *it == '\n' ? 1 : 0;
+                column = *it == '\n' ? 0 : column + 1;
+        }
+
+        json_tokenizer_init(tokenizer, sax->cursor);
+        token = json_tokenizer_next(tokenizer);
+        if (token) {
+                tokenizer->token.line += line - 1;
+                tokenizer->token.column += column;
+        }
+
+        error(&sax->parser->err, code);
+        return set_error(sax->error_desc, token, msg);
+}
+
+/** moves the cursor to the next position in the structural index, or to the end of the input if there is none */
+static inline void sax_next(struct sax_parser *sax)
+{
+        sax->cursor = sax->index->input + tokenizer_next_position(sax->index, false);
+}
+
+/** a scalar must be followed by a whitespace, a structural character, or the end of the input */
+static inline bool sax_scalar_ends(const struct sax_parser *sax)
+{
+        return sax->cursor == sax->end || tokenizer_is_delimiter(*sax->cursor);
+}
+
+static const char *sax_to_cstr(struct vector ofType(char) *buffer, const char *string, u32 string_len)
+{
+        vec_clear(buffer);
+        vec_push(buffer, string, string_len);
+        vec_push(buffer, "\0", 1);
+        return vec_all(buffer, char);
+}
+
+static bool sax_parse_string(const char **string, u32 *string_len, struct sax_parser *sax)
+{
+        assert(*sax->cursor == '"');
+        const char *begin = sax->cursor + 1;
+
+        /** inside a string literal, the structural index contains nothing but the closing quote */
+        sax_next(sax);
+        if (unlikely(sax->cursor == sax->end)) {
+                sax->cursor = begin - 1;
+                return sax_error(sax, NG5_ERR_JSONPARSEERR, "Unterminated string literal");
+        }
+        *string = begin;
+        *string_len = sax->cursor - begin;
+        sax_next(sax);
+        return true;
+}
+
+static bool sax_parse_number(struct json_number *number, struct sax_parser *sax)
+{
+        const char *begin = sax->cursor;
+        bool negative = *sax->cursor == '-';
+        bool is_float = false, overflow = false;
+        u64 magnitude = 0;
+
+        sax->cursor += negative ? 1 : 0;
+        if (unlikely(!isdigit(*sax->cursor))) {
+                goto malformed;
+        }
+        while (isdigit(*sax->cursor)) {
+                u64 digit = *sax->cursor++ - '0';
+                overflow |= magnitude > (UINT64_MAX - digit) / 10;
+                magnitude = magnitude * 10 + digit;
+        }
+        if (*sax->cursor == '.') {
+                is_float = true;
+                if (unlikely(!isdigit(*(++sax->cursor)))) {
+                        goto malformed;
+                }
+                while (isdigit(*sax->cursor)) {
+                        sax->cursor++;
+                }
+        }
+        if (*sax->cursor == 'e' || *sax->cursor == 'E') {
+                is_float = true;
+                sax->cursor++;
+                sax->cursor += (*sax->cursor == '+' || *sax->cursor == '-') ? 1 : 0;
+                if (unlikely(!isdigit(*sax->cursor))) {
+                        goto malformed;
+                }
+                while (isdigit(*sax->cursor)) {
+                        sax->cursor++;
+                }
+        }
+        if (unlikely(!sax_scalar_ends(sax))) {
+                goto malformed;
+        }
+
+        if (is_float) {
+                number->value_type = JSON_NUMBER_FLOAT;
+                number->value.float_number = strtof(begin, NULL);
+        } else if (negative) {
+                number->value_type = JSON_NUMBER_SIGNED;
+                number->value.signed_integer = (overflow || magnitude > (u64) INT64_MAX) ? INT64_MIN : -(i64) magnitude;
+        } else if (overflow || magnitude > (u64) INT64_MAX) {
+                number->value_type = JSON_NUMBER_UNSIGNED;
+                number->value.unsigned_integer = overflow ? UINT64_MAX : magnitude;
+        } else {
+                number->value_type = JSON_NUMBER_SIGNED;
+                number->value.signed_integer = (i64) magnitude;
+        }
+        sax_next(sax);
+        return true;
+
+        malformed:
+        sax->cursor = begin;
+        return sax_error(sax, NG5_ERR_JSONPARSEERR, "Malformed number literal");
+}
+
+static bool sax_parse_keyword(struct sax_parser *sax, const char *keyword, size_t keyword_len)
+{
+        if (strncmp(sax->cursor, keyword, keyword_len) == 0) {
+                sax->cursor += keyword_len;
+                if (likely(sax_scalar_ends(sax))) {
+                        sax_next(sax);
+                        return true;
+                }
+                sax->cursor -= keyword_len;
+        }
+        return false;
+}
+
+static bool sax_parse_literal(struct sax_value *value, struct sax_parser *sax)
+{
+        switch (*sax->cursor) {
+        case '"':
+                value->kind = SAX_VALUE_STRING;
+                return sax_parse_string(&value->string, &value->string_len, sax);
+        case 't':
+                if (sax_parse_keyword(sax, "true", 4)) {
+                        value->kind = SAX_VALUE_BOOLEAN;
+                        value->boolean = NG5_BOOLEAN_TRUE;
+                        return true;
+                }
+                break;
+        case 'f':
+                if (sax_parse_keyword(sax, "false", 5)) {
+                        value->kind = SAX_VALUE_BOOLEAN;
+                        value->boolean = NG5_BOOLEAN_FALSE;
+                        return true;
+                }
+                break;
+        case 'n':
+                if (sax_parse_keyword(sax, "null", 4)) {
+                        value->kind = SAX_VALUE_NULL;
+                        return true;
+                }
+                break;
+        default:
+                if (*sax->cursor == '-' || isdigit(*sax->cursor)) {
+                        value->kind = SAX_VALUE_NUMBER;
+                        return sax_parse_number(&value->number, sax);
+                }
+                break;
+        }
+        return sax_error(sax, NG5_ERR_JSONPARSEERR, "Expected value (string, number, object, enumeration, true, "
+                "false, or null).");
+}
+
+/** smallest field type that fits all numbers in [min, max], or float resp. u64 if such a number is contained */
+static field_e sax_number_type(bool has_float, bool has_unsigned, i64 min, i64 max)
+{
+        if (has_float) {
+                return FIELD_FLOAT;
+        } else if (has_unsigned || max > NG5_LIMITS_INT64_MAX) {
+                return FIELD_UINT64;
+        } else if (min >= NG5_LIMITS_INT8_MIN && max <= NG5_LIMITS_INT8_MAX) {
+                return FIELD_INT8;
+        } else if (min >= NG5_LIMITS_INT16_MIN && max <= NG5_LIMITS_INT16_MAX) {
+                return FIELD_INT16;
+        } else if (min >= NG5_LIMITS_INT32_MIN && max <= NG5_LIMITS_INT32_MAX) {
+                return FIELD_INT32;
+        } else {
+                return FIELD_INT64;
+        }
+}
+
+static void sax_push_number(struct doc_entries *entry, field_e type, const struct sax_value *value)
+{
+        bool is_null = value->kind == SAX_VALUE_NULL;
+        const struct json_number *number = &value->number;
+        i64 signed_value = number->value.signed_integer;
+
+        switch (type) {
+        case FIELD_INT8: {
+                field_i8_t v = is_null ? NG5_NULL_INT8 : (field_i8_t) signed_value;
+                doc_obj_push_primtive(entry, &v);
+        }
+                break;
+        case FIELD_INT16: {
+                field_i16_t v = is_null ? NG5_NULL_INT16 : (field_i16_t) signed_value;
+                doc_obj_push_primtive(entry, &v);
+        }
+                break;
+        case FIELD_INT32: {
+                field_i32_t v = is_null ? NG5_NULL_INT32 : (field_i32_t) signed_value;
+                doc_obj_push_primtive(entry, &v);
+        }
+                break;
+        case FIELD_INT64: {
+                field_i64_t v = is_null ? NG5_NULL_INT64 : (field_i64_t) signed_value;
+                doc_obj_push_primtive(entry, &v);
+        }
+                break;
+        case FIELD_UINT64: {
+                field_u64_t v = is_null ? NG5_NULL_UINT64 : (number->value_type == JSON_NUMBER_UNSIGNED ?
+                        number->value.unsigned_integer : (field_u64_t) signed_value);
+                doc_obj_push_primtive(entry, &v);
+        }
+                break;
+        case FIELD_FLOAT: {
+                field_number_t v = NG5_NULL_FLOAT;
+                if (!is_null) {
+                        if (number->value_type == JSON_NUMBER_FLOAT) {
+                                v = number->value.float_number;
+                        } else if (number->value_type == JSON_NUMBER_UNSIGNED) {
+                                v = number->value.unsigned_integer;
+                        } else {
+                                v = signed_value;
+                        }
+                }
+                doc_obj_push_primtive(entry, &v);
+        }
+                break;
+        default: print_error_and_die(NG5_ERR_INTERNALERR) /** not a number type  */
+                break;
+        }
+}
+
+static void sax_push_primitive(struct sax_parser *sax, struct doc_entries *entry, field_e type,
+        const struct sax_value *value)
+{
+        switch (type) {
+        case FIELD_NULL:
+                doc_obj_push_primtive(entry, NULL);
+                break;
+        case FIELD_STRING:
+                doc_obj_push_primtive(entry, value->kind == SAX_VALUE_NULL ? NG5_NULL_ENCODED_STRING :
+                        sax_to_cstr(&sax->value_buffer, value->string, value->string_len));
+                break;
+        case FIELD_BOOLEAN: {
+                FIELD_BOOLEANean_t v = value->kind == SAX_VALUE_NULL ? NG5_NULL_BOOLEAN : value->boolean;
+                doc_obj_push_primtive(entry, &v);
+        }
+                break;
+        default:
+                sax_push_number(entry, type, value);
+                break;
+        }
+}
+
+static field_e sax_value_type(const struct sax_value *values, size_t num_values)
+{
+        enum sax_value_kind kind = SAX_VALUE_NULL;
+        bool has_float = false, has_unsigned = false;
+        i64 min = 0, max = 0;
+
+        for (size_t i = 0; i < num_values; i++) {
+                const struct sax_value *value = values + i;
+                kind = value->kind == SAX_VALUE_NULL ? kind : value->kind;
+                if (value->kind == SAX_VALUE_NUMBER) {
+                        const struct json_number *number = &value->number;
+                        has_float |= number->value_type == JSON_NUMBER_FLOAT;
+                        has_unsigned |= number->value_type == JSON_NUMBER_UNSIGNED;
+                        if (number->value_type == JSON_NUMBER_SIGNED) {
+                                min = ng5_min(min, number->value.signed_integer);
+                                max = ng5_max(max, number->value.signed_integer);
+                        }
+                }
+        }
+
+        switch (kind) {
+        case SAX_VALUE_STRING:
+                return FIELD_STRING;
+        case SAX_VALUE_BOOLEAN:
+                return FIELD_BOOLEAN;
+        case SAX_VALUE_NUMBER:
+                return sax_number_type(has_float, has_unsigned, min, max);
+        default:
+                return FIELD_NULL;
+        }
+}
+
+static bool sax_parse_array_prop(struct sax_parser *sax, struct doc_obj *target, const char *key)
+{
+        struct doc_entries *entry = NULL;
+        enum sax_value_kind kind = SAX_VALUE_NULL;
+        const char *element;
+
+        assert(*sax->cursor == '[');
+        sax_next(sax);
+        vec_clear(&sax->array_values);
+
+        if (*sax->cursor == ']') {
+                /** empty arrays are imported as null */
+                sax_next(sax);
+                doc_obj_add_key(&entry, target, key, FIELD_NULL);
+                doc_obj_push_primtive(entry, NULL);
+                return true;
+        }
+
+        while (true) {
+                /** errors on mixed types are reported at the first element whose type does not match */
+                element = sax->cursor;
+                if (unlikely(*sax->cursor == '[')) {
+                        return sax_error(sax, NG5_ERR_ARRAYOFARRAYS, "JSON file constraint broken: arrays of "
+                                "arrays detected");
+                } else if (*sax->cursor == '{') {
+                        if (kind == SAX_VALUE_NULL) {
+                                /** leading nulls in an array of objects are imported as empty objects */
+                                kind = SAX_VALUE_OBJECT;
+                                doc_obj_add_key(&entry, target, key, FIELD_OBJECT);
+                                for (size_t i = 0; i < sax->array_values.num_elems; i++) {
+                                        struct doc_obj *nested;
+                                        doc_obj_push_object(&nested, entry);
+                                }
+                        } else if (unlikely(kind != SAX_VALUE_OBJECT)) {
+                                goto mixed_types;
+                        }
+                        struct doc_obj *nested;
+                        doc_obj_push_object(&nested, entry);
+                        if (!sax_parse_object(sax, nested)) {
+                                return false;
+                        }
+                } else {
+                        struct sax_value value;
+                        if (!sax_parse_literal(&value, sax)) {
+                                return false;
+                        }
+                        if (kind == SAX_VALUE_OBJECT) {
+                                if (unlikely(value.kind != SAX_VALUE_NULL)) {
+                                        goto mixed_types;
+                                }
+                                struct doc_obj *nested;
+                                doc_obj_push_object(&nested, entry);
+                        } else {
+                                if (unlikely(kind != SAX_VALUE_NULL && value.kind != SAX_VALUE_NULL &&
+                                        value.kind != kind)) {
+                                        goto mixed_types;
+                                }
+                                kind = value.kind == SAX_VALUE_NULL ? kind : value.kind;
+                                vec_push(&sax->array_values, &value, 1);
+                        }
+                }
+
+                if (*sax->cursor == ',') {
+                        sax_next(sax);
+                } else if (*sax->cursor == ']') {
+                        sax_next(sax);
+                        break;
+                } else {
+                        return sax_error(sax, NG5_ERR_JSONPARSEERR, "Expected enumeration (','), or end of "
+                                "enumeration (']')");
+                }
+        }
+
+        if (kind != SAX_VALUE_OBJECT) {
+                const struct sax_value *values = vec_all(&sax->array_values, struct sax_value);
+                size_t num_values = sax->array_values.num_elems;
+                field_e type = sax_value_type(values, num_values);
+                doc_obj_add_key(&entry, target, key, type);
+                for (size_t i = 0; i < num_values; i++) {
+                        sax_push_primitive(sax, entry, type, values + i);
+                }
+        }
+        return true;
+
+        mixed_types:
+        sax->cursor = element;
+        return sax_error(sax, NG5_ERR_ARRAYOFMIXEDTYPES, "JSON file constraint broken: arrays of mixed types "
+                "detected");
+}
+
+static bool sax_parse_prop(struct sax_parser *sax, struct doc_obj *target, const char *key)
+{
+        struct doc_entries *entry;
+
+        switch (*sax->cursor) {
+        case '{': {
+                struct doc_obj *nested;
+                doc_obj_add_key(&entry, target, key, FIELD_OBJECT);
+                doc_obj_push_object(&nested, entry);
+                return sax_parse_object(sax, nested);
+        }
+        case '[':
+                return sax_parse_array_prop(sax, target, key);
+        default: {
+                struct sax_value value;
+                if (!sax_parse_literal(&value, sax)) {
+                        return false;
+                }
+                field_e type = sax_value_type(&value, 1);
+                doc_obj_add_key(&entry, target, key, type);
+                sax_push_primitive(sax, entry, type, &value);
+                return true;
+        }
+        }
+}
+
+static bool sax_parse_object(struct sax_parser *sax, struct doc_obj *target)
+{
+        assert(*sax->cursor == '{');
+        sax_next(sax);
+
+        if (*sax->cursor == '}') {
+                sax_next(sax);
+                return true;
+        }
+
+        while (true) {
+                const char *key = NULL;
+                u32 key_len = 0;
+
+                if (unlikely(*sax->cursor != '"')) {
+                        return sax_error(sax, NG5_ERR_JSONPARSEERR, "Expected key name or '}'");
+                }
+                if (!sax_parse_string(&key, &key_len, sax)) {
+                        return false;
+                }
+                if (unlikely(*sax->cursor != ':')) {
+                        return sax_error(sax, NG5_ERR_JSONPARSEERR, "Expected key name (missing ':')");
+                }
+                sax_next(sax);
+
+                /** the key buffer is reused for nested keys, which is safe since 'doc_obj_add_key' copies the key
+                 * before any nested object is read */
+                if (!sax_parse_prop(sax, target, sax_to_cstr(&sax->key_buffer, key, key_len))) {
+                        return false;
+                }
+
+                if (*sax->cursor == ',') {
+                        sax_next(sax);
+                } else if (*sax->cursor == '}') {
+                        sax_next(sax);
+                        return true;
+                } else {
+                        return sax_error(sax, NG5_ERR_JSONPARSEERR, "Expected enumeration (','), or end of "
+                                "object ('}')");
+                }
+        }
+}
+
+static bool sax_parse_document(struct doc_obj **out, struct sax_parser *sax, struct doc_entries *partition)
+{
+        size_t root_idx = partition->values.num_elems;
+        struct doc_obj *root;
+
+        doc_obj_push_object(&root, partition);
+
+        if (*sax->cursor == '{') {
+                if (!sax_parse_object(sax, root)) {
+                        return false;
+                }
+        } else if (*sax->cursor == '[') {
+                /** the first object of a top-level array is the root, and its successors are siblings of the root */
+                sax_next(sax);
+                for (bool is_first = true; ; is_first = false) {
+                        struct doc_obj *target = root;
+                        if (is_first && *sax->cursor == ']') {
+                                break;
+                        } else if (unlikely(*sax->cursor == ']')) {
+                                return sax_error(sax, NG5_ERR_JSONPARSEERR, "Expected JSON object after "
+                                        "enumeration (',')");
+                        } else if (unlikely(*sax->cursor != '{')) {
+                                return sax_error(sax, NG5_ERR_JSONTYPE, "Expected JSON object in top-level array");
+                        }
+                        if (!is_first) {
+                                doc_obj_push_object(&target, partition);
+                        }
+                        if (!sax_parse_object(sax, target)) {
+                                return false;
+                        }
+                        if (*sax->cursor == ',') {
+                                sax_next(sax);
+                        } else if (*sax->cursor == ']') {
+                                break;
+                        } else {
+                                return sax_error(sax, NG5_ERR_JSONPARSEERR, "Expected enumeration (','), or "
+                                        "end of enumeration (']')");
+                        }
+                }
+                sax_next(sax);
+        } else {
+                return sax_error(sax, NG5_ERR_JSONPARSEERR, "Expected JSON document: missing '{' or '['");
+        }
+
+        if (unlikely(sax->cursor != sax->end)) {
+                return sax_error(sax, NG5_ERR_JSONPARSEERR, "Unexpected token");
+        }
+
+        ng5_optional_set(out, vec_get(&partition->values, root_idx, struct doc_obj));
+        return true;
+}
+
+/** starts parsing [<code>begin</code>, <code>end</code>) of <code>input</code> at the first structural position */
+static void sax_create(struct sax_parser *sax, struct json_err *error_desc, struct json_parser *parser,
+        const char *input, const char *begin, const char *end)
+{
+        *sax = (struct sax_parser) {.input = input, .end = end, .index = &parser->tokenizer, .parser = parser,
+                .error_desc = error_desc};
+
+        vec_create(&sax->key_buffer, NULL, sizeof(char), 256);
+        vec_create(&sax->value_buffer, NULL, sizeof(char), 256);
+        vec_create(&sax->array_values, NULL, sizeof(struct sax_value), 64);
+
+        tokenizer_init_index(sax->index, begin, end - begin);
+        sax_next(sax);
+}
+
+static void sax_drop(struct sax_parser *sax)
+{
+        vec_drop(&sax->key_buffer);
+        vec_drop(&sax->value_buffer);
+        vec_drop(&sax->array_values);
+}
+
+NG5_EXPORT(bool) json_parse_to_doc(struct doc_obj **out, struct json_err *error_desc, struct json_parser *parser,
+        struct doc_entries *partition, const char *input)
+{
+        error_if_null(parser)
+        error_if_null(partition)
+        error_if_null(input)
+
+        struct sax_parser sax;
+        sax_create(&sax, error_desc, parser, input, input, input + strlen(input));
+        bool status = sax_parse_document(out, &sax, partition);
+        sax_drop(&sax);
+        return status;
+}
+
+NG5_EXPORT(size_t) json_split_records(struct json_record_range *ranges, size_t max_ranges, const char *input)
+{
+        if (!ranges || max_ranges == 0 || !input) {
+                return 0;
+        }
+
+        size_t input_len = strlen(input), range_size = input_len / max_ranges;
+        size_t num_ranges = 0, depth = 0;
+        bool has_records = false;
+        const char *begin = NULL;
+        struct json_scan_carry carry = {.escaped = 0, .in_string = 0, .scalar_pred = 1};
+
+        if (input[strspn(input, " \t\r\n")] != '[') {
+                return 0;
+        }
+
+        for (size_t block_begin = 0; block_begin < input_len; block_begin += NG5_JSON_SCAN_BLOCK_SIZE) {
+                struct json_scan_block block;
+                size_t remain = input_len - block_begin;
+                if (likely(remain >= NG5_JSON_SCAN_BLOCK_SIZE)) {
+                        json_scan_classify(&block, input + block_begin);
+                } else {
+                        char tail[NG5_JSON_SCAN_BLOCK_SIZE];
+                        memset(tail, ' ', sizeof(tail));
+                        memcpy(tail, input + block_begin, remain);
+                        json_scan_classify(&block, tail);
+                }
+                /** only brackets and separators outside of string literals are of interest here */
+                u64 index = json_scan_index(&block, &carry) & block.structural;
+
+                while (index) {
+                        size_t pos = block_begin + __builtin_ctzll(index);
+                        index &= index - 1;
+                        switch (input[pos]) {
+                        case '[':
+                        case '{':
+                                has_records |= (depth == 1 && input[pos] == '{');
+                                if (depth++ == 0) {
+                                        begin = input + pos + 1;
+                                }
+                                break;
+                        case ']':
+                        case '}':
+                                if (unlikely(depth == 0)) {
+                                        return 0;
+                                } else if (--depth == 0) {
+                                        ranges[num_ranges++] = (struct json_record_range) {begin, input + pos};
+                                        pos++;
+                                        return (has_records && pos + strspn(input + pos, " \t\r\n") == input_len)
+                                                ? num_ranges : 0;
+                                }
+                                break;
+                        case ',':
+                                if (depth == 1 && num_ranges + 1 < max_ranges
+                                        && pos >= (num_ranges + 1) * range_size) {
+                                        ranges[num_ranges++] = (struct json_record_range) {begin, input + pos};
+                                        begin = input + pos + 1;
+                                }
+                                break;
+                        default:
+                                break;
+                        }
+                }
+        }
+        return 0;
+}
+
+NG5_EXPORT(bool) json_parse_records_to_doc(struct json_err *error_desc, struct json_parser *parser,
+        struct doc_entries *partition, const char *input, const struct json_record_range *range)
+{
+        error_if_null(parser)
+        error_if_null(partition)
+        error_if_null(input)
+        error_if_null(range)
+
+        /** strings of the records in 'range' are closed within 'range', since the range was split outside of them;
+         * hence, the structural index of the range is the same as the one of the entire input */
+        struct sax_parser sax;
+        bool status = true;
+
+        sax_create(&sax, error_desc, parser, input, range->begin, range->end);
+
+        while (status) {
+                struct doc_obj *target;
+                /** ranges are not empty, and a consumed ',' must be followed by another record, as in
+                 * 'json_parse_to_doc' */
+                if (unlikely(sax.cursor == range->end && *range->end == ']')) {
+                        status = sax_error(&sax, NG5_ERR_JSONPARSEERR, "Expected JSON object after enumeration "
+                                "(',')");
+                        break;
+                } else if (unlikely(*sax.cursor != '{')) {
+                        status = sax_error(&sax, NG5_ERR_JSONTYPE, "Expected JSON object in top-level array");
+                        break;
+                }
+                doc_obj_push_object(&target, partition);
+                if (!(status = sax_parse_object(&sax, target))) {
+                        break;
+                }
+                if (sax.cursor == range->end) {
+                        break;
+                } else if (*sax.cursor == ',') {
+                        sax_next(&sax);
+                } else {
+                        status = sax_error(&sax, NG5_ERR_JSONPARSEERR, "Expected enumeration (','), or end of "
+                                "enumeration (']')");
+                }
+        }
+
+        sax_drop(&sax);
+        return status;
+}
+
 bool test_condition_value(struct err *err, struct json_node_value *value)
 {
         switch (value->value_type) {
@@ -359,17 +1131,17 @@ static struct json_token get_token(struct vector ofType(struct json_token) *toke
         return *(struct json_token *) vec_at(token_stream, token_idx);
 }
 
-bool parse_members(struct err *err, struct json_members *members, struct vector ofType(struct json_token) *token_stream,
-        size_t *token_idx)
+bool parse_members(struct err *err, struct json_members *members, struct allocator *alloc,
+        struct vector ofType(struct json_token) *token_stream, size_t *token_idx)
 {
-        vec_create(&members->members, NULL, sizeof(struct json_prop), 20);
+        vec_create(&members->members, alloc, sizeof(struct json_prop), 20);
         struct json_token delimiter_token;
 
         do {
                 struct json_prop *member = vec_new_and_get(&members->members, struct json_prop);
                 struct json_token keyNameToken = get_token(token_stream, *token_idx);
 
-                member->key.value = malloc(keyNameToken.length + 1);
+                member->key.value = alloc_malloc(alloc, keyNameToken.length + 1);
                 strncpy(member->key.value, keyNameToken.string, keyNameToken.length);
                 member->key.value[keyNameToken.length] = '\0';
 
@@ -380,27 +1152,27 @@ bool parse_members(struct err *err, struct json_members *members, struct vector
                 switch (valueToken.type) {
                 case OBJECT_OPEN:
                         member->value.value.value_type = JSON_VALUE_OBJECT;
-                        member->value.value.value.object = malloc(sizeof(struct json_object_t));
-                        if (!parse_object(member->value.value.value.object, err, token_stream, token_idx)) {
+                        member->value.value.value.object = alloc_malloc(alloc, sizeof(struct json_object_t));
+                        if (!parse_object(member->value.value.value.object, err, alloc, token_stream, token_idx)) {
                                 return false;
                         }
                         break;
                 case ARRAY_OPEN:
                         member->value.value.value_type = JSON_VALUE_ARRAY;
-                        member->value.value.value.array = malloc(sizeof(struct json_array));
-                        if (!parse_array(member->value.value.value.array, err, token_stream, token_idx)) {
+                        member->value.value.value.array = alloc_malloc(alloc, sizeof(struct json_array));
+                        if (!parse_array(member->value.value.value.array, err, alloc, token_stream, token_idx)) {
                                 return false;
                         }
                         break;
                 case LITERAL_STRING:
                         member->value.value.value_type = JSON_VALUE_STRING;
-                        member->value.value.value.string = malloc(sizeof(struct json_string));
-                        parse_string(member->value.value.value.string, token_stream, token_idx);
+                        member->value.value.value.string = alloc_malloc(alloc, sizeof(struct json_string));
+                        parse_string(member->value.value.value.string, alloc, token_stream, token_idx);
                         break;
                 case LITERAL_INT:
                 case LITERAL_FLOAT:
                         member->value.value.value_type = JSON_VALUE_NUMBER;
-                        member->value.value.value.number = malloc(sizeof(struct json_number));
+                        member->value.value.value.number = alloc_malloc(alloc, sizeof(struct json_number));
                         parse_number(member->value.value.value.number, token_stream, token_idx);
                         break;
                 case LITERAL_TRUE:
@@ -427,29 +1199,29 @@ bool parse_members(struct err *err, struct json_members *members, struct vector
         return true;
 }
 
-static bool parse_object(struct json_object_t *object, struct err *err,
+static bool parse_object(struct json_object_t *object, struct err *err, struct allocator *alloc,
         struct vector ofType(struct json_token) *token_stream, size_t *token_idx)
 {
         assert(get_token(token_stream, *token_idx).type == OBJECT_OPEN);
         NEXT_TOKEN(token_idx);  /** Skip '{' */
-        object->value = malloc(sizeof(struct json_members));
+        object->value = alloc_malloc(alloc, sizeof(struct json_members));
 
         /** test whether this is an empty object */
         struct json_token token = get_token(token_stream, *token_idx);
 
         if (token.type != OBJECT_CLOSE) {
-                if (!parse_members(err, object->value, token_stream, token_idx)) {
+                if (!parse_members(err, object->value, alloc, token_stream, token_idx)) {
                         return false;
                 }
         } else {
-                vec_create(&object->value->members, NULL, sizeof(struct json_prop), 20);
+                vec_create(&object->value->members, alloc, sizeof(struct json_prop), 20);
         }
 
         NEXT_TOKEN(token_idx);  /** Skip '}' */
         return true;
 }
 
-static bool parse_array(struct json_array *array, struct err *err,
+static bool parse_array(struct json_array *array, struct err *err, struct allocator *alloc,
         struct vector ofType(struct json_token) *token_stream, size_t *token_idx)
 {
         struct json_token token = get_token(token_stream, *token_idx);
@@ -457,8 +1229,8 @@ static bool parse_array(struct json_array *array, struct err *err,
         assert(token.type == ARRAY_OPEN);
         NEXT_TOKEN(token_idx); /** Skip '[' */
 
-        vec_create(&array->elements.elements, NULL, sizeof(struct json_element), 250);
-        if (!parse_elements(&array->elements, err, token_stream, token_idx)) {
+        vec_create(&array->elements.elements, alloc, sizeof(struct json_element), 250);
+        if (!parse_elements(&array->elements, err, alloc, token_stream, token_idx)) {
                 return false;
         }
 
@@ -466,13 +1238,13 @@ static bool parse_array(struct json_array *array, struct err *err,
         return true;
 }
 
-static void parse_string(struct json_string *string, struct vector ofType(struct json_token) *token_stream,
-        size_t *token_idx)
+static void parse_string(struct json_string *string, struct allocator *alloc,
+        struct vector ofType(struct json_token) *token_stream, size_t *token_idx)
 {
         struct json_token token = get_token(token_stream, *token_idx);
         assert(token.type == LITERAL_STRING);
 
-        string->value = malloc(token.length + 1);
+        string->value = alloc_malloc(alloc, token.length + 1);
         if (likely(token.length > 0)) {
                 strncpy(string->value, token.string, token.length);
         }
@@ -515,30 +1287,30 @@ static void parse_number(struct json_number *number, struct vector ofType(struct
         NEXT_TOKEN(token_idx);
 }
 
-static bool parse_element(struct json_element *element, struct err *err,
+static bool parse_element(struct json_element *element, struct err *err, struct allocator *alloc,
         struct vector ofType(struct json_token) *token_stream, size_t *token_idx)
 {
         struct json_token token = get_token(token_stream, *token_idx);
 
         if (token.type == OBJECT_OPEN) { /** Parse object */
                 element->value.value_type = JSON_VALUE_OBJECT;
-                element->value.value.object = malloc(sizeof(struct json_object_t));
-                if (!parse_object(element->value.value.object, err, token_stream, token_idx)) {
+                element->value.value.object = alloc_malloc(alloc, sizeof(struct json_object_t));
+                if (!parse_object(element->value.value.object, err, alloc, token_stream, token_idx)) {
                         return false;
                 }
         } else if (token.type == ARRAY_OPEN) { /** Parse array */
                 element->value.value_type = JSON_VALUE_ARRAY;
-                element->value.value.array = malloc(sizeof(struct json_array));
-                if (!parse_array(element->value.value.array, err, token_stream, token_idx)) {
+                element->value.value.array = alloc_malloc(alloc, sizeof(struct json_array));
+                if (!parse_array(element->value.value.array, err, alloc, token_stream, token_idx)) {
                         return false;
                 }
         } else if (token.type == LITERAL_STRING) { /** Parse string */
                 element->value.value_type = JSON_VALUE_STRING;
-                element->value.value.string = malloc(sizeof(struct json_string));
-                parse_string(element->value.value.string, token_stream, token_idx);
+                element->value.value.string = alloc_malloc(alloc, sizeof(struct json_string));
+                parse_string(element->value.value.string, alloc, token_stream, token_idx);
         } else if (token.type == LITERAL_FLOAT || token.type == LITERAL_INT) { /** Parse number */
                 element->value.value_type = JSON_VALUE_NUMBER;
-                element->value.value.number = malloc(sizeof(struct json_number));
+                element->value.value.number = alloc_malloc(alloc, sizeof(struct json_number));
                 parse_number(element->value.value.number, token_stream, token_idx);
         } else if (token.type == LITERAL_TRUE) {
                 element->value.value_type = JSON_VALUE_TRUE;
@@ -555,13 +1327,14 @@ static bool parse_element(struct json_element *element, struct err *err,
         return true;
 }
 
-static bool parse_elements(struct json_elements *elements, struct err *err,
+static bool parse_elements(struct json_elements *elements, struct err *err, struct allocator *alloc,
         struct vector ofType(struct json_token) *token_stream, size_t *token_idx)
 {
         struct json_token delimiter;
         do {
                 if (!parse_element(vec_new_and_get(&elements->elements, struct json_element),
                         err,
+                        alloc,
                         token_stream,
                         token_idx)) {
                         return false;
@@ -574,11 +1347,11 @@ static bool parse_elements(struct json_elements *elements, struct err *err,
         return true;
 }
 
-static bool parse_token_stream(struct json *json, struct err *err,
+static bool parse_token_stream(struct json *json, struct err *err, struct allocator *alloc,
         struct vector ofType(struct json_token) *token_stream)
 {
         size_t token_idx = 0;
-        if (!parse_element(json->element, err, token_stream, &token_idx)) {
+        if (!parse_element(json->element, err, alloc, token_stream, &token_idx)) {
                 return false;
         }
         connect_child_and_parents(json);
@@ -889,24 +1662,24 @@ static bool json_ast_node_element_print(FILE *file, struct err *err, struct json
         return json_ast_node_value_print(file, err, &element->value);
 }
 
-static bool json_ast_node_value_drop(struct json_node_value *value, struct err *err);
+static bool json_ast_node_value_drop(struct json_node_value *value, struct err *err, struct allocator *alloc);
 
-static bool json_ast_node_element_drop(struct json_element *element, struct err *err)
+static bool json_ast_node_element_drop(struct json_element *element, struct err *err, struct allocator *alloc)
 {
-        return json_ast_node_value_drop(&element->value, err);
+        return json_ast_node_value_drop(&element->value, err, alloc);
 }
 
-static bool json_ast_node_member_drop(struct json_prop *member, struct err *err)
+static bool json_ast_node_member_drop(struct json_prop *member, struct err *err, struct allocator *alloc)
 {
-        free(member->key.value);
-        return json_ast_node_element_drop(&member->value, err);
+        alloc_free(alloc, member->key.value);
+        return json_ast_node_element_drop(&member->value, err, alloc);
 }
 
-static bool json_ast_node_members_drop(struct json_members *members, struct err *err)
+static bool json_ast_node_members_drop(struct json_members *members, struct err *err, struct allocator *alloc)
 {
         for (size_t i = 0; i < members->members.num_elems; i++) {
                 struct json_prop *member = vec_get(&members->members, i, struct json_prop);
-                if (!json_ast_node_member_drop(member, err)) {
+                if (!json_ast_node_member_drop(member, err, alloc)) {
                         return false;
                 }
         }
@@ -914,11 +1687,11 @@ static bool json_ast_node_members_drop(struct json_members *members, struct err
         return true;
 }
 
-static bool json_ast_node_elements_drop(struct json_elements *elements, struct err *err)
+static bool json_ast_node_elements_drop(struct json_elements *elements, struct err *err, struct allocator *alloc)
 {
         for (size_t i = 0; i < elements->elements.num_elems; i++) {
                 struct json_element *element = vec_get(&elements->elements, i, struct json_element);
-                if (!json_ast_node_element_drop(element, err)) {
+                if (!json_ast_node_element_drop(element, err, alloc)) {
                         return false;
                 }
         }
@@ -926,24 +1699,24 @@ static bool json_ast_node_elements_drop(struct json_elements *elements, struct e
         return true;
 }
 
-static bool json_ast_node_object_drop(struct json_object_t *object, struct err *err)
+static bool json_ast_node_object_drop(struct json_object_t *object, struct err *err, struct allocator *alloc)
 {
-        if (!json_ast_node_members_drop(object->value, err)) {
+        if (!json_ast_node_members_drop(object->value, err, alloc)) {
                 return false;
         } else {
-                free(object->value);
+                alloc_free(alloc, object->value);
                 return true;
         }
 }
 
-static bool json_ast_node_array_drop(struct json_array *array, struct err *err)
+static bool json_ast_node_array_drop(struct json_array *array, struct err *err, struct allocator *alloc)
 {
-        return json_ast_node_elements_drop(&array->elements, err);
+        return json_ast_node_elements_drop(&array->elements, err, alloc);
 }
 
-static void json_ast_node_string_drop(struct json_string *string)
+static void json_ast_node_string_drop(struct json_string *string, struct allocator *alloc)
 {
-        free(string->value);
+        alloc_free(alloc, string->value);
 }
 
 static void json_ast_node_number_drop(struct json_number *number)
@@ -951,30 +1724,30 @@ static void json_ast_node_number_drop(struct json_number *number)
         ng5_unused(number);
 }
 
-static bool json_ast_node_value_drop(struct json_node_value *value, struct err *err)
+static bool json_ast_node_value_drop(struct json_node_value *value, struct err *err, struct allocator *alloc)
 {
         switch (value->value_type) {
         case JSON_VALUE_OBJECT:
-                if (!json_ast_node_object_drop(value->value.object, err)) {
+                if (!json_ast_node_object_drop(value->value.object, err, alloc)) {
                         return false;
                 } else {
-                        free(value->value.object);
+                        alloc_free(alloc, value->value.object);
                 }
                 break;
         case JSON_VALUE_ARRAY:
-                if (!json_ast_node_array_drop(value->value.array, err)) {
+                if (!json_ast_node_array_drop(value->value.array, err, alloc)) {
                         return false;
                 } else {
-                        free(value->value.array);
+                        alloc_free(alloc, value->value.array);
                 }
                 break;
         case JSON_VALUE_STRING:
-                json_ast_node_string_drop(value->value.string);
-                free(value->value.string);
+                json_ast_node_string_drop(value->value.string, alloc);
+                alloc_free(alloc, value->value.string);
                 break;
         case JSON_VALUE_NUMBER:
                 json_ast_node_number_drop(value->value.number);
-                free(value->value.number);
+                alloc_free(alloc, value->value.number);
                 break;
         case JSON_VALUE_TRUE:
         case JSON_VALUE_FALSE:
@@ -990,10 +1763,13 @@ static bool json_ast_node_value_drop(struct json_node_value *value, struct err *
 bool json_drop(struct json *json)
 {
         struct json_element *element = json->element;
-        if (!json_ast_node_value_drop(&element->value, &json->err)) {
+        if (arena_alloc_is(&json->alloc)) {
+                /** all nodes live in the arena, and are released at once together with the arena */
+                return true;
+        } else if (!json_ast_node_value_drop(&element->value, &json->err, &json->alloc)) {
                 return false;
         } else {
-                free(json->element);
+                alloc_free(&json->alloc, json->element);
                 return true;
         }
 }
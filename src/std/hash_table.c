@@ -186,10 +186,8 @@ static void insert(struct hashtable_bucket *bucket, struct hashtable *map, const
 {
         assert(map->key_data.num_elems == map->value_data.num_elems);
         u64 idx = map->key_data.num_elems;
-        void *key_datum = vec_new_and_get(&map->key_data, void *);
-        void *value_datum = vec_new_and_get(&map->value_data, void *);
-        memcpy(key_datum, key, map->key_data.elem_size);
-        memcpy(value_datum, value, map->value_data.elem_size);
+        vec_push(&map->key_data, key, 1);
+        vec_push(&map->value_data, value, 1);
         bucket->data_idx = idx;
         bucket->in_use_flag = true;
         bucket->displacement = displacement;
@@ -201,7 +199,7 @@ static inline uint_fast32_t insert_or_update(struct hashtable *map, const u32 *b
 {
         for (uint_fast32_t i = 0; i < num_pairs; i++) {
                 const void *key = keys + i * map->key_data.elem_size;
-                const void *value = values + i * map->key_data.elem_size;
+                const void *value = values + i * map->value_data.elem_size;
                 u32 intended_bucket_idx = bucket_idxs[i];
 
                 u32 bucket_idx = intended_bucket_idx;
@@ -219,11 +217,19 @@ static inline uint_fast32_t insert_or_update(struct hashtable *map, const u32 *b
                                         break;
                                 } else {
                                         i32 displacement = displace_idx - bucket_idx;
-                                        const void *swap_key = get_bucket_key(bucket, map);
-                                        const void *swap_value = get_bucket_value(bucket, map);
 
                                         if (bucket->displacement < displacement) {
-                                                insert(bucket, map, key, value, displacement);
+                                                /** copy the displaced pair out before its data slot is reused
+                                                 * by the new pair, and re-insert the copy afterwards */
+                                                u8 swap_key[map->key_data.elem_size];
+                                                u8 swap_value[map->value_data.elem_size];
+                                                void *slot_key = (void *) get_bucket_key(bucket, map);
+                                                void *slot_value = (void *) get_bucket_value(bucket, map);
+                                                memcpy(swap_key, slot_key, sizeof(swap_key));
+                                                memcpy(swap_value, slot_value, sizeof(swap_value));
+                                                memcpy(slot_key, key, sizeof(swap_key));
+                                                memcpy(slot_value, value, sizeof(swap_value));
+                                                bucket->displacement = displacement;
                                                 insert_or_update(map, &displace_idx, swap_key, swap_value, 1);
                                                 goto next_round;
                                         }
@@ -16,6 +16,7 @@
  */
 
 #include "std/sort.h"
+#include "core/async/parallel.h"
 
 NG5_EXPORT(bool) sort_qsort_indicies(size_t *indices, const void *base, size_t width, less_eq_func_t comp,
         size_t nelemns, struct allocator *alloc)
@@ -158,4 +159,464 @@ NG5_EXPORT(double) sort_get_sum(const size_t *elements, size_t nelemens)
 NG5_EXPORT(double) sort_get_avg(const size_t *elements, size_t nelemens)
 {
         return sort_get_sum(elements, nelemens) / (double) nelemens;
-}
\ No newline at end of file
+}
+
+/** below this number of elements, insertion sort is used instead of radix passes resp. merging */
+#define SORT_SMALL              32
+
+/** buckets per thread of the parallel sample sort, and sampled keys per bucket */
+#define SORT_BUCKETS_PER_THREAD 4
+#define SORT_SAMPLES_PER_BUCKET 32
+
+static unsigned key_width(enum sort_key_type key_type)
+{
+        switch (key_type) {
+        case SORT_KEY_U8:
+        case SORT_KEY_I8:
+                return 1;
+        case SORT_KEY_U16:
+        case SORT_KEY_I16:
+                return 2;
+        case SORT_KEY_U32:
+        case SORT_KEY_I32:
+        case SORT_KEY_FLOAT:
+                return 4;
+        case SORT_KEY_U64:
+        case SORT_KEY_I64:
+        case SORT_KEY_SID:
+                return 8;
+        default: print_error_and_die(NG5_ERR_NOTYPE)
+                return 0;
+        }
+}
+
+/** maps keys to unsigned integers that are ordered the same way (sign bit flipped, negative floats inverted) */
+static void normalize_keys(u64 *dst, const void *keys, enum sort_key_type key_type, size_t nelemens)
+{
+        for (size_t i = 0; i < nelemens; i++) {
+                switch (key_type) {
+                case SORT_KEY_U8:
+                        dst[i] = ((const u8 *) keys)[i];
+                        break;
+                case SORT_KEY_U16:
+                        dst[i] = ((const u16 *) keys)[i];
+                        break;
+                case SORT_KEY_U32:
+                        dst[i] = ((const u32 *) keys)[i];
+                        break;
+                case SORT_KEY_U64:
+                case SORT_KEY_SID:
+                        dst[i] = ((const u64 *) keys)[i];
+                        break;
+                case SORT_KEY_I8:
+                        dst[i] = (u8) ((const i8 *) keys)[i] ^ (u8) 0x80;
+                        break;
+                case SORT_KEY_I16:
+                        dst[i] = (u16) ((const i16 *) keys)[i] ^ (u16) 0x8000;
+                        break;
+                case SORT_KEY_I32:
+                        dst[i] = (u32) ((const i32 *) keys)[i] ^ (u32) 0x80000000;
+                        break;
+                case SORT_KEY_I64:
+                        dst[i] = (u64) ((const i64 *) keys)[i] ^ (u64) 0x8000000000000000;
+                        break;
+                case SORT_KEY_FLOAT: {
+                        u32 bits;
+                        memcpy(&bits, (const float *) keys + i, sizeof(u32));
+                        dst[i] = (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+                } break;
+                default: print_error_and_die(NG5_ERR_NOTYPE)
+                }
+        }
+}
+
+static void insertion_argsort(size_t *indices, u64 *keys, size_t nelemens)
+{
+        for (size_t i = 1; i < nelemens; i++) {
+                u64 key = keys[i];
+                size_t idx = indices[i];
+                size_t j = i;
+                while (j > 0 && keys[j - 1] > key) {
+                        keys[j] = keys[j - 1];
+                        indices[j] = indices[j - 1];
+                        j--;
+                }
+                keys[j] = key;
+                indices[j] = idx;
+        }
+}
+
+/**
+ * Sorts the pairs (<code>keys[i]</code>, <code>indices[i]</code>) by key (stable), using <code>keys_tmp</code> and
+ * <code>indices_tmp</code> as scratch buffers of the same length
+ */
+static void radix_argsort(size_t *indices, u64 *keys, size_t *indices_tmp, u64 *keys_tmp, size_t nelemens,
+        unsigned width)
+{
+        if (nelemens < SORT_SMALL) {
+                insertion_argsort(indices, keys, nelemens);
+                return;
+        }
+
+        size_t histogram[8][256] = { { 0 } };
+        for (size_t i = 0; i < nelemens; i++) {
+                u64 key = keys[i];
+                for (unsigned byte = 0; byte < width; byte++) {
+                        histogram[byte][(key >> (8 * byte)) & 0xFF]++;
+                }
+        }
+
+        u64 *src_keys = keys, *dst_keys = keys_tmp;
+        size_t *src_indices = indices, *dst_indices = indices_tmp;
+
+        for (unsigned byte = 0; byte < width; byte++) {
+                size_t *counts = histogram[byte];
+                unsigned shift = 8 * byte;
+                if (counts[(src_keys[0] >> shift) & 0xFF] == nelemens) {
+                        /** all keys agree on this byte */
+                        continue;
+                }
+                size_t offset = 0;
+                for (unsigned digit = 0; digit < 256; digit++) {
+                        size_t count = counts[digit];
+                        counts[digit] = offset;
+                        offset += count;
+                }
+                for (size_t i = 0; i < nelemens; i++) {
+                        size_t pos = counts[(src_keys[i] >> shift) & 0xFF]++;
+                        dst_keys[pos] = src_keys[i];
+                        dst_indices[pos] = src_indices[i];
+                }
+                u64 *keys_swap = src_keys;
+                size_t *indices_swap = src_indices;
+                src_keys = dst_keys;
+                src_indices = dst_indices;
+                dst_keys = keys_swap;
+                dst_indices = indices_swap;
+        }
+
+        if (src_keys != keys) {
+                memcpy(keys, src_keys, nelemens * sizeof(u64));
+                memcpy(indices, src_indices, nelemens * sizeof(size_t));
+        }
+}
+
+NG5_EXPORT(bool) sort_argsort(size_t *indices, const void *keys, enum sort_key_type key_type, size_t nelemens,
+        struct allocator *alloc)
+{
+        error_if_null(indices);
+        error_if_null(keys);
+        error_if_null(alloc);
+
+        if (nelemens == 0) {
+                return true;
+        }
+
+        u64 *normalized = alloc_malloc(alloc, 2 * nelemens * sizeof(u64));
+        size_t *indices_tmp = alloc_malloc(alloc, nelemens * sizeof(size_t));
+        error_if_null(normalized);
+        error_if_null(indices_tmp);
+
+        normalize_keys(normalized, keys, key_type, nelemens);
+        for (size_t i = 0; i < nelemens; i++) {
+                indices[i] = i;
+        }
+        radix_argsort(indices, normalized, indices_tmp, normalized + nelemens, nelemens, key_width(key_type));
+
+        alloc_free(alloc, indices_tmp);
+        alloc_free(alloc, normalized);
+        return true;
+}
+
+struct sample_sort {
+        const u64 *keys;                /* normalized keys */
+        size_t nelemens;
+        unsigned width;
+        const u64 *splitters;           /* num_buckets - 1 ascending keys */
+        size_t num_buckets;
+        size_t chunk_len;               /* number of keys per chunk, except for the last chunk */
+        u32 *bucket_of;                 /* bucket per key */
+        size_t *offsets;                /* per chunk and bucket, the next output position */
+        size_t *bucket_begin;           /* per bucket and one past the last bucket, the first output position */
+        u64 *bucket_keys;
+        size_t *bucket_indices;
+        u64 *keys_tmp;
+        size_t *indices_tmp;
+};
+
+static u32 find_bucket(const struct sample_sort *sort, u64 key)
+{
+        /** first splitter greater than the key, such that equal keys end up in the same bucket */
+        size_t l = 0, r = sort->num_buckets - 1;
+        while (l < r) {
+                size_t m = l + (r - l) / 2;
+                if (sort->splitters[m] <= key) {
+                        l = m + 1;
+                } else {
+                        r = m;
+                }
+        }
+        return l;
+}
+
+static void chunk_range(size_t *begin, size_t *end, const struct sample_sort *sort, size_t chunk, size_t num_chunks)
+{
+        *begin = chunk * sort->chunk_len;
+        *end = chunk + 1 == num_chunks ? sort->nelemens : *begin + sort->chunk_len;
+}
+
+static void count_buckets(const void *start, size_t width, size_t len, void *args, thread_id_t tid)
+{
+        ng5_unused(width);
+        ng5_unused(tid);
+        struct sample_sort *sort = args;
+        size_t num_chunks = (sort->nelemens + sort->chunk_len - 1) / sort->chunk_len;
+        for (const size_t *chunk = start; len--; chunk++) {
+                size_t begin, end;
+                size_t *counts = sort->offsets + *chunk * sort->num_buckets;
+                chunk_range(&begin, &end, sort, *chunk, num_chunks);
+                for (size_t i = begin; i < end; i++) {
+                        u32 bucket = find_bucket(sort, sort->keys[i]);
+                        sort->bucket_of[i] = bucket;
+                        counts[bucket]++;
+                }
+        }
+}
+
+static void scatter_buckets(const void *start, size_t width, size_t len, void *args, thread_id_t tid)
+{
+        ng5_unused(width);
+        ng5_unused(tid);
+        struct sample_sort *sort = args;
+        size_t num_chunks = (sort->nelemens + sort->chunk_len - 1) / sort->chunk_len;
+        for (const size_t *chunk = start; len--; chunk++) {
+                size_t begin, end;
+                size_t *offsets = sort->offsets + *chunk * sort->num_buckets;
+                chunk_range(&begin, &end, sort, *chunk, num_chunks);
+                for (size_t i = begin; i < end; i++) {
+                        size_t pos = offsets[sort->bucket_of[i]]++;
+                        sort->bucket_keys[pos] = sort->keys[i];
+                        sort->bucket_indices[pos] = i;
+                }
+        }
+}
+
+static void sort_buckets(const void *start, size_t width, size_t len, void *args, thread_id_t tid)
+{
+        ng5_unused(width);
+        ng5_unused(tid);
+        struct sample_sort *sort = args;
+        for (const size_t *bucket = start; len--; bucket++) {
+                size_t begin = sort->bucket_begin[*bucket];
+                size_t num = sort->bucket_begin[*bucket + 1] - begin;
+                radix_argsort(sort->bucket_indices + begin, sort->bucket_keys + begin, sort->indices_tmp + begin,
+                        sort->keys_tmp + begin, num, sort->width);
+        }
+}
+
+static int compare_u64(const void *lhs, const void *rhs)
+{
+        u64 a = *(const u64 *) lhs, b = *(const u64 *) rhs;
+        return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+NG5_EXPORT(bool) sort_argsort_parallel(size_t *indices, const void *keys, enum sort_key_type key_type,
+        size_t nelemens, struct allocator *alloc, uint_fast16_t num_threads)
+{
+        if (num_threads <= 1 || nelemens < NG5_SORT_PARALLEL_MIN) {
+                return sort_argsort(indices, keys, key_type, nelemens, alloc);
+        }
+
+        error_if_null(indices);
+        error_if_null(keys);
+        error_if_null(alloc);
+
+        size_t num_chunks = num_threads;
+        size_t num_buckets = num_threads * SORT_BUCKETS_PER_THREAD;
+        size_t num_samples = num_buckets * SORT_SAMPLES_PER_BUCKET;
+        size_t num_tasks = ng5_max(num_chunks, num_buckets);
+
+        u64 *normalized = alloc_malloc(alloc, 3 * nelemens * sizeof(u64));
+        size_t *indices_tmp = alloc_malloc(alloc, nelemens * sizeof(size_t));
+        u32 *bucket_of = alloc_malloc(alloc, nelemens * sizeof(u32));
+        u64 *samples = alloc_malloc(alloc, num_samples * sizeof(u64));
+        size_t *offsets = alloc_malloc(alloc, num_chunks * num_buckets * sizeof(size_t));
+        size_t *bucket_begin = alloc_malloc(alloc, (num_buckets + 1) * sizeof(size_t));
+        size_t *tasks = alloc_malloc(alloc, num_tasks * sizeof(size_t));
+
+        normalize_keys(normalized, keys, key_type, nelemens);
+
+        /** splitters are equidistant keys of a sorted sample of equidistant keys */
+        for (size_t i = 0; i < num_samples; i++) {
+                samples[i] = normalized[i * (nelemens / num_samples)];
+        }
+        qsort(samples, num_samples, sizeof(u64), compare_u64);
+        for (size_t i = 0; i < num_buckets - 1; i++) {
+                samples[i] = samples[(i + 1) * SORT_SAMPLES_PER_BUCKET];
+        }
+        for (size_t i = 0; i < num_tasks; i++) {
+                tasks[i] = i;
+        }
+        memset(offsets, 0, num_chunks * num_buckets * sizeof(size_t));
+
+        struct sample_sort sort = {
+                .keys = normalized,
+                .nelemens = nelemens,
+                .width = key_width(key_type),
+                .splitters = samples,
+                .num_buckets = num_buckets,
+                .chunk_len = nelemens / num_chunks,
+                .bucket_of = bucket_of,
+                .offsets = offsets,
+                .bucket_begin = bucket_begin,
+                .bucket_keys = normalized + nelemens,
+                .bucket_indices = indices,
+                .keys_tmp = normalized + 2 * nelemens,
+                .indices_tmp = indices_tmp
+        };
+
+        parallel_for(tasks, sizeof(size_t), num_chunks, count_buckets, &sort, THREADING_HINT_MULTI, num_threads - 1);
+
+        /** keys of a bucket are placed in the order of their chunks, and chunks keep the input order (stable) */
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < num_buckets; bucket++) {
+                bucket_begin[bucket] = offset;
+                for (size_t chunk = 0; chunk < num_chunks; chunk++) {
+                        size_t count = offsets[chunk * num_buckets + bucket];
+                        offsets[chunk * num_buckets + bucket] = offset;
+                        offset += count;
+                }
+        }
+        bucket_begin[num_buckets] = offset;
+
+        parallel_for(tasks, sizeof(size_t), num_chunks, scatter_buckets, &sort, THREADING_HINT_MULTI, num_threads - 1);
+        parallel_for(tasks, sizeof(size_t), num_buckets, sort_buckets, &sort, THREADING_HINT_MULTI, num_threads - 1);
+
+        alloc_free(alloc, tasks);
+        alloc_free(alloc, bucket_begin);
+        alloc_free(alloc, offsets);
+        alloc_free(alloc, samples);
+        alloc_free(alloc, bucket_of);
+        alloc_free(alloc, indices_tmp);
+        alloc_free(alloc, normalized);
+        return true;
+}
+
+typedef bool (*index_less_func_t)(size_t lhs, size_t rhs, const void *args);
+
+/** sorts <code>indices</code> by <code>less</code> (stable) */
+static bool merge_argsort(size_t *indices, size_t nelemens, index_less_func_t less, const void *args,
+        struct allocator *alloc)
+{
+        for (size_t i = 0; i < nelemens; i++) {
+                indices[i] = i;
+        }
+
+        /** runs of SORT_SMALL elements are sorted by insertion... */
+        for (size_t begin = 0; begin < nelemens; begin += SORT_SMALL) {
+                size_t end = ng5_min(begin + SORT_SMALL, nelemens);
+                for (size_t i = begin + 1; i < end; i++) {
+                        size_t idx = indices[i];
+                        size_t j = i;
+                        while (j > begin && less(idx, indices[j - 1], args)) {
+                                indices[j] = indices[j - 1];
+                                j--;
+                        }
+                        indices[j] = idx;
+                }
+        }
+
+        if (nelemens <= SORT_SMALL) {
+                return true;
+        }
+
+        /** ...and merged bottom-up afterwards */
+        size_t *src = indices;
+        size_t *dst = alloc_malloc(alloc, nelemens * sizeof(size_t));
+        size_t *tmp = dst;
+        error_if_null(dst);
+        for (size_t run = SORT_SMALL; run < nelemens; run *= 2) {
+                for (size_t begin = 0; begin < nelemens; begin += 2 * run) {
+                        size_t mid = ng5_min(begin + run, nelemens);
+                        size_t end = ng5_min(begin + 2 * run, nelemens);
+                        size_t l = begin, r = mid, out = begin;
+                        while (l < mid && r < end) {
+                                /** take from the right run only if strictly smaller (stable) */
+                                dst[out++] = less(src[r], src[l], args) ? src[r++] : src[l++];
+                        }
+                        while (l < mid) {
+                                dst[out++] = src[l++];
+                        }
+                        while (r < end) {
+                                dst[out++] = src[r++];
+                        }
+                }
+                size_t *swap = src;
+                src = dst;
+                dst = swap;
+        }
+        if (src != indices) {
+                memcpy(indices, src, nelemens * sizeof(size_t));
+        }
+        alloc_free(alloc, tmp);
+        return true;
+}
+
+static bool string_less(size_t lhs, size_t rhs, const void *args)
+{
+        const char *const *strings = args;
+        return strings[rhs] && (!strings[lhs] || strcmp(strings[lhs], strings[rhs]) < 0);
+}
+
+NG5_EXPORT(bool) sort_argsort_strings(size_t *indices, const char *const *strings, size_t nelemens,
+        struct allocator *alloc)
+{
+        error_if_null(indices);
+        error_if_null(strings);
+        error_if_null(alloc);
+
+        return merge_argsort(indices, nelemens, string_less, strings, alloc);
+}
+
+struct key_arrays {
+        const u64 *keys;                /* normalized keys of all arrays */
+        const size_t *offsets;
+};
+
+static bool array_less(size_t lhs, size_t rhs, const void *args)
+{
+        const struct key_arrays *arrays = args;
+        const u64 *a = arrays->keys + arrays->offsets[lhs];
+        const u64 *b = arrays->keys + arrays->offsets[rhs];
+        size_t a_len = arrays->offsets[lhs + 1] - arrays->offsets[lhs];
+        size_t b_len = arrays->offsets[rhs + 1] - arrays->offsets[rhs];
+        size_t len = ng5_min(a_len, b_len);
+        for (size_t i = 0; i < len; i++) {
+                if (a[i] != b[i]) {
+                        return a[i] < b[i];
+                }
+        }
+        return a_len < b_len;
+}
+
+NG5_EXPORT(bool) sort_argsort_arrays(size_t *indices, const void *keys, enum sort_key_type key_type,
+        const size_t *offsets, size_t nelemens, struct allocator *alloc)
+{
+        error_if_null(indices);
+        error_if_null(offsets);
+        error_if_null(alloc);
+
+        size_t num_keys = nelemens > 0 ? offsets[nelemens] : 0;
+        u64 *normalized = alloc_malloc(alloc, ng5_max(1, num_keys) * sizeof(u64));
+        error_if_null(normalized);
+        if (num_keys > 0) {
+                error_if_null(keys);
+                normalize_keys(normalized, keys, key_type, num_keys);
+        }
+
+        struct key_arrays arrays = { .keys = normalized, .offsets = offsets };
+        bool status = merge_argsort(indices, nelemens, array_less, &arrays, alloc);
+
+        alloc_free(alloc, normalized);
+        return status;
+}
@@ -69,8 +69,11 @@ DEFINE_PRINTER_FUNCTION(size_t, "%zu")
 bool vec_create(struct vector *out, const struct allocator *alloc, size_t elem_size, size_t cap_elems)
 {
         error_if_null(out)
-        out->allocator = malloc(sizeof(struct allocator));
-        alloc_this_or_std(out->allocator, alloc);
+        struct allocator allocator;
+        alloc_this_or_std(&allocator, alloc);
+        /** the allocator itself is stored in memory of that allocator, e.g., in the same arena as the elements */
+        out->allocator = alloc_malloc(&allocator, sizeof(struct allocator));
+        *out->allocator = allocator;
         out->base = alloc_malloc(out->allocator, cap_elems * elem_size);
         out->num_elems = 0;
         out->cap_elems = cap_elems;
@@ -124,8 +127,10 @@ NG5_EXPORT(bool) vec_deserialize(struct vector *vec, struct err *err, FILE *file
                 goto error_handling;
         }
 
-        vec->allocator = malloc(sizeof(struct allocator));
-        alloc_this_or_std(vec->allocator, NULL);
+        struct allocator allocator;
+        alloc_create_std(&allocator);
+        vec->allocator = alloc_malloc(&allocator, sizeof(struct allocator));
+        *vec->allocator = allocator;
         vec->base = alloc_malloc(vec->allocator, header.cap_elems * header.elem_size);
         vec->num_elems = header.num_elems;
         vec->cap_elems = header.cap_elems;
@@ -166,8 +171,9 @@ bool vec_set_grow_factor(struct vector *vec, float factor)
 bool vec_drop(struct vector *vec)
 {
         error_if_null(vec)
-        alloc_free(vec->allocator, vec->base);
-        free(vec->allocator);
+        struct allocator allocator = *vec->allocator;
+        alloc_free(&allocator, vec->base);
+        alloc_free(&allocator, vec->allocator);
         vec->base = NULL;
         return true;
 }
@@ -178,14 +184,28 @@ bool vec_is_empty(const struct vector *vec)
         return vec->num_elems == 0 ? true : false;
 }
 
+/** Resizes the memory of <code>vec</code> to <code>cap_elems</code> elements, and keeps it if that fails */
+static bool vec_realloc(struct vector *vec, u32 cap_elems)
+{
+        void *base = alloc_realloc(vec->allocator, vec->base, cap_elems * vec->elem_size);
+        if (unlikely(!base)) {
+                error(&vec->err, NG5_ERR_MALLOCERR);
+                return false;
+        }
+        vec->base = base;
+        vec->cap_elems = cap_elems;
+        return true;
+}
+
 bool vec_push(struct vector *vec, const void *data, size_t num_elems)
 {
         error_if_null(vec && data)
         size_t next_num = vec->num_elems + num_elems;
         while (next_num > vec->cap_elems) {
                 size_t more = next_num - vec->cap_elems;
-                vec->cap_elems = (vec->cap_elems + more) * vec->grow_factor;
-                vec->base = alloc_realloc(vec->allocator, vec->base, vec->cap_elems * vec->elem_size);
+                if (unlikely(!vec_realloc(vec, (vec->cap_elems + more) * vec->grow_factor))) {
+                        return false;
+                }
         }
         memcpy(vec->base + vec->num_elems * vec->elem_size, data, num_elems * vec->elem_size);
         vec->num_elems += num_elems;
@@ -207,8 +227,9 @@ bool vec_repeated_push(struct vector *vec, const void *data, size_t how_often)
         size_t next_num = vec->num_elems + how_often;
         while (next_num > vec->cap_elems) {
                 size_t more = next_num - vec->cap_elems;
-                vec->cap_elems = (vec->cap_elems + more) * vec->grow_factor;
-                vec->base = alloc_realloc(vec->allocator, vec->base, vec->cap_elems * vec->elem_size);
+                if (unlikely(!vec_realloc(vec, (vec->cap_elems + more) * vec->grow_factor))) {
+                        return false;
+                }
         }
         for (size_t i = 0; i < how_often; i++) {
                 memcpy(vec->base + (vec->num_elems + i) * vec->elem_size, data, vec->elem_size);
@@ -239,8 +260,7 @@ bool vec_shrink(struct vector *vec)
 {
         error_if_null(vec);
         if (vec->num_elems < vec->cap_elems) {
-                vec->cap_elems = ng5_max(1, vec->num_elems);
-                vec->base = alloc_realloc(vec->allocator, vec->base, vec->cap_elems * vec->elem_size);
+                return vec_realloc(vec, ng5_max(1, vec->num_elems));
         }
         return true;
 }
@@ -250,8 +270,9 @@ bool vec_grow(size_t *numNewSlots, struct vector *vec)
         error_if_null(vec)
         size_t freeSlotsBefore = vec->cap_elems - vec->num_elems;
 
-        vec->cap_elems = (vec->cap_elems * vec->grow_factor) + 1;
-        vec->base = alloc_realloc(vec->allocator, vec->base, vec->cap_elems * vec->elem_size);
+        if (unlikely(!vec_realloc(vec, (vec->cap_elems * vec->grow_factor) + 1))) {
+                return false;
+        }
         size_t freeSlotsAfter = vec->cap_elems - vec->num_elems;
         if (likely(numNewSlots != NULL)) {
                 *numNewSlots = freeSlotsAfter - freeSlotsBefore;
@@ -262,9 +283,7 @@ bool vec_grow(size_t *numNewSlots, struct vector *vec)
 NG5_EXPORT(bool) vec_grow_to(struct vector *vec, size_t capacity)
 {
         error_if_null(vec);
-        vec->cap_elems = ng5_max(vec->cap_elems, capacity);
-        vec->base = alloc_realloc(vec->allocator, vec->base, vec->cap_elems * vec->elem_size);
-        return true;
+        return vec_realloc(vec, ng5_max(vec->cap_elems, capacity));
 }
 
 size_t vec_length(const struct vector *vec)
@@ -329,7 +348,7 @@ NG5_EXPORT(bool) vec_cpy_to(struct vector *dst, struct vector *src)
 {
         error_if_null(dst)
         error_if_null(src)
-        void *handle = realloc(dst->base, src->cap_elems * src->elem_size);
+        void *handle = alloc_realloc(dst->allocator, dst->base, src->cap_elems * src->elem_size);
         if (handle) {
                 dst->elem_size = src->elem_size;
                 dst->num_elems = src->num_elems;
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <string>
 
 #include "core/carbon.h"
 
@@ -38,6 +39,129 @@ TEST(ConverterTest, PerformConversion)
     archive_close(&archive);
 }
 
+/* converts 'archive' back to JSON, and closes it */
+static std::string
+converted_of(struct archive *archive)
+{
+    struct encoded_doc_list collection;
+    char *text = NULL;
+    size_t text_len = 0;
+
+    archive_converter(&collection, archive);
+    FILE *file = open_memstream(&text, &text_len);
+    encoded_doc_collection_print(file, &collection);
+    fclose(file);
+    std::string converted(text, text_len);
+    free(text);
+    encoded_doc_collection_drop(&collection);
+    archive_close(archive);
+    return converted;
+}
+
+/* converts 'json' imported with 'num_import_threads' threads back to JSON */
+static std::string
+converted_of(const std::string &json, size_t num_import_threads)
+{
+    struct archive archive;
+    struct err err;
+
+    EXPECT_TRUE(archive_from_json_parallel(&archive, "tmp-test-archive.carbon", &err, json.c_str(),
+        num_import_threads, PACK_NONE, ASYNC, 2, false, false, 0, false, NULL));
+    return converted_of(&archive);
+}
+
+/* imports the JSON lines 'ndjson' in batches of 'batch_size' records */
+static bool
+archive_of_ndjson(struct archive *archive, struct err *err, const std::string &ndjson, size_t batch_size)
+{
+    FILE *file = fmemopen((void *) ndjson.data(), ndjson.size(), "r");
+    bool status = archive_from_ndjson(archive, "tmp-test-archive.carbon", err, file, batch_size, PACK_NONE, ASYNC,
+        2, false, false, 0, false, NULL);
+    fclose(file);
+    return status;
+}
+
+TEST(ConverterTest, ParallelImportMatchesSingleThreadedImport)
+{
+    /* records differ in their keys and types, such that ranges contribute different strings and columns */
+    std::string json = "[";
+    for (int i = 0; i < 300; i++) {
+        json += (i > 0 ? ",\n" : "") + std::string("{\"id\": ") + std::to_string(i) + ", \"name\": \"n"
+            + std::to_string(i % 17) + "\"";
+        if (i % 3 == 0) {
+            json += ", \"tags\": [\"t" + std::to_string(i % 5) + "\", \"x\"], \"score\": " + std::to_string(i * 0.25);
+        }
+        if (i % 7 == 0) {
+            json += ", \"nested\": {\"flag\": " + std::string(i % 2 ? "true" : "false") + ", \"items\": [{\"v\": "
+                + std::to_string(i) + "}, null]}";
+        }
+        json += "}";
+    }
+    json += "]";
+
+    const std::string expected = converted_of(json, 1);
+    ASSERT_NE(expected.find("\"n16\""), std::string::npos);
+    for (size_t num_import_threads : { 2, 3, 8, 64 }) {
+        ASSERT_EQ(converted_of(json, num_import_threads), expected) << num_import_threads;
+    }
+}
+
+TEST(ConverterTest, NdjsonImportMatchesJsonImport)
+{
+    /* blank lines are skipped, and the last line has no trailing newline */
+    const std::string ndjson = "\n{\"id\": 1, \"name\": \"a\"}\n\n  \t\r\n{\"id\": 2, \"name\": \"b\"}\r\n"
+        "{\"id\": 3, \"tags\": [\"x\", \"y\"]}\n\n{\"id\": 4, \"name\": \"d\"}";
+    const std::string json = "[{\"id\": 1, \"name\": \"a\"}, {\"id\": 2, \"name\": \"b\"}, "
+        "{\"id\": 3, \"tags\": [\"x\", \"y\"]}, {\"id\": 4, \"name\": \"d\"}]";
+    const std::string expected = converted_of(json, 1);
+    ASSERT_NE(expected.find("\"d\""), std::string::npos);
+
+    for (size_t batch_size : { 1, 2, 3, 1000 }) {
+        struct archive archive;
+        struct err err;
+        ASSERT_TRUE(archive_of_ndjson(&archive, &err, ndjson, batch_size)) << batch_size;
+        ASSERT_EQ(converted_of(&archive), expected) << batch_size;
+        ASSERT_TRUE(archive_of_ndjson(&archive, &err, ndjson + "\n", batch_size)) << batch_size;
+        ASSERT_EQ(converted_of(&archive), expected) << batch_size;
+    }
+}
+
+TEST(ConverterTest, NdjsonImportOfLinesLongerThanTheReadChunk)
+{
+    /* the second line does not fit into twice the read chunk, such that the line buffer grows twice */
+    const std::string value(2 * NG5_NDJSON_CHUNK_SIZE + 100, 'v');
+    const std::string ndjson = "{\"id\": 1}\n{\"id\": 2, \"long\": \"" + value + "\"}\n{\"id\": 3}";
+    const std::string json = "[{\"id\": 1}, {\"id\": 2, \"long\": \"" + value + "\"}, {\"id\": 3}]";
+
+    struct archive archive;
+    struct err err;
+    ASSERT_TRUE(archive_of_ndjson(&archive, &err, ndjson, NG5_NDJSON_BATCH_SIZE));
+    const std::string converted = converted_of(&archive);
+    ASSERT_NE(converted.find(value), std::string::npos);
+    ASSERT_EQ(converted, converted_of(json, 1));
+}
+
+TEST(ConverterTest, NdjsonImportReportsTheLineOfAMalformedRecord)
+{
+    struct archive archive;
+    struct err err;
+
+    /* blank lines and lines that span read chunks are counted as well */
+    const std::string value(NG5_NDJSON_CHUNK_SIZE, 'v');
+    const std::string ndjson = "{\"id\": 1}\n\n{\"id\": \"" + value + "\"}\r\n\t\n{\"id\": 2}\n{\"id\": }\n{\"id\": 3}\n";
+    ASSERT_FALSE(archive_of_ndjson(&archive, &err, ndjson, 1));
+    ASSERT_EQ(err.code, NG5_ERR_JSONPARSEERR);
+    ASSERT_TRUE(err.details != NULL);
+    ASSERT_EQ(std::string(err.details).find("In line 6 of input: "), 0u) << err.details;
+
+    ASSERT_FALSE(archive_of_ndjson(&archive, &err, "{\"id\": 1}\n{\"id\": 2}\n[{\"id\": 3}]", 1));
+    ASSERT_TRUE(err.details != NULL);
+    ASSERT_EQ(std::string(err.details).find("In line 3 of input: "), 0u) << err.details;
+
+    ASSERT_FALSE(archive_of_ndjson(&archive, &err, "\n \n", 1));
+    ASSERT_EQ(err.code, NG5_ERR_JSONPARSEERR);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
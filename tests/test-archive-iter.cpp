@@ -1,8 +1,16 @@
 #include <gtest/gtest.h>
 #include <stdio.h>
 #include <inttypes.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "core/carbon/archive_iter.h"
+#include "core/carbon/archive_int.h"
+#include "core/carbon/archive_query.h"
 #include "core/carbon.h"
 
 static void
@@ -494,6 +502,41 @@ iterate_properties(struct prop_iter *prop_iter)
     }
 }
 
+/* iterators to walk the record of an archive, i.e., the single object of the root object's first property */
+struct record_iters {
+    struct err err;
+    struct prop_iter prop_iter;
+    enum prop_iter_mode iter_type;
+    struct archive_value_vector value_iter;
+    struct archive_object record;
+    archive_collection_iter_t collection_iter;
+    archive_column_group_iter_t group_iter;
+    archive_column_iter_t column_iter;
+    archive_column_entry_iter_t entry_iter;
+};
+
+/* positions 'iters->prop_iter' before the first property of the record in 'archive', or with 'to_collection' at the
+ * record's first collection (i.e., array of objects) such that 'iters->collection_iter' iterates it */
+static bool
+open_record(struct record_iters *iters, struct archive *archive, bool to_collection)
+{
+    if (!archive_prop_iter_from_archive(&iters->prop_iter, &iters->err, NG5_ARCHIVE_ITER_MASK_ANY, archive)
+        || !archive_prop_iter_next(&iters->iter_type, &iters->value_iter, &iters->collection_iter, &iters->prop_iter)
+        || iters->iter_type != PROP_ITER_MODE_OBJECT
+        || !archive_value_vector_get_object_at(&iters->record, 0, &iters->value_iter)
+        || !archive_prop_iter_from_object(&iters->prop_iter, NG5_ARCHIVE_ITER_MASK_ANY, &iters->err,
+            &iters->record)) {
+        return false;
+    }
+    while (to_collection && iters->iter_type != PROP_ITER_MODE_COLLECTION) {
+        if (!archive_prop_iter_next(&iters->iter_type, &iters->value_iter, &iters->collection_iter,
+            &iters->prop_iter)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 TEST(ArchiveIterTest, CreateIterator)
 {
     struct archive            archive;
@@ -515,6 +558,538 @@ TEST(ArchiveIterTest, CreateIterator)
     ASSERT_TRUE(status);
 }
 
+TEST(ArchiveIterTest, CountOnRunLengthEncodedColumn)
+{
+    struct archive archive;
+    struct record_iters it;
+
+    /* 'code' repeats in long runs such that its column is run-length encoded across all of its entries */
+    std::string json = "{ \"events\": [";
+    std::vector<i8> codes;
+    for (u32 i = 0; i < 2000; i++) {
+        codes.push_back((i8) (i / 100 % 3 + 1));
+        json += (i > 0 ? ", " : "") + std::string("{ \"code\": ") + std::to_string(codes.back()) + " }";
+    }
+    json += "] }";
+
+    ASSERT_TRUE(archive_from_json(&archive, "tmp-test-archive.carbon", &it.err, json.c_str(), PACK_NONE, SYNC, 0,
+        false, false, NULL));
+    ASSERT_TRUE(open_record(&it, &archive, true));
+    ASSERT_TRUE(archive_collection_next_column_group(&it.group_iter, &it.collection_iter));
+    ASSERT_TRUE(archive_column_group_next_column(&it.column_iter, &it.group_iter));
+    ASSERT_EQ(it.column_iter.state.current_column_group.current_column.encoding, INTPACK_RLE);
+
+    /* entries are slices of the decoded runs */
+    std::vector<u64> expected(4, 0);
+    u32 num_values = 0;
+    while (archive_column_next_entry(&it.entry_iter, &it.column_iter)) {
+        u32 length;
+        const field_i8_t *values = archive_column_entry_get_int8s(&length, &it.entry_iter);
+        ASSERT_TRUE(values != NULL);
+        for (u32 i = 0; i < length; i++, num_values++) {
+            ASSERT_EQ(values[i], codes[num_values]);
+            expected[values[i]]++;
+        }
+    }
+    ASSERT_EQ(num_values, codes.size());
+
+    u64 count;
+    ASSERT_TRUE(archive_column_count_range(&count, 2, 2, &it.column_iter));
+    ASSERT_EQ(count, expected[2]);
+    ASSERT_TRUE(archive_column_count_range(&count, 1, 2, &it.column_iter));
+    ASSERT_EQ(count, expected[1] + expected[2]);
+    ASSERT_TRUE(archive_column_count_range(&count, 4, 10, &it.column_iter));
+    ASSERT_EQ(count, 0u);
+
+    struct hashmap_u64_u32 counts;
+    hashmap_u64_u32_create(&counts, NULL, 16);
+    ASSERT_TRUE(archive_column_count_values(&counts, &it.column_iter));
+    ASSERT_EQ(hashmap_u64_u32_size(&counts), 3u);
+    for (u64 code = 1; code <= 3; code++) {
+        ASSERT_EQ(*hashmap_u64_u32_get(&counts, code), expected[code]);
+    }
+    hashmap_u64_u32_drop(&counts);
+
+    archive_close(&archive);
+}
+
+TEST(ArchiveIterTest, CountOnBitPackedBooleanColumn)
+{
+    struct archive archive;
+    struct record_iters it;
+
+    /* every third object lacks 'flags', such that the column of 'flags' stores a validity bitmap */
+    std::string json = "{ \"events\": [";
+    std::vector<bool> present;
+    u64 expected_true = 0, expected_false = 0, expected_null = 0;
+    for (u32 i = 0; i < 300; i++) {
+        json += (i > 0 ? ", " : "") + std::string("{ \"id\": ") + std::to_string(i);
+        present.push_back(i % 3 != 0);
+        if (present.back()) {
+            json += ", \"flags\": [";
+            for (u32 k = 0; k < 12; k++) {
+                u32 x = (i * 7 + k * 13) % 5;
+                json += std::string(k > 0 ? ", " : "") + (x == 0 ? "null" : x % 2 ? "true" : "false");
+                expected_null += x == 0;
+                expected_true += x != 0 && x % 2;
+                expected_false += x != 0 && !(x % 2);
+            }
+            json += "]";
+        }
+        json += " }";
+    }
+    json += "] }";
+
+    ASSERT_TRUE(archive_from_json(&archive, "tmp-test-archive.carbon", &it.err, json.c_str(), PACK_NONE, SYNC, 0,
+        false, false, NULL));
+    ASSERT_TRUE(open_record(&it, &archive, true));
+    ASSERT_TRUE(archive_collection_next_column_group(&it.group_iter, &it.collection_iter));
+
+    bool found = false;
+    while (archive_column_group_next_column(&it.column_iter, &it.group_iter)) {
+        field_sid_t name;
+        enum field_type type;
+        ASSERT_TRUE(archive_column_get_name(&name, &type, &it.column_iter));
+        if (type != FIELD_BOOLEAN) {
+            continue;
+        }
+        found = true;
+        ASSERT_EQ(it.column_iter.state.current_column_group.current_column.encoding, INTPACK_BITMAP);
+        ASSERT_TRUE(it.column_iter.state.current_column_group.current_column.validity != NULL);
+
+        u64 num_true, num_false, num_null;
+        ASSERT_TRUE(archive_column_count_booleans(&num_true, &num_false, &num_null, &it.column_iter));
+        ASSERT_EQ(num_true, expected_true);
+        ASSERT_EQ(num_false, expected_false);
+        ASSERT_EQ(num_null, expected_null);
+        u64 num_values;
+        ASSERT_TRUE(archive_column_count_range(&num_values, 0, 1, &it.column_iter));
+        ASSERT_EQ(num_values, expected_true + expected_false);
+
+        for (u32 begin = 0; begin < present.size(); begin += 17) {
+            u32 count, end = begin + 100;
+            u32 expected = 0;
+            for (u32 i = begin; i < std::min((u32) present.size(), end); i++) {
+                expected += present[i];
+            }
+            ASSERT_TRUE(archive_column_count_present(&count, begin, end, &it.column_iter));
+            ASSERT_EQ(count, expected);
+        }
+    }
+    ASSERT_TRUE(found);
+
+    archive_close(&archive);
+}
+
+TEST(ArchiveIterTest, DecodeFloatingPointNumbers)
+{
+    struct archive archive;
+    struct record_iters it;
+
+    /* quarters are exactly representable, and have two digits after the decimal point */
+    auto quarter = [](u32 i) { return (field_number_t) ((i32) (i % 97) - 48) / 4; };
+    std::string json = "{ \"scale\": [";
+    for (u32 i = 0; i < 100; i++) {
+        json += (i > 0 ? ", " : "") + std::to_string(quarter(i));
+    }
+    json += "], \"events\": [";
+    for (u32 i = 0; i < 300; i++) {
+        json += (i > 0 ? ", " : "") + std::string("{ \"t\": ") + std::to_string(quarter(i * 7)) + " }";
+    }
+    json += "] }";
+
+    ASSERT_TRUE(archive_from_json(&archive, "tmp-test-archive.carbon", &it.err, json.c_str(), PACK_NONE, SYNC, 0,
+        false, false, NULL));
+    ASSERT_TRUE(open_record(&it, &archive, false));
+
+    u32 num_checked = 0;
+    while (archive_prop_iter_next(&it.iter_type, &it.value_iter, &it.collection_iter, &it.prop_iter)) {
+        if (it.iter_type == PROP_ITER_MODE_OBJECT) {
+            enum field_type type;
+            ASSERT_TRUE(archive_value_vector_get_basic_type(&type, &it.value_iter));
+            ASSERT_EQ(type, FIELD_FLOAT);
+            ASSERT_EQ(it.prop_iter.mode_object.prop_group_header.header->encoding, FLOATPACK_ALP);
+            u32 length;
+            const field_number_t *values = archive_value_vector_get_number_arrays_at(&length, 0, &it.value_iter);
+            ASSERT_EQ(length, 100u);
+            for (u32 i = 0; i < length; i++, num_checked++) {
+                ASSERT_EQ(values[i], quarter(i));
+            }
+        } else {
+            ASSERT_TRUE(archive_collection_next_column_group(&it.group_iter, &it.collection_iter));
+            ASSERT_TRUE(archive_column_group_next_column(&it.column_iter, &it.group_iter));
+            ASSERT_EQ(it.column_iter.state.current_column_group.current_column.encoding, FLOATPACK_ALP);
+            u32 i = 0;
+            while (archive_column_next_entry(&it.entry_iter, &it.column_iter)) {
+                u32 length;
+                const field_number_t *values = archive_column_entry_get_numbers(&length, &it.entry_iter);
+                ASSERT_EQ(length, 1u);
+                ASSERT_EQ(values[0], quarter(i++ * 7));
+                num_checked++;
+            }
+        }
+    }
+    ASSERT_EQ(num_checked, 400u);
+
+    archive_close(&archive);
+}
+
+TEST(ArchiveIterTest, KeysAndStringsUseCompactIds)
+{
+    struct archive archive;
+    struct archive_query query;
+    struct archive_info info;
+    struct record_iters it;
+
+    /* string ids of the asynchronous dictionary carry the id of the inserting thread in their upper bits */
+    const char *json = "{ \"name\": \"alice\", \"city\": \"paris\", \"items\": [{ \"k\": \"v1\" }, "
+                       "{ \"k\": \"v2\" }] }";
+    ASSERT_TRUE(archive_from_json(&archive, "tmp-test-archive.carbon", &it.err, json, PACK_NONE, ASYNC, 4, false,
+        false, NULL));
+    ASSERT_TRUE(archive.record_table.flags.bits.sid32);
+    ASSERT_TRUE(archive_get_info(&info, &archive));
+    ASSERT_TRUE(archive_query(&query, &archive));
+
+    auto string_of = [&](field_sid_t id) {
+        EXPECT_LE(id, info.num_embeddded_strings);
+        char *string = query_fetch_string_by_id(&query, id);
+        std::string result = string ? string : "";
+        free(string);
+        return result;
+    };
+
+    ASSERT_TRUE(open_record(&it, &archive, false));
+
+    std::vector<std::string> pairs;
+    while (archive_prop_iter_next(&it.iter_type, &it.value_iter, &it.collection_iter, &it.prop_iter)) {
+        u32 num_keys;
+        if (it.iter_type == PROP_ITER_MODE_OBJECT) {
+            const field_sid_t *keys = archive_value_vector_get_keys(&num_keys, &it.value_iter);
+            const field_sid_t *values = archive_value_vector_get_strings(&num_keys, &it.value_iter);
+            ASSERT_TRUE(values != NULL);
+            for (u32 i = 0; i < num_keys; i++) {
+                pairs.push_back(string_of(keys[i]) + "=" + string_of(values[i]));
+            }
+        } else {
+            const field_sid_t *keys = archive_collection_iter_get_keys(&num_keys, &it.collection_iter);
+            ASSERT_EQ(num_keys, 1u);
+            ASSERT_TRUE(archive_collection_next_column_group(&it.group_iter, &it.collection_iter));
+            ASSERT_TRUE(archive_column_group_next_column(&it.column_iter, &it.group_iter));
+            field_sid_t name;
+            enum field_type type;
+            ASSERT_TRUE(archive_column_get_name(&name, &type, &it.column_iter));
+            while (archive_column_next_entry(&it.entry_iter, &it.column_iter)) {
+                u32 length;
+                const field_sid_t *values = archive_column_entry_get_strings(&length, &it.entry_iter);
+                ASSERT_EQ(length, 1u);
+                pairs.push_back(string_of(keys[0]) + "." + string_of(name) + "=" + string_of(values[0]));
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    ASSERT_EQ(pairs, std::vector<std::string>({ "city=paris", "items.k=v1", "items.k=v2", "name=alice" }));
+
+    ASSERT_TRUE(query_drop(&query));
+    archive_close(&archive);
+
+    /* enough sparse ids that the baked string id index displaces entries and rehashes while it is built */
+    std::string many = "{";
+    std::vector<std::string> expected({ "/" });
+    for (int i = 0; i < 1000; i++) {
+        many += (i ? ", \"key-" : " \"key-") + std::to_string(i) + "\": \"value-" + std::to_string(i) + "\"";
+        expected.push_back("key-" + std::to_string(i));
+        expected.push_back("value-" + std::to_string(i));
+    }
+    many += " }";
+    ASSERT_TRUE(archive_from_json(&archive, "tmp-test-archive.carbon", &it.err, many.c_str(), PACK_NONE, ASYNC, 4,
+        false, true, NULL));
+    bool has_index;
+    ASSERT_TRUE(archive_has_query_index_string_id_to_offset(&has_index, &archive));
+    ASSERT_TRUE(has_index);
+    ASSERT_TRUE(archive_query(&query, &archive));
+
+    struct strid_iter strid_iter;
+    struct strid_info *strid_infos;
+    size_t num_strid_infos;
+    bool success;
+    std::vector<std::string> fetched;
+    ASSERT_TRUE(query_scan_strids(&strid_iter, &query));
+    while (strid_iter_next(&success, &strid_infos, &it.err, &num_strid_infos, &strid_iter)) {
+        for (size_t i = 0; i < num_strid_infos; i++) {
+            char *string = query_fetch_string_by_id_nocache(&query, strid_infos[i].id);
+            ASSERT_TRUE(string != NULL);
+            fetched.push_back(string);
+            free(string);
+        }
+    }
+    ASSERT_TRUE(strid_iter_close(&strid_iter));
+    std::sort(fetched.begin(), fetched.end());
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(fetched, expected);
+
+    ASSERT_TRUE(query_drop(&query));
+    archive_close(&archive);
+}
+
+TEST(ArchiveIterTest, AlignedLayoutAlignsColumnValues)
+{
+    /* random values do not shrink by any encoding, such that the column of 'v' stores its entries plain */
+    std::mt19937 random(13);
+    std::string json = "{ \"events\": [";
+    std::vector<i32> values;
+    for (u32 i = 0; i < 50; i++) {
+        json += (i > 0 ? ", " : "") + std::string("{ \"id\": ") + std::to_string(i) + ", \"v\": [";
+        for (u32 k = 0; k < 100; k++) {
+            values.push_back((i32) random());
+            json += (k > 0 ? ", " : "") + std::to_string(values.back());
+        }
+        json += "] }";
+    }
+    json += "] }";
+
+    auto scan = [&](bool aligned) {
+        struct archive archive;
+        struct record_iters it;
+        std::vector<i32> scanned;
+
+        EXPECT_TRUE(archive_from_json_parallel(&archive, "tmp-test-archive.carbon", &it.err, json.c_str(), 2,
+            PACK_NONE, SYNC, 0, false, aligned, 0, false, NULL));
+        EXPECT_EQ(archive.record_table.flags.bits.aligned, aligned);
+        archive_prop_iter_from_archive(&it.prop_iter, &it.err, NG5_ARCHIVE_ITER_MASK_ANY, &archive);
+        iterate_properties(&it.prop_iter);
+
+        EXPECT_TRUE(open_record(&it, &archive, true));
+        archive_collection_next_column_group(&it.group_iter, &it.collection_iter);
+        while (archive_column_group_next_column(&it.column_iter, &it.group_iter)) {
+            field_sid_t name;
+            enum field_type type;
+            archive_column_get_name(&name, &type, &it.column_iter);
+            if (type != FIELD_INT32) {
+                continue;
+            }
+            EXPECT_EQ(it.column_iter.state.current_column_group.current_column.encoding, INTPACK_PLAIN);
+            while (archive_column_next_entry(&it.entry_iter, &it.column_iter)) {
+                u32 length;
+                const field_i32_t *entry = archive_column_entry_get_int32s(&length, &it.entry_iter);
+                if (aligned) {
+                    /* entries of at least NG5_ARCHIVE_ALIGN_LARGE bytes start at a cache line */
+                    EXPECT_EQ((uintptr_t) entry % NG5_ARCHIVE_CACHE_LINE, 0u);
+                }
+                scanned.insert(scanned.end(), entry, entry + length);
+            }
+            u64 count;
+            EXPECT_TRUE(archive_column_count_range(&count, 0, INT32_MAX / 2, &it.column_iter));
+            EXPECT_EQ(count, (u64) std::count_if(scanned.begin(), scanned.end(),
+                [](i32 value) { return value >= 0 && value <= INT32_MAX / 2; }));
+        }
+        archive_close(&archive);
+        return scanned;
+    };
+
+    ASSERT_EQ(scan(true), values);
+    ASSERT_EQ(scan(false), values);
+}
+
+TEST(ArchiveIterTest, ObjectWithManyArraysOfObjects)
+{
+    struct archive archive;
+    struct archive_info info;
+    struct record_iters it;
+
+    /* more arrays of objects than fit into a byte, each of which is a column group of its own */
+    const u32 num_arrays = 300;
+    std::string json = "{ \"id\": 1";
+    for (u32 i = 0; i < num_arrays; i++) {
+        json += std::string(", \"a") + std::to_string(i) + "\": [{ \"x\": " + std::to_string(i)
+            + " }, { \"x\": " + std::to_string(i) + " }]";
+    }
+    json += "}";
+
+    ASSERT_TRUE(archive_from_json(&archive, "tmp-test-archive.carbon", &it.err, json.c_str(), PACK_NONE, SYNC, 0,
+        false, false, NULL));
+    ASSERT_TRUE(archive_get_info(&info, &archive));
+    ASSERT_GE(info.num_embeddded_strings, num_arrays);
+    ASSERT_TRUE(open_record(&it, &archive, true));
+
+    u32 num_keys;
+    archive_collection_iter_get_keys(&num_keys, &it.collection_iter);
+    ASSERT_EQ(num_keys, num_arrays);
+    u32 num_groups = 0;
+    while (archive_collection_next_column_group(&it.group_iter, &it.collection_iter)) {
+        u32 num_objects, num_entries = 0;
+        archive_column_group_get_object_ids(&num_objects, &it.group_iter);
+        ASSERT_EQ(num_objects, 2u);
+        ASSERT_TRUE(archive_column_group_next_column(&it.column_iter, &it.group_iter));
+        while (archive_column_next_entry(&it.entry_iter, &it.column_iter)) {
+            num_entries++;
+        }
+        ASSERT_EQ(num_entries, 2u);
+        num_groups++;
+    }
+    ASSERT_EQ(num_groups, num_arrays);
+
+    archive_close(&archive);
+}
+
+TEST(ArchiveIterTest, ReadOptimizedSortsArrayColumnsInLinearithmicTime)
+{
+    struct archive archive;
+    struct archive_query query;
+    struct record_iters it;
+
+    /* returns the seconds it takes to create a read-optimized archive from num_records arrays of few distinct strings,
+     * and checks that the array column is sorted */
+    auto create_sorted = [&](u32 num_records) {
+        std::mt19937 gen(num_records);
+        std::uniform_int_distribution<int> word(0, 7), length(1, 4);
+        std::string json = "{ \"records\": [";
+        for (u32 i = 0; i < num_records; i++) {
+            json += i ? ", { \"tags\": [" : " { \"tags\": [";
+            for (int j = 0, n = length(gen); j < n; j++) {
+                json += (j ? ", \"t" : "\"t") + std::to_string(word(gen)) + "\"";
+            }
+            json += "], \"nums\": [" + std::to_string(word(gen)) + ", " + std::to_string(word(gen)) + "] }";
+        }
+        /* properties of the root object that are arrays are sorted as well */
+        json += "]";
+        for (u32 i = 0; i < num_records; i++) {
+            json += ", \"p" + std::to_string(i) + "\": [\"t" + std::to_string(word(gen)) + "\", \"t"
+                + std::to_string(word(gen)) + "\"]";
+        }
+        json += " }";
+
+        auto begin = std::chrono::steady_clock::now();
+        EXPECT_TRUE(archive_from_json(&archive, "tmp-test-archive.carbon", &it.err, json.c_str(), PACK_NONE, ASYNC,
+            4, true, false, NULL));
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        EXPECT_TRUE(archive_query(&query, &archive));
+        EXPECT_TRUE(open_record(&it, &archive, true));
+        EXPECT_TRUE(archive_collection_next_column_group(&it.group_iter, &it.collection_iter));
+
+        u32 num_entries = 0;
+        while (archive_column_group_next_column(&it.column_iter, &it.group_iter)) {
+            field_sid_t name;
+            enum field_type type;
+            EXPECT_TRUE(archive_column_get_name(&name, &type, &it.column_iter));
+            if (type != FIELD_STRING) {
+                continue;
+            }
+            std::vector<std::string> previous;
+            while (archive_column_next_entry(&it.entry_iter, &it.column_iter)) {
+                u32 length;
+                const field_sid_t *values = archive_column_entry_get_strings(&length, &it.entry_iter);
+                std::vector<std::string> strings;
+                for (u32 i = 0; i < length; i++) {
+                    char *string = query_fetch_string_by_id(&query, values[i]);
+                    strings.push_back(string);
+                    free(string);
+                }
+                EXPECT_LE(previous, strings);
+                previous = strings;
+                num_entries++;
+            }
+        }
+        EXPECT_EQ(num_entries, num_records);
+
+        EXPECT_TRUE(query_drop(&query));
+        archive_close(&archive);
+        return seconds;
+    };
+
+    /* a quadratic sort of the many equal arrays takes 16 times longer on 4 times the records */
+    double small = create_sorted(1000);
+    double large = create_sorted(4000);
+    ASSERT_LT(large, 8 * small);
+}
+
+TEST(ArchiveIterTest, RowGroupsPruneSplitAndSeek)
+{
+    /* 'v' grows with the position of its object, and 'k' changes every 250 objects such that it is stored as a run */
+    const u32 num_events = 1000, row_group_size = 100;
+    std::string json = "{ \"events\": [";
+    for (u32 i = 0; i < num_events; i++) {
+        json += (i > 0 ? ", " : "") + std::string("{ \"v\": ") + std::to_string(1000 + i) + ", \"k\": "
+            + std::to_string(1000 + i / 250) + " }";
+    }
+    json += "] }";
+
+    auto scan = [&](u64 size) {
+        struct archive archive;
+        struct record_iters it;
+        u32 num_row_groups, num_columns = 0;
+        u64 group_size;
+
+        ASSERT_TRUE(archive_from_json_parallel(&archive, "tmp-test-archive.carbon", &it.err, json.c_str(), 2,
+            PACK_NONE, SYNC, 0, false, false, size, false, NULL));
+        ASSERT_TRUE(open_record(&it, &archive, true));
+        ASSERT_TRUE(archive_collection_next_column_group(&it.group_iter, &it.collection_iter));
+        ASSERT_TRUE(archive_column_group_get_row_groups(&num_row_groups, &group_size, &it.group_iter));
+        ASSERT_EQ(num_row_groups, size ? num_events / row_group_size : 1);
+        ASSERT_EQ(group_size, size ? row_group_size : num_events);
+
+        while (archive_column_group_next_column(&it.column_iter, &it.group_iter)) {
+            enum field_type type;
+            archive_column_get_name(NULL, &type, &it.column_iter);
+            ASSERT_EQ(type, FIELD_INT16);
+            num_columns++;
+
+            std::vector<i16> values;
+            archive_column_iter_t entries = it.column_iter;
+            while (archive_column_next_entry(&it.entry_iter, &entries)) {
+                u32 length;
+                const field_i16_t *entry = archive_column_entry_get_int16s(&length, &it.entry_iter);
+                values.insert(values.end(), entry, entry + length);
+            }
+            ASSERT_EQ(values.size(), num_events);
+            if (size) {
+                const struct row_group_zone *zones = it.column_iter.state.current_column_group.current_column.zones;
+                ASSERT_TRUE(it.column_iter.state.current_column_group.current_column.zone_map);
+                for (u32 g = 0; g < num_row_groups; g++) {
+                    ASSERT_EQ((i64) zones[g].min, values[g * row_group_size]);
+                    ASSERT_EQ((i64) zones[g].max, values[(g + 1) * row_group_size - 1]);
+                }
+            }
+
+            for (u64 lo : { 0, 1001, 1150, 1420, 1999, 3000 }) {
+                u64 hi = lo + 333, count, first_half, second_half;
+                u64 expected = std::count_if(values.begin(), values.end(),
+                    [&](i16 value) { return value >= (i64) lo && value <= (i64) hi; });
+                ASSERT_TRUE(archive_column_count_range(&count, lo, hi, &it.column_iter));
+                ASSERT_EQ(count, expected);
+
+                /* each thread scans a copy of the iterator on half of the row groups */
+                archive_column_iter_t copy = it.column_iter;
+                u32 half = num_row_groups / 2;
+                std::thread thread([&]() {
+                    archive_column_count_range_in_row_groups(&first_half, 0, half, lo, hi, &copy);
+                });
+                ASSERT_TRUE(archive_column_count_range_in_row_groups(&second_half, half, num_row_groups - half, lo,
+                    hi, &it.column_iter));
+                thread.join();
+                ASSERT_EQ(first_half + second_half, expected);
+            }
+
+            /* pages start at the first object of a row group */
+            for (u32 g = 0; g < num_row_groups; g++) {
+                entries = it.column_iter;
+                ASSERT_TRUE(archive_column_seek_row_group(g, &entries));
+                ASSERT_TRUE(archive_column_next_entry(&it.entry_iter, &entries));
+                u32 length;
+                const field_i16_t *entry = archive_column_entry_get_int16s(&length, &it.entry_iter);
+                ASSERT_EQ(length, 1u);
+                ASSERT_EQ(entry[0], values[g * group_size]);
+            }
+            ASSERT_FALSE(archive_column_seek_row_group(num_row_groups, &it.column_iter));
+        }
+        ASSERT_EQ(num_columns, 2u);
+        archive_close(&archive);
+    };
+
+    scan(row_group_size);
+    scan(0);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
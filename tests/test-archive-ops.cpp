@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
 #include <inttypes.h>
+#include <set>
+#include <string>
+#include <vector>
 #include "core/carbon/archive_query.h"
 #include "core/carbon.h"
 
@@ -262,7 +265,7 @@ TEST(CarbonArchiveOpsTest, FindStringIdMatchingPredicateEquals)
     ASSERT_TRUE(string != NULL);
     printf("MATCHED EQUALS %" PRIu64 " ('%s')\n", result[0], string);
     ASSERT_TRUE(strcmp(string, needle) == 0);
-    ASSERT_TRUE(result[0] == 72057594037928054);
+    ASSERT_TRUE(result[0] == 44);
     free(string);
 
     free(result);
@@ -270,6 +273,108 @@ TEST(CarbonArchiveOpsTest, FindStringIdMatchingPredicateEquals)
     archive_close(&archive);
 }
 
+static void decode_strings_by_id_from_compressed_archive(enum packer_type compressor)
+{
+    struct archive       archive;
+    struct strid_iter    strid_iter;
+    struct strid_info   *info;
+    struct err           err;
+    struct archive_query query;
+    size_t               vector_len;
+    bool                 success;
+
+    /* letters with Fibonacci frequencies have Huffman codes longer than NG5_HUFFMAN_MAX_CODE_LENGTH unless limited */
+    std::set<std::string> expected = { "", "x", "hello world", "some much longer string that spans several probes of "
+                                       "the decode table", "\xc3\xa4\xc3\xb6\xc3\xbc" };
+    u64 prev = 1, freq = 1;
+    for (char letter = 'a'; letter <= 't'; letter++) {
+        expected.insert(std::string(freq, letter) + "!");
+        u64 next = prev + freq;
+        prev = freq;
+        freq = next;
+    }
+    /* enough strings to be encoded concurrently on multi-core machines */
+    for (int i = 0; i < 5000; i++) {
+        expected.insert("http://www.example.org/item/" + std::to_string(i * 7919 % 10007));
+    }
+    std::string json = "{ \"strings\": [";
+    for (const std::string &string : expected) {
+        json += (json.back() == '[' ? "\"" : ", \"") + string + "\"";
+    }
+    json += "] }";
+
+    ASSERT_TRUE(archive_from_json(&archive, "tmp-test-archive.carbon", &err, json.c_str(), compressor, SYNC, 0,
+        false, false, NULL));
+    ASSERT_TRUE(archive_query(&query, &archive));
+    ASSERT_TRUE(query_scan_strids(&strid_iter, &query));
+
+    std::set<std::string> decoded;
+    while (strid_iter_next(&success, &info, &err, &vector_len, &strid_iter)) {
+        for (size_t i = 0; i < vector_len; i++) {
+            char *string = query_fetch_string_by_id(&query, info[i].id);
+            ASSERT_TRUE(string != NULL);
+            decoded.insert(string);
+            free(string);
+        }
+    }
+    ASSERT_TRUE(strid_iter_close(&strid_iter));
+
+    for (const std::string &string : expected) {
+        ASSERT_TRUE(decoded.count(string) == 1) << "'" << string << "' not decoded";
+    }
+
+    ASSERT_TRUE(query_drop(&query));
+    ASSERT_TRUE(archive_close(&archive));
+}
+
+TEST(CarbonArchiveOpsTest, DecodeStringByIdFromHuffmanCompressedArchive)
+{
+    decode_strings_by_id_from_compressed_archive(PACK_HUFFMAN);
+}
+
+TEST(CarbonArchiveOpsTest, DecodeStringByIdFromFsstCompressedArchive)
+{
+    decode_strings_by_id_from_compressed_archive(PACK_FSST);
+}
+
+TEST(CarbonArchiveOpsTest, CompareFsstCompressedStrings)
+{
+    struct vector ofType(const char *) strings;
+    struct coding_fsst dic;
+    const char *urls[] = { "http://www.example.org/index.html", "http://www.example.org/about.html",
+                           "https://www.example.com/index.html", "http://www.example.org/index.htm", "" };
+
+    vec_create(&strings, NULL, sizeof(const char *), 16);
+    for (size_t round = 0; round < 100; round++) {
+        vec_push(&strings, urls, 4);
+    }
+    ASSERT_TRUE(coding_fsst_build(&dic, &strings));
+    ASSERT_TRUE(dic.num_symbols > 0);
+
+    for (const char *lhs : urls) {
+        std::vector<char> lhs_encoded(2 * strlen(lhs) + 1);
+        size_t lhs_nbytes = coding_fsst_compress(lhs_encoded.data(), &dic, lhs, strlen(lhs));
+        ASSERT_TRUE(lhs_nbytes <= 2 * strlen(lhs));
+        if (strlen(lhs) > 0) {
+            ASSERT_TRUE(lhs_nbytes < strlen(lhs));
+        }
+
+        std::vector<char> decoded(strlen(lhs) + 1);
+        ASSERT_TRUE(coding_fsst_decode(decoded.data(), strlen(lhs), &dic, lhs_encoded.data(), lhs_nbytes));
+        ASSERT_EQ(std::string(decoded.data(), strlen(lhs)), lhs);
+
+        for (const char *rhs : urls) {
+            std::vector<char> rhs_encoded(2 * strlen(rhs) + 1);
+            size_t rhs_nbytes = coding_fsst_compress(rhs_encoded.data(), &dic, rhs, strlen(rhs));
+            ASSERT_EQ(coding_fsst_equals(lhs_encoded.data(), lhs_nbytes, rhs_encoded.data(), rhs_nbytes),
+                strcmp(lhs, rhs) == 0) << lhs << " vs. " << rhs;
+        }
+    }
+
+    coding_fsst_drop(&dic);
+    vec_drop(&strings);
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "core/alloc/arena.h"
+
+static const size_t chunk_size = 4096;
+
+static void fill(void *block, size_t size, int seed)
+{
+    for (size_t i = 0; i < size; i++) {
+        ((unsigned char *) block)[i] = (unsigned char) (seed + i);
+    }
+}
+
+static bool has_fill(const void *block, size_t size, int seed)
+{
+    for (size_t i = 0; i < size; i++) {
+        if (((const unsigned char *) block)[i] != (unsigned char) (seed + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static size_t arena_size(const struct allocator *alloc)
+{
+    size_t num_bytes = 0;
+    EXPECT_TRUE(arena_alloc_size(&num_bytes, alloc));
+    return num_bytes;
+}
+
+TEST(ArenaTest, SmallBlocksAreAligned)
+{
+    struct allocator alloc;
+    ASSERT_TRUE(arena_alloc_create(&alloc, chunk_size));
+    ASSERT_TRUE(arena_alloc_is(&alloc));
+    ASSERT_EQ(arena_size(&alloc), 0u);
+
+    std::vector<void *> blocks;
+    for (size_t i = 0; i < 1000; i++) {
+        size_t size = 1 + i % 100;
+        void *block = alloc_malloc(&alloc, size);
+        ASSERT_EQ((uintptr_t) block % NG5_ARENA_ALIGNMENT, 0u);
+        fill(block, size, i);
+        blocks.push_back(block);
+    }
+    for (size_t i = 0; i < blocks.size(); i++) {
+        ASSERT_TRUE(has_fill(blocks[i], 1 + i % 100, i));
+    }
+    ASSERT_GT(arena_size(&alloc), 10 * chunk_size);
+    ASSERT_TRUE(arena_alloc_drop(&alloc));
+}
+
+TEST(ArenaTest, ResetKeepsFirstChunk)
+{
+    struct allocator alloc;
+    ASSERT_TRUE(arena_alloc_create(&alloc, chunk_size));
+
+    alloc_malloc(&alloc, 16);
+    size_t one_chunk = arena_size(&alloc);
+    ASSERT_GE(one_chunk, chunk_size);
+
+    for (size_t i = 0; i < 100; i++) {
+        alloc_malloc(&alloc, 512);
+    }
+    void *large = alloc_malloc(&alloc, 2 * chunk_size);
+    fill(large, 2 * chunk_size, 1);
+    ASSERT_GT(arena_size(&alloc), 10 * one_chunk);
+
+    ASSERT_TRUE(arena_alloc_reset(&alloc));
+    ASSERT_EQ(arena_size(&alloc), one_chunk);
+
+    /** the kept chunk is handed out from its beginning again */
+    std::vector<void *> blocks;
+    for (size_t i = 0; i < 100; i++) {
+        void *block = alloc_malloc(&alloc, 64);
+        fill(block, 64, i);
+        blocks.push_back(block);
+    }
+    for (size_t i = 0; i < blocks.size(); i++) {
+        ASSERT_TRUE(has_fill(blocks[i], 64, i));
+    }
+    ASSERT_TRUE(arena_alloc_drop(&alloc));
+}
+
+TEST(ArenaTest, ResetWithDedicatedChunkAtFront)
+{
+    struct allocator alloc;
+    ASSERT_TRUE(arena_alloc_create(&alloc, chunk_size));
+
+    /** the first block is larger than a quarter of a chunk, hence its chunk of its own becomes the first chunk */
+    void *large = alloc_malloc(&alloc, chunk_size / 2);
+    fill(large, chunk_size / 2, 3);
+    ASSERT_GE(arena_size(&alloc), chunk_size / 2);
+    ASSERT_LT(arena_size(&alloc), chunk_size);
+
+    /** that chunk is not kept for small blocks */
+    ASSERT_TRUE(arena_alloc_reset(&alloc));
+    ASSERT_EQ(arena_size(&alloc), 0u);
+
+    std::vector<void *> blocks;
+    for (size_t i = 0; i < 50; i++) {
+        void *block = alloc_malloc(&alloc, 200);
+        fill(block, 200, i);
+        blocks.push_back(block);
+        if (i == 0) {
+            large = alloc_malloc(&alloc, chunk_size);
+            fill(large, chunk_size, 7);
+        }
+    }
+    ASSERT_TRUE(has_fill(large, chunk_size, 7));
+    for (size_t i = 0; i < blocks.size(); i++) {
+        ASSERT_TRUE(has_fill(blocks[i], 200, i));
+    }
+
+    /** a chunk of small blocks is in front of chunks of their own, and is kept */
+    size_t with_large = arena_size(&alloc);
+    alloc_free(&alloc, large);
+    ASSERT_LE(arena_size(&alloc), with_large - chunk_size);
+    ASSERT_TRUE(arena_alloc_reset(&alloc));
+    size_t one_chunk = arena_size(&alloc);
+    ASSERT_GE(one_chunk, chunk_size);
+    ASSERT_LT(one_chunk, 2 * chunk_size);
+
+    large = alloc_malloc(&alloc, chunk_size);
+    blocks.clear();
+    for (size_t i = 0; i < 10; i++) {
+        void *block = alloc_malloc(&alloc, 200);
+        fill(block, 200, i);
+        blocks.push_back(block);
+    }
+    for (size_t i = 0; i < blocks.size(); i++) {
+        ASSERT_TRUE(has_fill(blocks[i], 200, i));
+    }
+    ASSERT_TRUE(arena_alloc_reset(&alloc));
+    ASSERT_EQ(arena_size(&alloc), one_chunk);
+    ASSERT_TRUE(arena_alloc_reset(&alloc));
+    ASSERT_EQ(arena_size(&alloc), one_chunk);
+    ASSERT_TRUE(arena_alloc_drop(&alloc));
+}
+
+TEST(ArenaTest, LargeBlocksGetChunksOfTheirOwn)
+{
+    struct allocator alloc;
+    ASSERT_TRUE(arena_alloc_create(&alloc, chunk_size));
+
+    void *small = alloc_malloc(&alloc, 32);
+    fill(small, 32, 5);
+    size_t before = arena_size(&alloc);
+
+    void *large = alloc_malloc(&alloc, chunk_size / 4 + 1);
+    fill(large, chunk_size / 4 + 1, 9);
+    ASSERT_GT(arena_size(&alloc), before + chunk_size / 4);
+
+    /** a chunk of its own is resized in place, and its memory is given back when freed */
+    large = alloc_realloc(&alloc, large, 10 * chunk_size);
+    ASSERT_TRUE(large != NULL);
+    ASSERT_TRUE(has_fill(large, chunk_size / 4 + 1, 9));
+    ASSERT_GT(arena_size(&alloc), before + 10 * chunk_size);
+    fill(large, 10 * chunk_size, 11);
+
+    large = alloc_realloc(&alloc, large, chunk_size / 2);
+    ASSERT_TRUE(has_fill(large, chunk_size / 2, 11));
+    ASSERT_LT(arena_size(&alloc), before + chunk_size);
+
+    alloc_free(&alloc, large);
+    ASSERT_EQ(arena_size(&alloc), before);
+
+    /** small blocks keep being taken from the first chunk */
+    void *next = alloc_malloc(&alloc, 32);
+    ASSERT_EQ((char *) next, (char *) small + 32 + sizeof(size_t));
+    ASSERT_TRUE(has_fill(small, 32, 5));
+    ASSERT_EQ(arena_size(&alloc), before);
+
+    ASSERT_TRUE(arena_alloc_drop(&alloc));
+}
+
+TEST(ArenaTest, LastBlockGrowsInPlace)
+{
+    struct allocator alloc;
+    ASSERT_TRUE(arena_alloc_create(&alloc, chunk_size));
+
+    void *first = alloc_malloc(&alloc, 16);
+    fill(first, 16, 1);
+
+    void *grown = alloc_realloc(&alloc, first, 200);
+    ASSERT_EQ(grown, first);
+    ASSERT_TRUE(has_fill(grown, 16, 1));
+    fill(grown, 200, 2);
+
+    void *shrunk = alloc_realloc(&alloc, grown, 40);
+    ASSERT_EQ(shrunk, first);
+    ASSERT_TRUE(has_fill(shrunk, 40, 2));
+
+    /** a block that is no longer the most recent one is copied to grow */
+    void *second = alloc_malloc(&alloc, 8);
+    ASSERT_EQ((char *) second, (char *) first + 40 + sizeof(size_t));
+    void *moved = alloc_realloc(&alloc, first, 100);
+    ASSERT_NE(moved, first);
+    ASSERT_TRUE(has_fill(moved, 40, 2));
+    ASSERT_EQ(alloc_realloc(&alloc, second, 8), second);
+
+    /** the most recent block moves to a chunk of its own once it exceeds a quarter of a chunk */
+    size_t before = arena_size(&alloc);
+    fill(moved, 100, 4);
+    void *large = alloc_realloc(&alloc, moved, chunk_size);
+    ASSERT_NE(large, moved);
+    ASSERT_TRUE(has_fill(large, 100, 4));
+    ASSERT_GE(arena_size(&alloc), before + chunk_size);
+
+    /** the most recent block also moves if the first chunk is exhausted */
+    void *last = NULL, *resized = NULL;
+    for (size_t i = 0; i < 100 && resized == last; i++) {
+        last = alloc_malloc(&alloc, 400);
+        fill(last, 400, 6);
+        resized = alloc_realloc(&alloc, last, 600);
+    }
+    ASSERT_NE(resized, last);
+    ASSERT_TRUE(has_fill(resized, 400, 6));
+    ASSERT_TRUE(arena_alloc_drop(&alloc));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <math.h>
+#include <random>
+#include <vector>
+
+#include "core/pack/floatpack.h"
+
+static const enum floatpack_type types[] = { FLOATPACK_PLAIN, FLOATPACK_ALP };
+
+static const size_t lengths[] = { 0, 1, 2, 7, 255, 256, 257, 1000, 4099 };
+
+static size_t round_trip(const std::vector<field_number_t> &values, enum floatpack_type type)
+{
+    struct memblock *block;
+    struct memfile file;
+    memblock_create(&block, 64);
+    memfile_open(&file, block, READ_WRITE);
+
+    EXPECT_TRUE(floatpack_encode(&file, type, values.data(), values.size()));
+    offset_t size = memfile_tell(&file);
+    const char *encoded = memblock_raw_data(block);
+    EXPECT_EQ(floatpack_encoded_size(encoded, type, values.size()), size);
+
+    std::vector<field_number_t> decoded(values.size() + 1);
+    EXPECT_EQ(floatpack_decode(decoded.data(), encoded, type, values.size()), size);
+    for (size_t i = 0; i < values.size(); i++) {
+        /* bitwise, such that nulls and negative zeros are compared, too */
+        EXPECT_EQ(memcmp(&decoded[i], &values[i], sizeof(field_number_t)), 0)
+            << floatpack_type_str(type) << " at " << i << ": " << decoded[i] << " != " << values[i];
+    }
+
+    memblock_drop(block);
+    return size;
+}
+
+TEST(FloatPackTest, RoundTripDecimals)
+{
+    std::mt19937_64 random(42);
+    for (size_t length : lengths) {
+        for (unsigned digits = 0; digits <= 4; digits++) {
+            std::vector<field_number_t> values(length);
+            for (size_t i = 0; i < length; i++) {
+                values[i] = (field_number_t) ((double) (i64) (random() % 200000 - 100000) / pow(10, digits));
+            }
+            for (enum floatpack_type type : types) {
+                round_trip(values, type);
+            }
+        }
+    }
+}
+
+TEST(FloatPackTest, RoundTripExceptions)
+{
+    std::mt19937_64 random(7);
+    std::uniform_real_distribution<field_number_t> uniform(-1e6f, 1e6f);
+    for (size_t length : lengths) {
+        std::vector<field_number_t> values(length);
+        for (size_t i = 0; i < length; i++) {
+            switch (i % 7) {
+            case 0: values[i] = NG5_NULL_FLOAT;
+                break;
+            case 1: values[i] = -0.0f;
+                break;
+            case 2: values[i] = uniform(random);
+                break;
+            case 3: values[i] = i % 2 ? INFINITY : 3.4e38f;
+                break;
+            default: values[i] = (field_number_t) (random() % 1000) / 10;
+                break;
+            }
+        }
+        for (enum floatpack_type type : types) {
+            round_trip(values, type);
+        }
+    }
+}
+
+TEST(FloatPackTest, DecimalsShrink)
+{
+    std::mt19937_64 random(3);
+    std::vector<field_number_t> temperatures(10000), noise(10000);
+    for (size_t i = 0; i < temperatures.size(); i++) {
+        temperatures[i] = (field_number_t) (200 + (i64) (random() % 150)) / 10;
+        noise[i] = (field_number_t) exp(std::uniform_real_distribution<double>(-40, 40)(random));
+    }
+
+    size_t sizes[NG5_FLOATPACK_NUM_TYPES] = { 0 };
+    floatpack_estimate(sizes, temperatures.data(), temperatures.size());
+    ASSERT_EQ(floatpack_choose(sizes), FLOATPACK_ALP);
+    /* three digits fit into 8 bits instead of 32 */
+    size_t size = round_trip(temperatures, FLOATPACK_ALP);
+    ASSERT_EQ(size, sizes[FLOATPACK_ALP]);
+    ASSERT_LT(size, temperatures.size() * sizeof(field_number_t) / 3);
+
+    /* numbers of widely spread magnitudes are exceptions mostly */
+    memset(sizes, 0, sizeof(sizes));
+    floatpack_estimate(sizes, noise.data(), noise.size());
+    ASSERT_EQ(floatpack_choose(sizes), FLOATPACK_PLAIN);
+    round_trip(noise, FLOATPACK_ALP);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+
+#include "std/hash_map.h"
+
+TEST(HashMapTest, CreationAndDrop)
+{
+    struct hashmap_u64_u32 map;
+    bool             status;
+
+    status = hashmap_u64_u32_create(&map, NULL, 100);
+    ASSERT_TRUE(status);
+    status = hashmap_u64_u32_drop(&map);
+    ASSERT_TRUE(status);
+}
+
+TEST(HashMapTest, PutAndGetWithRehash)
+{
+    struct hashmap_u64_u32 map;
+
+    hashmap_u64_u32_create(&map, NULL, 10);
+
+    for (u64 key = 0; key < 100000; key++) {
+        ASSERT_TRUE(hashmap_u64_u32_put(&map, key << 32, (u32) key));
+    }
+    ASSERT_EQ(hashmap_u64_u32_size(&map), 100000u);
+
+    for (u64 key = 0; key < 100000; key++) {
+        const u32 *value = hashmap_u64_u32_get(&map, key << 32);
+        ASSERT_TRUE(value != NULL);
+        ASSERT_EQ(*value, (u32) key);
+    }
+    ASSERT_TRUE(hashmap_u64_u32_get(&map, 1) == NULL);
+
+    hashmap_u64_u32_drop(&map);
+}
+
+TEST(HashMapTest, UpsertCounts)
+{
+    struct hashmap_u64_u32 map;
+    bool found;
+
+    hashmap_u64_u32_create(&map, NULL, 0);
+
+    for (u64 i = 0; i < 1000; i++) {
+        (*hashmap_u64_u32_upsert(&map, i % 10, &found))++;
+        ASSERT_EQ(found, i >= 10);
+    }
+    ASSERT_EQ(hashmap_u64_u32_size(&map), 10u);
+
+    u64 key;
+    u32 *value;
+    u32 it = 0, num_pairs = 0;
+    while (hashmap_u64_u32_next(&key, &value, &it, &map)) {
+        ASSERT_TRUE(key < 10);
+        ASSERT_EQ(*value, 100u);
+        num_pairs++;
+    }
+    ASSERT_EQ(num_pairs, 10u);
+
+    hashmap_u64_u32_drop(&map);
+}
+
+TEST(HashMapTest, RemoveAndBatchGet)
+{
+    struct hashmap_u64_u32 map;
+    u64 keys[1000];
+    u32 *values[1000];
+
+    hashmap_u64_u32_create(&map, NULL, 100);
+
+    for (u64 key = 0; key < 1000; key++) {
+        hashmap_u64_u32_put(&map, key, (u32) key + 1);
+        keys[key] = key;
+    }
+    for (u64 key = 0; key < 1000; key += 2) {
+        ASSERT_TRUE(hashmap_u64_u32_remove(&map, key));
+        ASSERT_FALSE(hashmap_u64_u32_remove(&map, key));
+    }
+    ASSERT_EQ(hashmap_u64_u32_size(&map), 500u);
+
+    hashmap_u64_u32_get_batch(values, &map, keys, 1000);
+    for (u64 key = 0; key < 1000; key++) {
+        if (key % 2 == 0) {
+            ASSERT_TRUE(values[key] == NULL);
+        } else {
+            ASSERT_TRUE(values[key] != NULL);
+            ASSERT_EQ(*values[key], (u32) key + 1);
+        }
+    }
+
+    hashmap_u64_u32_drop(&map);
+}
+
+/* allocator that fails once 'extra' (the number of remaining allocations) drops to zero */
+static void *limited_malloc(struct allocator *self, size_t size)
+{
+    size_t *remaining = (size_t *) self->extra;
+    if (*remaining == 0) {
+        return NULL;
+    }
+    (*remaining)--;
+    return malloc(size);
+}
+
+static void *limited_realloc(struct allocator *self, void *ptr, size_t size)
+{
+    (void) self;
+    return realloc(ptr, size);
+}
+
+static void limited_free(struct allocator *self, void *ptr)
+{
+    (void) self;
+    free(ptr);
+}
+
+static void limited_clone(struct allocator *dst, const struct allocator *self)
+{
+    *dst = *self;
+}
+
+TEST(HashMapTest, FailedRehashKeepsContents)
+{
+    struct hashmap_u64_u32 map;
+    size_t remaining = 3;
+    struct allocator limited = { &remaining, { 0, NULL, 0, NULL }, limited_malloc, limited_realloc, limited_free,
+                                 limited_clone };
+
+    ASSERT_TRUE(hashmap_u64_u32_create(&map, &limited, 0));
+    u64 num_keys = 0;
+    while (hashmap_u64_u32_upsert(&map, num_keys, NULL)) {
+        *hashmap_u64_u32_get(&map, num_keys) = (u32) num_keys + 1;
+        num_keys++;
+    }
+    ASSERT_EQ(num_keys, 12u);
+
+    /* growing fails for each of the table's arrays */
+    for (size_t allocations = 0; allocations < 3; allocations++) {
+        remaining = allocations;
+        ASSERT_TRUE(hashmap_u64_u32_upsert(&map, num_keys, NULL) == NULL);
+        ASSERT_FALSE(hashmap_u64_u32_put(&map, num_keys, 0));
+        ASSERT_EQ(hashmap_u64_u32_size(&map), num_keys);
+        for (u64 key = 0; key < num_keys; key++) {
+            const u32 *value = hashmap_u64_u32_get(&map, key);
+            ASSERT_TRUE(value != NULL);
+            ASSERT_EQ(*value, (u32) key + 1);
+        }
+    }
+
+    remaining = 3;
+    ASSERT_TRUE(hashmap_u64_u32_put(&map, num_keys, (u32) num_keys + 1));
+    ASSERT_EQ(hashmap_u64_u32_size(&map), num_keys + 1);
+    for (u64 key = 0; key <= num_keys; key++) {
+        ASSERT_EQ(*hashmap_u64_u32_get(&map, key), (u32) key + 1);
+    }
+
+    hashmap_u64_u32_drop(&map);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
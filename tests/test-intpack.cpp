@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <random>
+#include <limits>
+#include <vector>
+
+#include "core/pack/intpack.h"
+
+static const enum intpack_type types[] = { INTPACK_PLAIN, INTPACK_FOR, INTPACK_DELTA, INTPACK_BITPACK, INTPACK_RLE };
+
+static const size_t lengths[] = { 0, 1, 2, 7, 8, 9, 255, 256, 257, 1000, 4099 };
+
+template<typename T>
+static void round_trip(const std::vector<T> &values)
+{
+    for (enum intpack_type type : types) {
+        struct memblock *block;
+        struct memfile file;
+        memblock_create(&block, 64);
+        memfile_open(&file, block, READ_WRITE);
+
+        ASSERT_TRUE(intpack_encode(&file, type, values.data(), values.size(), sizeof(T),
+            std::numeric_limits<T>::is_signed));
+        offset_t size = memfile_tell(&file);
+        const char *encoded = memblock_raw_data(block);
+        ASSERT_EQ(intpack_encoded_size(encoded, type, values.size(), sizeof(T)), size);
+
+        std::vector<T> decoded(values.size() + 1);
+        ASSERT_EQ(intpack_decode(decoded.data(), encoded, type, values.size(), sizeof(T),
+            std::numeric_limits<T>::is_signed), size);
+        for (size_t i = 0; i < values.size(); i++) {
+            ASSERT_EQ(decoded[i], values[i]) << intpack_type_str(type) << " at " << i << " of " << values.size();
+        }
+
+        memblock_drop(block);
+    }
+}
+
+template<typename T>
+static void round_trip_all_bit_widths()
+{
+    std::mt19937_64 random(42);
+    const unsigned max_bits = sizeof(T) * 8;
+    for (size_t length : lengths) {
+        for (unsigned bits = 0; bits <= max_bits; bits++) {
+            std::vector<T> values(length), sorted(length);
+            u64 mask = bits == 64 ? ~0ull : (1ull << bits) - 1;
+            for (size_t i = 0; i < length; i++) {
+                values[i] = (T) (random() & mask);
+            }
+            round_trip(values);
+            for (size_t i = 0; i < length; i++) {
+                sorted[i] = (T) (i > 0 ? sorted[i - 1] + (T) (random() & (mask >> 4)) : values[0]);
+            }
+            round_trip(sorted);
+        }
+        std::vector<T> extremes(length);
+        for (size_t i = 0; i < length; i++) {
+            extremes[i] = i % 2 ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+        }
+        round_trip(extremes);
+    }
+}
+
+TEST(IntPackTest, RoundTripInt8) { round_trip_all_bit_widths<i8>(); }
+
+TEST(IntPackTest, RoundTripInt16) { round_trip_all_bit_widths<i16>(); }
+
+TEST(IntPackTest, RoundTripInt32) { round_trip_all_bit_widths<i32>(); }
+
+TEST(IntPackTest, RoundTripInt64) { round_trip_all_bit_widths<i64>(); }
+
+TEST(IntPackTest, RoundTripUInt8) { round_trip_all_bit_widths<u8>(); }
+
+TEST(IntPackTest, RoundTripUInt16) { round_trip_all_bit_widths<u16>(); }
+
+TEST(IntPackTest, RoundTripUInt32) { round_trip_all_bit_widths<u32>(); }
+
+TEST(IntPackTest, RoundTripUInt64) { round_trip_all_bit_widths<u64>(); }
+
+TEST(IntPackTest, EstimateIsExactForShortRuns)
+{
+    std::mt19937_64 random(7);
+    std::vector<i32> values(1000);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = (i32) (random() % 1000) - 500;
+    }
+
+    size_t sizes[NG5_INTPACK_NUM_TYPES] = { 0 };
+    intpack_estimate(sizes, values.data(), values.size(), sizeof(i32), true);
+    for (enum intpack_type type : types) {
+        struct memblock *block;
+        struct memfile file;
+        memblock_create(&block, 64);
+        memfile_open(&file, block, READ_WRITE);
+        intpack_encode(&file, type, values.data(), values.size(), sizeof(i32), true);
+        ASSERT_EQ(sizes[type], memfile_tell(&file)) << intpack_type_str(type);
+        memblock_drop(block);
+    }
+}
+
+TEST(IntPackTest, ChooseSmallestEncoding)
+{
+    std::vector<u64> timestamps(100000), constants(100000, 1234567890123ull), random_values(100000);
+    std::mt19937_64 random(3);
+    for (size_t i = 0; i < timestamps.size(); i++) {
+        timestamps[i] = 1550000000000ull + i * 1000 + random() % 10;
+        random_values[i] = random();
+    }
+
+    size_t sizes[NG5_INTPACK_NUM_TYPES] = { 0 };
+    intpack_estimate(sizes, timestamps.data(), timestamps.size(), sizeof(u64), false);
+    ASSERT_EQ(intpack_choose(sizes), INTPACK_DELTA);
+
+    memset(sizes, 0, sizeof(sizes));
+    intpack_estimate(sizes, constants.data(), constants.size(), sizeof(u64), false);
+    ASSERT_EQ(intpack_choose(sizes), INTPACK_FOR);
+
+    memset(sizes, 0, sizeof(sizes));
+    intpack_estimate(sizes, random_values.data(), random_values.size(), sizeof(u64), false);
+    ASSERT_EQ(intpack_choose(sizes), INTPACK_PLAIN);
+}
+
+TEST(IntPackTest, CountRangeOnRuns)
+{
+    std::vector<i16> values(5000);
+    std::mt19937_64 random(11);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = (i16) (i / 250 % 7) - 3;
+    }
+    std::vector<i16> random_values(values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        random_values[i] = (i16) random();
+    }
+
+    size_t sizes[NG5_INTPACK_NUM_TYPES] = { 0 };
+    intpack_estimate(sizes, values.data(), values.size(), sizeof(i16), true);
+    ASSERT_EQ(intpack_choose(sizes), INTPACK_RLE);
+
+    for (const std::vector<i16> *input : { &values, &random_values }) {
+        for (enum intpack_type type : types) {
+            struct memblock *block;
+            struct memfile file;
+            memblock_create(&block, 64);
+            memfile_open(&file, block, READ_WRITE);
+            intpack_encode(&file, type, input->data(), input->size(), sizeof(i16), true);
+            for (i64 lo = -4; lo <= 4; lo++) {
+                i64 hi = lo + 2;
+                size_t expected = 0;
+                for (i16 value : *input) {
+                    expected += value >= lo && value <= hi;
+                }
+                ASSERT_EQ(intpack_count_range(memblock_raw_data(block), type, input->size(), sizeof(i16), true,
+                    (u64) lo, (u64) hi), expected) << intpack_type_str(type);
+            }
+            memblock_drop(block);
+        }
+    }
+}
+
+TEST(IntPackTest, BitmapRoundTripAndPopcount)
+{
+    std::mt19937_64 random(5);
+    for (size_t length : lengths) {
+        for (bool with_nulls : { false, true }) {
+            std::vector<i8> values(length);
+            size_t num_true = 0, num_null = 0;
+            for (size_t i = 0; i < length; i++) {
+                values[i] = (i8) (with_nulls && random() % 4 == 0 ? NG5_NULL_BOOLEAN : random() % 2);
+                num_true += values[i] == 1;
+                num_null += values[i] == NG5_NULL_BOOLEAN;
+            }
+
+            size_t sizes[NG5_INTPACK_NUM_TYPES] = { 0 };
+            intpack_estimate(sizes, values.data(), values.size(), sizeof(i8), false);
+            if (length >= 8 && num_true + num_null > 0) {
+                ASSERT_EQ(intpack_choose(sizes), INTPACK_BITMAP);
+            }
+
+            struct memblock *block;
+            struct memfile file;
+            memblock_create(&block, 64);
+            memfile_open(&file, block, READ_WRITE);
+            ASSERT_TRUE(intpack_encode(&file, INTPACK_BITMAP, values.data(), values.size(), sizeof(i8), false));
+            const char *encoded = memblock_raw_data(block);
+            ASSERT_EQ(sizes[INTPACK_BITMAP], memfile_tell(&file));
+            ASSERT_EQ(intpack_encoded_size(encoded, INTPACK_BITMAP, length, sizeof(i8)), memfile_tell(&file));
+
+            std::vector<i8> decoded(length + 1);
+            ASSERT_EQ(intpack_decode(decoded.data(), encoded, INTPACK_BITMAP, length, sizeof(i8), false),
+                memfile_tell(&file));
+            for (size_t i = 0; i < length; i++) {
+                ASSERT_EQ(decoded[i], values[i]) << i << " of " << length;
+            }
+
+            size_t counted_null;
+            ASSERT_EQ(intpack_bitmap_count(&counted_null, encoded, length), num_true);
+            ASSERT_EQ(counted_null, num_null);
+            ASSERT_EQ(intpack_count_range(encoded, INTPACK_BITMAP, length, sizeof(i8), false, 0, 1),
+                length - num_null);
+            ASSERT_EQ(intpack_count_range(encoded, INTPACK_BITMAP, length, sizeof(i8), false, 1, UINT64_MAX),
+                num_true + num_null);
+            memblock_drop(block);
+        }
+    }
+
+    /* values other than booleans cannot be encoded as bitmaps */
+    std::vector<i8> values = { 0, 1, 2 };
+    size_t sizes[NG5_INTPACK_NUM_TYPES] = { 0 };
+    intpack_estimate(sizes, values.data(), values.size(), sizeof(i8), false);
+    ASSERT_EQ(sizes[INTPACK_BITMAP], SIZE_MAX);
+    intpack_estimate(sizes, values.data(), 2, sizeof(i8), false);
+    ASSERT_EQ(sizes[INTPACK_BITMAP], SIZE_MAX);
+}
+
+TEST(IntPackTest, PopcountOfBitRanges)
+{
+    std::mt19937_64 random(9);
+    std::vector<u8> bits(64);
+    for (u8 &byte : bits) {
+        byte = (u8) random();
+    }
+    for (size_t begin = 0; begin < 80; begin += 3) {
+        for (size_t end = begin; end <= bits.size() * 8; end += 29) {
+            size_t expected = 0;
+            for (size_t i = begin; i < end; i++) {
+                expected += (bits[i / 8] >> (i % 8)) & 1;
+            }
+            ASSERT_EQ(intpack_popcount(bits.data(), begin, end), expected) << begin << ".." << end;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
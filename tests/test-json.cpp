@@ -0,0 +1,382 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/encode/encode_sync.h"
+#include "json/doc.h"
+#include "json/json.h"
+#include "json/json_scan.h"
+
+/* pads 'text' with whitespaces to one block */
+static std::string
+block_of(const std::string &text)
+{
+    std::string block = text;
+    block.resize(NG5_JSON_SCAN_BLOCK_SIZE, ' ');
+    return block;
+}
+
+static u64
+escaped_of(const std::string &block, struct json_scan_carry *carry)
+{
+    struct json_scan_block classified;
+    json_scan_classify(&classified, block.c_str());
+    return json_scan_escaped(classified.backslash, carry);
+}
+
+TEST(JsonScanTest, OddBackslashRunsEscape)
+{
+    for (size_t run = 0; run < 8; run++) {
+        struct json_scan_carry carry = { 0, 0, 1 };
+        std::string block = block_of("\"ab" + std::string(run, '\\') + "\"c\"");
+        u64 escaped = escaped_of(block, &carry);
+        size_t quote = 3 + run;
+        ASSERT_EQ((escaped >> quote) & 1, run % 2) << run << " backslashes";
+        /* backslashes inside the run escape each other, but are not reported as escaped characters themselves */
+        ASSERT_EQ(escaped & ~(1ull << quote) & ~(((1ull << run) - 1) << 3), 0u) << run << " backslashes";
+        ASSERT_EQ(carry.escaped, 0u);
+    }
+}
+
+TEST(JsonScanTest, BackslashRunsCarryIntoNextBlock)
+{
+    for (size_t run = 1; run < 6; run++) {
+        struct json_scan_carry carry = { 0, 0, 1 };
+        std::string first = block_of("\"");
+        first.replace(NG5_JSON_SCAN_BLOCK_SIZE - run, run, std::string(run, '\\'));
+        escaped_of(first, &carry);
+        ASSERT_EQ(carry.escaped, run % 2);
+        u64 escaped = escaped_of(block_of("\"x\""), &carry);
+        ASSERT_EQ(escaped & 1, run % 2) << run << " backslashes";
+    }
+
+    /* a run that fills an entire block */
+    struct json_scan_carry carry = { 0, 0, 1 };
+    escaped_of(std::string(NG5_JSON_SCAN_BLOCK_SIZE, '\\'), &carry);
+    ASSERT_EQ(carry.escaped, 0u);
+    ASSERT_EQ(escaped_of(block_of("\"\""), &carry) & 1, 0u);
+}
+
+TEST(JsonScanTest, PrefixXor)
+{
+    std::mt19937_64 gen(42);
+    for (int i = 0; i < 1000; i++) {
+        u64 bits = i < 64 ? 1ull << i : gen();
+        u64 expected = 0, parity = 0;
+        for (unsigned bit = 0; bit < 64; bit++) {
+            parity ^= (bits >> bit) & 1;
+            expected |= parity << bit;
+        }
+        ASSERT_EQ(json_scan_prefix_xor(bits), expected);
+    }
+}
+
+/*
+ * positions that the structural index of 'input' is expected to contain, computed byte by byte; as in the index,
+ * a backslash escapes the next quote also outside of string literals
+ */
+static std::vector<size_t>
+expected_index(const std::string &input)
+{
+    std::vector<size_t> positions;
+    bool in_string = false, escaped = false, in_scalar = false;
+    for (size_t i = 0; i < input.size(); i++) {
+        char c = input[i];
+        bool quote = c == '"' && !escaped;
+        escaped = !escaped && c == '\\';
+        if (in_string) {
+            if (quote) {
+                positions.push_back(i);
+                in_string = false;
+            }
+            continue;
+        }
+        bool structural = std::string("{}[]:,").find(c) != std::string::npos;
+        bool whitespace = std::string(" \t\r\n").find(c) != std::string::npos;
+        if (quote) {
+            positions.push_back(i);
+            in_string = true;
+            in_scalar = false;
+        } else if (structural) {
+            positions.push_back(i);
+            in_scalar = false;
+        } else if (whitespace) {
+            in_scalar = false;
+        } else if (!in_scalar) {
+            positions.push_back(i);
+            in_scalar = true;
+        }
+    }
+    return positions;
+}
+
+static std::vector<size_t>
+scanned_index(const std::string &input)
+{
+    std::vector<size_t> positions;
+    struct json_scan_carry carry = { 0, 0, 1 };
+    for (size_t begin = 0; begin < input.size(); begin += NG5_JSON_SCAN_BLOCK_SIZE) {
+        struct json_scan_block block;
+        json_scan_classify(&block, block_of(input.substr(begin, NG5_JSON_SCAN_BLOCK_SIZE)).c_str());
+        for (u64 index = json_scan_index(&block, &carry); index; index &= index - 1) {
+            positions.push_back(begin + __builtin_ctzll(index));
+        }
+    }
+    return positions;
+}
+
+TEST(JsonScanTest, StringContentsAreNotIndexed)
+{
+    ASSERT_EQ(scanned_index("{\"a,b\": \"x]y\", \"c\": -1, \"d\": [true,null]}"),
+              std::vector<size_t>({ 0, 1, 5, 6, 8, 12, 13, 15, 17, 18, 20, 22, 24, 26, 27, 29, 30, 34, 35, 39, 40 }));
+
+    /* strings, escapes and scalars that span blocks */
+    std::string input = "{ \"k\": \"" + std::string(70, 'x') + "\\\",:[{}]\\\\\", \"n\": 1234567, \"e\": \"\\\\\\\"\" ";
+    input += std::string(NG5_JSON_SCAN_BLOCK_SIZE * 2 - 1 - input.size(), ' ') + "\"" + std::string(10, ',') + "\"";
+    input += ", \"t\": " + std::string(60, ' ') + "false }";
+    ASSERT_EQ(scanned_index(input), expected_index(input));
+
+    std::mt19937 gen(7);
+    const std::string alphabet = "\"\\{}[]:, \nab1";
+    for (int i = 0; i < 200; i++) {
+        std::string random(std::uniform_int_distribution<int>(1, 300)(gen), ' ');
+        for (char &c : random) {
+            c = alphabet[std::uniform_int_distribution<size_t>(0, alphabet.size() - 1)(gen)];
+        }
+        ASSERT_EQ(scanned_index(random), expected_index(random)) << random;
+    }
+}
+
+TEST(JsonTokenizerTest, TracksLinesAndColumns)
+{
+    std::string input = "{\n  \"key\": \"a\\\"\n\",\n\t\"numbers\": [1, -2.5,\n\n 3],";
+    input += std::string(80, ' ') + "\"multi\nline\": true,\r\n" + std::string(130, '\n') + "  \"x\": null }";
+
+    struct json_tokenizer tokenizer;
+    ASSERT_TRUE(json_tokenizer_init(&tokenizer, input.c_str()));
+    std::vector<size_t> positions = expected_index(input);
+    size_t num_tokens = 0;
+    for (const struct json_token *token; (token = json_tokenizer_next(&tokenizer)); num_tokens++) {
+        size_t pos = token->string - input.c_str() - (token->type == LITERAL_STRING ? 1 : 0);
+        ASSERT_NE(token->type, JSON_UNKNOWN) << pos;
+        unsigned line = 1;
+        size_t line_begin = 0;
+        for (size_t i = 0; i < pos; i++) {
+            if (input[i] == '\n') {
+                line++;
+                line_begin = i + 1;
+            }
+        }
+        ASSERT_EQ(token->line, line) << pos;
+        ASSERT_EQ(token->column, pos - line_begin + 1) << pos;
+        /* closing quotes are part of string tokens */
+        positions.erase(std::find(positions.begin(), positions.end(), pos));
+        if (token->type == LITERAL_STRING) {
+            positions.erase(std::find(positions.begin(), positions.end(), pos + token->length + 1));
+        }
+    }
+    ASSERT_TRUE(positions.empty());
+    ASSERT_EQ(num_tokens, 23u);
+}
+
+TEST(JsonTokenizerTest, UnterminatedStringsEndAtTheInput)
+{
+    const std::string input = "{\"key\": \"abc";
+    struct json_tokenizer tokenizer;
+    ASSERT_TRUE(json_tokenizer_init(&tokenizer, input.c_str()));
+    const struct json_token *token = NULL;
+    for (const struct json_token *next; (next = json_tokenizer_next(&tokenizer)); ) {
+        token = next;
+    }
+    ASSERT_NE(token, nullptr);
+    ASSERT_EQ(token->type, LITERAL_STRING);
+    ASSERT_EQ(token->string + token->length, input.c_str() + input.size());
+    ASSERT_EQ(std::string(token->string, token->length), "abc");
+}
+
+struct json_import {
+    struct strdic dic;
+    struct doc_bulk bulk;
+    struct doc_entries *partition;
+    struct json_parser parser;
+    struct json_err error_desc;
+    struct doc_obj *root;
+};
+
+static bool
+import_create(struct json_import *import, const std::string &input)
+{
+    encode_sync_create(&import->dic, 100, 10, 10, 0, NULL);
+    doc_bulk_create(&import->bulk, &import->dic, NULL);
+    import->partition = doc_bulk_new_entries(&import->bulk);
+    json_parser_create(&import->parser, &import->bulk);
+    return json_parse_to_doc(&import->root, &import->error_desc, &import->parser, import->partition, input.c_str());
+}
+
+static void
+import_drop(struct json_import *import)
+{
+    doc_bulk_Drop(&import->bulk);
+    strdic_drop(&import->dic);
+}
+
+static const struct doc_entries *
+entry_of(const struct doc_obj *object, const char *key)
+{
+    for (size_t i = 0; i < object->entries.num_elems; i++) {
+        const struct doc_entries *entry = vec_get(&object->entries, i, struct doc_entries);
+        if (strcmp(entry->key, key) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+TEST(JsonParseToDocTest, NumbersUseTheSmallestFittingType)
+{
+    struct json_import import;
+    ASSERT_TRUE(import_create(&import, "{\"i8\": [-128, null, 126], \"one\": 1, \"i16\": [-129, 1], \"i8null\": 127, "
+        "\"i32\": [0, 32768], \"i32min\": -2147483648, \"i64\": [2147483648], \"i64min\": -9223372036854775808, "
+        "\"u64\": [1, 18446744073709551615], \"u64big\": 9223372036854775808, \"f\": [1, 2.5], \"e\": 1e3, "
+        "\"nulls\": [null, null]}"));
+
+    /* the largest value of each signed type is reserved for null */
+    const std::vector<std::pair<const char *, field_e>> expected = {
+        { "i8", FIELD_INT8 }, { "one", FIELD_INT8 }, { "i16", FIELD_INT16 }, { "i8null", FIELD_INT16 },
+        { "i32", FIELD_INT32 }, { "i32min", FIELD_INT32 }, { "i64", FIELD_INT64 }, { "i64min", FIELD_INT64 },
+        { "u64", FIELD_UINT64 }, { "u64big", FIELD_UINT64 }, { "f", FIELD_FLOAT }, { "e", FIELD_FLOAT },
+        { "nulls", FIELD_NULL }
+    };
+    for (const auto &key_type : expected) {
+        const struct doc_entries *entry = entry_of(import.root, key_type.first);
+        ASSERT_NE(entry, nullptr) << key_type.first;
+        ASSERT_EQ(entry->type, key_type.second) << key_type.first;
+    }
+
+    const struct doc_entries *int8s = entry_of(import.root, "i8");
+    ASSERT_EQ(int8s->values.num_elems, 3u);
+    ASSERT_EQ(*vec_get(&int8s->values, 0, i8), -128);
+    ASSERT_EQ(*vec_get(&int8s->values, 1, i8), NG5_NULL_INT8);
+    ASSERT_EQ(*vec_get(&int8s->values, 2, i8), 126);
+    ASSERT_EQ(*vec_get(&entry_of(import.root, "i64min")->values, 0, i64), INT64_MIN);
+    ASSERT_EQ(*vec_get(&entry_of(import.root, "u64")->values, 1, u64), UINT64_MAX);
+    ASSERT_EQ(*vec_get(&entry_of(import.root, "f")->values, 1, float), 2.5f);
+    import_drop(&import);
+}
+
+TEST(JsonParseToDocTest, MixedTypeArraysAreRejected)
+{
+    const char *inputs[] = {
+        "{\"a\": [1, \"x\"]}", "{\"a\": [\"x\", true]}", "{\"a\": [null, true, 1.5]}", "{\"a\": [{\"b\": 1}, 1]}",
+        "{\"a\": [1, {\"b\": 1}]}", "{\"a\": [{\"b\": 1}, null, \"x\"]}"
+    };
+    for (const char *input : inputs) {
+        struct json_import import;
+        ASSERT_FALSE(import_create(&import, input)) << input;
+        ASSERT_EQ(import.parser.err.code, NG5_ERR_ARRAYOFMIXEDTYPES) << input;
+        import_drop(&import);
+    }
+
+    /* nulls mix with any type, and integers mix with floats */
+    const char *valid[] = {
+        "{\"a\": [null, 1, null]}", "{\"a\": [null, {\"b\": 1}, null]}", "{\"a\": [1, 2.5, -3]}", "{\"a\": []}"
+    };
+    for (const char *input : valid) {
+        struct json_import import;
+        ASSERT_TRUE(import_create(&import, input)) << input;
+        import_drop(&import);
+    }
+}
+
+TEST(JsonParseToDocTest, TopLevelArraysImportSiblingRecords)
+{
+    struct json_import import;
+    ASSERT_TRUE(import_create(&import, " [ {\"a\": 1}, {\"a\": 2, \"b\": \"x\"}, {} ] \n"));
+    ASSERT_EQ(import.partition->values.num_elems, 3u);
+    ASSERT_EQ(import.root, vec_get(&import.partition->values, 0, struct doc_obj));
+    const struct doc_obj *second = vec_get(&import.partition->values, 1, struct doc_obj);
+    ASSERT_EQ(entry_of(second, "b")->type, FIELD_STRING);
+    ASSERT_EQ((vec_get(&import.partition->values, 2, struct doc_obj))->entries.num_elems, 0u);
+    import_drop(&import);
+
+    ASSERT_FALSE(import_create(&import, "[{\"a\": 1}, 2]"));
+    ASSERT_EQ(import.parser.err.code, NG5_ERR_JSONTYPE);
+    import_drop(&import);
+
+    ASSERT_FALSE(import_create(&import, "[{\"a\": 1} {\"a\": 2}]"));
+    ASSERT_EQ(import.parser.err.code, NG5_ERR_JSONPARSEERR);
+    import_drop(&import);
+}
+
+TEST(JsonParseToDocTest, TrailingCommasAreRejected)
+{
+    const char *inputs[] = { "[{\"a\": 1},]", "[{\"a\": 1}, {\"a\": 2} , ]", "{\"a\": [1,]}", "{\"a\": 1,}",
+        "{\"a\": [{\"b\": 1},]}" };
+    for (const char *input : inputs) {
+        struct json_import import;
+        ASSERT_FALSE(import_create(&import, input)) << input;
+        ASSERT_EQ(import.parser.err.code, NG5_ERR_JSONPARSEERR) << input;
+        import_drop(&import);
+    }
+
+    struct json_import import;
+    ASSERT_FALSE(import_create(&import, "[{\"a\": 1},\n ]"));
+    ASSERT_NE(import.error_desc.token, nullptr);
+    ASSERT_EQ(import.error_desc.token->line, 2u);
+    ASSERT_EQ(import.error_desc.token->column, 2u);
+    import_drop(&import);
+
+    ASSERT_TRUE(import_create(&import, "[]"));
+    import_drop(&import);
+}
+
+TEST(JsonParseToDocTest, TrailingCommasAreRejectedInRecordRanges)
+{
+    const std::string input = "[{\"a\": 1}, {\"a\": 2}, {\"a\": 3},]";
+    struct json_record_range ranges[2];
+    ASSERT_EQ(json_split_records(ranges, 2, input.c_str()), 2u);
+
+    struct json_import import;
+    ASSERT_TRUE(import_create(&import, "{}"));
+    ASSERT_TRUE(json_parse_records_to_doc(&import.error_desc, &import.parser, import.partition, input.c_str(),
+        ranges + 0));
+    ASSERT_FALSE(json_parse_records_to_doc(&import.error_desc, &import.parser, import.partition, input.c_str(),
+        ranges + 1));
+    ASSERT_EQ(import.parser.err.code, NG5_ERR_JSONPARSEERR);
+    ASSERT_EQ(import.error_desc.token->column, input.size());
+    import_drop(&import);
+}
+
+TEST(JsonParseToDocTest, ErrorsReportTheOffendingToken)
+{
+    struct expected_error {
+        std::string input;
+        int code;
+        unsigned line, column;
+    };
+    const expected_error errors[] = {
+        { "{\"a\": 1,\n  \"b\": [1, \"x\"]}", NG5_ERR_ARRAYOFMIXEDTYPES, 2, 12 },
+        { "{\"a\": [[1]]}", NG5_ERR_ARRAYOFARRAYS, 1, 8 },
+        { "{\"a\" 1}", NG5_ERR_JSONPARSEERR, 1, 6 },
+        { "{\n\n  \"a\": tru }", NG5_ERR_JSONPARSEERR, 3, 8 },
+        { "{\"a\": 1 \"b\": 2}", NG5_ERR_JSONPARSEERR, 1, 9 },
+        { "{\"a\": 1}\n  x", NG5_ERR_JSONPARSEERR, 2, 3 },
+        { std::string(100, ' ') + "{\"a\":\n" + std::string(70, ' ') + "-}", NG5_ERR_JSONPARSEERR, 2, 71 },
+    };
+    for (const expected_error &error : errors) {
+        struct json_import import;
+        ASSERT_FALSE(import_create(&import, error.input)) << error.input;
+        ASSERT_EQ(import.parser.err.code, error.code) << error.input;
+        ASSERT_NE(import.error_desc.token, nullptr) << error.input;
+        ASSERT_EQ(import.error_desc.token->line, error.line) << error.input;
+        ASSERT_EQ(import.error_desc.token->column, error.column) << error.input;
+        import_drop(&import);
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+#include "core/alloc/pool.h"
+
+static void fill(void *block, size_t size, size_t seed)
+{
+    for (size_t i = 0; i < size; i++) {
+        ((unsigned char *) block)[i] = (unsigned char) (seed + i);
+    }
+}
+
+static bool has_fill(const void *block, size_t size, size_t seed)
+{
+    for (size_t i = 0; i < size; i++) {
+        if (((const unsigned char *) block)[i] != (unsigned char) (seed + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static size_t pool_size()
+{
+    size_t num_bytes = 0;
+    EXPECT_TRUE(pool_alloc_size(&num_bytes));
+    return num_bytes;
+}
+
+TEST(PoolTest, BlocksOfAllSizeClasses)
+{
+    struct allocator alloc;
+    ASSERT_TRUE(pool_alloc_create(&alloc));
+    ASSERT_TRUE(pool_alloc_is(&alloc));
+
+    std::vector<void *> blocks;
+    for (size_t size = 1; size <= NG5_POOL_MAX_BLOCK_SIZE; size += 1 + size / 8) {
+        void *block = alloc_malloc(&alloc, size);
+        ASSERT_EQ((uintptr_t) block % NG5_POOL_ALIGNMENT, 0u) << size;
+        fill(block, size, size);
+        blocks.push_back(block);
+    }
+    size_t size = 1;
+    for (void *block : blocks) {
+        ASSERT_TRUE(has_fill(block, size, size)) << size;
+        alloc_free(&alloc, block);
+        size += 1 + size / 8;
+    }
+}
+
+TEST(PoolTest, LargeBlocksAreMappedOneByOne)
+{
+    struct allocator alloc;
+    ASSERT_TRUE(pool_alloc_create(&alloc));
+
+    size_t before = pool_size();
+    void *block = alloc_malloc(&alloc, NG5_POOL_MAX_BLOCK_SIZE + 1);
+    ASSERT_EQ((uintptr_t) block % NG5_POOL_ALIGNMENT, 0u);
+    fill(block, NG5_POOL_MAX_BLOCK_SIZE + 1, 1);
+    ASSERT_GT(pool_size(), before + NG5_POOL_MAX_BLOCK_SIZE);
+
+    void *huge = alloc_malloc(&alloc, 64 * NG5_POOL_MAX_BLOCK_SIZE);
+    fill(huge, 64 * NG5_POOL_MAX_BLOCK_SIZE, 2);
+    ASSERT_GT(pool_size(), before + 65 * NG5_POOL_MAX_BLOCK_SIZE);
+    ASSERT_TRUE(has_fill(block, NG5_POOL_MAX_BLOCK_SIZE + 1, 1));
+
+    alloc_free(&alloc, block);
+    ASSERT_GT(pool_size(), before + 64 * NG5_POOL_MAX_BLOCK_SIZE);
+
+    /** a large block is unmapped by any thread */
+    std::thread([&alloc, huge] {
+        ASSERT_TRUE(has_fill(huge, 64 * NG5_POOL_MAX_BLOCK_SIZE, 2));
+        alloc_free(&alloc, huge);
+    }).join();
+    ASSERT_EQ(pool_size(), before);
+}
+
+TEST(PoolTest, ReallocAcrossSizeClasses)
+{
+    struct allocator alloc;
+    ASSERT_TRUE(pool_alloc_create(&alloc));
+
+    /** warm up the size classes used below, such that they own a slab already */
+    for (size_t size : { 16, 30, 100, 1000, 50 }) {
+        alloc_free(&alloc, alloc_malloc(&alloc, size));
+    }
+    size_t before = pool_size();
+
+    void *block = alloc_malloc(&alloc, 16);
+    fill(block, 16, 3);
+    block = alloc_realloc(&alloc, block, 100);
+    ASSERT_TRUE(has_fill(block, 16, 3));
+    fill(block, 100, 4);
+
+    /** blocks stay in place within their size class */
+    void *same = alloc_realloc(&alloc, block, 112);
+    ASSERT_EQ(same, block);
+    ASSERT_EQ(alloc_realloc(&alloc, block, 100), block);
+
+    block = alloc_realloc(&alloc, block, 1000);
+    ASSERT_TRUE(has_fill(block, 100, 4));
+    fill(block, 1000, 5);
+    ASSERT_EQ(pool_size(), before);
+
+    /** into a mapping of its own, within it, and back into a slab */
+    block = alloc_realloc(&alloc, block, 3 * NG5_POOL_MAX_BLOCK_SIZE);
+    ASSERT_TRUE(has_fill(block, 1000, 5));
+    fill(block, 3 * NG5_POOL_MAX_BLOCK_SIZE, 6);
+    size_t mapped = pool_size();
+    ASSERT_GT(mapped, before + 3 * NG5_POOL_MAX_BLOCK_SIZE);
+
+    ASSERT_EQ(alloc_realloc(&alloc, block, 2 * NG5_POOL_MAX_BLOCK_SIZE), block);
+    ASSERT_EQ(pool_size(), mapped);
+
+    block = alloc_realloc(&alloc, block, 10 * NG5_POOL_MAX_BLOCK_SIZE);
+    ASSERT_TRUE(has_fill(block, 2 * NG5_POOL_MAX_BLOCK_SIZE, 6));
+    ASSERT_GT(pool_size(), before + 10 * NG5_POOL_MAX_BLOCK_SIZE);
+    ASSERT_LT(pool_size(), before + 12 * NG5_POOL_MAX_BLOCK_SIZE);
+
+    block = alloc_realloc(&alloc, block, 50);
+    ASSERT_TRUE(has_fill(block, 50, 6));
+    ASSERT_EQ(pool_size(), before);
+
+    block = alloc_realloc(&alloc, block, 30);
+    ASSERT_TRUE(has_fill(block, 30, 6));
+    alloc_free(&alloc, block);
+    ASSERT_EQ(pool_size(), before);
+}
+
+TEST(PoolTest, BlocksAreFreedByOtherThreads)
+{
+    struct allocator alloc;
+    ASSERT_TRUE(pool_alloc_create(&alloc));
+
+    const size_t num_blocks = 20000, num_rounds = 50;
+    std::vector<void *> blocks(num_blocks);
+    size_t after_first_round = 0;
+
+    for (size_t round = 0; round < num_rounds; round++) {
+        for (size_t i = 0; i < num_blocks; i++) {
+            blocks[i] = alloc_malloc(&alloc, 48 + i % 64);
+            fill(blocks[i], 48, i + round);
+        }
+        /** remote frees are collected by this thread, such that the pool does not grow round by round */
+        std::thread([&alloc, &blocks, round] {
+            for (size_t i = 0; i < blocks.size(); i++) {
+                ASSERT_TRUE(has_fill(blocks[i], 48, i + round));
+                alloc_free(&alloc, blocks[i]);
+            }
+        }).join();
+        if (round == 0) {
+            after_first_round = pool_size();
+        }
+    }
+    ASSERT_LE(pool_size(), after_first_round + NG5_POOL_SLABS_PER_CHUNK * NG5_POOL_SLAB_SIZE);
+}
+
+TEST(PoolTest, BlocksOfExitedThreadsAreFreedAndReused)
+{
+    struct allocator alloc;
+    ASSERT_TRUE(pool_alloc_create(&alloc));
+
+    const size_t num_blocks = 20000, num_rounds = 50;
+    std::vector<void *> blocks(num_blocks);
+    size_t after_first_round = 0;
+
+    for (size_t round = 0; round < num_rounds; round++) {
+        /** each thread takes over the heap of the previous one, and collects the blocks freed meanwhile */
+        std::thread([&alloc, &blocks, round] {
+            for (size_t i = 0; i < blocks.size(); i++) {
+                blocks[i] = alloc_malloc(&alloc, 100 + i % 200);
+                fill(blocks[i], 100, i + round);
+            }
+        }).join();
+        for (size_t i = 0; i < num_blocks; i++) {
+            ASSERT_TRUE(has_fill(blocks[i], 100, i + round));
+            alloc_free(&alloc, blocks[i]);
+        }
+        if (round == 0) {
+            after_first_round = pool_size();
+        }
+    }
+    ASSERT_LE(pool_size(), after_first_round + NG5_POOL_SLABS_PER_CHUNK * NG5_POOL_SLAB_SIZE);
+}
+
+TEST(PoolTest, ConcurrentAllocationsAndFrees)
+{
+    struct allocator alloc;
+    ASSERT_TRUE(pool_alloc_create(&alloc));
+
+    /** each thread frees the blocks of its neighbour, while that one keeps allocating */
+    const size_t num_threads = 4, num_blocks = 50000;
+    std::vector<std::vector<void *>> blocks(num_threads, std::vector<void *>(num_blocks));
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; t++) {
+        threads.emplace_back([&alloc, &blocks, t] {
+            for (size_t i = 0; i < num_blocks; i++) {
+                blocks[t][i] = alloc_malloc(&alloc, 16 + (i * 7 + t) % 2000);
+                fill(blocks[t][i], 16, i + t);
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+    for (size_t t = 0; t < num_threads; t++) {
+        threads.emplace_back([&alloc, &blocks, t] {
+            std::vector<void *> &theirs = blocks[(t + 1) % num_threads];
+            for (size_t i = 0; i < num_blocks; i++) {
+                if (!has_fill(theirs[i], 16, i + (t + 1) % num_threads)) {
+                    ADD_FAILURE() << "block " << i << " of thread " << (t + 1) % num_threads << " was overwritten";
+                    return;
+                }
+                alloc_free(&alloc, theirs[i]);
+                void *own = alloc_malloc(&alloc, 16 + i % 2000);
+                fill(own, 16, t);
+                theirs[i] = own;
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    for (size_t t = 0; t < num_threads; t++) {
+        for (void *block : blocks[t]) {
+            alloc_free(&alloc, block);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "core/async/spin.h"
+
+static struct spin_stats stats_of(const struct spinlock *lock)
+{
+    struct spin_stats stats;
+    EXPECT_TRUE(spin_stats(&stats, lock));
+    return stats;
+}
+
+TEST(SpinTest, UncontendedAcquisitions)
+{
+    struct spinlock lock;
+    ASSERT_TRUE(spin_init(&lock));
+
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(spin_acquire(&lock));
+        ASSERT_TRUE(spin_release(&lock));
+    }
+    struct spin_stats stats = stats_of(&lock);
+    ASSERT_EQ(stats.acquisitions, 10u);
+    ASSERT_EQ(stats.contended, 0u);
+    ASSERT_EQ(stats.spins, 0u);
+    ASSERT_EQ(stats.sleeps, 0u);
+    ASSERT_EQ(stats.wait_ns, 0u);
+}
+
+TEST(SpinTest, ThreadsIncrementCounterUnderLock)
+{
+    struct spinlock lock;
+    ASSERT_TRUE(spin_init(&lock));
+
+    /** more threads than processors, such that waiting threads spin and fall asleep */
+    const size_t num_threads = 2 * ng5_max(4u, std::thread::hardware_concurrency());
+    const size_t num_increments = 20000;
+    size_t counter = 0;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; t++) {
+        threads.emplace_back([&lock, &counter, num_increments] {
+            for (size_t i = 0; i < num_increments; i++) {
+                spin_acquire(&lock);
+                counter++;
+                spin_release(&lock);
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(counter, num_threads * num_increments);
+
+    struct spin_stats stats = stats_of(&lock);
+    ASSERT_EQ(stats.acquisitions, num_threads * num_increments);
+    ASSERT_LE(stats.contended, stats.acquisitions);
+    ASSERT_EQ(lock.next, lock.serving);
+    ASSERT_EQ(lock.owner, 0u);
+}
+
+TEST(SpinTest, NestedAcquisitionsAreReleasedByDepth)
+{
+    struct spinlock lock;
+    ASSERT_TRUE(spin_init(&lock));
+
+    ASSERT_TRUE(spin_acquire(&lock));
+    ASSERT_TRUE(spin_acquire(&lock));
+    ASSERT_TRUE(spin_acquire(&lock));
+    ASSERT_EQ(lock.depth, 2u);
+
+    std::atomic<bool> acquired(false);
+    std::thread other([&lock, &acquired] {
+        spin_acquire(&lock);
+        acquired = true;
+        spin_release(&lock);
+    });
+
+    /** the lock is given up by the release that matches the outermost acquisition only */
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_FALSE(acquired);
+    ASSERT_TRUE(spin_release(&lock));
+    ASSERT_TRUE(spin_release(&lock));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_FALSE(acquired);
+    ASSERT_EQ(lock.depth, 0u);
+    ASSERT_TRUE(spin_release(&lock));
+    other.join();
+    ASSERT_TRUE(acquired);
+
+    /** a release without an acquisition has no effect */
+    ASSERT_FALSE(spin_release(&lock));
+
+    /** nested acquisitions are no acquisitions of their own, and the other thread waited (and fell asleep) */
+    struct spin_stats stats = stats_of(&lock);
+    ASSERT_EQ(stats.acquisitions, 2u);
+    ASSERT_EQ(stats.contended, 1u);
+    ASSERT_GE(stats.sleeps, 1u);
+    ASSERT_GT(stats.wait_ns, 0u);
+}
+
+TEST(SpinTest, ReleaseByOtherThreadHasNoEffect)
+{
+    struct spinlock lock;
+    ASSERT_TRUE(spin_init(&lock));
+    ASSERT_TRUE(spin_acquire(&lock));
+
+    bool released = true;
+    std::thread([&lock, &released] {
+        released = spin_release(&lock);
+    }).join();
+    ASSERT_FALSE(released);
+
+    /** this thread still holds the lock, and another thread gets it once this one releases it */
+    std::atomic<bool> acquired(false);
+    std::thread other([&lock, &acquired] {
+        spin_acquire(&lock);
+        acquired = true;
+        spin_release(&lock);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_FALSE(acquired);
+    ASSERT_TRUE(spin_release(&lock));
+    other.join();
+    ASSERT_TRUE(acquired);
+    ASSERT_FALSE(spin_release(&lock));
+    ASSERT_EQ(stats_of(&lock).acquisitions, 2u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -2236,7 +2236,7 @@ bool moduleCliInvoke(int argc, char **argv, FILE *file, struct cmdopt_mgr *manag
 
             struct archive_info info;
             archive_get_info(&info, &archive);
-            printf("CARBON file successfully loaded: '%s' (%.2f GiB) \n%.2f MiB record data, %.2f MiB string table (%" PRIu32 " strings), %.2f MiB index data\n",
+            printf("CARBON file successfully loaded: '%s' (%.2f GiB) \n%.2f MiB record data, %.2f MiB string table (%" PRIu64 " strings), %.2f MiB index data\n",
                     pathCarbonFileIn, file_size / 1024.0 / 1024.0 / 1024.0,
                     info.record_table_size / 1024.0 / 1024.0, info.string_table_size / 1024.0 / 1024.0, info.num_embeddded_strings,
                     info.string_id_index_size / 1024.0 / 1024.0);
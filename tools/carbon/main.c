@@ -21,6 +21,14 @@
                           "                              index\n" \
                           "   --read-optimized           Sort keys and values during pre-processing for\n" \
                           "                              efficient reads (experimental)\n" \
+                          "   --aligned                  Pad arrays in the record table to their natural\n" \
+                          "                              alignment (large ones to cache lines), such that\n" \
+                          "                              values can be loaded aligned\n" \
+                          "   --row-group-size <num>     Cut top-level arrays of more than <num> objects\n" \
+                          "                              into row groups of <num> objects, and store the\n" \
+                          "                              smallest and largest value of each column per row\n" \
+                          "                              group, such that scans can be split, pruned, and\n" \
+                          "                              paginated by row group\n" \
                           "   --force-overwrite          Overwrite the output file if this file already\n" \
                           "                              exists\n" \
                           "   --silent                   Suppress all outputs to stdout\n" \
@@ -32,9 +40,24 @@
                           "                              string dictionary encoding. Ignored unless\n" \
                           "                              parameter `--dic-type` is set to `async`.\n" \
                           "                              By default, 8 threads are spawned\n" \
+                          "   --ndjson                   Read <input> as newline-delimited JSON, i.e., one\n" \
+                          "                              JSON object per line. The input is read in chunks\n" \
+                          "                              and never held in memory entirely\n" \
+                          "   --ndjson-batch <num>       Insert strings into the string dictionary after\n" \
+                          "                              each <num> records. Ignored unless `--ndjson` is\n" \
+                          "                              set. By default, batches of 10000 records are used\n" \
+                          "   --import-nthreads <num>    Parse and import the records of a top-level array\n" \
+                          "                              with <num> threads into partitions that are merged\n" \
+                          "                              afterwards. Ignored if `--ndjson` is set. By default,\n" \
+                          "                              one thread per online processor is used\n" \
+                          "   --prof-alloc               Sample allocations of the string dictionary, the\n" \
+                          "                              columnar representation and string id caches,\n" \
+                          "                              and print bytes per subsystem and the top call\n" \
+                          "                              sites to stderr after conversion\n" \
                           "\nEXAMPLE\n" \
                           "   $ carbon-tool convert out.carbon in.json\n" \
-                          "   $ carbon-tool convert --size-optimized --read-optimized out.carbon in.json" \
+                          "   $ carbon-tool convert --size-optimized --read-optimized out.carbon in.json\n" \
+                          "   $ carbon-tool convert --ndjson out.carbon in.jsonl" \
 
 #define DESC_CAB2JS_INFO  "Convert single CARBON file into JSON and print it to stdout"
 #define DESC_CAB2JS_USAGE "The parameter <args> is a path to a CARBON file that is converted JSON and printed on stdout.\n" \
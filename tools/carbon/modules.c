@@ -1,5 +1,6 @@
 
 #include <inttypes.h>
+#include <unistd.h>
 #include "core/pack/pack.h"
 #include "core/carbon/archive_query.h"
 #include "core/carbon/archive_int.h"
@@ -43,12 +44,17 @@ static int convertJs2Model(struct js_to_context *context, FILE *file, bool optim
     encode_async_create(&context->dictionary, 1000, 1000, 1000, 8, NULL);
     NG5_CONSOLE_WRITE_CONT(file, "[%s]\n", "OK");
 
-    NG5_CONSOLE_WRITE(file, "  - Parse JSON file%s", "");
+    NG5_CONSOLE_WRITE(file, "  - Create bulk insertion bulk%s", "");
+    doc_bulk_create(&context->context, &context->dictionary, NULL);
+    NG5_CONSOLE_WRITE_CONT(file, "[%s]\n", "OK");
+
+    context->partition = doc_bulk_new_entries(&context->context);
+
+    NG5_CONSOLE_WRITE(file, "  - Parse JSON file into new partition%s", "");
     struct json_parser parser;
     struct json_err error_desc;
-    struct json jsonAst;
     json_parser_create(&parser, &context->context);
-    int status = json_parse(&jsonAst, &error_desc, &parser, context->jsonContent);
+    int status = json_parse_to_doc(NULL, &error_desc, &parser, context->partition, context->jsonContent);
     if (!status) {
         NG5_CONSOLE_WRITE_CONT(file, "[%s]\n", "ERROR");
         if (error_desc.token) {
@@ -63,35 +69,13 @@ static int convertJs2Model(struct js_to_context *context, FILE *file, bool optim
         NG5_CONSOLE_WRITE_CONT(file, "[%s]\n", "OK");
     }
 
-    NG5_CONSOLE_WRITE(file, "  - Test document restrictions%s", "");
-    struct err err;
-    status = json_test(&err, &jsonAst);
-    if (!status) {
-        NG5_CONSOLE_WRITE_CONT(file, "[%s]\n", "ERROR");
-        error_print_to_stderr(&err);
-        return false;
-    } else {
-        NG5_CONSOLE_WRITE_CONT(file, "[%s]\n", "OK");
-    }
-
-    NG5_CONSOLE_WRITE(file, "  - Create bulk insertion bulk%s", "");
-    doc_bulk_create(&context->context, &context->dictionary);
-    NG5_CONSOLE_WRITE_CONT(file, "[%s]\n", "OK");
-
-    context->partition = doc_bulk_new_entries(&context->context);
-
-    NG5_CONSOLE_WRITE(file, "  - Add file to new partition%s", "");
-    doc_bulk_add_json(context->partition, &jsonAst);
-    json_drop(&jsonAst);
-    NG5_CONSOLE_WRITE_CONT(file, "[%s]\n", "OK");
-
     NG5_CONSOLE_WRITE(file, "  - Cleanup reserved memory%s", "");
     doc_bulk_shrink(&context->context);
     NG5_CONSOLE_WRITE_CONT(file, "[%s]\n", "OK");
 
     NG5_CONSOLE_WRITE(file, "  - Finalize partition%s", "");
     context->partitionMetaModel =
-        doc_entries_columndoc(&context->context, context->partition, optimizeForReads);
+        doc_entries_columndoc(&context->context, context->partition, optimizeForReads, NULL);
     NG5_CONSOLE_WRITE_CONT(file, "[%s]\n", "OK");
 
     return true;
@@ -167,11 +151,17 @@ bool moduleCheckJsInvoke(int argc, char **argv, FILE *file, struct cmdopt_mgr *m
 #define JS_2_CAB_OPTION_SILENT_OUTPUT "--silent"
 #define JS_2_CAB_OPTION_SIZE_OPTIMIZED "--size-optimized"
 #define JS_2_CAB_OPTION_READ_OPTIMIZED "--read-optimized"
+#define JS_2_CAB_OPTION_ALIGNED "--aligned"
+#define JS_2_CAB_OPTION_ROW_GROUP_SIZE "--row-group-size"
 #define JS_2_CAB_OPTION_DIC_TYPE "--dic-type"
 #define JS_2_CAB_OPTION_DIC_NTHREADS "--dic-nthreads"
 #define JS_2_CAB_OPTION_NO_STRING_ID_INDEX "--no-string-id-index"
 #define JS_2_CAB_OPTION_USE_COMPRESSOR "--compressor"
 #define JS_2_CAB_OPTION_USE_COMPRESSOR_HUFFMAN "huffman"
+#define JS_2_CAB_OPTION_NDJSON "--ndjson"
+#define JS_2_CAB_OPTION_NDJSON_BATCH "--ndjson-batch"
+#define JS_2_CAB_OPTION_IMPORT_NTHREADS "--import-nthreads"
+#define JS_2_CAB_OPTION_PROF_ALLOC "--prof-alloc"
 
 static void tracker_begin_create_from_model()
 {
@@ -321,11 +311,17 @@ bool moduleJs2CabInvoke(int argc, char **argv, FILE *file, struct cmdopt_mgr *ma
     } else {
         bool flagSizeOptimized = false;
         bool flagReadOptimized = false;
+        bool flagAligned = false;
+        u64 row_group_size = 0;
         bool flagForceOverwrite = false;
         bool flagBakeStringIdIndex = true;
+        bool flagNdJson = false;
+        size_t ndjson_batch_size = NG5_NDJSON_BATCH_SIZE;
         enum packer_type compressor = PACK_NONE;
         enum strdic_tag dic_type = ASYNC;
         int string_dic_async_nthreads = 8;
+        long import_nthreads = ng5_max(1, sysconf(_SC_NPROCESSORS_ONLN));
+        bool flagProfAlloc = false;
 
         int outputIdx = 0, inputIdx = 1;
         int i;
@@ -338,6 +334,8 @@ bool moduleJs2CabInvoke(int argc, char **argv, FILE *file, struct cmdopt_mgr *ma
                     compressor = PACK_HUFFMAN;
                 } else if (strcmp(opt, JS_2_CAB_OPTION_READ_OPTIMIZED) == 0) {
                     flagReadOptimized = true;
+                } else if (strcmp(opt, JS_2_CAB_OPTION_ALIGNED) == 0) {
+                    flagAligned = true;
                 } else if (strcmp(opt, JS_2_CAB_OPTION_NO_STRING_ID_INDEX) == 0) {
                     flagBakeStringIdIndex = false;
                 } else if (strcmp(opt, JS_2_CAB_OPTION_SILENT_OUTPUT) == 0) {
@@ -353,6 +351,46 @@ bool moduleJs2CabInvoke(int argc, char **argv, FILE *file, struct cmdopt_mgr *ma
                         NG5_CONSOLE_WRITELN(file, "** ERROR ** unsupported operation requested: %s", opt);
                         return false;
                     }
+                } else if (strcmp(opt, JS_2_CAB_OPTION_ROW_GROUP_SIZE) == 0 && i++ < argc) {
+                    const char *size_str = argv[i];
+                    long long size_atoll = atoll(size_str);
+                    if (size_atoll > 0) {
+                        row_group_size = size_atoll;
+                    } else {
+                        NG5_CONSOLE_WRITE(file, "not a number or zero objects per row group: '%s'",
+                                             size_str);
+                        NG5_CONSOLE_WRITE_CONT(file, "[%s]\n", "ERROR");
+                        NG5_CONSOLE_WRITELN(file, "** ERROR ** row group setting cannot be applied: %s", opt);
+                        return false;
+                    }
+                } else if (strcmp(opt, JS_2_CAB_OPTION_NDJSON) == 0) {
+                    flagNdJson = true;
+                } else if (strcmp(opt, JS_2_CAB_OPTION_NDJSON_BATCH) == 0 && i++ < argc) {
+                    const char *batch_str = argv[i];
+                    int batch_atoi = atoi(batch_str);
+                    if (batch_atoi > 0) {
+                        ndjson_batch_size = batch_atoi;
+                    } else {
+                        NG5_CONSOLE_WRITE(file, "not a number or zero records per batch: '%s'",
+                                             batch_str);
+                        NG5_CONSOLE_WRITE_CONT(file, "[%s]\n", "ERROR");
+                        NG5_CONSOLE_WRITELN(file, "** ERROR ** batch setting cannot be applied: %s", opt);
+                        return false;
+                    }
+                } else if (strcmp(opt, JS_2_CAB_OPTION_IMPORT_NTHREADS) == 0 && i++ < argc) {
+                    const char *nthreads_str = argv[i];
+                    int nthreads_atoi = atoi(nthreads_str);
+                    if (nthreads_atoi > 0) {
+                        import_nthreads = nthreads_atoi;
+                    } else {
+                        NG5_CONSOLE_WRITE(file, "not a number or zero threads assigned: '%s'",
+                                             nthreads_str);
+                        NG5_CONSOLE_WRITE_CONT(file, "[%s]\n", "ERROR");
+                        NG5_CONSOLE_WRITELN(file, "** ERROR ** thread setting cannot be applied: %s", opt);
+                        return false;
+                    }
+                } else if (strcmp(opt, JS_2_CAB_OPTION_PROF_ALLOC) == 0) {
+                    flagProfAlloc = true;
                 } else if (strcmp(opt, JS_2_CAB_OPTION_DIC_TYPE) == 0 && i++ < argc) {
                     const char *dic_type_name = argv[i];
                     if (strcmp(dic_type_name, "async") == 0) {
@@ -415,17 +453,22 @@ bool moduleJs2CabInvoke(int argc, char **argv, FILE *file, struct cmdopt_mgr *ma
             return false;
         }
 
-        NG5_CONSOLE_WRITELN(file, "  - Read contents into memory%s", "");
-
+        char *jsonContent = NULL;
         FILE *f = fopen(pathJsonFileIn, "rb");
-        fseek(f, 0, SEEK_END);
-        long fsize = ftell(f);
-        fseek(f, 0, SEEK_SET);
-        char *jsonContent = malloc(fsize + 1);
-        size_t nread = fread(jsonContent, fsize, 1, f);
-        ng5_unused(nread);
-        fclose(f);
-        jsonContent[fsize] = 0;
+        if (!flagNdJson) {
+            NG5_CONSOLE_WRITELN(file, "  - Read contents into memory%s", "");
+            fseek(f, 0, SEEK_END);
+            long fsize = ftell(f);
+            fseek(f, 0, SEEK_SET);
+            jsonContent = malloc(fsize + 1);
+            size_t nread = fread(jsonContent, fsize, 1, f);
+            ng5_unused(nread);
+            fclose(f);
+            jsonContent[fsize] = 0;
+        } else {
+            NG5_CONSOLE_WRITELN(file, "  - Stream newline-delimited contents in batches of %zu records",
+                                ndjson_batch_size);
+        }
 
         struct archive archive;
         struct err err;
@@ -459,14 +502,32 @@ bool moduleJs2CabInvoke(int argc, char **argv, FILE *file, struct cmdopt_mgr *ma
         progress_tracker.begin_string_id_index_baking = tracker_begin_string_id_index_baking;
         progress_tracker.end_string_id_index_baking = tracker_end_string_id_index_baking;
 
-        if (!archive_from_json(&archive, pathCarbonFileOut, &err, jsonContent,
-                                      compressor, dic_type, string_dic_async_nthreads, flagReadOptimized,
-                                      flagBakeStringIdIndex, &progress_tracker)) {
+        if (flagProfAlloc) {
+            prof_alloc_enable(NG5_PROF_SAMPLE_RATE);
+        }
+
+        bool status;
+        if (!flagNdJson) {
+            status = archive_from_json_parallel(&archive, pathCarbonFileOut, &err, jsonContent, import_nthreads,
+                                                compressor, dic_type, string_dic_async_nthreads, flagReadOptimized,
+                                                flagAligned, row_group_size, flagBakeStringIdIndex,
+                                                &progress_tracker);
+        } else {
+            status = archive_from_ndjson(&archive, pathCarbonFileOut, &err, f, ndjson_batch_size,
+                                         compressor, dic_type, string_dic_async_nthreads, flagReadOptimized,
+                                         flagAligned, row_group_size, flagBakeStringIdIndex, &progress_tracker);
+            fclose(f);
+        }
+        if (!status) {
             error_print_and_abort(&err);
         } else {
             archive_close(&archive);
         }
 
+        if (flagProfAlloc) {
+            prof_alloc_dump(stderr);
+        }
+
 
         free(jsonContent);
 
@@ -577,7 +638,7 @@ bool moduleInspectInvoke(int argc, char **argv, FILE *file, struct cmdopt_mgr *m
             printf("string-table-size:\t%zu B\n", info.string_table_size);
             printf("record-table-size:\t%zu B\n", info.record_table_size);
             printf("index-size:\t\t%zu B\n", info.string_id_index_size);
-            printf("#-embedded-strings:\t%" PRIu32 "\n", info.num_embeddded_strings);
+            printf("#-embedded-strings:\t%" PRIu64 "\n", info.num_embeddded_strings);
         }
     }
 
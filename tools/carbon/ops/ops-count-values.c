@@ -1,14 +1,13 @@
 #include "core/carbon/archive_visitor.h"
-#include "std/hash_set.h"
-#include "std/hash_table.h"
+#include "std/hash_map.h"
 #include "core/carbon/archive_query.h"
 #include "ops-count-values.h"
 
 struct capture
 {
     const char *path;
-    struct hashtable ofMapping(field_sid_t, u32) counts;
-    struct hashset ofType(field_sid_t) keys;
+    struct hashmap_u64_u32 ofMapping(field_sid_t, u32) counts;
+    bool out_of_memory;
 };
 //
 static void
@@ -38,15 +37,12 @@ visit_string_pairs (struct archive *archive, path_stack_t path, object_id_t id,
 //                printf("visit_string_pairs -- KEY %s, VALUE %s\n", keystr, valuestr);
 //                free(valuestr);
 
-                const u32 *count_ptr = hashtable_get_value(&params->counts, &keys[i]);
-                u32 count_val = 0;
-                if (!count_ptr) {
-                    hashset_insert_or_update(&params->keys, &keys[i], 1);
+                u32 *count = hashmap_u64_u32_upsert(&params->counts, keys[i], NULL);
+                if (unlikely(!count)) {
+                    params->out_of_memory = true;
                 } else {
-                    count_val = *count_ptr;
+                    (*count)++;
                 }
-                count_val++;
-                hashtable_insert_or_update(&params->counts, &keys[i], &count_val, 1);
             }
 
             free(keystr);
@@ -124,16 +120,12 @@ get_column_entry_count(struct archive *archive, path_stack_t path, field_sid_t k
     archive_visitor_path_to_string(buffer, archive, path);
 
     if (strcmp(buffer, params->path) == 0) {
-        const u32 *count_ptr = hashtable_get_value(&params->counts, &key);
-        u32 count_val = 0;
-        if (!count_ptr) {
-            hashset_insert_or_update(&params->keys, &key, 1);
-        } else {
-            count_val = *count_ptr;
+        u32 *value = hashmap_u64_u32_upsert(&params->counts, key, NULL);
+        if (unlikely(!value)) {
+            params->out_of_memory = true;
+            return false;
         }
-        count_val += count;
-        hashtable_insert_or_update(&params->counts, &key, &count_val, 1);
-
+        *value += count;
     }
     return true;
 
@@ -150,10 +142,12 @@ ops_count_values(timestamp_t *duration, struct vector ofType(ops_count_values_re
     struct archive_visitor_desc desc = { .visit_mask = NG5_ARCHIVE_ITER_MASK_ANY };
 
     struct capture capture = {
-        .path = path
+        .path = path,
+        .out_of_memory = false
     };
-    hashtable_create(&capture.counts, &archive->err, sizeof(field_sid_t), sizeof(u32), 50);
-    hashset_create(&capture.keys, &archive->err, sizeof(field_sid_t), 50);
+    if (!hashmap_u64_u32_create(&capture.counts, NULL, 50)) {
+        return false;
+    }
 
     visitor.visit_string_pairs = visit_string_pairs;
     visitor.visit_string_array_pair = visit_string_array_pair;
@@ -165,22 +159,23 @@ ops_count_values(timestamp_t *duration, struct vector ofType(ops_count_values_re
     timestamp_t end = time_now_wallclock();
     *duration = (end - begin);
 
-    struct vector ofType(field_sid_t) *keys = hashset_keys(&capture.keys);
-//    vec_push(result, pairs->base, pairs->num_elems);
-    for (u32 i = 0; i < keys->num_elems; i++) {
-        field_sid_t id = *vec_get(keys, i, field_sid_t);
-        u32 count = *(u32 *) hashtable_get_value(&capture.counts, &id);
+    if (unlikely(capture.out_of_memory)) {
+        hashmap_u64_u32_drop(&capture.counts);
+        return false;
+    }
+
+    field_sid_t id;
+    u32 *count;
+    u32 it = 0;
+    while (hashmap_u64_u32_next(&id, &count, &it, &capture.counts)) {
         ops_count_values_result_t r = {
             .key = id,
-            .count = count
+            .count = *count
         };
         vec_push(result, &r, 1);
     }
-    vec_drop(keys);
-
 
-    hashtable_drop(&capture.counts);
-    hashset_drop(&capture.keys);
+    hashmap_u64_u32_drop(&capture.counts);
 
     return true;
 }
\ No newline at end of file
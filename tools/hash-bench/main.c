@@ -0,0 +1,366 @@
+/**
+ * Copyright 2018 Marcus Pinnecke
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * Throughput and bucket-collision quality benchmark for the hash functions in 'src/include/hash/'.
+ *
+ * For each key set, every hash function is run over all keys for a number of rounds to measure throughput in
+ * bytes per second. Then, keys are distributed into as many buckets as there are keys (using 'hash % num_buckets' as
+ * the containers in this library do), and the distribution is compared against an ideal uniform random hash:
+ *
+ *  - quality: sum_j b_j(b_j + 1)/2 / ((n / 2m)(n + 2m - 1)), where b_j is the number of keys in bucket j; values
+ *    close to 1.0 are ideal, values above 1.0 indicate clustering
+ *  - empty: fraction of empty buckets (ideal is 1/e ~ 0.368 for load factor 1.0)
+ *  - max: longest bucket chain
+ *  - full collisions: number of distinct keys with the same (full) 32bit hash value
+ *
+ * Key sets are the strings of each input file (string literals for JSON files, lines for any other file), and
+ * synthetic fixed-width field_sid_t keys (dense, and strided as produced by the async dictionary).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "shared/common.h"
+#include "std/vec.h"
+#include "hash/add.h"
+#include "hash/bern.h"
+#include "hash/bern2.h"
+#include "hash/elf.h"
+#include "hash/fnv.h"
+#include "hash/jenkins.h"
+#include "hash/oat.h"
+#include "hash/rot.h"
+#include "hash/sax.h"
+#include "hash/xor.h"
+#include "hash/wyhash.h"
+
+#define DEFAULT_NUM_ROUNDS      10
+#define NUM_SYNTHETIC_SIDS      1000000
+#define SID_STRIDE              (1ull << 54)     /* see MAKE_GLOBAL in encode_async.c */
+
+typedef hash32_t (*hash_func_t)(size_t key_size, const void *key);
+
+struct key_set {
+        const char *name;
+        size_t num_keys;
+        size_t num_bytes;
+        const void **keys;
+        size_t *key_sizes;
+};
+
+#define DEFINE_HASH_FUNC(name, macro)                                                                                  \
+static hash32_t hash_##name(size_t len, const void *key)                                                               \
+{                                                                                                                      \
+        return macro(len, key);                                                                                        \
+}
+
+DEFINE_HASH_FUNC(additive, NG5_HASH_ADDITIVE)
+DEFINE_HASH_FUNC(xor, NG5_HASH_XOR)
+DEFINE_HASH_FUNC(rot, NG5_HASH_ROT)
+DEFINE_HASH_FUNC(sax, NG5_HASH_SAX)
+DEFINE_HASH_FUNC(oat, NG5_HASH_OAT)
+DEFINE_HASH_FUNC(elf, NG5_HASH_ELF)
+DEFINE_HASH_FUNC(fnv, NG5_HASH_FNV)
+DEFINE_HASH_FUNC(bernstein, NG5_HASH_BERNSTEIN)
+DEFINE_HASH_FUNC(bernstein2, NG5_HASH_BERNSTEIN2)
+DEFINE_HASH_FUNC(jenkins, NG5_HASH_JENKINS)
+DEFINE_HASH_FUNC(wyhash, NG5_HASH_WYHASH)
+
+static hash32_t hash_wyhash_sid(size_t key_size, const void *key)
+{
+        ng5_unused(key_size);
+        assert(key_size == sizeof(field_sid_t));
+        return NG5_HASH_WYHASH_SID(*(const field_sid_t *) key);
+}
+
+static struct {
+        const char *name;
+        hash_func_t func;
+        bool fixed_width_only;
+} hash_funcs[] = {
+        { "additive",   hash_additive,   false },
+        { "xor",        hash_xor,        false },
+        { "rot",        hash_rot,        false },
+        { "sax",        hash_sax,        false },
+        { "oat",        hash_oat,        false },
+        { "elf",        hash_elf,        false },
+        { "fnv",        hash_fnv,        false },
+        { "bernstein",  hash_bernstein,  false },
+        { "bernstein2", hash_bernstein2, false },
+        { "jenkins",    hash_jenkins,    false },
+        { "wyhash",     hash_wyhash,     false },
+        { "wyhash-sid", hash_wyhash_sid, true  }
+};
+
+static double now_seconds()
+{
+        struct timespec spec;
+        clock_gettime(CLOCK_MONOTONIC, &spec);
+        return spec.tv_sec + spec.tv_nsec / 1.0e9;
+}
+
+static bool read_file(char **content, size_t *size, const char *path)
+{
+        FILE *file = fopen(path, "rb");
+        if (!file) {
+                fprintf(stderr, "unable to open file '%s'\n", path);
+                return false;
+        }
+        fseek(file, 0, SEEK_END);
+        *size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        *content = malloc(*size + 1);
+        if (!*content) {
+                fprintf(stderr, "unable to allocate memory for file '%s'\n", path);
+                fclose(file);
+                return false;
+        }
+        if (fread(*content, 1, *size, file) != *size) {
+                fprintf(stderr, "unable to read file '%s'\n", path);
+                free(*content);
+                fclose(file);
+                return false;
+        }
+        (*content)[*size] = '\0';
+        fclose(file);
+        return true;
+}
+
+static void key_set_add(struct vector ofType(const void *) *keys, struct vector ofType(size_t) *sizes,
+                        size_t *num_bytes, const char *key, size_t key_size)
+{
+        if (key_size > 0) {
+                vec_push(keys, &key, 1);
+                vec_push(sizes, &key_size, 1);
+                *num_bytes += key_size;
+        }
+}
+
+static void key_set_finalize(struct key_set *set, const char *name, struct vector ofType(const void *) *keys,
+                             struct vector ofType(size_t) *sizes, size_t num_bytes)
+{
+        set->name = name;
+        set->num_keys = keys->num_elems;
+        set->num_bytes = num_bytes;
+        set->keys = malloc(keys->num_elems * sizeof(void *));
+        set->key_sizes = malloc(sizes->num_elems * sizeof(size_t));
+        memcpy(set->keys, vec_all(keys, const void *), keys->num_elems * sizeof(void *));
+        memcpy(set->key_sizes, vec_all(sizes, size_t), sizes->num_elems * sizeof(size_t));
+}
+
+static void key_set_drop(struct key_set *set);
+
+/** on success, the keys of 'set' point into 'content', which must be freed after 'set' is dropped */
+static bool key_set_from_file(struct key_set *set, char **content, const char *path)
+{
+        size_t size, num_bytes = 0;
+        struct vector ofType(const void *) keys;
+        struct vector ofType(size_t) sizes;
+
+        if (!read_file(content, &size, path)) {
+                return false;
+        }
+
+        vec_create(&keys, NULL, sizeof(const void *), 1024);
+        vec_create(&sizes, NULL, sizeof(size_t), 1024);
+
+        size_t path_len = strlen(path);
+        bool is_json = path_len > 5 && strcmp(path + path_len - 5, ".json") == 0;
+        char *it = *content, *end = *content + size;
+
+        if (is_json) {
+                /* string literals (keys and values) are what ends up in the string dictionary */
+                while ((it = memchr(it, '"', end - it)) != NULL) {
+                        char *begin = ++it;
+                        while (it < end && *it != '"') {
+                                it += (*it == '\\') ? 2 : 1;
+                        }
+                        if (it >= end) {
+                                break;
+                        }
+                        key_set_add(&keys, &sizes, &num_bytes, begin, it - begin);
+                        it++;
+                }
+        } else {
+                while (it < end) {
+                        char *line_end = memchr(it, '\n', end - it);
+                        line_end = line_end ? line_end : end;
+                        key_set_add(&keys, &sizes, &num_bytes, it, line_end - it);
+                        it = line_end + 1;
+                }
+        }
+
+        key_set_finalize(set, path, &keys, &sizes, num_bytes);
+        vec_drop(&keys);
+        vec_drop(&sizes);
+
+        if (set->num_keys == 0) {
+                fprintf(stderr, "no keys found in file '%s'\n", path);
+                key_set_drop(set);
+                free(*content);
+                return false;
+        }
+        return true;
+}
+
+static void key_set_from_sids(struct key_set *set, field_sid_t *sids, const char *name, u64 stride)
+{
+        set->name = name;
+        set->num_keys = NUM_SYNTHETIC_SIDS;
+        set->num_bytes = NUM_SYNTHETIC_SIDS * sizeof(field_sid_t);
+        set->keys = malloc(NUM_SYNTHETIC_SIDS * sizeof(void *));
+        set->key_sizes = malloc(NUM_SYNTHETIC_SIDS * sizeof(size_t));
+        for (size_t i = 0; i < NUM_SYNTHETIC_SIDS; i++) {
+                /* with a stride, ids are spread over 8 disjoint ranges as they are when produced by several
+                 * dictionary threads */
+                sids[i] = stride == 1 ? i : (i % 8) * stride + i / 8;
+                set->keys[i] = sids + i;
+                set->key_sizes[i] = sizeof(field_sid_t);
+        }
+}
+
+static void key_set_drop(struct key_set *set)
+{
+        free(set->keys);
+        free(set->key_sizes);
+}
+
+struct hash_entry {
+        hash32_t hash;
+        size_t idx;
+};
+
+static int hash_entry_cmp(const void *lhs, const void *rhs)
+{
+        const struct hash_entry *a = lhs, *b = rhs;
+        if (a->hash != b->hash) {
+                return a->hash < b->hash ? -1 : 1;
+        }
+        return a->idx < b->idx ? -1 : (a->idx > b->idx ? 1 : 0);
+}
+
+static void run_benchmark(const struct key_set *set, hash_func_t func, const char *func_name, size_t num_rounds)
+{
+        size_t num_buckets = set->num_keys;
+        size_t *bucket_sizes = calloc(num_buckets, sizeof(size_t));
+        hash32_t *hashes = malloc(set->num_keys * sizeof(hash32_t));
+        volatile hash32_t sink = 0;
+
+        double begin = now_seconds();
+        for (size_t round = 0; round < num_rounds; round++) {
+                hash32_t acc = 0;
+                for (size_t i = 0; i < set->num_keys; i++) {
+                        acc ^= func(set->key_sizes[i], set->keys[i]);
+                }
+                sink ^= acc;
+        }
+        double elapsed = now_seconds() - begin;
+        ng5_unused(sink);
+
+        for (size_t i = 0; i < set->num_keys; i++) {
+                hashes[i] = func(set->key_sizes[i], set->keys[i]);
+                bucket_sizes[hashes[i] % num_buckets]++;
+        }
+
+        double sum = 0, n = set->num_keys, m = num_buckets;
+        size_t num_empty = 0, max_chain = 0;
+        for (size_t j = 0; j < num_buckets; j++) {
+                sum += bucket_sizes[j] * (bucket_sizes[j] + 1) / 2.0;
+                num_empty += bucket_sizes[j] == 0 ? 1 : 0;
+                max_chain = ng5_max(max_chain, bucket_sizes[j]);
+        }
+        double quality = sum / ((n / (2 * m)) * (n + 2 * m - 1));
+
+        /* full 32bit hash collisions between distinct keys; real key sets contain duplicates (e.g., repeated
+         * property names), which must not be counted */
+        struct hash_entry *entries = malloc(set->num_keys * sizeof(struct hash_entry));
+        for (size_t i = 0; i < set->num_keys; i++) {
+                entries[i].hash = hashes[i];
+                entries[i].idx = i;
+        }
+        qsort(entries, set->num_keys, sizeof(struct hash_entry), hash_entry_cmp);
+        size_t num_collisions = 0;
+        for (size_t i = 1; i < set->num_keys; i++) {
+                size_t a = entries[i - 1].idx, b = entries[i].idx;
+                if (entries[i - 1].hash == entries[i].hash && (set->key_sizes[a] != set->key_sizes[b] ||
+                                memcmp(set->keys[a], set->keys[b], set->key_sizes[a]) != 0)) {
+                        num_collisions++;
+                }
+        }
+
+        printf("%-12s %12.2f %10.4f %8.4f %8zu %12zu\n", func_name,
+               (set->num_bytes * num_rounds) / elapsed / (1024.0 * 1024.0), quality, num_empty / m, max_chain,
+               num_collisions);
+
+        free(entries);
+        free(hashes);
+        free(bucket_sizes);
+}
+
+static void run_benchmarks(const struct key_set *set, bool fixed_width, size_t num_rounds)
+{
+        printf("\nkey set '%s': %zu keys, %zu bytes\n", set->name, set->num_keys, set->num_bytes);
+        printf("%-12s %12s %10s %8s %8s %12s\n", "hash", "MiB/s", "quality", "empty", "max", "collisions");
+        for (size_t i = 0; i < NG5_ARRAY_LENGTH(hash_funcs); i++) {
+                if (!hash_funcs[i].fixed_width_only || fixed_width) {
+                        run_benchmark(set, hash_funcs[i].func, hash_funcs[i].name, num_rounds);
+                }
+        }
+}
+
+int main(int argc, char **argv)
+{
+        size_t num_rounds = DEFAULT_NUM_ROUNDS;
+        int arg_idx = 1;
+
+        if (argc > 1 && strncmp(argv[1], "--", 2) == 0) {
+                if (strcmp(argv[1], "--rounds") != 0 || argc < 3 || atoi(argv[2]) < 1) {
+                        fprintf(stderr, "usage: carbon-hash-bench [--rounds <num>] [<file.json>|<keys-per-line "
+                                "file>]...\n");
+                        return EXIT_FAILURE;
+                }
+                num_rounds = atoi(argv[2]);
+                arg_idx = 3;
+        }
+
+        for (; arg_idx < argc; arg_idx++) {
+                struct key_set set;
+                char *content;
+                if (key_set_from_file(&set, &content, argv[arg_idx])) {
+                        run_benchmarks(&set, false, num_rounds);
+                        key_set_drop(&set);
+                        free(content);
+                }
+        }
+
+        field_sid_t *sids = malloc(NUM_SYNTHETIC_SIDS * sizeof(field_sid_t));
+        struct key_set set;
+
+        key_set_from_sids(&set, sids, "dense sids", 1);
+        run_benchmarks(&set, true, num_rounds);
+        key_set_drop(&set);
+
+        key_set_from_sids(&set, sids, "strided sids", SID_STRIDE);
+        run_benchmarks(&set, true, num_rounds);
+        key_set_drop(&set);
+
+        free(sids);
+        return EXIT_SUCCESS;
+}